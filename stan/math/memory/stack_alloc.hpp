@@ -5,11 +5,19 @@
 //            is best we can do to get safe pointer casts to uints.
 #include <stdint.h>
 #include <stan/math/prim/meta.hpp>
+#include <algorithm>
 #include <cstdlib>
 #include <cstddef>
+#include <new>
 #include <sstream>
 #include <stdexcept>
 #include <vector>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+#ifdef _WIN32
+#include <malloc.h>
+#endif
 
 namespace stan {
 namespace math {
@@ -33,23 +41,201 @@ bool is_aligned(T* ptr, unsigned int bytes_aligned) {
 namespace internal {
 const size_t DEFAULT_INITIAL_NBYTES = 1 << 16;  // 64KB
 
-// FIXME: enforce alignment
-// big fun to inline, but only called twice
-inline char* eight_byte_aligned_malloc(size_t size) {
-  char* ptr = static_cast<char*>(malloc(size));
-  if (!ptr) {
-    return ptr;  // malloc failed to alloc
+/**
+ * Alignment in bytes of every block handed out by
+ * <code>stack_alloc</code>. 64 bytes is a cache line on all supported
+ * architectures.
+ */
+const size_t ARENA_BLOCK_ALIGNMENT = 64;
+
+/**
+ * Size of a transparent huge page. Blocks of at least this size are
+ * backed by huge pages when huge pages are enabled.
+ */
+const size_t HUGE_PAGE_NBYTES = 1 << 21;  // 2MB
+
+/**
+ * Return <code>true</code> if arena blocks should be backed by
+ * transparent huge pages. This is always the case if
+ * <code>STAN_MATH_ARENA_HUGE_PAGES</code> is defined at compile time.
+ * Otherwise huge pages are used if the environment variable
+ * <code>STAN_MATH_ARENA_HUGE_PAGES</code> is set to anything other than
+ * an empty string or <code>0</code>.
+ *
+ * Huge pages are only available on Linux; elsewhere the request is
+ * ignored and blocks are allocated on the heap.
+ *
+ * @return <code>true</code> if huge pages are requested.
+ */
+inline bool arena_huge_pages_requested() {
+#ifdef STAN_MATH_ARENA_HUGE_PAGES
+  return true;
+#else
+  const char* env = std::getenv("STAN_MATH_ARENA_HUGE_PAGES");
+  return env != nullptr && env[0] != '\0'
+         && !(env[0] == '0' && env[1] == '\0');
+#endif
+}
+
+/**
+ * Return <code>true</code> if a block of the given size is mapped
+ * directly from the OS with huge pages rather than taken from the heap.
+ *
+ * @param size Size of the block in bytes.
+ * @param huge_pages Whether huge pages are enabled for the allocator.
+ * @return <code>true</code> if the block is (or will be) memory mapped.
+ */
+inline bool is_huge_page_block(size_t size, bool huge_pages) {
+#ifdef __linux__
+  return huge_pages && size >= HUGE_PAGE_NBYTES;
+#else
+  return false;
+#endif
+}
+
+/**
+ * Return the number of bytes actually reserved for a block request of
+ * the given size. Memory mapped blocks are rounded up to a multiple of
+ * the huge page size so that the whole block can be huge page backed.
+ *
+ * @param size Requested size of the block in bytes.
+ * @param huge_pages Whether huge pages are enabled for the allocator.
+ * @return Number of bytes to reserve.
+ */
+inline size_t block_nbytes(size_t size, bool huge_pages) {
+  if (is_huge_page_block(size, huge_pages)) {
+    return (size + HUGE_PAGE_NBYTES - 1) & ~(HUGE_PAGE_NBYTES - 1);
+  }
+  return size;
+}
+
+/**
+ * Allocate a block of memory aligned to
+ * <code>ARENA_BLOCK_ALIGNMENT</code> bytes. If huge pages are enabled
+ * and the block is large enough it is mapped anonymously and advised
+ * as a transparent huge page region.
+ *
+ * @param size Size of the block in bytes, as returned by
+ * <code>block_nbytes()</code>.
+ * @param huge_pages Whether huge pages are enabled for the allocator.
+ * @return Pointer to the block or <code>nullptr</code> if the
+ * allocation failed.
+ */
+inline char* aligned_block_malloc(size_t size, bool huge_pages) {
+#ifdef __linux__
+  if (is_huge_page_block(size, huge_pages)) {
+    void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) {
+      return nullptr;
+    }
+#ifdef MADV_HUGEPAGE
+    madvise(ptr, size, MADV_HUGEPAGE);
+#endif
+    return static_cast<char*>(ptr);
+  }
+#endif
+#ifdef _WIN32
+  return static_cast<char*>(_aligned_malloc(size, ARENA_BLOCK_ALIGNMENT));
+#else
+  void* ptr = nullptr;
+  if (posix_memalign(&ptr, ARENA_BLOCK_ALIGNMENT, size) != 0) {
+    return nullptr;
+  }
+  return static_cast<char*>(ptr);
+#endif
+}
+
+/**
+ * Release a block allocated with <code>aligned_block_malloc()</code>.
+ *
+ * @param ptr Pointer to the block.
+ * @param size Size of the block in bytes.
+ * @param huge_pages Whether huge pages are enabled for the allocator.
+ */
+inline void aligned_block_free(char* ptr, size_t size, bool huge_pages) {
+#ifdef __linux__
+  if (is_huge_page_block(size, huge_pages)) {
+    munmap(ptr, size);
+    return;
   }
-  if (!is_aligned(ptr, 8U)) {
-    std::stringstream s;
-    s << "invalid alignment to 8 bytes, ptr="
-      << reinterpret_cast<uintptr_t>(ptr) << std::endl;
-    throw std::runtime_error(s.str());
+#endif
+#ifdef _WIN32
+  _aligned_free(ptr);
+#else
+  free(ptr);
+#endif
+}
+
+/**
+ * Return the pages of a memory mapped block past the first
+ * <code>keep</code> bytes to the OS with <code>MADV_DONTNEED</code>.
+ * The address range stays valid and is transparently refaulted (zero
+ * filled) when touched again. Heap blocks are left untouched.
+ *
+ * @param ptr Pointer to the block.
+ * @param size Size of the block in bytes.
+ * @param keep Number of leading bytes which stay resident.
+ * @param huge_pages Whether huge pages are enabled for the allocator.
+ */
+inline void release_block_tail(char* ptr, size_t size, size_t keep,
+                               bool huge_pages) {
+#if defined(__linux__) && defined(MADV_DONTNEED)
+  if (is_huge_page_block(size, huge_pages)) {
+    keep = (keep + HUGE_PAGE_NBYTES - 1) & ~(HUGE_PAGE_NBYTES - 1);
+    if (keep < size) {
+      madvise(ptr + keep, size - keep, MADV_DONTNEED);
+    }
   }
-  return ptr;
+#endif
 }
 }  // namespace internal
 
+/**
+ * Policies for how much memory a <code>stack_alloc</code> keeps when it
+ * is recovered with <code>recover_all()</code>.
+ *
+ * - <code>keep_all</code>: every block is kept for reuse (default).
+ * - <code>fixed_bytes</code>: about a fixed number of bytes are kept.
+ * - <code>moving_average</code>: an exponential moving average of the
+ *   bytes used per cycle (between two calls to
+ *   <code>recover_all()</code>) is kept, but at least a fixed number
+ *   of bytes.
+ */
+enum class arena_retention { keep_all, fixed_bytes, moving_average };
+
+/**
+ * Counters describing how a <code>stack_alloc</code> has been used since
+ * it was constructed or since the last call to
+ * <code>stack_alloc::reset_stats()</code>.
+ *
+ * The counters are only kept if <code>STAN_MATH_ARENA_STATS</code> is
+ * defined; otherwise <code>stack_alloc</code> has neither the counters
+ * nor <code>stats()</code>. They are updated on the slow paths of the
+ * allocator (switching blocks, nesting and recovery), never on the fast
+ * path of <code>stack_alloc::alloc()</code>.
+ */
+struct stack_alloc_stats {
+  size_t bytes_requested = 0;   // bytes handed out by alloc()
+  size_t bytes_reserved = 0;    // bytes currently held in blocks
+  size_t peak_bytes_used = 0;   // max bytes in use, including waste
+  size_t wasted_bytes = 0;      // bytes skipped at block ends
+  size_t block_switches = 0;    // moves to another block
+  size_t blocks_allocated = 0;  // blocks obtained from the system
+  size_t blocks_freed = 0;      // blocks returned to the system
+  size_t nested_starts = 0;     // calls to start_nested()
+  size_t recoveries = 0;        // calls to recover_all()
+
+  /**
+   * Return the fraction of the used arena memory which was wasted at
+   * the end of blocks.
+   */
+  inline double fragmentation() const {
+    const size_t used = bytes_requested + wasted_bytes;
+    return used == 0 ? 0.0 : static_cast<double>(wasted_bytes) / used;
+  }
+};
+
 /**
  * An instance of this class provides a memory pool through
  * which blocks of raw memory may be allocated and then collected
@@ -64,10 +250,25 @@ inline char* eight_byte_aligned_malloc(size_t size) {
  * recovered, with the blocks being reused, or all blocks may be
  * freed, resetting the stack of blocks to its original state.
  *
- * Alignment up to 8 byte boundaries guaranteed for the first malloc,
- * and after that it's up to the caller.  On 64-bit architectures,
- * all struct values should be padded to 8-byte boundaries if they
- * contain an 8-byte member or a virtual function.
+ * Every block is aligned to <code>internal::ARENA_BLOCK_ALIGNMENT</code>
+ * (64) bytes, so the first allocation in each block is cache line
+ * aligned. After that allocations are packed and their alignment is up
+ * to the caller.  On 64-bit architectures, all struct values should be
+ * padded to 8-byte boundaries if they contain an 8-byte member or a
+ * virtual function.
+ *
+ * On Linux, blocks of at least <code>internal::HUGE_PAGE_NBYTES</code>
+ * can be backed by transparent huge pages to reduce page faults and TLB
+ * misses on large tapes. See
+ * <code>internal::arena_huge_pages_requested()</code> for how this is
+ * enabled.
+ *
+ * By default all blocks are kept when the memory is recovered, so a
+ * long running process holds on to its peak usage. A retention policy
+ * set with <code>set_retention()</code> instead releases the memory
+ * past a target size back to the OS on <code>recover_all()</code> and
+ * consolidates the retained memory so the next cycle of the same size
+ * fits without switching blocks.
  */
 class stack_alloc {
  private:
@@ -82,6 +283,94 @@ class stack_alloc {
   std::vector<size_t> nested_cur_blocks_;
   std::vector<char*> nested_next_locs_;
   std::vector<char*> nested_cur_block_ends_;
+  bool huge_pages_;  // back large blocks with transparent huge pages
+  // next four for the retention policy applied in recover_all():
+  arena_retention retention_;
+  size_t retention_nbytes_;
+  double retention_weight_;
+  double avg_cycle_nbytes_;
+  size_t cycle_peak_nbytes_;  // peak bytes used since last recover_all()
+#ifdef STAN_MATH_ARENA_STATS
+  stack_alloc_stats stats_;
+  // used_nbytes() and stats_.wasted_bytes when stats_ were last synced
+  size_t stats_mark_nbytes_ = 0;
+  size_t stats_mark_wasted_ = 0;
+#endif
+
+  /**
+   * Return the number of bytes used in the current cycle, including
+   * space wasted at the end of blocks.
+   */
+  inline size_t used_nbytes() const {
+    size_t sum = next_loc_ - blocks_[cur_block_];
+    for (size_t i = 0; i < cur_block_; ++i) {
+      sum += sizes_[i];
+    }
+    return sum;
+  }
+
+  /**
+   * Add the bytes handed out since the last sync to the statistics.
+   * Must be called before the position of the next allocation is moved
+   * back.
+   */
+  inline void sync_stats() {
+#ifdef STAN_MATH_ARENA_STATS
+    const size_t used = used_nbytes();
+    stats_.bytes_requested += used - stats_mark_nbytes_
+                              - (stats_.wasted_bytes - stats_mark_wasted_);
+    stats_.peak_bytes_used = std::max(stats_.peak_bytes_used, used);
+    mark_stats();
+#endif
+  }
+
+  /**
+   * Remember the current position as the base for the next sync of the
+   * statistics.
+   */
+  inline void mark_stats() {
+#ifdef STAN_MATH_ARENA_STATS
+    stats_mark_nbytes_ = used_nbytes();
+    stats_mark_wasted_ = stats_.wasted_bytes;
+#endif
+  }
+
+  /**
+   * Record the bytes currently used if a retention policy is active.
+   */
+  inline void update_cycle_peak() {
+    if (retention_ != arena_retention::keep_all) {
+      cycle_peak_nbytes_ = std::max(cycle_peak_nbytes_, used_nbytes());
+    }
+  }
+
+  /**
+   * Free all blocks from the specified index on back to the system.
+   *
+   * @param first Index of the first block to free.
+   */
+  inline void release_blocks(size_t first) {
+    for (size_t i = first; i < blocks_.size(); ++i) {
+      if (blocks_[i]) {
+        internal::aligned_block_free(blocks_[i], sizes_[i], huge_pages_);
+#ifdef STAN_MATH_ARENA_STATS
+        ++stats_.blocks_freed;
+#endif
+      }
+    }
+    sizes_.resize(first);
+    blocks_.resize(first);
+  }
+
+  /**
+   * Point the next allocation to the start of the first block.
+   */
+  inline void reset_to_first_block() {
+    cur_block_ = 0;
+    next_loc_ = blocks_[0];
+    cur_block_end_ = next_loc_ + sizes_[0];
+    mark_stats();
+  }
 
   /**
    * Moves us to the next block of memory, allocating that block
@@ -93,9 +382,16 @@ class stack_alloc {
    */
   char* move_to_next_block(size_t len) {
     char* result;
+#ifdef STAN_MATH_ARENA_STATS
+    stats_.wasted_bytes += cur_block_end_ - (next_loc_ - len);
+    ++stats_.block_switches;
+#endif
     ++cur_block_;
     // Find the next block (if any) containing at least len bytes.
     while ((cur_block_ < blocks_.size()) && (sizes_[cur_block_] < len)) {
+#ifdef STAN_MATH_ARENA_STATS
+      stats_.wasted_bytes += sizes_[cur_block_];
+#endif
       ++cur_block_;
     }
     // Allocate a new block if necessary.
@@ -105,16 +401,22 @@ class stack_alloc {
       if (newsize < len) {
         newsize = len;
       }
-      blocks_.push_back(internal::eight_byte_aligned_malloc(newsize));
+      newsize = internal::block_nbytes(newsize, huge_pages_);
+      blocks_.push_back(internal::aligned_block_malloc(newsize, huge_pages_));
       if (!blocks_.back()) {
         throw std::bad_alloc();
       }
       sizes_.push_back(newsize);
+#ifdef STAN_MATH_ARENA_STATS
+      ++stats_.blocks_allocated;
+#endif
     }
     result = blocks_[cur_block_];
     // Get the object's state back in order.
     next_loc_ = result + len;
     cur_block_end_ = result + sizes_[cur_block_];
+    update_cycle_peak();
+    sync_stats();
     return result;
   }
 
@@ -125,18 +427,31 @@ class stack_alloc {
    *
    * @param initial_nbytes Initial number of bytes for the
    * allocator.  Defaults to <code>(1 << 16) = 64KB</code> initial bytes.
-   * @throws std::runtime_error if the underlying malloc is not 8-byte
-   * aligned.
+   * @param huge_pages Back blocks of at least 2MB with transparent huge
+   * pages. Defaults to <code>internal::arena_huge_pages_requested()</code>.
+   * @throws std::bad_alloc if the initial block cannot be allocated.
    */
-  explicit stack_alloc(size_t initial_nbytes = internal::DEFAULT_INITIAL_NBYTES)
-      : blocks_(1, internal::eight_byte_aligned_malloc(initial_nbytes)),
-        sizes_(1, initial_nbytes),
+  explicit stack_alloc(size_t initial_nbytes = internal::DEFAULT_INITIAL_NBYTES,
+                       bool huge_pages = internal::arena_huge_pages_requested())
+      : blocks_(1, internal::aligned_block_malloc(
+                       internal::block_nbytes(initial_nbytes, huge_pages),
+                       huge_pages)),
+        sizes_(1, internal::block_nbytes(initial_nbytes, huge_pages)),
         cur_block_(0),
-        cur_block_end_(blocks_[0] + initial_nbytes),
-        next_loc_(blocks_[0]) {
+        cur_block_end_(blocks_[0] + sizes_[0]),
+        next_loc_(blocks_[0]),
+        huge_pages_(huge_pages),
+        retention_(arena_retention::keep_all),
+        retention_nbytes_(0),
+        retention_weight_(0),
+        avg_cycle_nbytes_(0),
+        cycle_peak_nbytes_(0) {
     if (!blocks_[0]) {
       throw std::bad_alloc();  // no msg allowed in bad_alloc ctor
     }
+#ifdef STAN_MATH_ARENA_STATS
+    stats_.blocks_allocated = 1;
+#endif
   }
 
   /**
@@ -147,9 +462,9 @@ class stack_alloc {
    */
   ~stack_alloc() {
     // free ALL blocks
-    for (auto& block : blocks_) {
-      if (block) {
-        free(block);
+    for (size_t i = 0; i < blocks_.size(); ++i) {
+      if (blocks_[i]) {
+        internal::aligned_block_free(blocks_[i], sizes_[i], huge_pages_);
       }
     }
   }
@@ -158,7 +473,8 @@ class stack_alloc {
    * Return a newly allocated block of memory of the appropriate
    * size managed by the stack allocator.
    *
-   * The allocated pointer will be 8-byte aligned.
+   * The allocated pointer is only guaranteed to be 64-byte aligned if
+   * it is the first allocation in a block.
    *
    * This function may call C++'s <code>malloc()</code> function,
    * with any exceptions percolated through this function.
@@ -195,11 +511,101 @@ class stack_alloc {
    * of memory blocks allocated so far will be available for further
    * allocations.  To free memory back to the system, use the
    * function free_all().
+   *
+   * If a retention policy other than <code>keep_all</code> is set,
+   * the memory past the target of the policy is released with
+   * <code>trim()</code>.
    */
   inline void recover_all() {
-    cur_block_ = 0;
-    next_loc_ = blocks_[0];
-    cur_block_end_ = next_loc_ + sizes_[0];
+#ifdef STAN_MATH_ARENA_STATS
+    ++stats_.recoveries;
+#endif
+    if (unlikely(retention_ != arena_retention::keep_all)) {
+      update_cycle_peak();
+      const double cycle_nbytes = cycle_peak_nbytes_;
+      avg_cycle_nbytes_
+          = avg_cycle_nbytes_ == 0
+                ? cycle_nbytes
+                : retention_weight_ * cycle_nbytes
+                      + (1 - retention_weight_) * avg_cycle_nbytes_;
+      cycle_peak_nbytes_ = 0;
+      size_t target = retention_nbytes_;
+      if (retention_ == arena_retention::moving_average) {
+        target = std::max(target, static_cast<size_t>(avg_cycle_nbytes_));
+      }
+      trim(target);
+      return;
+    }
+    sync_stats();
+    reset_to_first_block();
+  }
+
+  /**
+   * Set the policy for how much memory is kept by
+   * <code>recover_all()</code>.
+   *
+   * @param policy Retention policy.
+   * @param nbytes Number of bytes kept for <code>fixed_bytes</code> and
+   * lower bound on the number of bytes kept for
+   * <code>moving_average</code>.
+   * @param weight Weight of the most recent cycle in the moving
+   * average, in (0, 1].
+   * @throws std::invalid_argument if the weight is not in (0, 1].
+   */
+  inline void set_retention(arena_retention policy, size_t nbytes = 0,
+                            double weight = 0.2) {
+    if (!(weight > 0 && weight <= 1)) {
+      throw std::invalid_argument(
+          "stack_alloc::set_retention: weight must be in (0, 1]");
+    }
+    retention_ = policy;
+    retention_nbytes_ = nbytes;
+    retention_weight_ = weight;
+    avg_cycle_nbytes_ = 0;
+    cycle_peak_nbytes_ = 0;
+  }
+
+  /**
+   * Recover all memory and release everything but about the specified
+   * number of bytes back to the system.
+   *
+   * The first block is always kept. Memory retained beyond the first
+   * block is consolidated into a single block, so that a following
+   * cycle using up to <code>nbytes</code> bytes does not have to switch
+   * or allocate blocks. An existing second block is reused if it holds
+   * between one and two times the bytes needed; any huge pages past the
+   * bytes needed are then returned to the OS with
+   * <code>MADV_DONTNEED</code>.
+   *
+   * Must not be called while memory on the stack is still in use.
+   *
+   * @param nbytes Number of bytes to retain.
+   * @throws std::bad_alloc if the consolidated block cannot be
+   * allocated.
+   */
+  inline void trim(size_t nbytes) {
+    sync_stats();
+    const size_t extra = nbytes > sizes_[0] ? nbytes - sizes_[0] : 0;
+    if (extra == 0) {
+      release_blocks(1);
+    } else if (blocks_.size() == 2 && sizes_[1] >= extra
+               && sizes_[1] / 2 <= extra) {
+      internal::release_block_tail(blocks_[1], sizes_[1], extra, huge_pages_);
+    } else {
+      release_blocks(1);
+      const size_t newsize = internal::block_nbytes(extra, huge_pages_);
+      blocks_.push_back(internal::aligned_block_malloc(newsize, huge_pages_));
+      if (!blocks_.back()) {
+        blocks_.pop_back();
+        reset_to_first_block();
+        throw std::bad_alloc();
+      }
+      sizes_.push_back(newsize);
+#ifdef STAN_MATH_ARENA_STATS
+      ++stats_.blocks_allocated;
+#endif
+    }
+    reset_to_first_block();
   }
 
   /**
@@ -207,6 +613,9 @@ class stack_alloc {
    * recover back to start.
    */
   inline void start_nested() {
+#ifdef STAN_MATH_ARENA_STATS
+    ++stats_.nested_starts;
+#endif
     nested_cur_blocks_.push_back(cur_block_);
     nested_next_locs_.push_back(next_loc_);
     nested_cur_block_ends_.push_back(cur_block_end_);
@@ -219,6 +628,8 @@ class stack_alloc {
     if (unlikely(nested_cur_blocks_.empty())) {
       recover_all();
     }
+    update_cycle_peak();
+    sync_stats();
 
     cur_block_ = nested_cur_blocks_.back();
     nested_cur_blocks_.pop_back();
@@ -228,6 +639,7 @@ class stack_alloc {
 
     cur_block_end_ = nested_cur_block_ends_.back();
     nested_cur_block_ends_.pop_back();
+    mark_stats();
   }
 
   /**
@@ -237,14 +649,10 @@ class stack_alloc {
    */
   inline void free_all() {
     // frees all BUT the first (index 0) block
-    for (size_t i = 1; i < blocks_.size(); ++i) {
-      if (blocks_[i]) {
-        free(blocks_[i]);
-      }
-    }
-    sizes_.resize(1);
-    blocks_.resize(1);
-    recover_all();
+    sync_stats();
+    release_blocks(1);
+    cycle_peak_nbytes_ = 0;
+    reset_to_first_block();
   }
 
   /**
@@ -265,6 +673,46 @@ class stack_alloc {
     return sum;
   }
 
+#ifdef STAN_MATH_ARENA_STATS
+  /**
+   * Return a snapshot of the usage statistics of this allocator.
+   *
+   * @return statistics since construction or the last call to
+   * <code>reset_stats()</code>
+   */
+  inline stack_alloc_stats stats() const {
+    stack_alloc_stats result = stats_;
+    const size_t used = used_nbytes();
+    result.bytes_requested += used - stats_mark_nbytes_
+                              - (stats_.wasted_bytes - stats_mark_wasted_);
+    result.peak_bytes_used = std::max(result.peak_bytes_used, used);
+    result.bytes_reserved = 0;
+    for (size_t size : sizes_) {
+      result.bytes_reserved += size;
+    }
+    return result;
+  }
+
+  /**
+   * Return the bytes handed out by <code>alloc()</code> as counted in
+   * <code>stats()</code>, without computing the other statistics.
+   */
+  inline size_t bytes_requested() const {
+    return stats_.bytes_requested + used_nbytes() - stats_mark_nbytes_
+           - (stats_.wasted_bytes - stats_mark_wasted_);
+  }
+
+  /**
+   * Reset all counters of the usage statistics to zero. The peak usage
+   * restarts from the bytes currently in use.
+   */
+  inline void reset_stats() {
+    stats_ = stack_alloc_stats();
+    mark_stats();
+    stats_.peak_bytes_used = stats_mark_nbytes_;
+  }
+#endif
+
   /**
    * Indicates whether the memory in the pointer
    * is in the stack.
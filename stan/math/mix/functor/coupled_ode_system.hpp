@@ -0,0 +1,153 @@
+#ifndef STAN_MATH_MIX_FUNCTOR_COUPLED_ODE_SYSTEM_HPP
+#define STAN_MATH_MIX_FUNCTOR_COUPLED_ODE_SYSTEM_HPP
+
+#include <stan/math/fwd/core.hpp>
+#include <stan/math/rev/core.hpp>
+#include <stan/math/rev/fun/value_of.hpp>
+#include <stan/math/rev/functor/coupled_ode_system.hpp>
+#include <stan/math/prim/err.hpp>
+#include <stan/math/prim/fun/Eigen.hpp>
+#include <stan/math/prim/fun/promote_scalar.hpp>
+#include <stan/math/prim/functor/apply.hpp>
+#include <initializer_list>
+#include <ostream>
+#include <tuple>
+#include <vector>
+
+namespace stan {
+namespace math {
+namespace internal {
+
+/**
+ * Return an argument of the ode right hand side without autodiff
+ * variables unchanged.
+ */
+template <typename T, require_not_st_var<T>* = nullptr>
+inline const T& to_fvar_ode_arg(const T& x) {
+  return x;
+}
+
+/**
+ * Return a copy of an argument of the ode right hand side with the vars
+ * replaced by <code>fvar<double></code> of the same value.
+ */
+template <typename T, require_st_var<T>* = nullptr>
+inline auto to_fvar_ode_arg(const T& x) {
+  return promote_scalar<fvar<double>>(value_of(x));
+}
+
+/**
+ * Set the tangents of the scalars of an argument of the ode right hand
+ * side, counted by <code>index</code> in the order of
+ * <code>count_vars()</code>, to one for the scalar <code>k</code> and to
+ * zero for all others.
+ */
+inline void seed_ode_tangent(fvar<double>& x, int& index, int k) {
+  x.d_ = index++ == k ? 1.0 : 0.0;
+}
+
+template <typename T, require_st_arithmetic<T>* = nullptr>
+inline void seed_ode_tangent(const T& x, int& index, int k) {}
+
+template <typename T, require_not_st_arithmetic<T>* = nullptr>
+inline void seed_ode_tangent(std::vector<T>& x, int& index, int k) {
+  for (auto& x_i : x) {
+    seed_ode_tangent(x_i, index, k);
+  }
+}
+
+template <typename T, require_eigen_t<T>* = nullptr,
+          require_not_st_arithmetic<T>* = nullptr>
+inline void seed_ode_tangent(T& x, int& index, int k) {
+  for (Eigen::Index i = 0; i < x.size(); ++i) {
+    seed_ode_tangent(x.coeffRef(i), index, k);
+  }
+}
+
+}  // namespace internal
+
+/**
+ * Calculate the right hand side of a coupled ode system with forward
+ * mode autodiff if it has fewer sensitivities than states.
+ *
+ * The right hand side of the sensitivity \f$ s_k \f$ is the directional
+ * derivative \f$ J_y s_k + J_{args} e_k \f$ of the ode right hand side,
+ * where \f$ e_k \f$ is zero for the sensitivities of the initial state.
+ * It is calculated by one evaluation of the right hand side with
+ * <code>fvar<double></code> states and arguments with these tangents.
+ * This costs one forward pass per sensitivity, while the reverse mode
+ * right hand side costs one recording of the ode right hand side, one
+ * reverse sweep per state and a matrix product.
+ *
+ * This overload is found by <code>coupled_ode_system_impl::operator()
+ * </code> if forward mode autodiff is included.
+ *
+ * @param[in] system coupled ode system
+ * @param[in] z state of the coupled ode system
+ * @param[out] dz_dt right hand side of the coupled ode system, only
+ *   written if true is returned
+ * @param[in] t time
+ * @return true if the right hand side was calculated, false if reverse
+ *   mode autodiff is cheaper
+ * @throw exception if the base ode function does not return the
+ *    expected number of derivatives, N.
+ */
+template <typename F, typename T_y0, typename... Args>
+inline bool coupled_ode_forward_rhs(
+    coupled_ode_system_impl<false, F, T_y0, Args...>& system,
+    const std::vector<double>& z, std::vector<double>& dz_dt, double t) {
+  const size_t N = system.N_;
+  const size_t num_y0_vars = system.num_y0_vars_;
+  const size_t num_sens = num_y0_vars + system.num_args_vars;
+  if (num_sens == 0 || num_sens >= N) {
+    return false;
+  }
+
+  auto fvar_args = apply(
+      [](const auto&... args) {
+        return std::tuple<decltype(internal::to_fvar_ode_arg(args))...>(
+            internal::to_fvar_ode_arg(args)...);
+      },
+      system.local_args_tuple_);
+  Eigen::Matrix<fvar<double>, Eigen::Dynamic, 1> y(N);
+  for (size_t n = 0; n < N; ++n) {
+    y.coeffRef(n).val_ = z[n];
+  }
+
+  dz_dt.resize(system.size());
+  for (size_t k = 0; k < num_sens; ++k) {
+    for (size_t n = 0; n < N; ++n) {
+      y.coeffRef(n).d_ = z[N + N * k + n];
+    }
+    const int arg_k = static_cast<int>(k) - static_cast<int>(num_y0_vars);
+    int index = 0;
+    apply(
+        [&](auto&... args) {
+          static_cast<void>(std::initializer_list<int>{
+              (internal::seed_ode_tangent(args, index, arg_k), 0)...});
+        },
+        fvar_args);
+
+    Eigen::Matrix<fvar<double>, Eigen::Dynamic, 1> f_y_t = apply(
+        [&](const auto&... args) {
+          return system.f_(t, y, system.msgs_, args...);
+        },
+        fvar_args);
+
+    if (k == 0) {
+      check_size_match("coupled_ode_system", "dy_dt", f_y_t.size(),
+                       "states", N);
+      for (size_t n = 0; n < N; ++n) {
+        dz_dt[n] = f_y_t.coeff(n).val_;
+      }
+    }
+    for (size_t n = 0; n < N; ++n) {
+      dz_dt[N + N * k + n] = f_y_t.coeff(n).d_;
+    }
+  }
+  return true;
+}
+
+}  // namespace math
+}  // namespace stan
+#endif
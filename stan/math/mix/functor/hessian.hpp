@@ -4,10 +4,104 @@
 #include <stan/math/fwd/core.hpp>
 #include <stan/math/prim/fun/Eigen.hpp>
 #include <stan/math/rev/core.hpp>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
 #include <stdexcept>
 
 namespace stan {
 namespace math {
+namespace internal {
+
+/**
+ * Calculate the value of the specified function, its directional
+ * derivatives and the products of its Hessian with the specified
+ * directions, with one forward-over-reverse pass per direction.
+ *
+ * Every pass evaluates the function with <code>fvar<var></code>
+ * carrying a single tangent and sweeps its own tape, so the work grows
+ * linearly with the number of directions; directions do not share a
+ * forward or a reverse sweep.
+ *
+ * The passes are independent of each other. If requested and
+ * STAN_THREADS is defined they are distributed over the threads of the
+ * TBB thread pool, each of which runs its passes on its own autodiff
+ * stack, so the function must then be safe to call concurrently. This
+ * spreads the same work over the threads without reducing it. Otherwise
+ * they are run sequentially.
+ *
+ * @tparam F Type of function
+ * @param[in] f Function
+ * @param[in] x Argument to function
+ * @param[in] V Directions, one per column
+ * @param[in] parallel Run the passes in parallel if STAN_THREADS is
+ * defined
+ * @param[out] fx Function applied to argument
+ * @param[out] grad_V Gradient of function at argument times each
+ * direction
+ * @param[out] HV Hessian of function at argument times the directions
+ * @param[out] grad If not null, gradient of function at argument,
+ * calculated with one more reverse pass after the first direction
+ */
+template <typename F>
+inline void hessian_times_directions(
+    const F& f, const Eigen::Matrix<double, Eigen::Dynamic, 1>& x,
+    const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& V,
+    bool parallel, double& fx, Eigen::Matrix<double, Eigen::Dynamic, 1>& grad_V,
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& HV,
+    Eigen::Matrix<double, Eigen::Dynamic, 1>* grad = nullptr) {
+  grad_V.resize(V.cols());
+  HV.resize(x.size(), V.cols());
+  if (grad != nullptr) {
+    grad->resize(x.size());
+  }
+
+  // need to compute fx even without directions
+  if (V.cols() == 0) {
+    fx = f(x);
+    return;
+  }
+  auto direction = [&](int k) {
+    // Run nested autodiff in this scope
+    nested_rev_autodiff nested;
+
+    Eigen::Matrix<fvar<var>, Eigen::Dynamic, 1> x_fvar(x.size());
+    for (int j = 0; j < x.size(); ++j) {
+      x_fvar(j) = fvar<var>(x(j), V(j, k));
+    }
+    fvar<var> fx_fvar = f(x_fvar);
+    grad_V(k) = fx_fvar.d_.val();
+    if (k == 0) {
+      fx = fx_fvar.val_.val();
+    }
+    stan::math::grad(fx_fvar.d_.vi_);
+    for (int j = 0; j < x.size(); ++j) {
+      HV(j, k) = x_fvar(j).val_.adj();
+    }
+    if (k == 0 && grad != nullptr) {
+      nested.set_zero_all_adjoints();
+      stan::math::grad(fx_fvar.val_.vi_);
+      for (int j = 0; j < x.size(); ++j) {
+        grad->coeffRef(j) = x_fvar(j).val_.adj();
+      }
+    }
+  };
+#ifdef STAN_THREADS
+  if (parallel) {
+    tbb::parallel_for(tbb::blocked_range<int>(0, V.cols()),
+                      [&](const tbb::blocked_range<int>& r) {
+                        for (int k = r.begin(); k < r.end(); ++k) {
+                          direction(k);
+                        }
+                      });
+    return;
+  }
+#endif
+  for (int k = 0; k < V.cols(); ++k) {
+    direction(k);
+  }
+}
+
+}  // namespace internal
 
 /**
  * Calculate the value, the gradient, and the Hessian,
@@ -31,43 +125,32 @@ namespace math {
  * general namespace imports that eventually depend on functions
  * defined in Stan.
  *
+ * The N forward-over-reverse passes run in parallel if
+ * <code>parallel</code> is true and STAN_THREADS is defined, see
+ * <code>internal::hessian_times_directions()</code>. The function must
+ * then be safe to call concurrently.
+ *
  * @tparam F Type of function
  * @param[in] f Function
  * @param[in] x Argument to function
  * @param[out] fx Function applied to argument
  * @param[out] grad gradient of function at argument
  * @param[out] H Hessian of function at argument
+ * @param[in] parallel Run the passes in parallel if STAN_THREADS is
+ * defined, false by default
  */
 template <typename F>
 void hessian(const F& f, const Eigen::Matrix<double, Eigen::Dynamic, 1>& x,
              double& fx, Eigen::Matrix<double, Eigen::Dynamic, 1>& grad,
-             Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& H) {
-  H.resize(x.size(), x.size());
-  grad.resize(x.size());
-
-  // need to compute fx even with size = 0
-  if (x.size() == 0) {
-    fx = f(x);
-    return;
-  }
-  for (int i = 0; i < x.size(); ++i) {
-    // Run nested autodiff in this scope
-    nested_rev_autodiff nested;
-
-    Eigen::Matrix<fvar<var>, Eigen::Dynamic, 1> x_fvar(x.size());
-    for (int j = 0; j < x.size(); ++j) {
-      x_fvar(j) = fvar<var>(x(j), i == j);
-    }
-    fvar<var> fx_fvar = f(x_fvar);
-    grad(i) = fx_fvar.d_.val();
-    if (i == 0) {
-      fx = fx_fvar.val_.val();
-    }
-    stan::math::grad(fx_fvar.d_.vi_);
-    for (int j = 0; j < x.size(); ++j) {
-      H(i, j) = x_fvar(j).val_.adj();
-    }
-  }
+             Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& H,
+             bool parallel = false) {
+  Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> H_cols;
+  internal::hessian_times_directions(
+      f, x,
+      Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>::Identity(
+          x.size(), x.size()),
+      parallel, fx, grad, H_cols);
+  H = H_cols.transpose();
 }
 
 }  // namespace math
@@ -2,6 +2,8 @@
 #define STAN_MATH_MIX_FUNCTOR_HESSIAN_TIMES_VECTOR_HPP
 
 #include <stan/math/fwd/core.hpp>
+#include <stan/math/mix/functor/hessian.hpp>
+#include <stan/math/prim/err.hpp>
 #include <stan/math/prim/fun/Eigen.hpp>
 #include <stan/math/rev/core.hpp>
 #include <stdexcept>
@@ -35,6 +37,38 @@ void hessian_times_vector(const F& f,
     Hv(i) = x_var(i).adj();
   }
 }
+/**
+ * Calculate the value of the specified function and the products of its
+ * Hessian at the specified argument with a batch of vectors, the
+ * columns of <code>V</code>.
+ *
+ * Every column costs one forward-over-reverse pass of its own, so for
+ * K columns this is cheaper than the full Hessian when K is smaller than
+ * the size of the argument. The passes run in parallel if
+ * <code>parallel</code> is true and STAN_THREADS is defined, see
+ * <code>internal::hessian_times_directions()</code>.
+ *
+ * @tparam F Type of function
+ * @param[in] f Function
+ * @param[in] x Argument to function
+ * @param[in] V Vectors to multiply the Hessian with, one per column
+ * @param[out] fx Function applied to argument
+ * @param[out] HV Hessian of function at argument times V
+ * @param[in] parallel Run the passes in parallel if STAN_THREADS is
+ * defined, false by default
+ */
+template <typename F>
+void hessian_times_vector(
+    const F& f, const Eigen::Matrix<double, Eigen::Dynamic, 1>& x,
+    const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& V,
+    double& fx, Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& HV,
+    bool parallel = false) {
+  check_size_match("hessian_times_vector", "rows of V", V.rows(),
+                   "size of x", x.size());
+  Eigen::Matrix<double, Eigen::Dynamic, 1> grad_V;
+  internal::hessian_times_directions(f, x, V, parallel, fx, grad_V, HV);
+}
+
 template <typename T, typename F>
 void hessian_times_vector(const F& f,
                           const Eigen::Matrix<T, Eigen::Dynamic, 1>& x,
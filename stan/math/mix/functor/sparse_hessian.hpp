@@ -0,0 +1,259 @@
+#ifndef STAN_MATH_MIX_FUNCTOR_SPARSE_HESSIAN_HPP
+#define STAN_MATH_MIX_FUNCTOR_SPARSE_HESSIAN_HPP
+
+#include <stan/math/mix/functor/hessian.hpp>
+#include <stan/math/rev/functor/sparse_jacobian.hpp>
+#include <stan/math/prim/err.hpp>
+#include <stan/math/prim/fun/Eigen.hpp>
+#include <stan/math/prim/fun/constants.hpp>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace stan {
+namespace math {
+namespace internal {
+
+/**
+ * Return the pairs of inputs with a structurally non-zero second
+ * derivative of a function evaluated with <code>fvar<var></code>, whose
+ * tangents are independent vars.
+ *
+ * The tangent of the output is \f$ d = \sum_j g_j(x) t_j \f$ with the
+ * gradient \f$ g \f$ of the function, so the Hessian entry
+ * \f$ (j, k) \f$ is the derivative of \f$ d \f$ with respect to
+ * \f$ t_j \f$ and \f$ x_k \f$. Forward mode never multiplies tangents
+ * with each other, so every vari depending on a tangent is linear in the
+ * tangents and its operands are tangents or values. For every vari the
+ * sets of tangents and of values it depends on are propagated, and the
+ * pairs of tangents of one operand and values of another operand (or
+ * the same one, if it is a value) are added to the pairs of its tangent
+ * operands. The sets of intermediate varis are released after their last
+ * use.
+ *
+ * @param graph Dependencies from <code>trace_tape()</code>, with the
+ * values of the inputs as the first <code>n</code> nodes and their
+ * tangents as the next <code>n</code> nodes
+ * @param n Number of inputs
+ * @param output Node of the tangent of the output, -1 if it is not on the
+ * nested tape
+ * @return Sorted pairs of the indexes of a tangent and a value
+ */
+inline std::vector<std::pair<int, int>> hessian_dependencies(
+    const tape_graph& graph, int n, int output) {
+  const size_t num_nodes = graph.operands_.size();
+  std::vector<int> uses(num_nodes, 0);
+  for (int node : graph.order_) {
+    for (int op : graph.operands_[node]) {
+      ++uses[op];
+    }
+  }
+  if (output < 0) {
+    return {};
+  }
+  ++uses[output];
+  std::vector<std::vector<int>> values(num_nodes);
+  std::vector<std::vector<int>> tangents(num_nodes);
+  std::vector<std::vector<std::pair<int, int>>> pairs(num_nodes);
+  for (int j = 0; j < n; ++j) {
+    values[j].push_back(j);
+    tangents[n + j].push_back(j);
+  }
+  std::vector<int> merged;
+  std::vector<std::pair<int, int>> merged_pairs;
+  std::vector<std::pair<int, int>> cross;
+  for (int node : graph.order_) {
+    const std::vector<int>& ops = graph.operands_[node];
+    cross.clear();
+    for (int a : ops) {
+      for (int b : ops) {
+        for (int t : tangents[a]) {
+          for (int v : values[b]) {
+            cross.emplace_back(t, v);
+          }
+        }
+      }
+    }
+    std::sort(cross.begin(), cross.end());
+    cross.erase(std::unique(cross.begin(), cross.end()), cross.end());
+    merged_pairs.clear();
+    std::set_union(pairs[node].begin(), pairs[node].end(), cross.begin(),
+                   cross.end(), std::back_inserter(merged_pairs));
+    pairs[node].swap(merged_pairs);
+    for (int op : ops) {
+      merged.clear();
+      std::set_union(values[node].begin(), values[node].end(),
+                     values[op].begin(), values[op].end(),
+                     std::back_inserter(merged));
+      values[node].swap(merged);
+      merged.clear();
+      std::set_union(tangents[node].begin(), tangents[node].end(),
+                     tangents[op].begin(), tangents[op].end(),
+                     std::back_inserter(merged));
+      tangents[node].swap(merged);
+      merged_pairs.clear();
+      std::set_union(pairs[node].begin(), pairs[node].end(),
+                     pairs[op].begin(), pairs[op].end(),
+                     std::back_inserter(merged_pairs));
+      pairs[node].swap(merged_pairs);
+      if (--uses[op] == 0) {
+        std::vector<int>().swap(values[op]);
+        std::vector<int>().swap(tangents[op]);
+        std::vector<std::pair<int, int>>().swap(pairs[op]);
+      }
+    }
+    if (!tangents[node].empty()) {
+      // the values a tangent is multiplied with are kept in its pairs
+      std::vector<int>().swap(values[node]);
+    }
+  }
+  return pairs[output];
+}
+
+}  // namespace internal
+
+/**
+ * Return the sparsity pattern of the Hessian of the specified function,
+ * with ones at the structural non-zeros.
+ *
+ * The function is evaluated once with <code>fvar<var></code> at
+ * <code>x</code>, with a separate var as the tangent of every input, and
+ * the pattern is found with one pass over the tape (see
+ * <code>internal::trace_tape()</code> and
+ * <code>internal::hessian_dependencies()</code>). Entries whose second
+ * derivative happens to vanish at <code>x</code> are found too.
+ *
+ * If the tape holds varis whose operands cannot be traced, the pattern
+ * is found instead by one forward-over-reverse pass per input, in the
+ * direction of its unit vector and with the adjoint of the directional
+ * derivative set to NaN, which costs as much as a dense Hessian.
+ *
+ * As for <code>jacobian_sparsity()</code>, dependencies which are not on
+ * the tape because of a value dependent branch are not found. The
+ * pattern is meant to be computed once and reused by
+ * <code>sparse_hessian()</code> for many arguments.
+ *
+ * @tparam F Type of function, see <code>hessian()</code>
+ * @param f Function
+ * @param x Argument of the function
+ * @return Symmetric sparse matrix with the sparsity of the Hessian
+ */
+template <typename F>
+inline Eigen::SparseMatrix<double> hessian_sparsity(
+    const F& f, const Eigen::VectorXd& x) {
+  const int n = x.size();
+  std::vector<Eigen::Triplet<double>> non_zeros;
+  bool traced = false;
+  {
+    nested_rev_autodiff nested;
+    Eigen::Matrix<fvar<var>, Eigen::Dynamic, 1> x_fvar(n);
+    std::vector<vari*> inputs(2 * n);
+    for (int j = 0; j < n; ++j) {
+      x_fvar(j) = fvar<var>(var(x(j)), var(1.0));
+      inputs[j] = x_fvar(j).val_.vi_;
+      inputs[n + j] = x_fvar(j).d_.vi_;
+    }
+    fvar<var> fx_fvar = f(x_fvar);
+    internal::tape_graph graph;
+    traced = internal::trace_tape(inputs, graph);
+    if (traced) {
+      for (const auto& pair : internal::hessian_dependencies(
+               graph, n, graph.node(fx_fvar.d_.vi_))) {
+        non_zeros.emplace_back(pair.first, pair.second, 1.0);
+        non_zeros.emplace_back(pair.second, pair.first, 1.0);
+      }
+    }
+  }
+  for (int j = 0; !traced && j < n; ++j) {
+    nested_rev_autodiff nested;
+    Eigen::Matrix<fvar<var>, Eigen::Dynamic, 1> x_fvar(n);
+    for (int k = 0; k < n; ++k) {
+      x_fvar(k) = fvar<var>(x(k), j == k ? 1.0 : 0.0);
+    }
+    fvar<var> fx_fvar = f(x_fvar);
+    fx_fvar.d_.adj() = NOT_A_NUMBER;
+    grad();
+    for (int k = 0; k < n; ++k) {
+      if (x_fvar(k).val_.adj() != 0) {
+        non_zeros.emplace_back(j, k, 1.0);
+        non_zeros.emplace_back(k, j, 1.0);
+      }
+    }
+  }
+  Eigen::SparseMatrix<double> pattern(n, n);
+  pattern.setFromTriplets(non_zeros.begin(), non_zeros.end());
+  pattern.coeffs() = 1.0;
+  return pattern;
+}
+
+/**
+ * Calculate the value, the gradient and the sparse Hessian of the
+ * specified function at the specified argument.
+ *
+ * The columns of the Hessian are colored such that columns of the same
+ * color have no non-zero in a common row. The columns of each color are
+ * calculated together with one forward-over-reverse pass in the
+ * direction of the sum of their unit vectors, so the number of passes is
+ * the number of colors instead of the size of <code>x</code>. For a
+ * banded Hessian it is the bandwidth plus one, for a block-diagonal
+ * Hessian the size of the largest block.
+ *
+ * The sparsity pattern is taken from <code>H</code>, which is usually
+ * built once with <code>hessian_sparsity()</code> or from the structure
+ * of the function, e.g. its bands or blocks. If <code>H</code> is empty
+ * and <code>x</code> is not, it is detected with
+ * <code>hessian_sparsity()</code> first. A non-zero missing from the
+ * pattern is added to the entries of its row in the columns of the same
+ * color, so the pattern must contain every structural non-zero.
+ *
+ * The passes run in parallel if <code>parallel</code> is true and
+ * STAN_THREADS is defined, see
+ * <code>internal::hessian_times_directions()</code>.
+ *
+ * @tparam F Type of function, see <code>hessian()</code>
+ * @param[in] f Function
+ * @param[in] x Argument to function
+ * @param[out] fx Function applied to argument
+ * @param[out] grad Gradient of function at argument
+ * @param[in, out] H Hessian with the sparsity pattern of the Hessian of
+ * <code>f</code>, or empty; its values are overwritten
+ * @param[in] parallel Run the passes in parallel if STAN_THREADS is
+ * defined, false by default
+ * @throw std::invalid_argument if H is not square with the size of x
+ */
+template <typename F>
+inline void sparse_hessian(const F& f, const Eigen::VectorXd& x, double& fx,
+                           Eigen::VectorXd& grad,
+                           Eigen::SparseMatrix<double>& H,
+                           bool parallel = false) {
+  if (H.size() == 0 && x.size() > 0) {
+    H = hessian_sparsity(f, x);
+  }
+  check_size_match("sparse_hessian", "rows of H", H.rows(), "size of x",
+                   x.size());
+  check_size_match("sparse_hessian", "columns of H", H.cols(), "size of x",
+                   x.size());
+  int num_colors = 0;
+  const Eigen::SparseMatrix<double> H_transpose = H.transpose();
+  std::vector<int> colors
+      = internal::sparsity_row_coloring(H_transpose, num_colors);
+  Eigen::MatrixXd V = Eigen::MatrixXd::Zero(x.size(), num_colors);
+  for (int j = 0; j < x.size(); ++j) {
+    V.coeffRef(j, colors[j]) = 1;
+  }
+
+  Eigen::VectorXd grad_V;
+  Eigen::MatrixXd HV;
+  internal::hessian_times_directions(f, x, V, parallel, fx, grad_V, HV,
+                                     &grad);
+  for (int j = 0; j < H.outerSize(); ++j) {
+    for (Eigen::SparseMatrix<double>::InnerIterator it(H, j); it; ++it) {
+      it.valueRef() = HV.coeff(it.row(), colors[j]);
+    }
+  }
+}
+
+}  // namespace math
+}  // namespace stan
+#endif
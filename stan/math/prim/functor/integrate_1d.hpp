@@ -14,6 +14,38 @@
 
 namespace stan {
 namespace math {
+namespace internal {
+
+/**
+ * Return the tanh-sinh quadrature of the calling thread. The abscissas
+ * and weights are computed once per thread and extended as needed
+ * instead of being recomputed for every integral.
+ */
+inline boost::math::quadrature::tanh_sinh<double>& tanh_sinh_quadrature() {
+  static thread_local boost::math::quadrature::tanh_sinh<double> integrator;
+  return integrator;
+}
+
+/**
+ * Return the exp-sinh quadrature of the calling thread, see
+ * <code>tanh_sinh_quadrature()</code>.
+ */
+inline boost::math::quadrature::exp_sinh<double>& exp_sinh_quadrature() {
+  static thread_local boost::math::quadrature::exp_sinh<double> integrator;
+  return integrator;
+}
+
+/**
+ * Return the sinh-sinh quadrature of the calling thread, see
+ * <code>tanh_sinh_quadrature()</code>.
+ */
+inline boost::math::quadrature::sinh_sinh<double>& sinh_sinh_quadrature() {
+  static thread_local boost::math::quadrature::sinh_sinh<double> integrator;
+  return integrator;
+}
+
+}  // namespace internal
+
 /**
  * Integrate a single variable function f from a to b to within a specified
  * relative tolerance. This function assumes a is less than b.
@@ -59,10 +91,10 @@ inline double integrate(const F& f, double a, double b,
   double Q = 0.0;
   auto f_wrap = [&](double x) { return f(x, NOT_A_NUMBER); };
   if (std::isinf(a) && std::isinf(b)) {
-    boost::math::quadrature::sinh_sinh<double> integrator;
+    auto& integrator = internal::sinh_sinh_quadrature();
     Q = integrator.integrate(f_wrap, relative_tolerance, &error1, &L1, &levels);
   } else if (std::isinf(a)) {
-    boost::math::quadrature::exp_sinh<double> integrator;
+    auto& integrator = internal::exp_sinh_quadrature();
     /**
      * If the integral crosses zero, break it into two (advice from the Boost
      * implementation:
@@ -72,7 +104,7 @@ inline double integrate(const F& f, double a, double b,
       Q = integrator.integrate(f_wrap, a, b, relative_tolerance, &error1, &L1,
                                &levels);
     } else {
-      boost::math::quadrature::tanh_sinh<double> integrator_right;
+      auto& integrator_right = internal::tanh_sinh_quadrature();
       Q = integrator.integrate(f_wrap, a, 0.0, relative_tolerance, &error1, &L1,
                                &levels)
           + integrator_right.integrate(f_wrap, 0.0, b, relative_tolerance,
@@ -80,12 +112,12 @@ inline double integrate(const F& f, double a, double b,
       used_two_integrals = true;
     }
   } else if (std::isinf(b)) {
-    boost::math::quadrature::exp_sinh<double> integrator;
+    auto& integrator = internal::exp_sinh_quadrature();
     if (a >= 0.0) {
       Q = integrator.integrate(f_wrap, a, b, relative_tolerance, &error1, &L1,
                                &levels);
     } else {
-      boost::math::quadrature::tanh_sinh<double> integrator_left;
+      auto& integrator_left = internal::tanh_sinh_quadrature();
       Q = integrator_left.integrate(f_wrap, a, 0, relative_tolerance, &error1,
                                     &L1, &levels)
           + integrator.integrate(f_wrap, relative_tolerance, &error2, &L2,
@@ -94,7 +126,7 @@ inline double integrate(const F& f, double a, double b,
     }
   } else {
     auto f_wrap = [&](double x, double xc) { return f(x, xc); };
-    boost::math::quadrature::tanh_sinh<double> integrator;
+    auto& integrator = internal::tanh_sinh_quadrature();
     if (a < 0.0 && b > 0.0) {
       Q = integrator.integrate(f_wrap, a, 0.0, relative_tolerance, &error1, &L1,
                                &levels)
@@ -168,6 +168,31 @@ struct reduce_sum_impl<ReduceFunction, require_arithmetic_t<ReturnType>,
   }
 };
 
+/**
+ * Largest number of chunks a deterministic reduction is split into.
+ */
+constexpr std::size_t deterministic_reduce_max_chunks = 1024;
+
+/**
+ * Return the grainsize used by a deterministic reduction over
+ *   `num_terms` terms.
+ *
+ * The chunks of a deterministic reduction are never split further, so
+ *   the grainsize is raised until there are at most
+ *   deterministic_reduce_max_chunks of them. The result does not depend
+ *   on the number of threads, so neither does the partition.
+ *
+ * @param num_terms Number of terms of the sum
+ * @param grainsize Requested grainsize
+ * @return Grainsize for tbb::parallel_deterministic_reduce
+ */
+inline int deterministic_grainsize(std::size_t num_terms, int grainsize) {
+  const std::size_t min_grainsize
+      = (num_terms + deterministic_reduce_max_chunks - 1)
+        / deterministic_reduce_max_chunks;
+  return std::max(grainsize, static_cast<int>(min_grainsize));
+}
+
 }  // namespace internal
 
 /**
@@ -184,6 +209,12 @@ struct reduce_sum_impl<ReduceFunction, require_arithmetic_t<ReturnType>,
  *
  * grainsize must be greater than or equal to 1
  *
+ * If STAN_MATH_DETERMINISTIC_REDUCE is defined, the terms are split into
+ *   a fixed partition with at most internal::deterministic_reduce_max_chunks
+ *   chunks of at least grainsize terms, and the partial sums are joined in
+ *   a fixed order. The result is then bitwise reproducible, independent
+ *   of the number of threads and of the scheduling.
+ *
  * @tparam ReduceFunction Type of reducer function
  * @tparam ReturnType An arithmetic type
  * @tparam Vec Type of sliced argument
@@ -203,10 +234,19 @@ inline auto reduce_sum(Vec&& vmapped, int grainsize, std::ostream* msgs,
   check_positive("reduce_sum", "grainsize", grainsize);
 
 #ifdef STAN_THREADS
+#ifdef STAN_MATH_DETERMINISTIC_REDUCE
+  const int deterministic_grainsize
+      = internal::deterministic_grainsize(vmapped.size(), grainsize);
+  return internal::reduce_sum_impl<ReduceFunction, void, return_type, Vec,
+                                   ref_type_t<Args&&>...>()(
+      std::forward<Vec>(vmapped), false, deterministic_grainsize, msgs,
+      std::forward<Args>(args)...);
+#else
   return internal::reduce_sum_impl<ReduceFunction, void, return_type, Vec,
                                    ref_type_t<Args&&>...>()(
       std::forward<Vec>(vmapped), true, grainsize, msgs,
       std::forward<Args>(args)...);
+#endif
 #else
   if (vmapped.empty()) {
     return return_type(0.0);
@@ -0,0 +1,151 @@
+#ifndef STAN_MATH_PRIM_FUNCTOR_REDUCE_SUM_ADAPTIVE_HPP
+#define STAN_MATH_PRIM_FUNCTOR_REDUCE_SUM_ADAPTIVE_HPP
+
+#include <stan/math/prim/meta.hpp>
+#include <stan/math/prim/err.hpp>
+#include <stan/math/prim/functor/reduce_sum.hpp>
+#include <tbb/task_arena.h>
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <mutex>
+
+namespace stan {
+namespace math {
+namespace internal {
+
+/**
+ * Online tuner of the grainsize used by <code>reduce_sum_adaptive</code>.
+ *
+ * Every call reports the wall time per term it took with the grainsize
+ * it was given. The tuner climbs towards the cheapest grainsize by
+ * doubling or halving it after each call, and turns around whenever the
+ * cost went up. Once it has found the cheapest grainsize it keeps
+ * probing its neighbours, so it follows changes of the cost of the
+ * terms.
+ */
+class reduce_sum_grainsize_tuner {
+  std::mutex mutex_;
+  int grainsize_{1};
+  bool increasing_{true};
+  double last_cost_{std::numeric_limits<double>::infinity()};
+
+  static inline int clamp(int grainsize, int max_grainsize) {
+    return std::max(1, std::min(grainsize, max_grainsize));
+  }
+
+ public:
+  /**
+   * Return the grainsize for the next call.
+   *
+   * @param max_grainsize largest grainsize to use
+   */
+  inline int grainsize(int max_grainsize) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return clamp(grainsize_, max_grainsize);
+  }
+
+  /**
+   * Report the cost of a call and move the grainsize.
+   *
+   * @param grainsize grainsize used by the call
+   * @param cost wall time per term of the call
+   * @param max_grainsize largest grainsize to use
+   */
+  inline void update(int grainsize, double cost, int max_grainsize) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (cost > last_cost_) {
+      increasing_ = !increasing_;
+    }
+    last_cost_ = cost;
+    grainsize_ = clamp(increasing_ ? 2 * grainsize : grainsize / 2,
+                       max_grainsize);
+  }
+};
+
+/**
+ * Return the grainsize tuner of a reducer function.
+ *
+ * @tparam ReduceFunction Type of reducer function
+ */
+template <typename ReduceFunction>
+inline reduce_sum_grainsize_tuner& reduce_sum_tuner() {
+  static reduce_sum_grainsize_tuner tuner;
+  return tuner;
+}
+
+}  // namespace internal
+
+/**
+ * Call an instance of the function `ReduceFunction` on every element
+ *   of an input sequence and sum these terms, choosing the grainsize
+ *   automatically.
+ *
+ * This works like reduce_sum, except that the grainsize is tuned online
+ *   from the wall time of previous calls with the same `ReduceFunction`
+ *   (see internal::reduce_sum_grainsize_tuner). The grainsize is kept
+ *   small enough that every thread gets at least two chunks of work.
+ *
+ * If STAN_MATH_DETERMINISTIC_REDUCE is defined, the grainsize is not
+ *   tuned, since the partition has to be fixed for reproducible results,
+ *   and this is the same as reduce_sum with grainsize 1.
+ *
+ * ReduceFunction must define an operator() with the same signature as:
+ *   T f(Vec&& vmapped_subset, int start, int end, std::ostream* msgs, Args&&...
+ * args)
+ *
+ * `ReduceFunction` must be default constructible without any arguments
+ *
+ * If STAN_THREADS is not defined, do all the work with one ReduceFunction call.
+ *
+ * @tparam ReduceFunction Type of reducer function
+ * @tparam Vec Type of sliced argument
+ * @tparam Args Types of shared arguments
+ * @param vmapped Vector containing one element per term of sum
+ * @param[in, out] msgs The print stream for warning messages
+ * @param args Shared arguments used in every sum term
+ * @return Sum of terms
+ */
+template <typename ReduceFunction, typename Vec,
+          typename = require_vector_like_t<Vec>, typename... Args>
+inline auto reduce_sum_adaptive(Vec&& vmapped, std::ostream* msgs,
+                                Args&&... args) {
+  using return_type = return_type_t<Vec, Args...>;
+
+  if (vmapped.empty()) {
+    return return_type(0.0);
+  }
+
+#if defined(STAN_THREADS) && defined(STAN_MATH_DETERMINISTIC_REDUCE)
+  return reduce_sum<ReduceFunction>(std::forward<Vec>(vmapped), 1, msgs,
+                                    std::forward<Args>(args)...);
+#elif defined(STAN_THREADS)
+  const std::size_t num_terms = vmapped.size();
+  const int num_threads = std::max(tbb::this_task_arena::max_concurrency(), 1);
+  const int max_grainsize = static_cast<int>(std::min<std::size_t>(
+      num_terms / (2 * num_threads), std::numeric_limits<int>::max()));
+  auto& tuner = internal::reduce_sum_tuner<ReduceFunction>();
+  const int grainsize = tuner.grainsize(max_grainsize);
+
+  const auto start = std::chrono::steady_clock::now();
+  return_type sum
+      = internal::reduce_sum_impl<ReduceFunction, void, return_type, Vec,
+                                  ref_type_t<Args&&>...>()(
+          std::forward<Vec>(vmapped), true, grainsize, msgs,
+          std::forward<Args>(args)...);
+  const double elapsed = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+  tuner.update(grainsize, elapsed / num_terms, max_grainsize);
+  return sum;
+#else
+  return ReduceFunction()(std::forward<Vec>(vmapped), 0, vmapped.size() - 1,
+                          msgs, std::forward<Args>(args)...);
+#endif
+}
+
+}  // namespace math
+}  // namespace stan
+
+#endif
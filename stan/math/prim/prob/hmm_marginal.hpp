@@ -11,6 +11,10 @@
 #include <stan/math/prim/fun/value_of.hpp>
 #include <stan/math/prim/core.hpp>
 #include <stan/math/prim/functor/operands_and_partials.hpp>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <algorithm>
+#include <numeric>
 #include <vector>
 
 namespace stan {
@@ -180,6 +184,332 @@ inline auto hmm_marginal(const T_omega& log_omegas, const T_Gamma& Gamma,
   return ops_partials.build(log_marginal_density);
 }
 
+namespace internal {
+
+/**
+ * Number of sequences the batched `hmm_marginal` runs through the forward
+ * and backward algorithms together.
+ */
+constexpr size_t hmm_marginal_group_size = 256;
+
+/**
+ * Return the sum of the log marginal densities of a group of hidden
+ * Markov models sharing their transition matrix and initial state, and
+ * add the derivatives of this sum to the specified partials.
+ *
+ * The forward and backward algorithms are run for all the sequences of
+ * the group in lockstep, so each step multiplies Gamma with the
+ * matrix of the states of all the sequences which are still running at
+ * that step, instead of a vector per sequence. The sequences must be
+ * ordered by decreasing number of observations, such that the sequences
+ * still running at a step are the leading columns of these matrices.
+ * The density and the derivatives of each sequence are the same as
+ * those of `hmm_marginal()` for that sequence alone.
+ *
+ * @tparam T type of the values and partials
+ * @param[in] omegas matrices of observational densities of all sequences
+ * @param[in] seqs indices of the sequences of the group in `omegas`, by
+ * decreasing number of columns
+ * @param[in] Gamma transition density between hidden states.
+ * @param[in] rho initial state
+ * @param[in, out] omega_partials if not null, the partials of the log
+ * observational densities of the sequences of the group are set
+ * @param[in, out] Gamma_partial if not null, the partials of Gamma are
+ * added to it
+ * @param[in, out] rho_partial if not null, the partials of rho are added
+ * to it
+ * @return sum of the log marginal densities of the group.
+ */
+template <typename T>
+inline T hmm_marginal_lockstep(
+    const std::vector<Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>>&
+        omegas,
+    const std::vector<int>& seqs,
+    const Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>& Gamma,
+    const Eigen::Matrix<T, Eigen::Dynamic, 1>& rho,
+    std::vector<Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>>*
+        omega_partials,
+    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>* Gamma_partial,
+    Eigen::Matrix<T, Eigen::Dynamic, 1>* rho_partial) {
+  using matrix_t = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>;
+  using row_vector_t = Eigen::Matrix<T, 1, Eigen::Dynamic>;
+  const int n_states = Gamma.rows();
+  const int n_seqs = seqs.size();
+  const int n_steps = omegas[seqs[0]].cols();
+
+  // n_active[n] is the number of sequences with more than n observations
+  std::vector<int> n_active(n_steps + 1, 0);
+  for (int j = 0; j < n_seqs; ++j) {
+    ++n_active[omegas[seqs[j]].cols() - 1];
+  }
+  for (int n = n_steps - 1; n-- > 0;) {
+    n_active[n] += n_active[n + 1];
+  }
+
+  // observational densities at step n of the first n_cols sequences
+  auto gather = [&](int n, int n_cols) {
+    matrix_t omega_n(n_states, n_cols);
+    for (int j = 0; j < n_cols; ++j) {
+      omega_n.col(j) = omegas[seqs[j]].col(n);
+    }
+    return omega_n;
+  };
+  // scale each column by its largest element and return the log scales
+  auto normalize = [](auto&& m) {
+    row_vector_t log_norms(m.cols());
+    for (int j = 0; j < m.cols(); ++j) {
+      const T norm = m.col(j).maxCoeff();
+      m.col(j) /= norm;
+      log_norms(j) = log(norm);
+    }
+    return log_norms;
+  };
+
+  // forward algorithm
+  std::vector<matrix_t> alphas(n_steps);
+  std::vector<row_vector_t> alpha_log_norms(n_steps);
+  alphas[0] = rho.asDiagonal() * gather(0, n_seqs);
+  alpha_log_norms[0] = normalize(alphas[0]);
+  const matrix_t Gamma_transpose = Gamma.transpose();
+  for (int n = 1; n < n_steps; ++n) {
+    const int n_cols = n_active[n];
+    alphas[n] = gather(n, n_cols).cwiseProduct(
+        Gamma_transpose * alphas[n - 1].leftCols(n_cols));
+    alpha_log_norms[n]
+        = normalize(alphas[n]) + alpha_log_norms[n - 1].head(n_cols);
+  }
+
+  row_vector_t unnormed_marginals(n_seqs);
+  row_vector_t norm_norms(n_seqs);
+  T log_marginal_density = 0;
+  for (int j = 0; j < n_seqs; ++j) {
+    const int n_last = omegas[seqs[j]].cols() - 1;
+    unnormed_marginals(j) = alphas[n_last].col(j).sum();
+    norm_norms(j) = alpha_log_norms[n_last](j);
+    log_marginal_density += log(unnormed_marginals(j)) + norm_norms(j);
+  }
+
+  // backward algorithm, kappa holds the sequences with a transition after
+  // the current step
+  matrix_t kappa;
+  row_vector_t kappa_log_norms;
+  for (int n = n_steps - 1; n-- > 0;) {
+    const int n_cols = n_active[n + 1];
+    const int n_running = n_active[n + 2];
+    matrix_t kappa_n(n_states, n_cols);
+    row_vector_t kappa_log_norms_n(n_cols);
+    if (n_running > 0) {
+      kappa_n.leftCols(n_running)
+          = Gamma * gather(n + 2, n_running).cwiseProduct(kappa);
+      kappa_log_norms_n.head(n_running)
+          = normalize(kappa_n.leftCols(n_running)) + kappa_log_norms;
+    }
+    // the last transition of the other sequences
+    kappa_n.rightCols(n_cols - n_running).setOnes();
+    kappa_log_norms_n.tail(n_cols - n_running).setZero();
+    kappa.swap(kappa_n);
+    kappa_log_norms.swap(kappa_log_norms_n);
+
+    row_vector_t weights(n_cols);
+    for (int j = 0; j < n_cols; ++j) {
+      weights(j) = exp(alpha_log_norms[n](j) + kappa_log_norms(j)
+                       - norm_norms(j))
+                   / unnormed_marginals(j);
+    }
+    const matrix_t omega_next = gather(n + 1, n_cols);
+    if (Gamma_partial != nullptr) {
+      *Gamma_partial += alphas[n].leftCols(n_cols) * weights.asDiagonal()
+                        * kappa.cwiseProduct(omega_next).transpose();
+    }
+    if (omega_partials != nullptr) {
+      const matrix_t omega_jacad
+          = kappa
+                .cwiseProduct(Gamma_transpose * alphas[n].leftCols(n_cols))
+                .cwiseProduct(omega_next)
+            * weights.asDiagonal();
+      for (int j = 0; j < n_cols; ++j) {
+        (*omega_partials)[seqs[j]].col(n + 1) = omega_jacad.col(j);
+      }
+    }
+  }
+
+  if (omega_partials == nullptr && rho_partial == nullptr) {
+    return log_marginal_density;
+  }
+  // boundary terms of the sequences with at least one transition
+  const int n_transitioning = n_active[1];
+  if (n_transitioning > 0) {
+    row_vector_t weights(n_transitioning);
+    for (int j = 0; j < n_transitioning; ++j) {
+      weights(j) = exp(kappa_log_norms(j) - norm_norms(j))
+                   / unnormed_marginals(j);
+    }
+    const matrix_t C = Gamma * gather(1, n_transitioning).cwiseProduct(kappa)
+                       * weights.asDiagonal();
+    const matrix_t omega_first = gather(0, n_transitioning);
+    if (omega_partials != nullptr) {
+      for (int j = 0; j < n_transitioning; ++j) {
+        (*omega_partials)[seqs[j]].col(0)
+            = C.col(j).cwiseProduct(rho).cwiseProduct(omega_first.col(j));
+      }
+    }
+    if (rho_partial != nullptr) {
+      *rho_partial += C.cwiseProduct(omega_first).rowwise().sum();
+    }
+  }
+  // sequences with a single observation
+  for (int j = n_transitioning; j < n_seqs; ++j) {
+    const auto& omega = omegas[seqs[j]];
+    const T marginal_density = exp(log(unnormed_marginals(j)) + norm_norms(j));
+    if (omega_partials != nullptr) {
+      (*omega_partials)[seqs[j]] = omega.cwiseProduct(rho) / marginal_density;
+    }
+    if (rho_partial != nullptr) {
+      *rho_partial += omega.col(0) / marginal_density;
+    }
+  }
+  return log_marginal_density;
+}
+
+}  // namespace internal
+
+/**
+ * Return the sum of the log marginal densities of independent hidden
+ * Markov models which share their transition matrix Gamma and initial
+ * state rho, log p(y_1, ..., y_S | theta). Each sequence may have a
+ * different number of observations. The value and the derivatives are
+ * those of the sum of `hmm_marginal()` over the sequences.
+ *
+ * The sequences are sorted by their number of observations and
+ * processed in groups whose forward and backward algorithms run in
+ * lockstep, which replaces the matrix-vector products of each step by
+ * one matrix-matrix product for the group. If STAN_THREADS is defined
+ * and no autodiff types are needed for the partials, the groups are
+ * distributed over the threads of the TBB thread pool.
+ *
+ * @tparam T_omega type of the log likelihood matrices
+ * @tparam T_Gamma type of the transition matrix
+ * @tparam T_rho type of the initial guess vector
+ * @param[in] log_omegas log matrices of observational densities, one per
+ * sequence.
+ * @param[in] Gamma transition density between hidden states.
+ * @param[in] rho initial state
+ * @return sum of the log marginal densities, or zero if there are no
+ * sequences.
+ * @throw `std::invalid_argument` if Gamma is not square, if a sequence has
+ *         no observations, or if the size of rho or the number of rows of
+ *         Gamma is not the number of rows of the log_omegas.
+ * @throw `std::domain_error` if rho is not a simplex and of the rows
+ *         of Gamma are not a simplex.
+ */
+template <typename T_omega, typename T_Gamma, typename T_rho,
+          require_all_eigen_t<T_omega, T_Gamma>* = nullptr,
+          require_eigen_col_vector_t<T_rho>* = nullptr>
+inline auto hmm_marginal(const std::vector<T_omega>& log_omegas,
+                         const T_Gamma& Gamma, const T_rho& rho) {
+  using T_partial_type = partials_return_t<T_omega, T_Gamma, T_rho>;
+  using eig_matrix_partial
+      = Eigen::Matrix<T_partial_type, Eigen::Dynamic, Eigen::Dynamic>;
+  using eig_vector_partial = Eigen::Matrix<T_partial_type, Eigen::Dynamic, 1>;
+  using T_Gamma_ref = ref_type_if_t<!is_constant<T_Gamma>::value, T_Gamma>;
+  using T_rho_ref = ref_type_if_t<!is_constant<T_rho>::value, T_rho>;
+  static const char* function = "hmm_marginal";
+  const size_t n_seqs = log_omegas.size();
+
+  T_Gamma_ref Gamma_ref = Gamma;
+  T_rho_ref rho_ref = rho;
+  operands_and_partials<std::vector<T_omega>, T_Gamma_ref, T_rho_ref>
+      ops_partials(log_omegas, Gamma_ref, rho_ref);
+  if (n_seqs == 0) {
+    return ops_partials.build(T_partial_type(0));
+  }
+
+  const eig_matrix_partial Gamma_val
+      = value_of(Gamma_ref).template cast<T_partial_type>();
+  const eig_vector_partial rho_val
+      = value_of(rho_ref).template cast<T_partial_type>();
+  hmm_check(log_omegas[0], Gamma_val, rho_val, function);
+  const int n_states = Gamma_val.rows();
+  std::vector<eig_matrix_partial> omegas(n_seqs);
+  for (size_t s = 0; s < n_seqs; ++s) {
+    check_size_match(function, "Rows of log_omegas[i]", log_omegas[s].rows(),
+                     "rows of Gamma", n_states);
+    check_nonzero_size(function, "log_omegas[i]", log_omegas[s]);
+    omegas[s] = value_of(log_omegas[s]).array().exp();
+  }
+
+  std::vector<int> order(n_seqs);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+    return omegas[a].cols() > omegas[b].cols();
+  });
+
+  std::vector<eig_matrix_partial> omega_partials;
+  if (!is_constant_all<T_omega>::value) {
+    omega_partials.resize(n_seqs);
+    for (size_t s = 0; s < n_seqs; ++s) {
+      omega_partials[s].resize(n_states, omegas[s].cols());
+    }
+  }
+  const size_t group_size = internal::hmm_marginal_group_size;
+  const size_t n_groups = (n_seqs + group_size - 1) / group_size;
+  std::vector<T_partial_type> group_lps(n_groups);
+  std::vector<eig_matrix_partial> group_Gamma_partials(
+      n_groups, eig_matrix_partial::Zero(n_states, n_states));
+  std::vector<eig_vector_partial> group_rho_partials(
+      n_groups, eig_vector_partial::Zero(n_states));
+  auto run_group = [&](size_t g) {
+    std::vector<int> seqs(
+        order.begin() + g * group_size,
+        order.begin() + std::min((g + 1) * group_size, n_seqs));
+    group_lps[g] = internal::hmm_marginal_lockstep(
+        omegas, seqs, Gamma_val, rho_val,
+        is_constant_all<T_omega>::value ? nullptr : &omega_partials,
+        is_constant_all<T_Gamma>::value ? nullptr : &group_Gamma_partials[g],
+        is_constant_all<T_rho>::value ? nullptr : &group_rho_partials[g]);
+  };
+#ifdef STAN_THREADS
+  // autodiff partials must stay on the autodiff stack of this thread
+  if (std::is_arithmetic<T_partial_type>::value && n_groups > 1) {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, n_groups),
+                      [&](const tbb::blocked_range<size_t>& r) {
+                        for (size_t g = r.begin(); g < r.end(); ++g) {
+                          run_group(g);
+                        }
+                      });
+  } else {
+    for (size_t g = 0; g < n_groups; ++g) {
+      run_group(g);
+    }
+  }
+#else
+  for (size_t g = 0; g < n_groups; ++g) {
+    run_group(g);
+  }
+#endif
+
+  T_partial_type log_marginal_density = 0;
+  for (size_t g = 0; g < n_groups; ++g) {
+    log_marginal_density += group_lps[g];
+  }
+  if (!is_constant_all<T_omega>::value) {
+    for (size_t s = 0; s < n_seqs; ++s) {
+      ops_partials.edge1_.partials_vec_[s] = omega_partials[s];
+    }
+  }
+  if (!is_constant_all<T_Gamma>::value) {
+    for (size_t g = 0; g < n_groups; ++g) {
+      ops_partials.edge2_.partials_ += group_Gamma_partials[g];
+    }
+  }
+  if (!is_constant_all<T_rho>::value) {
+    for (size_t g = 0; g < n_groups; ++g) {
+      ops_partials.edge3_.partials_ += group_rho_partials[g];
+    }
+  }
+  return ops_partials.build(log_marginal_density);
+}
+
 }  // namespace math
 }  // namespace stan
 #endif
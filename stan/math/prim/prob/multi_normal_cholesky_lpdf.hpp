@@ -5,13 +5,12 @@
 #include <stan/math/prim/err.hpp>
 #include <stan/math/prim/fun/as_value_column_vector_or_scalar.hpp>
 #include <stan/math/prim/fun/constants.hpp>
-#include <stan/math/prim/fun/dot_self.hpp>
 #include <stan/math/prim/fun/log.hpp>
 #include <stan/math/prim/fun/max_size_mvt.hpp>
 #include <stan/math/prim/fun/mdivide_left_tri.hpp>
 #include <stan/math/prim/fun/size_mvt.hpp>
 #include <stan/math/prim/fun/sum.hpp>
-#include <stan/math/prim/fun/transpose.hpp>
+#include <stan/math/prim/fun/value_of.hpp>
 #include <stan/math/prim/fun/vector_seq_view.hpp>
 #include <stan/math/prim/functor/operands_and_partials.hpp>
 
@@ -27,6 +26,9 @@ namespace math {
  * http://qwone.com/~jason/writing/multivariateNormal.pdf
  * written by Jason D. M. Rennie.
  *
+ * The residuals of all the observations are stacked into one matrix and
+ * solved against L at once.
+ *
  * @param y A scalar vector
  * @param mu The mean vector of the multivariate normal distribution.
  * @param L The Cholesky decomposition of a variance matrix
@@ -49,9 +51,6 @@ return_type_t<T_y, T_loc, T_covar> multi_normal_cholesky_lpdf(
   using T_partials_return = partials_return_t<T_y, T_loc, T_covar>;
   using matrix_partials_t
       = Eigen::Matrix<T_partials_return, Eigen::Dynamic, Eigen::Dynamic>;
-  using vector_partials_t = Eigen::Matrix<T_partials_return, Eigen::Dynamic, 1>;
-  using row_vector_partials_t
-      = Eigen::Matrix<T_partials_return, 1, Eigen::Dynamic>;
   using T_y_ref = ref_type_t<T_y>;
   using T_mu_ref = ref_type_t<T_loc>;
   using T_L_ref = ref_type_t<T_covar>;
@@ -119,37 +118,43 @@ return_type_t<T_y, T_loc, T_covar> multi_normal_cholesky_lpdf(
     logp += NEG_LOG_SQRT_TWO_PI * size_y * size_vec;
   }
 
-  const matrix_partials_t inv_L_dbl
-      = mdivide_left_tri<Eigen::Lower>(value_of(L_ref));
-
   if (include_summand<propto, T_y, T_loc, T_covar_elem>::value) {
+    matrix_partials_t y_val_minus_mu_val(size_y, size_vec);
     for (size_t i = 0; i < size_vec; i++) {
       decltype(auto) y_val = as_value_column_vector_or_scalar(y_vec[i]);
       decltype(auto) mu_val = as_value_column_vector_or_scalar(mu_vec[i]);
+      y_val_minus_mu_val.col(i) = y_val - mu_val;
+    }
 
-      const row_vector_partials_t half
-          = (inv_L_dbl.template triangularView<Eigen::Lower>()
-             * (y_val - mu_val).template cast<T_partials_return>())
-                .transpose();
-      const vector_partials_t scaled_diff
-          = (half * inv_L_dbl.template triangularView<Eigen::Lower>())
-                .transpose();
+    // one triangular solve for the residuals of all the observations
+    const matrix_partials_t L_val = value_of(L_ref);
+    const matrix_partials_t half
+        = L_val.template triangularView<Eigen::Lower>().solve(
+            y_val_minus_mu_val);
+    const matrix_partials_t scaled_diff
+        = L_val.template triangularView<Eigen::Lower>().transpose().solve(
+            half);
 
-      logp -= 0.5 * dot_self(half);
+    logp -= 0.5 * half.squaredNorm();
 
-      if (!is_constant_all<T_y>::value) {
-        ops_partials.edge1_.partials_vec_[i] -= scaled_diff;
-      }
-      if (!is_constant_all<T_loc>::value) {
-        ops_partials.edge2_.partials_vec_[i] += scaled_diff;
+    if (!is_constant_all<T_y>::value) {
+      for (size_t i = 0; i < size_vec; i++) {
+        ops_partials.edge1_.partials_vec_[i] -= scaled_diff.col(i);
       }
-      if (!is_constant_all<T_covar>::value) {
-        ops_partials.edge3_.partials_ += scaled_diff * half;
+    }
+    if (!is_constant_all<T_loc>::value) {
+      for (size_t i = 0; i < size_vec; i++) {
+        ops_partials.edge2_.partials_vec_[i] += scaled_diff.col(i);
       }
     }
+    if (!is_constant_all<T_covar>::value) {
+      ops_partials.edge3_.partials_ += scaled_diff * half.transpose();
+    }
   }
 
   if (include_summand<propto, T_covar_elem>::value) {
+    const matrix_partials_t inv_L_dbl
+        = mdivide_left_tri<Eigen::Lower>(value_of(L_ref));
     logp += sum(log(inv_L_dbl.diagonal())) * size_vec;
     if (!is_constant_all<T_covar>::value) {
       ops_partials.edge3_.partials_ -= size_vec * inv_L_dbl.transpose();
@@ -3,25 +3,51 @@
 
 #include <stan/math/prim/meta.hpp>
 #include <stan/math/prim/err.hpp>
-#include <stan/math/prim/fun/as_column_vector_or_scalar.hpp>
+#include <stan/math/prim/fun/as_value_column_vector_or_scalar.hpp>
 #include <stan/math/prim/fun/constants.hpp>
 #include <stan/math/prim/fun/log_determinant_ldlt.hpp>
 #include <stan/math/prim/fun/max_size_mvt.hpp>
+#include <stan/math/prim/fun/mdivide_left_ldlt.hpp>
 #include <stan/math/prim/fun/size_mvt.hpp>
-#include <stan/math/prim/fun/to_ref.hpp>
-#include <stan/math/prim/fun/trace_inv_quad_form_ldlt.hpp>
+#include <stan/math/prim/fun/value_of.hpp>
 #include <stan/math/prim/fun/vector_seq_view.hpp>
+#include <stan/math/prim/functor/operands_and_partials.hpp>
 
 namespace stan {
 namespace math {
 
+/** \ingroup multivar_dists
+ * The log of the multivariate normal density for the given y, mu, and
+ * variance matrix Sigma.
+ *
+ * The residuals of all the observations are stacked into one matrix and
+ * solved against the LDLT factorization of Sigma at once, and the
+ * partials with respect to y, mu and Sigma are calculated analytically.
+ *
+ * @tparam propto Carry out calculations up to a proportion
+ * @tparam T_y Type of the random variable, a vector or an array of vectors
+ * @tparam T_loc Type of the location, a vector or an array of vectors
+ * @tparam T_covar Type of the variance matrix
+ * @param y A vector or an array of vectors
+ * @param mu The mean vector or the array of mean vectors
+ * @param Sigma The variance matrix
+ * @return The log of the multivariate normal density
+ * @throw std::domain_error if Sigma is not symmetric or not positive
+ * definite, or if any y or mu is not finite
+ * @throw std::invalid_argument if the sizes of the arguments do not match
+ */
 template <bool propto, typename T_y, typename T_loc, typename T_covar>
 return_type_t<T_y, T_loc, T_covar> multi_normal_lpdf(const T_y& y,
                                                      const T_loc& mu,
                                                      const T_covar& Sigma) {
   using T_covar_elem = typename scalar_type<T_covar>::type;
-  using lp_type = return_type_t<T_y, T_loc, T_covar>;
-  using Eigen::Dynamic;
+  using T_return = return_type_t<T_y, T_loc, T_covar>;
+  using T_partials_return = partials_return_t<T_y, T_loc, T_covar>;
+  using matrix_partials_t
+      = Eigen::Matrix<T_partials_return, Eigen::Dynamic, Eigen::Dynamic>;
+  using T_y_ref = ref_type_t<T_y>;
+  using T_mu_ref = ref_type_t<T_loc>;
+  using T_Sigma_ref = ref_type_t<T_covar>;
   static const char* function = "multi_normal_lpdf";
   check_positive(function, "Covariance matrix rows", Sigma.rows());
 
@@ -32,13 +58,15 @@ return_type_t<T_y, T_loc, T_covar> multi_normal_lpdf(const T_y& y,
     return 0.0;
   }
 
-  lp_type lp(0.0);
-  vector_seq_view<T_y> y_vec(y);
-  vector_seq_view<T_loc> mu_vec(mu);
-  size_t size_vec = max_size_mvt(y, mu);
+  T_y_ref y_ref = y;
+  T_mu_ref mu_ref = mu;
+  T_Sigma_ref Sigma_ref = Sigma;
+  vector_seq_view<T_y_ref> y_vec(y_ref);
+  vector_seq_view<T_mu_ref> mu_vec(mu_ref);
+  const size_t size_vec = max_size_mvt(y, mu);
 
-  int size_y = y_vec[0].size();
-  int size_mu = mu_vec[0].size();
+  const int size_y = y_vec[0].size();
+  const int size_mu = mu_vec[0].size();
   if (size_vec > 1) {
     for (size_t i = 1, size_mvt_y = size_mvt(y); i < size_mvt_y; i++) {
       check_size_match(function,
@@ -71,35 +99,65 @@ return_type_t<T_y, T_loc, T_covar> multi_normal_lpdf(const T_y& y,
     check_finite(function, "Location parameter", mu_vec[i]);
     check_not_nan(function, "Random variable", y_vec[i]);
   }
-  const auto& Sigma_ref = to_ref(Sigma);
   check_symmetric(function, "Covariance matrix", Sigma_ref);
 
-  auto ldlt_Sigma = make_ldlt_factor(Sigma_ref);
+  auto ldlt_Sigma = make_ldlt_factor(value_of(Sigma_ref));
   check_ldlt_factor(function, "LDLT_Factor of covariance parameter",
                     ldlt_Sigma);
 
   if (size_y == 0) {
-    return lp;
+    return T_return(0);
   }
 
+  operands_and_partials<T_y_ref, T_mu_ref, T_Sigma_ref> ops_partials(
+      y_ref, mu_ref, Sigma_ref);
+
+  T_partials_return logp(0);
   if (include_summand<propto>::value) {
-    lp += NEG_LOG_SQRT_TWO_PI * size_y * size_vec;
+    logp += NEG_LOG_SQRT_TWO_PI * size_y * size_vec;
   }
 
   if (include_summand<propto, T_covar_elem>::value) {
-    lp -= 0.5 * log_determinant_ldlt(ldlt_Sigma) * size_vec;
+    logp -= 0.5 * log_determinant_ldlt(ldlt_Sigma) * size_vec;
+    if (!is_constant_all<T_covar>::value) {
+      ops_partials.edge3_.partials_
+          -= 0.5 * size_vec
+             * mdivide_left_ldlt(ldlt_Sigma,
+                                 Eigen::MatrixXd::Identity(size_y, size_y));
+    }
   }
 
   if (include_summand<propto, T_y, T_loc, T_covar_elem>::value) {
-    lp_type sum_lp_vec(0.0);
+    matrix_partials_t y_val_minus_mu_val(size_y, size_vec);
     for (size_t i = 0; i < size_vec; i++) {
-      const auto& y_col = as_column_vector_or_scalar(y_vec[i]);
-      const auto& mu_col = as_column_vector_or_scalar(mu_vec[i]);
-      sum_lp_vec += trace_inv_quad_form_ldlt(ldlt_Sigma, y_col - mu_col);
+      decltype(auto) y_val = as_value_column_vector_or_scalar(y_vec[i]);
+      decltype(auto) mu_val = as_value_column_vector_or_scalar(mu_vec[i]);
+      y_val_minus_mu_val.col(i) = y_val - mu_val;
+    }
+
+    // one solve for the residuals of all the observations
+    const matrix_partials_t scaled_diff
+        = mdivide_left_ldlt(ldlt_Sigma, y_val_minus_mu_val);
+
+    logp -= 0.5 * (y_val_minus_mu_val.array() * scaled_diff.array()).sum();
+
+    if (!is_constant_all<T_y>::value) {
+      for (size_t i = 0; i < size_vec; i++) {
+        ops_partials.edge1_.partials_vec_[i] -= scaled_diff.col(i);
+      }
+    }
+    if (!is_constant_all<T_loc>::value) {
+      for (size_t i = 0; i < size_vec; i++) {
+        ops_partials.edge2_.partials_vec_[i] += scaled_diff.col(i);
+      }
+    }
+    if (!is_constant_all<T_covar>::value) {
+      ops_partials.edge3_.partials_
+          += 0.5 * scaled_diff * scaled_diff.transpose();
     }
-    lp -= 0.5 * sum_lp_vec;
   }
-  return lp;
+
+  return ops_partials.build(logp);
 }
 
 template <typename T_y, typename T_loc, typename T_covar>
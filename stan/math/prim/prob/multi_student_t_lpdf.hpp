@@ -3,16 +3,20 @@
 
 #include <stan/math/prim/meta.hpp>
 #include <stan/math/prim/err.hpp>
-#include <stan/math/prim/fun/as_column_vector_or_scalar.hpp>
+#include <stan/math/prim/fun/as_value_column_vector_or_scalar.hpp>
 #include <stan/math/prim/fun/constants.hpp>
+#include <stan/math/prim/fun/digamma.hpp>
 #include <stan/math/prim/fun/is_inf.hpp>
 #include <stan/math/prim/fun/log.hpp>
 #include <stan/math/prim/fun/log1p.hpp>
 #include <stan/math/prim/fun/lgamma.hpp>
+#include <stan/math/prim/fun/log_determinant_ldlt.hpp>
 #include <stan/math/prim/fun/max_size_mvt.hpp>
+#include <stan/math/prim/fun/mdivide_left_ldlt.hpp>
 #include <stan/math/prim/fun/size_mvt.hpp>
-#include <stan/math/prim/fun/to_ref.hpp>
+#include <stan/math/prim/fun/value_of.hpp>
 #include <stan/math/prim/fun/vector_seq_view.hpp>
+#include <stan/math/prim/functor/operands_and_partials.hpp>
 #include <stan/math/prim/prob/multi_normal_log.hpp>
 #include <cmath>
 #include <cstdlib>
@@ -24,6 +28,11 @@ namespace math {
  * Return the log of the multivariate Student t distribution
  * at the specified arguments.
  *
+ * The residuals of all the observations are stacked into one matrix and
+ * solved against the LDLT factorization of Sigma at once, and the
+ * partials with respect to all the arguments are calculated
+ * analytically.
+ *
  * @tparam propto Carry out calculations up to a proportion
  */
 template <bool propto, typename T_y, typename T_dof, typename T_loc,
@@ -31,10 +40,15 @@ template <bool propto, typename T_y, typename T_dof, typename T_loc,
 return_type_t<T_y, T_dof, T_loc, T_scale> multi_student_t_lpdf(
     const T_y& y, const T_dof& nu, const T_loc& mu, const T_scale& Sigma) {
   using T_scale_elem = typename scalar_type<T_scale>::type;
-  using lp_type = return_type_t<T_y, T_dof, T_loc, T_scale>;
-  using Eigen::Matrix;
-  using std::log;
-  using std::vector;
+  using T_return = return_type_t<T_y, T_dof, T_loc, T_scale>;
+  using T_partials_return = partials_return_t<T_y, T_dof, T_loc, T_scale>;
+  using matrix_partials_t
+      = Eigen::Matrix<T_partials_return, Eigen::Dynamic, Eigen::Dynamic>;
+  using vector_partials_t = Eigen::Matrix<T_partials_return, Eigen::Dynamic, 1>;
+  using T_y_ref = ref_type_t<T_y>;
+  using T_nu_ref = ref_type_t<T_dof>;
+  using T_mu_ref = ref_type_t<T_loc>;
+  using T_Sigma_ref = ref_type_t<T_scale>;
   static const char* function = "multi_student_t";
   check_not_nan(function, "Degrees of freedom parameter", nu);
   check_positive(function, "Degrees of freedom parameter", nu);
@@ -50,40 +64,32 @@ return_type_t<T_y, T_dof, T_loc, T_scale> multi_student_t_lpdf(
   }
   check_consistent_sizes_mvt(function, "y", y, "mu", mu);
 
-  vector_seq_view<T_y> y_vec(y);
-  vector_seq_view<T_loc> mu_vec(mu);
-  size_t size_vec = max_size_mvt(y, mu);
+  T_y_ref y_ref = y;
+  T_nu_ref nu_ref = nu;
+  T_mu_ref mu_ref = mu;
+  T_Sigma_ref Sigma_ref = Sigma;
+  vector_seq_view<T_y_ref> y_vec(y_ref);
+  vector_seq_view<T_mu_ref> mu_vec(mu_ref);
+  const size_t size_vec = max_size_mvt(y, mu);
 
-  int size_y = y_vec[0].size();
-  int size_mu = mu_vec[0].size();
+  const int size_y = y_vec[0].size();
+  const int size_mu = mu_vec[0].size();
   if (size_vec > 1) {
-    int size_y_old = size_y;
-    int size_y_new;
     for (size_t i = 1, size_mvt_y = size_mvt(y); i < size_mvt_y; i++) {
-      int size_y_new = y_vec[i].size();
       check_size_match(
           function, "Size of one of the vectors of the random variable",
-          size_y_new, "Size of another vector of the random variable",
-          size_y_old);
-      size_y_old = size_y_new;
+          y_vec[i].size(), "Size of another vector of the random variable",
+          y_vec[i - 1].size());
     }
-    int size_mu_old = size_mu;
-    int size_mu_new;
     for (size_t i = 1, size_mvt_mu = size_mvt(mu); i < size_mvt_mu; i++) {
-      int size_mu_new = mu_vec[i].size();
       check_size_match(function,
                        "Size of one of the vectors "
                        "of the location variable",
-                       size_mu_new,
+                       mu_vec[i].size(),
                        "Size of another vector of "
                        "the location variable",
-                       size_mu_old);
-      size_mu_old = size_mu_new;
+                       mu_vec[i - 1].size());
     }
-    (void)size_y_old;
-    (void)size_y_new;
-    (void)size_mu_old;
-    (void)size_mu_new;
   }
 
   check_size_match(function, "Size of random variable", size_y,
@@ -97,45 +103,102 @@ return_type_t<T_y, T_dof, T_loc, T_scale> multi_student_t_lpdf(
     check_finite(function, "Location parameter", mu_vec[i]);
     check_not_nan(function, "Random variable", y_vec[i]);
   }
-  const auto& Sigma_ref = to_ref(Sigma);
   check_symmetric(function, "Scale parameter", Sigma_ref);
 
-  auto ldlt_Sigma = make_ldlt_factor(Sigma_ref);
+  auto ldlt_Sigma = make_ldlt_factor(value_of(Sigma_ref));
   check_ldlt_factor(function, "LDLT_Factor of scale parameter", ldlt_Sigma);
 
   if (size_y == 0) {
-    return 0;
+    return T_return(0);
   }
 
-  lp_type lp(0);
+  operands_and_partials<T_y_ref, T_nu_ref, T_mu_ref, T_Sigma_ref> ops_partials(
+      y_ref, nu_ref, mu_ref, Sigma_ref);
+
+  const T_partials_return nu_val = value_of(nu_ref);
+  T_partials_return lp(0);
 
   if (include_summand<propto, T_dof>::value) {
-    lp += lgamma(0.5 * (nu + size_y)) * size_vec;
-    lp -= lgamma(0.5 * nu) * size_vec;
-    lp -= (0.5 * size_y) * log(nu) * size_vec;
+    lp += (lgamma(0.5 * (nu_val + size_y)) - lgamma(0.5 * nu_val)
+           - (0.5 * size_y) * log(nu_val))
+          * size_vec;
+    if (!is_constant_all<T_dof>::value) {
+      ops_partials.edge2_.partials_[0]
+          += 0.5
+             * (digamma(0.5 * (nu_val + size_y)) - digamma(0.5 * nu_val)
+                - size_y / nu_val)
+             * size_vec;
+    }
   }
 
   if (include_summand<propto>::value) {
     lp -= (0.5 * size_y) * LOG_PI * size_vec;
   }
 
-  using Eigen::Array;
-
   if (include_summand<propto, T_scale_elem>::value) {
     lp -= 0.5 * log_determinant_ldlt(ldlt_Sigma) * size_vec;
+    if (!is_constant_all<T_scale>::value) {
+      ops_partials.edge4_.partials_
+          -= 0.5 * size_vec
+             * mdivide_left_ldlt(ldlt_Sigma,
+                                 Eigen::MatrixXd::Identity(size_y, size_y));
+    }
   }
 
   if (include_summand<propto, T_y, T_dof, T_loc, T_scale_elem>::value) {
-    lp_type sum_lp_vec(0.0);
+    matrix_partials_t y_val_minus_mu_val(size_y, size_vec);
     for (size_t i = 0; i < size_vec; i++) {
-      const auto& y_col = as_column_vector_or_scalar(y_vec[i]);
-      const auto& mu_col = as_column_vector_or_scalar(mu_vec[i]);
-      sum_lp_vec
-          += log1p(trace_inv_quad_form_ldlt(ldlt_Sigma, y_col - mu_col) / nu);
+      decltype(auto) y_val = as_value_column_vector_or_scalar(y_vec[i]);
+      decltype(auto) mu_val = as_value_column_vector_or_scalar(mu_vec[i]);
+      y_val_minus_mu_val.col(i) = y_val - mu_val;
+    }
+
+    // one solve for the residuals of all the observations
+    const matrix_partials_t inv_Sigma_diff
+        = mdivide_left_ldlt(ldlt_Sigma, y_val_minus_mu_val);
+    const vector_partials_t quad_form
+        = (y_val_minus_mu_val.array() * inv_Sigma_diff.array())
+              .colwise()
+              .sum()
+              .transpose();
+
+    T_partials_return sum_log1p(0);
+    for (size_t i = 0; i < size_vec; i++) {
+      sum_log1p += log1p(quad_form.coeff(i) / nu_val);
+    }
+    lp -= 0.5 * (nu_val + size_y) * sum_log1p;
+
+    if (!is_constant_all<T_y, T_loc, T_scale>::value) {
+      const vector_partials_t weights
+          = (nu_val + size_y) / (nu_val + quad_form.array());
+      const matrix_partials_t scaled_diff
+          = inv_Sigma_diff * weights.asDiagonal();
+      if (!is_constant_all<T_y>::value) {
+        for (size_t i = 0; i < size_vec; i++) {
+          ops_partials.edge1_.partials_vec_[i] -= scaled_diff.col(i);
+        }
+      }
+      if (!is_constant_all<T_loc>::value) {
+        for (size_t i = 0; i < size_vec; i++) {
+          ops_partials.edge3_.partials_vec_[i] += scaled_diff.col(i);
+        }
+      }
+      if (!is_constant_all<T_scale>::value) {
+        ops_partials.edge4_.partials_
+            += 0.5 * scaled_diff * inv_Sigma_diff.transpose();
+      }
+    }
+    if (!is_constant_all<T_dof>::value) {
+      ops_partials.edge2_.partials_[0]
+          += 0.5
+             * ((nu_val + size_y)
+                    * (quad_form.array()
+                       / (nu_val * (nu_val + quad_form.array())))
+                          .sum()
+                - sum_log1p);
     }
-    lp -= 0.5 * (nu + size_y) * sum_lp_vec;
   }
-  return lp;
+  return ops_partials.build(lp);
 }
 
 template <typename T_y, typename T_dof, typename T_loc, typename T_scale>
@@ -58,6 +58,8 @@
 #include <stan/math/rev/core/scoped_chainablestack.hpp>
 #include <stan/math/rev/core/set_zero_all_adjoints.hpp>
 #include <stan/math/rev/core/set_zero_all_adjoints_nested.hpp>
+#include <stan/math/rev/core/soa_tape.hpp>
+#include <stan/math/rev/core/stack_stats.hpp>
 #include <stan/math/rev/core/start_nested.hpp>
 #include <stan/math/rev/core/std_complex.hpp>
 #include <stan/math/rev/core/std_isinf.hpp>
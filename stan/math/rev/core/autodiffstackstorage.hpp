@@ -7,6 +7,10 @@
 namespace stan {
 namespace math {
 
+namespace internal {
+class soa_tape_recorder;
+}  // namespace internal
+
 // Internal macro used to modify global pointer definition to the
 // global AD instance.
 #ifdef STAN_THREADS
@@ -110,6 +114,21 @@ struct AutodiffStackSingleton {
     std::vector<size_t> nested_var_stack_sizes_;
     std::vector<size_t> nested_var_nochain_stack_sizes_;
     std::vector<size_t> nested_var_alloc_stack_starts_;
+
+    // segment of the SoA tape new operations are appended to, if any;
+    // see soa_tape.hpp
+    ChainableT *soa_segment_ = nullptr;
+
+    // recorder of replayable SoA operations, if any; see soa_tape.hpp
+    internal::soa_tape_recorder *soa_recorder_ = nullptr;
+
+#ifdef STAN_MATH_ARENA_STATS
+    // usage statistics, updated on recovery; see get_stack_stats()
+    size_t peak_var_stack_size_ = 0;
+    size_t peak_var_nochain_stack_size_ = 0;
+    size_t peak_var_alloc_stack_size_ = 0;
+    size_t num_recovered_chainable_allocs_ = 0;
+#endif
   };
 
   explicit AutodiffStackSingleton(AutodiffStackSingleton_t const &) = delete;
@@ -2,7 +2,9 @@
 #define STAN_MATH_REV_CORE_CALLBACK_VARI_HPP
 
 #include <stan/math/rev/core/vari.hpp>
+#include <cstring>
 #include <utility>
+#include <vector>
 
 namespace stan {
 namespace math {
@@ -19,6 +21,23 @@ struct callback_vari : public vari_value<T> {
         rev_functor_(std::forward<F>(rev_functor)) {}
 
   inline void chain() final { rev_functor_(*this); }
+
+  /**
+   * Append every pointer sized word of the callback. The varis the
+   * callback updates are among them if it captures them by value (as
+   * vars or pointers to varis); those held in arena arrays are not, which
+   * <code>internal::trace_tape()</code> detects when it runs
+   * <code>chain()</code>.
+   */
+  bool trace_operands(std::vector<const void*>& operands) const {
+    const char* bytes = reinterpret_cast<const char*>(&rev_functor_);
+    for (size_t i = 0; i + sizeof(void*) <= sizeof(F); i += alignof(void*)) {
+      const void* word;
+      std::memcpy(&word, bytes + i, sizeof(word));
+      operands.push_back(word);
+    }
+    return true;
+  }
 };
 
 }  // namespace internal
@@ -2,6 +2,7 @@
 #define STAN_MATH_REV_CORE_DDV_VARI_HPP
 
 #include <stan/math/rev/core/vari.hpp>
+#include <vector>
 
 namespace stan {
 namespace math {
@@ -15,6 +16,11 @@ class op_ddv_vari : public vari {
  public:
   op_ddv_vari(double f, double a, double b, vari* cvi)
       : vari(f), ad_(a), bd_(b), cvi_(cvi) {}
+
+  bool trace_operands(std::vector<const void*>& operands) const final {
+    operands.push_back(cvi_);
+    return true;
+  }
 };
 
 }  // namespace math
@@ -2,6 +2,7 @@
 #define STAN_MATH_REV_CORE_DV_VARI_HPP
 
 #include <stan/math/rev/core/vari.hpp>
+#include <vector>
 
 namespace stan {
 namespace math {
@@ -13,6 +14,11 @@ class op_dv_vari : public vari {
 
  public:
   op_dv_vari(double f, double a, vari* bvi) : vari(f), ad_(a), bvi_(bvi) {}
+
+  bool trace_operands(std::vector<const void*>& operands) const final {
+    operands.push_back(bvi_);
+    return true;
+  }
 };
 
 }  // namespace math
@@ -2,6 +2,7 @@
 #define STAN_MATH_REV_CORE_DVD_VARI_HPP
 
 #include <stan/math/rev/core/vari.hpp>
+#include <vector>
 
 namespace stan {
 namespace math {
@@ -15,6 +16,11 @@ class op_dvd_vari : public vari {
  public:
   op_dvd_vari(double f, double a, vari* bvi, double c)
       : vari(f), ad_(a), bvi_(bvi), cd_(c) {}
+
+  bool trace_operands(std::vector<const void*>& operands) const final {
+    operands.push_back(bvi_);
+    return true;
+  }
 };
 
 }  // namespace math
@@ -2,6 +2,7 @@
 #define STAN_MATH_REV_CORE_DVV_VARI_HPP
 
 #include <stan/math/rev/core/vari.hpp>
+#include <vector>
 
 namespace stan {
 namespace math {
@@ -15,6 +16,11 @@ class op_dvv_vari : public vari {
  public:
   op_dvv_vari(double f, double a, vari* bvi, vari* cvi)
       : vari(f), ad_(a), bvi_(bvi), cvi_(cvi) {}
+
+  bool trace_operands(std::vector<const void*>& operands) const final {
+    operands.insert(operands.end(), {bvi_, cvi_});
+    return true;
+  }
 };
 
 }  // namespace math
@@ -3,6 +3,7 @@
 
 #include <stan/math/rev/meta.hpp>
 #include <stan/math/rev/core/var.hpp>
+#include <stan/math/rev/core/soa_tape.hpp>
 #include <stan/math/prim/err/check_matching_dims.hpp>
 #include <stan/math/rev/core/callback_vari.hpp>
 #include <stan/math/prim/fun/as_column_vector_or_scalar.hpp>
@@ -51,6 +52,9 @@ namespace math {
  * @return Variable result of adding two variables.
  */
 inline var operator+(const var& a, const var& b) {
+#ifdef STAN_MATH_SOA_TAPE
+  return {internal::soa_record(internal::soa_op::add, a.vi_, b.vi_)};
+#else
   return make_callback_vari(a.vi_->val_ + b.vi_->val_,
                             [avi = a.vi_, bvi = b.vi_](const auto& vi) mutable {
                               if (unlikely(std::isnan(vi.val_))) {
@@ -61,6 +65,7 @@ inline var operator+(const var& a, const var& b) {
                                 bvi->adj_ += vi.adj_;
                               }
                             });
+#endif
 }
 
 /**
@@ -80,6 +85,10 @@ inline var operator+(const var& a, Arith b) {
   if (unlikely(b == 0.0)) {
     return a;
   }
+#ifdef STAN_MATH_SOA_TAPE
+  return {internal::soa_record(internal::soa_op::add, a.vi_,
+                               static_cast<double>(b))};
+#else
   return make_callback_vari(a.vi_->val_ + b,
                             [avi = a.vi_, b](const auto& vi) mutable {
                               if (unlikely(std::isnan(vi.val_))) {
@@ -88,6 +97,7 @@ inline var operator+(const var& a, Arith b) {
                                 avi->adj_ += vi.adj_;
                               }
                             });
+#endif
 }
 
 /**
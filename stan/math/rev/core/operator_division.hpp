@@ -6,6 +6,7 @@
 #include <stan/math/prim/fun/constants.hpp>
 #include <stan/math/prim/fun/is_any_nan.hpp>
 #include <stan/math/rev/core/var.hpp>
+#include <stan/math/rev/core/soa_tape.hpp>
 #include <stan/math/rev/core/std_complex.hpp>
 #include <stan/math/rev/core/vv_vari.hpp>
 #include <stan/math/rev/core/vd_vari.hpp>
@@ -99,7 +100,12 @@ class divide_dv_vari final : public op_dv_vari {
  * second.
  */
 inline var operator/(const var& dividend, const var& divisor) {
+#ifdef STAN_MATH_SOA_TAPE
+  return {internal::soa_record(internal::soa_op::divide, dividend.vi_,
+                               divisor.vi_)};
+#else
   return {new internal::divide_vv_vari(dividend.vi_, divisor.vi_)};
+#endif
 }
 
 /**
@@ -120,7 +126,12 @@ inline var operator/(const var& dividend, Arith divisor) {
   if (divisor == 1.0) {
     return dividend;
   }
+#ifdef STAN_MATH_SOA_TAPE
+  return {internal::soa_record(internal::soa_op::divide, dividend.vi_,
+                               static_cast<double>(divisor))};
+#else
   return {new internal::divide_vd_vari(dividend.vi_, divisor)};
+#endif
 }
 
 /**
@@ -137,7 +148,12 @@ inline var operator/(const var& dividend, Arith divisor) {
  */
 template <typename Arith, require_arithmetic_t<Arith>* = nullptr>
 inline var operator/(Arith dividend, const var& divisor) {
+#ifdef STAN_MATH_SOA_TAPE
+  return {internal::soa_record(internal::soa_op::divide,
+                               static_cast<double>(dividend), divisor.vi_)};
+#else
   return {new internal::divide_dv_vari(dividend, divisor.vi_)};
+#endif
 }
 
 inline std::complex<var> operator/(const std::complex<var>& x1,
@@ -2,6 +2,7 @@
 #define STAN_MATH_REV_CORE_OPERATOR_EQUAL_HPP
 
 #include <stan/math/rev/core/var.hpp>
+#include <stan/math/rev/core/soa_tape.hpp>
 #include <stan/math/prim/meta.hpp>
 
 namespace stan {
@@ -25,7 +26,11 @@ namespace math {
  * second's.
  */
 inline bool operator==(const var& a, const var& b) {
+#ifdef STAN_MATH_SOA_TAPE
+  return internal::soa_guard(internal::soa_cmp::equal, a.vi_, b.vi_);
+#else
   return a.val() == b.val();
+#endif
 }
 
 /**
@@ -40,7 +45,12 @@ inline bool operator==(const var& a, const var& b) {
  */
 template <typename Arith, require_arithmetic_t<Arith>* = nullptr>
 inline bool operator==(const var& a, Arith b) {
+#ifdef STAN_MATH_SOA_TAPE
+  return internal::soa_guard(internal::soa_cmp::equal, a.vi_,
+                             static_cast<double>(b));
+#else
   return a.val() == b;
+#endif
 }
 
 /**
@@ -54,7 +64,12 @@ inline bool operator==(const var& a, Arith b) {
  */
 template <typename Arith, require_arithmetic_t<Arith>* = nullptr>
 inline bool operator==(Arith a, const var& b) {
+#ifdef STAN_MATH_SOA_TAPE
+  return internal::soa_guard(internal::soa_cmp::equal, static_cast<double>(a),
+                             b.vi_);
+#else
   return a == b.val();
+#endif
 }
 
 /**
@@ -2,6 +2,7 @@
 #define STAN_MATH_REV_CORE_OPERATOR_GREATER_THAN_OR_EQUAL_HPP
 
 #include <stan/math/rev/core/var.hpp>
+#include <stan/math/rev/core/soa_tape.hpp>
 #include <stan/math/prim/meta.hpp>
 
 namespace stan {
@@ -26,7 +27,11 @@ namespace math {
  * to the second's.
  */
 inline bool operator>=(const var& a, const var& b) {
+#ifdef STAN_MATH_SOA_TAPE
+  return internal::soa_guard(internal::soa_cmp::greater_equal, a.vi_, b.vi_);
+#else
   return a.val() >= b.val();
+#endif
 }
 
 /**
@@ -41,7 +46,12 @@ inline bool operator>=(const var& a, const var& b) {
  */
 template <typename Arith, require_arithmetic_t<Arith>* = nullptr>
 inline bool operator>=(const var& a, Arith b) {
+#ifdef STAN_MATH_SOA_TAPE
+  return internal::soa_guard(internal::soa_cmp::greater_equal, a.vi_,
+                             static_cast<double>(b));
+#else
   return a.val() >= b;
+#endif
 }
 
 /**
@@ -56,7 +66,12 @@ inline bool operator>=(const var& a, Arith b) {
  */
 template <typename Arith, typename Var, require_arithmetic_t<Arith>* = nullptr>
 inline bool operator>=(Arith a, const var& b) {
+#ifdef STAN_MATH_SOA_TAPE
+  return internal::soa_guard(internal::soa_cmp::greater_equal,
+                             static_cast<double>(a), b.vi_);
+#else
   return a >= b.val();
+#endif
 }
 
 }  // namespace math
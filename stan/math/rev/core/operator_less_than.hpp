@@ -2,6 +2,7 @@
 #define STAN_MATH_REV_CORE_OPERATOR_LESS_THAN_HPP
 
 #include <stan/math/rev/core/var.hpp>
+#include <stan/math/rev/core/soa_tape.hpp>
 #include <stan/math/prim/meta.hpp>
 
 namespace stan {
@@ -22,7 +23,13 @@ namespace math {
  * @param b Second variable.
  * @return True if first variable's value is less than second's.
  */
-inline bool operator<(const var& a, const var& b) { return a.val() < b.val(); }
+inline bool operator<(const var& a, const var& b) {
+#ifdef STAN_MATH_SOA_TAPE
+  return internal::soa_guard(internal::soa_cmp::less, a.vi_, b.vi_);
+#else
+  return a.val() < b.val();
+#endif
+}
 
 /**
  * Less than operator comparing variable's value and a double
@@ -35,7 +42,12 @@ inline bool operator<(const var& a, const var& b) { return a.val() < b.val(); }
  */
 template <typename Arith, require_arithmetic_t<Arith>* = nullptr>
 inline bool operator<(const var& a, Arith b) {
+#ifdef STAN_MATH_SOA_TAPE
+  return internal::soa_guard(internal::soa_cmp::less, a.vi_,
+                             static_cast<double>(b));
+#else
   return a.val() < b;
+#endif
 }
 
 /**
@@ -49,7 +61,12 @@ inline bool operator<(const var& a, Arith b) {
  */
 template <typename Arith, require_arithmetic_t<Arith>* = nullptr>
 inline bool operator<(Arith a, const var& b) {
+#ifdef STAN_MATH_SOA_TAPE
+  return internal::soa_guard(internal::soa_cmp::less, static_cast<double>(a),
+                             b.vi_);
+#else
   return a < b.val();
+#endif
 }
 
 }  // namespace math
@@ -3,6 +3,7 @@
 
 #include <stan/math/prim/meta.hpp>
 #include <stan/math/rev/core/var.hpp>
+#include <stan/math/rev/core/soa_tape.hpp>
 #include <stan/math/rev/core/vv_vari.hpp>
 #include <stan/math/rev/core/vd_vari.hpp>
 #include <stan/math/prim/fun/constants.hpp>
@@ -80,7 +81,11 @@ class multiply_vd_vari final : public op_vd_vari {
  * @return Variable result of multiplying operands.
  */
 inline var operator*(const var& a, const var& b) {
+#ifdef STAN_MATH_SOA_TAPE
+  return {internal::soa_record(internal::soa_op::multiply, a.vi_, b.vi_)};
+#else
   return {new internal::multiply_vv_vari(a.vi_, b.vi_)};
+#endif
 }
 
 /**
@@ -100,7 +105,12 @@ inline var operator*(const var& a, Arith b) {
   if (b == 1.0) {
     return a;
   }
+#ifdef STAN_MATH_SOA_TAPE
+  return {internal::soa_record(internal::soa_op::multiply, a.vi_,
+                               static_cast<double>(b))};
+#else
   return {new internal::multiply_vd_vari(a.vi_, b)};
+#endif
 }
 
 /**
@@ -120,7 +130,12 @@ inline var operator*(Arith a, const var& b) {
   if (a == 1.0) {
     return b;
   }
+#ifdef STAN_MATH_SOA_TAPE
+  return {internal::soa_record(internal::soa_op::multiply,
+                               static_cast<double>(a), b.vi_)};
+#else
   return {new internal::multiply_vd_vari(b.vi_, a)};  // by symmetry
+#endif
 }
 
 }  // namespace math
@@ -4,6 +4,7 @@
 #include <stan/math/rev/core/std_complex.hpp>
 #include <stan/math/rev/core/operator_equal.hpp>
 #include <stan/math/rev/core/var.hpp>
+#include <stan/math/rev/core/soa_tape.hpp>
 #include <stan/math/prim/meta.hpp>
 #include <complex>
 
@@ -28,7 +29,11 @@ namespace math {
  * second's.
  */
 inline bool operator!=(const var& a, const var& b) {
+#ifdef STAN_MATH_SOA_TAPE
+  return internal::soa_guard(internal::soa_cmp::not_equal, a.vi_, b.vi_);
+#else
   return a.val() != b.val();
+#endif
 }
 
 /**
@@ -43,7 +48,12 @@ inline bool operator!=(const var& a, const var& b) {
  */
 template <typename Arith, require_arithmetic_t<Arith>* = nullptr>
 inline bool operator!=(const var& a, Arith b) {
+#ifdef STAN_MATH_SOA_TAPE
+  return internal::soa_guard(internal::soa_cmp::not_equal, a.vi_,
+                             static_cast<double>(b));
+#else
   return a.val() != b;
+#endif
 }
 
 /**
@@ -58,7 +68,12 @@ inline bool operator!=(const var& a, Arith b) {
  */
 template <typename Arith, require_arithmetic_t<Arith>* = nullptr>
 inline bool operator!=(Arith a, const var& b) {
+#ifdef STAN_MATH_SOA_TAPE
+  return internal::soa_guard(internal::soa_cmp::not_equal,
+                             static_cast<double>(a), b.vi_);
+#else
   return a != b.val();
+#endif
 }
 
 /**
@@ -3,6 +3,7 @@
 
 #include <stan/math/rev/meta.hpp>
 #include <stan/math/rev/core/var.hpp>
+#include <stan/math/rev/core/soa_tape.hpp>
 #include <stan/math/rev/core/arena_matrix.hpp>
 #include <stan/math/rev/core/callback_vari.hpp>
 #include <stan/math/prim/fun/as_column_vector_or_scalar.hpp>
@@ -54,6 +55,9 @@ namespace math {
  * the first.
  */
 inline var operator-(const var& a, const var& b) {
+#ifdef STAN_MATH_SOA_TAPE
+  return {internal::soa_record(internal::soa_op::subtract, a.vi_, b.vi_)};
+#else
   return make_callback_vari(a.vi_->val_ - b.vi_->val_,
                             [avi = a.vi_, bvi = b.vi_](const auto& vi) mutable {
                               if (unlikely(is_nan(vi.val_))) {
@@ -64,6 +68,7 @@ inline var operator-(const var& a, const var& b) {
                                 bvi->adj_ -= vi.adj_;
                               }
                             });
+#endif
 }
 
 /**
@@ -84,6 +89,10 @@ inline var operator-(const var& a, Arith b) {
   if (unlikely(b == 0.0)) {
     return a;
   }
+#ifdef STAN_MATH_SOA_TAPE
+  return {internal::soa_record(internal::soa_op::subtract, a.vi_,
+                               static_cast<double>(b))};
+#else
   return make_callback_vari(a.vi_->val_ - b,
                             [avi = a.vi_, b](const auto& vi) mutable {
                               if (unlikely(is_nan(vi.val_))) {
@@ -92,6 +101,7 @@ inline var operator-(const var& a, Arith b) {
                                 avi->adj_ += vi.adj_;
                               }
                             });
+#endif
 }
 
 /**
@@ -109,6 +119,10 @@ inline var operator-(const var& a, Arith b) {
  */
 template <typename Arith, require_arithmetic_t<Arith>* = nullptr>
 inline var operator-(Arith a, const var& b) {
+#ifdef STAN_MATH_SOA_TAPE
+  return {internal::soa_record(internal::soa_op::subtract,
+                               static_cast<double>(a), b.vi_)};
+#else
   return make_callback_vari(a - b.vi_->val_,
                             [bvi = b.vi_, a](const auto& vi) mutable {
                               if (unlikely(is_nan(vi.val_))) {
@@ -117,6 +131,7 @@ inline var operator-(Arith a, const var& b) {
                                 bvi->adj_ -= vi.adj_;
                               }
                             });
+#endif
 }
 
 /**
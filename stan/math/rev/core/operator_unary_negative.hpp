@@ -3,6 +3,7 @@
 
 #include <stan/math/prim/meta.hpp>
 #include <stan/math/rev/core/var.hpp>
+#include <stan/math/rev/core/soa_tape.hpp>
 #include <stan/math/rev/core/v_vari.hpp>
 #include <stan/math/rev/core/callback_vari.hpp>
 #include <stan/math/prim/fun/constants.hpp>
@@ -50,6 +51,9 @@ class neg_vari final : public op_v_vari {
  * @return Negation of variable.
  */
 inline var operator-(const var& a) {
+#ifdef STAN_MATH_SOA_TAPE
+  return {internal::soa_record(internal::soa_op::negate, a.vi_)};
+#else
   return make_callback_var(-a.val(), [a](const auto vi) {
     if (unlikely(is_nan(a.val()))) {
       a.adj() = NOT_A_NUMBER;
@@ -57,6 +61,7 @@ inline var operator-(const var& a) {
       a.adj() -= vi.adj();
     }
   });
+#endif
 }
 
 /**
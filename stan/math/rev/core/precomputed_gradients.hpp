@@ -155,6 +155,18 @@ class precomputed_gradients_vari_template : public vari {
     });
   }
 
+  /**
+   * Append the operands which are scalars. The operands which are
+   * containers have no scalar adjoints, so they are not traced.
+   */
+  bool trace_operands(std::vector<const void*>& operands) const final {
+    if (N_containers > 0) {
+      return false;
+    }
+    operands.insert(operands.end(), varis_, varis_ + size_);
+    return true;
+  }
+
  private:
   /**
    * Implements the chain rule for one non-`std::vector` operand.
@@ -7,13 +7,128 @@
 #include <stan/math/rev/meta.hpp>
 #include <stan/math/rev/fun/value_of.hpp>
 #include <stan/math/prim/err.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
 #include <iostream>
+#include <map>
+#include <mutex>
 #include <sstream>
+#include <string>
 #include <thread>
+#include <utility>
+#include <vector>
 
 namespace stan {
 namespace math {
 
+class profile_info;
+
+namespace internal {
+
+/**
+ * Histogram of durations with buckets growing by powers of two. Bucket
+ * <code>k</code> counts the durations from <code>2^k</code> up to
+ * <code>2^(k+1)</code> nanoseconds; shorter durations fall into bucket
+ * zero.
+ */
+class profile_histogram {
+  std::array<size_t, 64> counts_{};
+  size_t n_ = 0;
+
+ public:
+  inline void add(double seconds) {
+    const double ns = seconds * 1e9;
+    const int k = ns < 2.0 ? 0 : std::min(std::ilogb(ns), 63);
+    ++counts_[k];
+    ++n_;
+  }
+
+  inline size_t size() const noexcept { return n_; }
+
+  inline const std::array<size_t, 64>& counts() const noexcept {
+    return counts_;
+  }
+
+  /**
+   * Return an upper bound on the <code>p</code>-quantile of the
+   * durations in seconds, which is at most twice the exact quantile.
+   * Returns zero if no durations were added.
+   */
+  inline double quantile(double p) const {
+    if (n_ == 0) {
+      return 0.0;
+    }
+    const double target = std::max(1.0, std::ceil(p * n_));
+    size_t cumulative = 0;
+    for (int k = 0; k < 64; ++k) {
+      cumulative += counts_[k];
+      if (cumulative >= target) {
+        return std::ldexp(1.0, k + 1) * 1e-9;
+      }
+    }
+    return std::ldexp(1.0, 64) * 1e-9;
+  }
+};
+
+/**
+ * A completed pass through a profiled region, kept for trace export.
+ */
+struct profile_event {
+  bool reverse;  // reverse pass if true, forward pass otherwise
+  std::chrono::time_point<std::chrono::steady_clock> start;
+  double duration;  // in seconds
+};
+
+/**
+ * Return the switch for recording trace events of all profiles.
+ */
+inline std::atomic<bool>& profile_tracing() {
+  static std::atomic<bool> tracing{false};
+  return tracing;
+}
+
+/**
+ * Return the innermost profile whose forward pass is running on this
+ * thread, if any.
+ */
+inline profile_info*& current_profile() {
+  static thread_local profile_info* current = nullptr;
+  return current;
+}
+
+/**
+ * Write a string as a JSON string literal.
+ */
+inline void write_json_string(std::ostream& o, const std::string& str) {
+  o << '"';
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      o << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      o << ' ';
+    } else {
+      o << c;
+    }
+  }
+  o << '"';
+}
+
+}  // namespace internal
+
+/**
+ * Enable or disable recording an event for every pass through a
+ * profiled region. Events are needed by
+ * <code>write_chrome_trace()</code> and take memory for every pass, so
+ * tracing is off by default.
+ */
+inline void set_profile_tracing(bool enabled) {
+  internal::profile_tracing() = enabled;
+}
+
 /**
  * Class used for storing profiling information.
  */
@@ -32,6 +147,13 @@ class profile_info {
   std::chrono::time_point<std::chrono::steady_clock> rev_pass_tp_;
   size_t start_chain_stack_size_;
   size_t start_nochain_stack_size_;
+  std::string name_;
+  profile_info* parent_;  // enclosing region of the last forward pass
+  size_t arena_bytes_sum_;
+  size_t start_arena_bytes_;
+  internal::profile_histogram fwd_pass_hist_;
+  internal::profile_histogram rev_pass_hist_;
+  std::vector<internal::profile_event> events_;
 
  public:
   profile_info()
@@ -46,7 +168,14 @@ class profile_info {
         fwd_pass_tp_(std::chrono::steady_clock::now()),
         rev_pass_tp_(std::chrono::steady_clock::now()),
         start_chain_stack_size_(0),
-        start_nochain_stack_size_(0) {}
+        start_nochain_stack_size_(0),
+        parent_(nullptr),
+        arena_bytes_sum_(0),
+        start_arena_bytes_(0) {}
+
+  explicit profile_info(const std::string& name) : profile_info() {
+    name_ = name;
+  }
 
   bool is_active() const noexcept { return active_; }
 
@@ -57,6 +186,12 @@ class profile_info {
       start_nochain_stack_size_
           = ChainableStack::instance_->var_nochain_stack_.size();
     }
+#ifdef STAN_MATH_ARENA_STATS
+    start_arena_bytes_
+        = ChainableStack::instance_->memalloc_.bytes_requested();
+#endif
+    parent_ = internal::current_profile();
+    internal::current_profile() = this;
     fwd_pass_tp_ = std::chrono::steady_clock::now();
     active_ = true;
   }
@@ -73,18 +208,33 @@ class profile_info {
     } else {
       n_fwd_no_AD_passes_++;
     }
-    fwd_pass_time_ += std::chrono::duration<double>(
-                          std::chrono::steady_clock::now() - fwd_pass_tp_)
-                          .count();
+    const double duration = std::chrono::duration<double>(
+                                std::chrono::steady_clock::now() - fwd_pass_tp_)
+                                .count();
+    fwd_pass_time_ += duration;
+    fwd_pass_hist_.add(duration);
+    if (internal::profile_tracing()) {
+      events_.push_back({false, fwd_pass_tp_, duration});
+    }
+#ifdef STAN_MATH_ARENA_STATS
+    arena_bytes_sum_ += ChainableStack::instance_->memalloc_.bytes_requested()
+                        - start_arena_bytes_;
+#endif
+    internal::current_profile() = parent_;
     active_ = false;
   }
 
   void rev_pass_start() { rev_pass_tp_ = std::chrono::steady_clock::now(); }
 
   void rev_pass_stop() {
-    rev_pass_time_ += std::chrono::duration<double>(
-                          std::chrono::steady_clock::now() - rev_pass_tp_)
-                          .count();
+    const double duration = std::chrono::duration<double>(
+                                std::chrono::steady_clock::now() - rev_pass_tp_)
+                                .count();
+    rev_pass_time_ += duration;
+    rev_pass_hist_.add(duration);
+    if (internal::profile_tracing()) {
+      events_.push_back({true, rev_pass_tp_, duration});
+    }
     n_rev_passes_++;
   }
 
@@ -111,12 +261,133 @@ class profile_info {
   size_t get_num_rev_passes() const noexcept { return n_rev_passes_; }
 
   double get_rev_time() const noexcept { return rev_pass_time_; }
+
+  const std::string& get_name() const noexcept { return name_; }
+
+  /**
+   * Return the region enclosing the last forward pass through this
+   * region, or <code>nullptr</code> if there was none.
+   */
+  const profile_info* get_parent() const noexcept { return parent_; }
+
+  /**
+   * Return the names of the enclosing regions and of this region,
+   * separated by <code>/</code>.
+   */
+  std::string get_path() const {
+    return parent_ == nullptr ? name_ : parent_->get_path() + "/" + name_;
+  }
+
+  /**
+   * Return the bytes allocated on the arena during all forward passes,
+   * including those of nested regions. The bytes are only counted if
+   * <code>STAN_MATH_ARENA_STATS</code> is defined, otherwise this is 0.
+   */
+  size_t get_arena_bytes() const noexcept { return arena_bytes_sum_; }
+
+  /**
+   * Return an upper bound on the <code>p</code>-quantile of the times
+   * of single forward passes in seconds, at most twice the exact value.
+   */
+  double get_fwd_time_quantile(double p) const {
+    return fwd_pass_hist_.quantile(p);
+  }
+
+  /**
+   * Return an upper bound on the <code>p</code>-quantile of the times
+   * of single reverse passes in seconds, at most twice the exact value.
+   */
+  double get_rev_time_quantile(double p) const {
+    return rev_pass_hist_.quantile(p);
+  }
+
+  const internal::profile_histogram& get_fwd_time_histogram() const noexcept {
+    return fwd_pass_hist_;
+  }
+
+  const internal::profile_histogram& get_rev_time_histogram() const noexcept {
+    return rev_pass_hist_;
+  }
+
+  const std::vector<internal::profile_event>& get_events() const noexcept {
+    return events_;
+  }
+
+  void clear_events() { events_.clear(); }
 };
 
 using profile_key = std::pair<std::string, std::thread::id>;
 
 using profile_map = std::map<profile_key, profile_info>;
 
+/**
+ * Return the profile with the specified name for the calling thread,
+ * adding it to the profiles if needed.
+ *
+ * The returned reference stays valid as long as the entry is not
+ * removed from the map. Constructing <code>profile</code> objects from it
+ * avoids looking up the map in every pass through the region.
+ *
+ * @param name name of the profile
+ * @param profiles map of all profiles
+ * @return profile of the calling thread
+ */
+inline profile_info& register_profile(const std::string& name,
+                                      profile_map& profiles) {
+  static std::mutex profiles_mutex;
+  std::lock_guard<std::mutex> lock(profiles_mutex);
+  profile_key key{name, std::this_thread::get_id()};
+  auto p = profiles.find(key);
+  if (p == profiles.end()) {
+    p = profiles.emplace(std::move(key), profile_info(name)).first;
+  }
+  return p->second;
+}
+
+/**
+ * Write the recorded events of all profiles in the Chrome trace event
+ * format, which can be viewed in <code>chrome://tracing</code> or
+ * Perfetto. Forward and reverse passes are complete events in the
+ * categories <code>forward</code> and <code>reverse</code>; nested
+ * regions show up nested in the timeline of their thread. Events are
+ * only recorded while tracing is enabled with
+ * <code>set_profile_tracing()</code>.
+ *
+ * @param o stream to write to
+ * @param profiles map of all profiles
+ */
+inline void write_chrome_trace(std::ostream& o, const profile_map& profiles) {
+  auto origin = std::chrono::time_point<std::chrono::steady_clock>::max();
+  for (const auto& p : profiles) {
+    for (const auto& event : p.second.get_events()) {
+      origin = std::min(origin, event.start);
+    }
+  }
+  std::map<std::thread::id, size_t> thread_ids;
+  const std::ios_base::fmtflags flags = o.flags();
+  const std::streamsize precision = o.precision();
+  o << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+  bool first = true;
+  for (const auto& p : profiles) {
+    const size_t tid
+        = thread_ids.emplace(p.first.second, thread_ids.size()).first->second;
+    for (const auto& event : p.second.get_events()) {
+      o << (first ? "\n" : ",\n") << "{\"name\":";
+      internal::write_json_string(o, p.first.first);
+      o << ",\"cat\":\"" << (event.reverse ? "reverse" : "forward")
+        << "\",\"ph\":\"X\",\"ts\":"
+        << std::chrono::duration<double, std::micro>(event.start - origin)
+               .count()
+        << ",\"dur\":" << event.duration * 1e6 << ",\"pid\":0,\"tid\":" << tid
+        << "}";
+      first = false;
+    }
+  }
+  o << "\n],\"displayTimeUnit\":\"ns\"}\n";
+  o.flags(flags);
+  o.precision(precision);
+}
+
 /**
  * Profiles C++ lines where the object is in scope.
  * When T is var, the constructor starts the profile for the forward pass
@@ -124,27 +395,30 @@ using profile_map = std::map<profile_key, profile_info>;
  * AD tape. The destructor stops the profile for the forward pass and
  * places a var with a callback to start the profile for the reverse pass.
  * When T is not var, the constructor and destructor only profile the
+ * forward pass.
  *
+ * Regions may be nested; each records the innermost region enclosing it
+ * (see <code>profile_info::get_parent()</code>).
  *
  * @tparam T type of profile class. If var, the created object is used
  * to profile reverse mode AD. Only profiles the forward pass otherwise.
  */
 template <typename T>
 class profile {
-  profile_key key_;
   profile_info* profile_;
 
  public:
   profile(std::string name, profile_map& profiles)
-      : key_({name, std::this_thread::get_id()}) {
-    profile_map::iterator p = profiles.find(key_);
-    if (p == profiles.end()) {
-      profiles[key_] = profile_info();
-    }
-    profile_ = &profiles[key_];
+      : profile(register_profile(name, profiles)) {}
+
+  /**
+   * Start profiling a region with a profile obtained from
+   * <code>register_profile()</code> on the calling thread.
+   */
+  explicit profile(profile_info& handle) : profile_(&handle) {
     if (profile_->is_active()) {
       std::ostringstream msg;
-      msg << "Profile '" << key_.first << "' already started!";
+      msg << "Profile '" << profile_->get_name() << "' already started!";
       throw std::runtime_error(msg.str());
     }
     profile_->fwd_pass_start<T>();
@@ -4,6 +4,7 @@
 #include <stan/math/rev/core/vari.hpp>
 #include <stan/math/rev/core/chainablestack.hpp>
 #include <stan/math/rev/core/empty_nested.hpp>
+#include <stan/math/rev/core/stack_stats.hpp>
 #include <stdexcept>
 
 namespace stan {
@@ -21,7 +22,13 @@ static inline void recover_memory() {
         "empty_nested() must be true"
         " before calling recover_memory()");
   }
+#ifdef STAN_MATH_ARENA_STATS
+  internal::update_stack_peaks();
+  ChainableStack::instance_->num_recovered_chainable_allocs_
+      += ChainableStack::instance_->var_alloc_stack_.size();
+#endif
   ChainableStack::instance_->var_stack_.clear();
+  ChainableStack::instance_->soa_segment_ = nullptr;
   ChainableStack::instance_->var_nochain_stack_.clear();
   for (auto &x : ChainableStack::instance_->var_alloc_stack_) {
     delete x;
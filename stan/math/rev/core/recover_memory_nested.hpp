@@ -4,6 +4,7 @@
 #include <stan/math/rev/core/chainable_alloc.hpp>
 #include <stan/math/rev/core/chainablestack.hpp>
 #include <stan/math/rev/core/empty_nested.hpp>
+#include <stan/math/rev/core/stack_stats.hpp>
 #include <stdexcept>
 
 namespace stan {
@@ -26,10 +27,17 @@ static inline void recover_memory_nested() {
         "empty_nested() must be false"
         " before calling recover_memory_nested()");
   }
+#ifdef STAN_MATH_ARENA_STATS
+  internal::update_stack_peaks();
+  ChainableStack::instance_->num_recovered_chainable_allocs_
+      += ChainableStack::instance_->var_alloc_stack_.size()
+         - ChainableStack::instance_->nested_var_alloc_stack_starts_.back();
+#endif
 
   ChainableStack::instance_->var_stack_.resize(
       ChainableStack::instance_->nested_var_stack_sizes_.back());
   ChainableStack::instance_->nested_var_stack_sizes_.pop_back();
+  ChainableStack::instance_->soa_segment_ = nullptr;
 
   ChainableStack::instance_->var_nochain_stack_.resize(
       ChainableStack::instance_->nested_var_nochain_stack_sizes_.back());
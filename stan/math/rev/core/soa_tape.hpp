@@ -0,0 +1,522 @@
+#ifndef STAN_MATH_REV_CORE_SOA_TAPE_HPP
+#define STAN_MATH_REV_CORE_SOA_TAPE_HPP
+
+#include <stan/math/rev/core/chainablestack.hpp>
+#include <stan/math/rev/core/vari.hpp>
+#include <stan/math/prim/fun/constants.hpp>
+#include <cmath>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace stan {
+namespace math {
+namespace internal {
+
+/**
+ * A segment of the structure-of-arrays (SoA) tape.
+ *
+ * Scalar operations with at most two operands and partials known in the
+ * forward pass can be recorded as entries of a segment instead of as
+ * individual varis with a virtual <code>chain()</code>. Each entry stores
+ * a pointer to the adjoint of the result, pointers to the adjoints of
+ * the operands and the partials, in separate contiguous arrays on the
+ * arena. The segment itself sits on <code>var_stack_</code> like any
+ * other vari and its <code>chain()</code> propagates all entries in
+ * reverse order in a single branch free loop.
+ *
+ * Consecutive operations are appended to the segment on top of
+ * <code>var_stack_</code>. As soon as any other vari is put on
+ * <code>var_stack_</code>, nesting starts or memory is recovered, the
+ * next operation starts a new segment, which keeps the order of the
+ * reverse pass intact. Such a segment has room for a single entry, so
+ * a tape on which SoA operations alternate with other varis does not
+ * reserve arena memory for entries that are never used. Full segments
+ * are followed by a new segment with twice the capacity (up to
+ * <code>max_capacity</code>), so long runs of SoA operations still end
+ * up in large segments.
+ *
+ * The results of the operations are plain varis on
+ * <code>var_nochain_stack_</code>, so their adjoints are reset by
+ * <code>set_zero_all_adjoints()</code> as usual.
+ */
+class soa_segment_vari final : public vari_base {
+ public:
+  static constexpr size_t initial_capacity = 1;
+  static constexpr size_t max_capacity = 4096;
+
+  double** res_adj_;
+  double** a_adj_;
+  double** b_adj_;
+  double* da_;
+  double* db_;
+  size_t size_;
+  size_t capacity_;
+  double sink_;  // adjoint target for operations with a single operand
+
+  explicit soa_segment_vari(size_t capacity)
+      : res_adj_(ChainableStack::instance_->memalloc_.alloc_array<double*>(
+            3 * capacity)),
+        a_adj_(res_adj_ + capacity),
+        b_adj_(a_adj_ + capacity),
+        da_(ChainableStack::instance_->memalloc_.alloc_array<double>(
+            2 * capacity)),
+        db_(da_ + capacity),
+        size_(0),
+        capacity_(capacity),
+        sink_(0) {
+    ChainableStack::instance_->var_stack_.push_back(this);
+  }
+
+  inline void chain() final {
+    for (size_t k = size_; k-- > 0;) {
+      const double adj = *res_adj_[k];
+      *a_adj_[k] += adj * da_[k];
+      *b_adj_[k] += adj * db_[k];
+    }
+  }
+
+  inline void set_zero_adjoint() final { sink_ = 0; }
+
+  /**
+   * Append an entry to the segment. The segment must not be full.
+   */
+  inline void push(double* res_adj, double* a_adj, double da, double* b_adj,
+                   double db) noexcept {
+    res_adj_[size_] = res_adj;
+    a_adj_[size_] = a_adj;
+    b_adj_[size_] = b_adj;
+    da_[size_] = da;
+    db_[size_] = db;
+    ++size_;
+  }
+};
+
+/**
+ * Return the segment new operations are appended to, starting a new
+ * segment if there is no open one or it is full.
+ */
+inline soa_segment_vari* soa_open_segment() {
+  auto& stack = *ChainableStack::instance_;
+  auto* seg = static_cast<soa_segment_vari*>(stack.soa_segment_);
+  if (likely(seg != nullptr && stack.var_stack_.back() == seg
+             && seg->size_ < seg->capacity_)) {
+    return seg;
+  }
+  size_t capacity = soa_segment_vari::initial_capacity;
+  if (seg != nullptr && stack.var_stack_.back() == seg) {
+    capacity = 2 * seg->capacity_ < soa_segment_vari::max_capacity
+                   ? 2 * seg->capacity_
+                   : soa_segment_vari::max_capacity;
+  }
+  seg = new soa_segment_vari(capacity);
+  stack.soa_segment_ = seg;
+  return seg;
+}
+
+/**
+ * Operations which can be recorded on the SoA tape.
+ */
+enum class soa_op : unsigned char {
+  add,
+  subtract,
+  multiply,
+  divide,
+  negate,
+  exp,
+  log
+};
+
+/**
+ * Comparisons which can be recorded as guards of a replayable tape.
+ */
+enum class soa_cmp : unsigned char {
+  less,
+  less_equal,
+  greater,
+  greater_equal,
+  equal,
+  not_equal
+};
+
+/**
+ * Return the value of an operation and set its partials.
+ *
+ * This is the only place the SoA operations are defined, so recording
+ * and replaying them (see <code>soa_tape_recorder</code>) give
+ * identical results.
+ *
+ * @param op operation
+ * @param a first operand
+ * @param b second operand, ignored by unary operations
+ * @param[out] da partial with respect to the first operand
+ * @param[out] db partial with respect to the second operand
+ * @return value of the result
+ */
+inline double soa_eval(soa_op op, double a, double b, double& da,
+                       double& db) {
+  switch (op) {
+    case soa_op::add: {
+      const double val = a + b;
+      da = unlikely(std::isnan(val)) ? NOT_A_NUMBER : 1.0;
+      db = da;
+      return val;
+    }
+    case soa_op::subtract: {
+      const double val = a - b;
+      const bool nan = unlikely(std::isnan(val));
+      da = nan ? NOT_A_NUMBER : 1.0;
+      db = nan ? NOT_A_NUMBER : -1.0;
+      return val;
+    }
+    case soa_op::multiply: {
+      const bool nan = unlikely(std::isnan(a) || std::isnan(b));
+      da = nan ? NOT_A_NUMBER : b;
+      db = nan ? NOT_A_NUMBER : a;
+      return a * b;
+    }
+    case soa_op::divide: {
+      const bool nan = unlikely(std::isnan(a) || std::isnan(b));
+      da = nan ? NOT_A_NUMBER : 1.0 / b;
+      db = nan ? NOT_A_NUMBER : -a / (b * b);
+      return a / b;
+    }
+    case soa_op::negate:
+      da = unlikely(std::isnan(a)) ? NOT_A_NUMBER : -1.0;
+      db = 0.0;
+      return -a;
+    case soa_op::exp: {
+      const double val = std::exp(a);
+      da = val;
+      db = 0.0;
+      return val;
+    }
+    case soa_op::log:
+      da = 1.0 / a;
+      db = 0.0;
+      return std::log(a);
+  }
+  return NOT_A_NUMBER;
+}
+
+/**
+ * Return the outcome of a comparison.
+ */
+inline bool soa_compare(soa_cmp cmp, double a, double b) {
+  switch (cmp) {
+    case soa_cmp::less:
+      return a < b;
+    case soa_cmp::less_equal:
+      return a <= b;
+    case soa_cmp::greater:
+      return a > b;
+    case soa_cmp::greater_equal:
+      return a >= b;
+    case soa_cmp::equal:
+      return a == b;
+    case soa_cmp::not_equal:
+      return a != b;
+  }
+  return false;
+}
+
+/**
+ * Program recorded from the operations on the SoA tape, which can be
+ * replayed for new inputs without running the code that created it.
+ *
+ * While a recorder is installed in <code>soa_recorder_</code> of the
+ * autodiff stack, every SoA operation appends an instruction and every
+ * comparison of vars appends a guard. Values live in slots: slot 0 is a
+ * sink for the missing operand of unary operations, the inputs follow,
+ * and every result and every constant operand gets a slot of its own.
+ * Each slot is written at most once, so a replay evaluates the
+ * instructions in order, checks that all guards still hold and runs the
+ * reverse pass over plain arrays.
+ *
+ * Operands which are neither inputs nor results of recorded operations
+ * are treated as constants. The recording is only a faithful copy of the
+ * computation if no other varis were put on <code>var_stack_</code> and
+ * no decision depended on values other than through var comparisons;
+ * see <code>taped_gradient</code>.
+ */
+class soa_tape_recorder {
+ public:
+  struct instruction {
+    soa_op op;
+    size_t res;
+    size_t a;
+    size_t b;
+  };
+
+  struct guard {
+    soa_cmp cmp;
+    bool outcome;
+    size_t a;
+    size_t b;
+  };
+
+  std::vector<instruction> instructions_;
+  std::vector<guard> guards_;
+  std::vector<double> values_;  // slot values, at record time until replayed
+  std::vector<double> adjs_;    // slot adjoints after reverse()
+  std::vector<double> da_;      // partials of the instructions
+  std::vector<double> db_;
+  std::unordered_map<const vari*, size_t> slots_;
+  size_t num_inputs_ = 0;
+  bool nested_ = false;  // nested autodiff was started while recording
+
+  soa_tape_recorder() : values_(1, 0.0) {}
+
+  /**
+   * Discard the recording.
+   */
+  inline void clear() {
+    instructions_.clear();
+    guards_.clear();
+    values_.assign(1, 0.0);
+    slots_.clear();
+    num_inputs_ = 0;
+    nested_ = false;
+  }
+
+  /**
+   * Register the next input. Inputs must be added before anything is
+   * recorded.
+   */
+  inline void add_input(const vari* vi) {
+    slots_[vi] = values_.size();
+    values_.push_back(vi->val_);
+    ++num_inputs_;
+  }
+
+  /**
+   * Return the slot of a vari, adding a constant slot for varis the
+   * recording has not seen before.
+   */
+  inline size_t operand(const vari* vi) {
+    auto it = slots_.find(vi);
+    if (it != slots_.end()) {
+      return it->second;
+    }
+    const size_t slot = values_.size();
+    slots_.emplace(vi, slot);
+    values_.push_back(vi->val_);
+    return slot;
+  }
+
+  /**
+   * Return a new constant slot.
+   */
+  inline size_t operand(double x) {
+    values_.push_back(x);
+    return values_.size() - 1;
+  }
+
+  inline void record(soa_op op, const vari* res, size_t a, size_t b) {
+    const size_t slot = values_.size();
+    slots_[res] = slot;
+    values_.push_back(res->val_);
+    instructions_.push_back({op, slot, a, b});
+  }
+
+  inline void record_guard(soa_cmp cmp, bool outcome, size_t a, size_t b) {
+    guards_.push_back({cmp, outcome, a, b});
+  }
+
+  /**
+   * Return the slot holding the value of a vari, or
+   * <code>values_.size()</code> if the recording has not seen it.
+   */
+  inline size_t find(const vari* vi) const {
+    auto it = slots_.find(vi);
+    return it == slots_.end() ? values_.size() : it->second;
+  }
+
+  /**
+   * Evaluate the recording for new inputs.
+   *
+   * @tparam EigVec type of the inputs
+   * @param x inputs, in the order they were added
+   * @return <code>true</code> if all guards hold and no slot is NaN,
+   * i.e. the recording describes the computation at <code>x</code>
+   */
+  template <typename EigVec>
+  inline bool forward(const EigVec& x) {
+    for (size_t i = 0; i < num_inputs_; ++i) {
+      values_[i + 1] = x.coeff(i);
+    }
+    da_.resize(instructions_.size());
+    db_.resize(instructions_.size());
+    for (size_t k = 0; k < instructions_.size(); ++k) {
+      const instruction& ins = instructions_[k];
+      values_[ins.res]
+          = soa_eval(ins.op, values_[ins.a], values_[ins.b], da_[k], db_[k]);
+    }
+    for (const guard& g : guards_) {
+      if (soa_compare(g.cmp, values_[g.a], values_[g.b]) != g.outcome) {
+        return false;
+      }
+    }
+    return !has_nan();
+  }
+
+  /**
+   * Return <code>true</code> if any slot holds NaN. Functions such as
+   * <code>fmax()</code> branch on NaN arguments without a comparison of
+   * vars, so a recording or replay involving NaN is not trusted.
+   */
+  inline bool has_nan() const {
+    for (double v : values_) {
+      if (unlikely(std::isnan(v))) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * Return <code>true</code> if the slot holds the result of a recorded
+   * instruction, as opposed to an input or a constant.
+   */
+  inline bool is_result(size_t slot) const {
+    for (const instruction& ins : instructions_) {
+      if (ins.res == slot) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * Propagate the adjoint of one slot, set to one, back to all slots
+   * using the partials of the last call to <code>forward()</code>.
+   */
+  inline void reverse(size_t out) {
+    adjs_.assign(values_.size(), 0.0);
+    adjs_[out] = 1.0;
+    for (size_t k = instructions_.size(); k-- > 0;) {
+      const instruction& ins = instructions_[k];
+      const double adj = adjs_[ins.res];
+      adjs_[ins.a] += adj * da_[k];
+      adjs_[ins.b] += adj * db_[k];
+    }
+  }
+};
+
+/**
+ * Record a binary operation on two variables on the SoA tape.
+ *
+ * @param op operation
+ * @param avi first operand
+ * @param bvi second operand
+ * @return vari holding the result
+ */
+inline vari* soa_record(soa_op op, vari* avi, vari* bvi) {
+  double da;
+  double db;
+  const double val = soa_eval(op, avi->val_, bvi->val_, da, db);
+  soa_segment_vari* seg = soa_open_segment();
+  vari* res = new vari(val, false);
+  seg->push(&res->adj_, &avi->adj_, da, &bvi->adj_, db);
+  soa_tape_recorder* rec = ChainableStack::instance_->soa_recorder_;
+  if (unlikely(rec != nullptr)) {
+    rec->record(op, res, rec->operand(avi), rec->operand(bvi));
+  }
+  return res;
+}
+
+/**
+ * Record a binary operation on a variable and a constant on the SoA
+ * tape.
+ *
+ * @param op operation
+ * @param avi first operand
+ * @param b second operand
+ * @return vari holding the result
+ */
+inline vari* soa_record(soa_op op, vari* avi, double b) {
+  double da;
+  double db;
+  const double val = soa_eval(op, avi->val_, b, da, db);
+  soa_segment_vari* seg = soa_open_segment();
+  vari* res = new vari(val, false);
+  seg->push(&res->adj_, &avi->adj_, da, &seg->sink_, 0.0);
+  soa_tape_recorder* rec = ChainableStack::instance_->soa_recorder_;
+  if (unlikely(rec != nullptr)) {
+    rec->record(op, res, rec->operand(avi), rec->operand(b));
+  }
+  return res;
+}
+
+/**
+ * Record a binary operation on a constant and a variable on the SoA
+ * tape.
+ *
+ * @param op operation
+ * @param a first operand
+ * @param bvi second operand
+ * @return vari holding the result
+ */
+inline vari* soa_record(soa_op op, double a, vari* bvi) {
+  double da;
+  double db;
+  const double val = soa_eval(op, a, bvi->val_, da, db);
+  soa_segment_vari* seg = soa_open_segment();
+  vari* res = new vari(val, false);
+  seg->push(&res->adj_, &bvi->adj_, db, &seg->sink_, 0.0);
+  soa_tape_recorder* rec = ChainableStack::instance_->soa_recorder_;
+  if (unlikely(rec != nullptr)) {
+    rec->record(op, res, rec->operand(a), rec->operand(bvi));
+  }
+  return res;
+}
+
+/**
+ * Record a unary operation on the SoA tape.
+ *
+ * @param op operation
+ * @param avi operand
+ * @return vari holding the result
+ */
+inline vari* soa_record(soa_op op, vari* avi) {
+  double da;
+  double db;
+  const double val = soa_eval(op, avi->val_, 0.0, da, db);
+  soa_segment_vari* seg = soa_open_segment();
+  vari* res = new vari(val, false);
+  seg->push(&res->adj_, &avi->adj_, da, &seg->sink_, 0.0);
+  soa_tape_recorder* rec = ChainableStack::instance_->soa_recorder_;
+  if (unlikely(rec != nullptr)) {
+    rec->record(op, res, rec->operand(avi), 0);
+  }
+  return res;
+}
+
+inline double soa_value(const vari* vi) { return vi->val_; }
+inline double soa_value(double x) { return x; }
+
+/**
+ * Return the outcome of a comparison of vars or of a var and a
+ * constant, recording it as a guard if a recorder is installed.
+ *
+ * @tparam T1 <code>vari*</code> or arithmetic type
+ * @tparam T2 <code>vari*</code> or arithmetic type
+ * @param cmp comparison
+ * @param a first operand
+ * @param b second operand
+ * @return outcome of the comparison
+ */
+template <typename T1, typename T2>
+inline bool soa_guard(soa_cmp cmp, const T1& a, const T2& b) {
+  const bool outcome = soa_compare(cmp, soa_value(a), soa_value(b));
+  soa_tape_recorder* rec = ChainableStack::instance_->soa_recorder_;
+  if (unlikely(rec != nullptr)) {
+    rec->record_guard(cmp, outcome, rec->operand(a), rec->operand(b));
+  }
+  return outcome;
+}
+
+}  // namespace internal
+}  // namespace math
+}  // namespace stan
+#endif
@@ -0,0 +1,88 @@
+#ifndef STAN_MATH_REV_CORE_STACK_STATS_HPP
+#define STAN_MATH_REV_CORE_STACK_STATS_HPP
+
+#include <stan/math/rev/core/chainablestack.hpp>
+#include <stan/math/memory/stack_alloc.hpp>
+#include <algorithm>
+#include <cstddef>
+
+#ifdef STAN_MATH_ARENA_STATS
+namespace stan {
+namespace math {
+
+/**
+ * Snapshot of the usage of the autodiff stack of the current thread.
+ *
+ * The statistics are opt-in: they and the counters behind them only
+ * exist if <code>STAN_MATH_ARENA_STATS</code> is defined.
+ *
+ * The peak stack sizes are tracked when memory is recovered, so they
+ * cover everything since the last call to <code>reset_stack_stats()</code>
+ * without adding any work when varis are pushed on the stacks.
+ */
+struct autodiff_stack_stats {
+  size_t var_stack_size = 0;          // current length of var_stack_
+  size_t var_nochain_stack_size = 0;  // current length of var_nochain_stack_
+  size_t var_stack_peak = 0;          // peak length of var_stack_
+  size_t var_nochain_stack_peak = 0;  // peak length of var_nochain_stack_
+  size_t chainable_alloc_peak = 0;    // peak live chainable_alloc objects
+  size_t chainable_allocs = 0;        // chainable_alloc objects created
+  stack_alloc_stats memalloc;         // arena statistics
+};
+
+namespace internal {
+/**
+ * Fold the current sizes of the autodiff stacks into their recorded
+ * peaks.
+ */
+static inline void update_stack_peaks() {
+  auto& stack = *ChainableStack::instance_;
+  stack.peak_var_stack_size_
+      = std::max(stack.peak_var_stack_size_, stack.var_stack_.size());
+  stack.peak_var_nochain_stack_size_ = std::max(
+      stack.peak_var_nochain_stack_size_, stack.var_nochain_stack_.size());
+  stack.peak_var_alloc_stack_size_ = std::max(
+      stack.peak_var_alloc_stack_size_, stack.var_alloc_stack_.size());
+}
+}  // namespace internal
+
+/**
+ * Return a snapshot of the usage statistics of the autodiff stack of
+ * the current thread.
+ *
+ * @return statistics since the stack was created or since the last call
+ * to <code>reset_stack_stats()</code>
+ */
+static inline autodiff_stack_stats get_stack_stats() {
+  internal::update_stack_peaks();
+  const auto& stack = *ChainableStack::instance_;
+  autodiff_stack_stats stats;
+  stats.var_stack_size = stack.var_stack_.size();
+  stats.var_nochain_stack_size = stack.var_nochain_stack_.size();
+  stats.var_stack_peak = stack.peak_var_stack_size_;
+  stats.var_nochain_stack_peak = stack.peak_var_nochain_stack_size_;
+  stats.chainable_alloc_peak = stack.peak_var_alloc_stack_size_;
+  stats.chainable_allocs
+      = stack.num_recovered_chainable_allocs_ + stack.var_alloc_stack_.size();
+  stats.memalloc = stack.memalloc_.stats();
+  return stats;
+}
+
+/**
+ * Reset the usage statistics of the autodiff stack of the current
+ * thread. Peaks restart from the current sizes of the stacks and
+ * chainable_alloc objects which are still alive are counted again.
+ */
+static inline void reset_stack_stats() {
+  auto& stack = *ChainableStack::instance_;
+  stack.peak_var_stack_size_ = stack.var_stack_.size();
+  stack.peak_var_nochain_stack_size_ = stack.var_nochain_stack_.size();
+  stack.peak_var_alloc_stack_size_ = stack.var_alloc_stack_.size();
+  stack.num_recovered_chainable_allocs_ = 0;
+  stack.memalloc_.reset_stats();
+}
+
+}  // namespace math
+}  // namespace stan
+#endif
+#endif
@@ -2,6 +2,7 @@
 #define STAN_MATH_REV_CORE_START_NESTED_HPP
 
 #include <stan/math/rev/core/chainablestack.hpp>
+#include <stan/math/rev/core/soa_tape.hpp>
 
 namespace stan {
 namespace math {
@@ -21,6 +22,10 @@ static inline void start_nested() {
   ChainableStack::instance_->nested_var_alloc_stack_starts_.push_back(
       ChainableStack::instance_->var_alloc_stack_.size());
   ChainableStack::instance_->memalloc_.start_nested();
+  ChainableStack::instance_->soa_segment_ = nullptr;
+  if (ChainableStack::instance_->soa_recorder_) {
+    ChainableStack::instance_->soa_recorder_->nested_ = true;
+  }
 }
 
 }  // namespace math
@@ -2,6 +2,7 @@
 #define STAN_MATH_REV_CORE_V_VARI_HPP
 
 #include <stan/math/rev/core/vari.hpp>
+#include <vector>
 
 namespace stan {
 namespace math {
@@ -12,6 +13,11 @@ class op_v_vari : public vari {
 
  public:
   op_v_vari(double f, vari* avi) : vari(f), avi_(avi) {}
+
+  bool trace_operands(std::vector<const void*>& operands) const final {
+    operands.push_back(avi_);
+    return true;
+  }
 };
 
 }  // namespace math
@@ -7,6 +7,7 @@
 #include <stan/math/prim/meta.hpp>
 #include <ostream>
 #include <type_traits>
+#include <vector>
 
 namespace stan {
 namespace math {
@@ -163,6 +164,24 @@ class vari_value<T, require_t<std::is_floating_point<T>>> : public vari_base {
 
   inline void chain() {}
 
+  /**
+   * Append the addresses of the varis whose adjoints <code>chain()</code>
+   * updates, possibly among other addresses, and return
+   * <code>true</code>, or return <code>false</code> if they are not
+   * known.
+   *
+   * This is used to trace the dependencies on the tape in a single pass
+   * (see <code>internal::trace_tape()</code>), so it may only return
+   * <code>true</code> for varis whose <code>chain()</code> reads no
+   * adjoint other than their own.
+   *
+   * @param[in, out] operands Addresses of the operands
+   * @return <code>true</code> if the operands were appended
+   */
+  virtual bool trace_operands(std::vector<const void*>& operands) const {
+    return false;
+  }
+
   /**
    * Initialize the adjoint for this (dependent) variable to 1.
    * This operation is applied to the dependent variable before
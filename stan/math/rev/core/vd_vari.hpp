@@ -2,6 +2,7 @@
 #define STAN_MATH_REV_CORE_VD_VARI_HPP
 
 #include <stan/math/rev/core/vari.hpp>
+#include <vector>
 
 namespace stan {
 namespace math {
@@ -13,6 +14,11 @@ class op_vd_vari : public vari {
 
  public:
   op_vd_vari(double f, vari* avi, double b) : vari(f), avi_(avi), bd_(b) {}
+
+  bool trace_operands(std::vector<const void*>& operands) const final {
+    operands.push_back(avi_);
+    return true;
+  }
 };
 
 }  // namespace math
@@ -2,6 +2,7 @@
 #define STAN_MATH_REV_CORE_VDD_VARI_HPP
 
 #include <stan/math/rev/core/vari.hpp>
+#include <vector>
 
 namespace stan {
 namespace math {
@@ -15,6 +16,11 @@ class op_vdd_vari : public vari {
  public:
   op_vdd_vari(double f, vari* avi, double b, double c)
       : vari(f), avi_(avi), bd_(b), cd_(c) {}
+
+  bool trace_operands(std::vector<const void*>& operands) const final {
+    operands.push_back(avi_);
+    return true;
+  }
 };
 
 }  // namespace math
@@ -2,6 +2,7 @@
 #define STAN_MATH_REV_CORE_VDV_VARI_HPP
 
 #include <stan/math/rev/core/vari.hpp>
+#include <vector>
 
 namespace stan {
 namespace math {
@@ -15,6 +16,11 @@ class op_vdv_vari : public vari {
  public:
   op_vdv_vari(double f, vari* avi, double b, vari* cvi)
       : vari(f), avi_(avi), bd_(b), cvi_(cvi) {}
+
+  bool trace_operands(std::vector<const void*>& operands) const final {
+    operands.insert(operands.end(), {avi_, cvi_});
+    return true;
+  }
 };
 
 }  // namespace math
@@ -2,6 +2,7 @@
 #define STAN_MATH_REV_CORE_VV_VARI_HPP
 
 #include <stan/math/rev/core/vari.hpp>
+#include <vector>
 
 namespace stan {
 namespace math {
@@ -13,6 +14,11 @@ class op_vv_vari : public vari {
 
  public:
   op_vv_vari(double f, vari* avi, vari* bvi) : vari(f), avi_(avi), bvi_(bvi) {}
+
+  bool trace_operands(std::vector<const void*>& operands) const final {
+    operands.insert(operands.end(), {avi_, bvi_});
+    return true;
+  }
 };
 
 }  // namespace math
@@ -2,6 +2,7 @@
 #define STAN_MATH_REV_CORE_VVV_VARI_HPP
 
 #include <stan/math/rev/core/vari.hpp>
+#include <vector>
 
 namespace stan {
 namespace math {
@@ -15,6 +16,11 @@ class op_vvv_vari : public vari {
  public:
   op_vvv_vari(double f, vari* avi, vari* bvi, vari* cvi)
       : vari(f), avi_(avi), bvi_(bvi), cvi_(cvi) {}
+
+  bool trace_operands(std::vector<const void*>& operands) const final {
+    operands.insert(operands.end(), {avi_, bvi_, cvi_});
+    return true;
+  }
 };
 
 }  // namespace math
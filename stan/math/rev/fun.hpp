@@ -70,6 +70,11 @@
 #include <stan/math/rev/fun/gamma_p.hpp>
 #include <stan/math/rev/fun/gamma_q.hpp>
 #include <stan/math/rev/fun/generalized_inverse.hpp>
+#include <stan/math/rev/fun/gp_dot_prod_cov.hpp>
+#include <stan/math/rev/fun/gp_exponential_cov.hpp>
+#include <stan/math/rev/fun/gp_isotropic_cov.hpp>
+#include <stan/math/rev/fun/gp_matern32_cov.hpp>
+#include <stan/math/rev/fun/gp_matern52_cov.hpp>
 #include <stan/math/rev/fun/gp_periodic_cov.hpp>
 #include <stan/math/rev/fun/grad.hpp>
 #include <stan/math/rev/fun/grad_inc_beta.hpp>
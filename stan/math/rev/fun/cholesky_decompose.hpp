@@ -12,6 +12,8 @@
 #include <stan/math/prim/err/check_pos_definite.hpp>
 #include <stan/math/prim/err/check_square.hpp>
 #include <stan/math/prim/err/check_symmetric.hpp>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
 #include <algorithm>
 #include <vector>
 
@@ -71,16 +73,55 @@ inline auto unblocked_cholesky_lambda(T1& L_A, T2& L, T3& A) {
   };
 }
 
+/**
+ * Number of rows (or columns) of a tile of the panel updates in
+ * `cholesky_lambda`.
+ */
+constexpr Eigen::Index cholesky_tile_size = 256;
+
+/**
+ * Applies `f` to the tiles `[begin, end)` of the range `[0, n)`. If
+ * STAN_THREADS is defined and the range holds more than one tile, the
+ * tiles are distributed over the threads of the TBB thread pool,
+ * otherwise they are processed in order, so that both builds split the
+ * work the same way.
+ *
+ * @tparam F type of the functor
+ * @param n size of the range
+ * @param f functor called with the first and one past the last index of
+ * a tile
+ */
+template <typename F>
+inline void cholesky_tiles(Eigen::Index n, const F& f) {
+#ifdef STAN_THREADS
+  if (n > cholesky_tile_size) {
+    tbb::parallel_for(
+        tbb::blocked_range<Eigen::Index>(0, n, cholesky_tile_size),
+        [&f](const tbb::blocked_range<Eigen::Index>& r) {
+          f(r.begin(), r.end());
+        });
+    return;
+  }
+#endif
+  for (Eigen::Index begin = 0; begin < n; begin += cholesky_tile_size) {
+    f(begin, std::min(begin + cholesky_tile_size, n));
+  }
+}
+
 /**
  * Reverse mode differentiation algorithm reference:
  *
  * Iain Murray: Differentiation of the Cholesky decomposition, 2016.
  *
+ * The adjoint is propagated one diagonal block at a time, from the bottom
+ * right corner. The panel below the diagonal block and the panel to its
+ * left are updated with triangular solves and matrix products on tiles of
+ * rows and columns respectively, which only touch disjoint parts of the
+ * adjoint, so with STAN_THREADS the tiles run in parallel.
  */
 template <typename T1, typename T2, typename T3>
 inline auto cholesky_lambda(T1& L_A, T2& L, T3& A) {
   return [L_A, L, A]() mutable {
-    using Block_ = Eigen::Block<Eigen::MatrixXd>;
     using Eigen::Lower;
     using Eigen::StrictlyUpper;
     using Eigen::Upper;
@@ -101,10 +142,12 @@ inline auto cholesky_lambda(T1& L_A, T2& L, T3& A) {
       auto C_adj = L_adj.block(k, j, M_ - k, k - j);
       D.transposeInPlace();
       if (C_adj.size() > 0) {
-        C_adj = D.template triangularView<Upper>()
-                    .solve(C_adj.transpose())
-                    .transpose();
-        B_adj.noalias() -= C_adj * R;
+        cholesky_tiles(C_adj.rows(), [&](Eigen::Index begin, Eigen::Index end) {
+          auto C_adj_tile = C_adj.middleRows(begin, end - begin);
+          D.template triangularView<Upper>().solveInPlace(
+              C_adj_tile.transpose());
+          B_adj.middleRows(begin, end - begin).noalias() -= C_adj_tile * R;
+        });
         D_adj.noalias() -= C_adj.transpose() * C;
       }
       D_adj = (D * D_adj.template triangularView<Lower>()).eval();
@@ -112,8 +155,13 @@ inline auto cholesky_lambda(T1& L_A, T2& L, T3& A) {
           = D_adj.adjoint().template triangularView<StrictlyUpper>();
       D.template triangularView<Upper>().solveInPlace(D_adj);
       D.template triangularView<Upper>().solveInPlace(D_adj.transpose());
-      R_adj.noalias() -= C_adj.transpose() * B;
-      R_adj.noalias() -= D_adj.template selfadjointView<Lower>() * R;
+      cholesky_tiles(R_adj.cols(), [&](Eigen::Index begin, Eigen::Index end) {
+        auto R_adj_tile = R_adj.middleCols(begin, end - begin);
+        R_adj_tile.noalias()
+            -= C_adj.transpose() * B.middleCols(begin, end - begin);
+        R_adj_tile.noalias() -= D_adj.template selfadjointView<Lower>()
+                                * R.middleCols(begin, end - begin);
+      });
       D_adj.diagonal() *= 0.5;
     }
     A.adj().template triangularView<Eigen::Lower>() += L_adj;
@@ -16,7 +16,7 @@ namespace stan {
 namespace math {
 
 /**
- * @deprecated use <code>gp_exp_quad_cov_vari</code>
+ * @deprecated use <code>gp_exp_quad_cov</code>
  */
 template <typename T_x, typename T_sigma, typename T_l>
 class cov_exp_quad_vari : public vari {
@@ -33,7 +33,7 @@ class cov_exp_quad_vari : public vari {
   vari** cov_diag_;
 
   /**
-   * @deprecated use <code>gp_exp_quad_cov_vari</code>
+   * @deprecated use <code>gp_exp_quad_cov</code>
    */
   cov_exp_quad_vari(const std::vector<T_x>& x, const T_sigma& sigma,
                     const T_l& l)
@@ -87,7 +87,7 @@ class cov_exp_quad_vari : public vari {
 };
 
 /**
- * @deprecated use <code>gp_exp_quad_cov_vari</code>
+ * @deprecated use <code>gp_exp_quad_cov</code>
  */
 template <typename T_x, typename T_l>
 class cov_exp_quad_vari<T_x, double, T_l> : public vari {
@@ -103,7 +103,7 @@ class cov_exp_quad_vari<T_x, double, T_l> : public vari {
   vari** cov_diag_;
 
   /**
-   * @deprecated use <code>gp_exp_quad_cov_vari</code>
+   * @deprecated use <code>gp_exp_quad_cov</code>
    */
   cov_exp_quad_vari(const std::vector<T_x>& x, double sigma, const T_l& l)
       : vari(0.0),
@@ -147,7 +147,7 @@ class cov_exp_quad_vari<T_x, double, T_l> : public vari {
 };
 
 /**
- * @deprecated use <code>gp_exp_quad_cov_vari</code>
+ * @deprecated use <code>gp_exp_quad_cov</code>
  */
 template <typename T_x,
           typename = require_arithmetic_t<typename scalar_type<T_x>::type>>
@@ -157,7 +157,7 @@ inline Eigen::Matrix<var, -1, -1> cov_exp_quad(const std::vector<T_x>& x,
 }
 
 /**
- * @deprecated use <code>gp_exp_quad_cov_vari</code>
+ * @deprecated use <code>gp_exp_quad_cov</code>
  */
 template <typename T_x,
           typename = require_arithmetic_t<typename scalar_type<T_x>::type>>
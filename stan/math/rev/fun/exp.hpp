@@ -46,7 +46,13 @@ class exp_vari : public op_v_vari {
  * @param a Variable to exponentiate.
  * @return Exponentiated variable.
  */
-inline var exp(const var& a) { return var(new internal::exp_vari(a.vi_)); }
+inline var exp(const var& a) {
+#ifdef STAN_MATH_SOA_TAPE
+  return {internal::soa_record(internal::soa_op::exp, a.vi_)};
+#else
+  return var(new internal::exp_vari(a.vi_));
+#endif
+}
 
 /**
  * Return the exponentiation (base e) of the specified complex number.
@@ -48,11 +48,16 @@ namespace math {
  * @return Absolute value of variable.
  */
 inline var fabs(const var& a) {
-  if (a.val() > 0.0) {
+  // comparisons of vars are recorded as guards of a replayable SoA tape
+  if (a > 0.0) {
     return a;
-  } else if (a.val() < 0.0) {
+  } else if (a < 0.0) {
+#ifdef STAN_MATH_SOA_TAPE
+    return -a;
+#else
     return var(new internal::neg_vari(a.vi_));
-  } else if (a.val() == 0) {
+#endif
+  } else if (a == 0) {
     return var(new vari(0));
   } else {
     return var(new precomp_v_vari(NOT_A_NUMBER, a.vi_, NOT_A_NUMBER));
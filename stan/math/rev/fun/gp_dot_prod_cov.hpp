@@ -0,0 +1,217 @@
+#ifndef STAN_MATH_REV_FUN_GP_DOT_PROD_COV_HPP
+#define STAN_MATH_REV_FUN_GP_DOT_PROD_COV_HPP
+
+#include <stan/math/rev/meta.hpp>
+#include <stan/math/rev/core.hpp>
+#include <stan/math/prim/err.hpp>
+#include <stan/math/prim/fun/Eigen.hpp>
+#include <stan/math/prim/fun/square.hpp>
+#include <vector>
+
+namespace stan {
+namespace math {
+namespace internal {
+
+/**
+ * Check the input vectors of the dot product covariance and return them
+ * as the columns of a matrix.
+ *
+ * @param x std::vector of vectors of the same size
+ * @return matrix with the input vectors as columns
+ * @throw std::domain_error if x is nan or infinite
+ * @throw std::invalid_argument if the vectors of x have different sizes
+ */
+inline Eigen::MatrixXd gp_dot_prod_cov_inputs(
+    const std::vector<Eigen::VectorXd> &x) {
+  const size_t x_size = x.size();
+  for (size_t i = 0; i < x_size; ++i) {
+    check_not_nan("gp_dot_prod_cov", "x", x[i]);
+    check_finite("gp_dot_prod_cov", "x", x[i]);
+  }
+  if (x_size == 0) {
+    return Eigen::MatrixXd(0, 0);
+  }
+  Eigen::MatrixXd x_mat(x[0].size(), x_size);
+  for (size_t i = 0; i < x_size; ++i) {
+    check_size_match("gp_dot_prod_cov", "x row", x[0].size(), "x's other row",
+                     x[i].size());
+    x_mat.col(i) = x[i];
+  }
+  return x_mat;
+}
+
+/**
+ * Check the input scalars of the dot product covariance and return them
+ * as the columns of a row vector.
+ *
+ * @param x std::vector of doubles
+ * @return row vector of the inputs
+ * @throw std::domain_error if x is nan or infinite
+ */
+inline Eigen::MatrixXd gp_dot_prod_cov_inputs(const std::vector<double> &x) {
+  check_not_nan("gp_dot_prod_cov", "x", x);
+  check_finite("gp_dot_prod_cov", "x", x);
+  return Eigen::Map<const Eigen::RowVectorXd>(x.data(), x.size());
+}
+
+/**
+ * Check sigma of the dot product covariance.
+ *
+ * @param sigma constant function
+ * @throw std::domain_error if sigma < 0, nan or inf
+ */
+inline void gp_dot_prod_cov_check_sigma(const var &sigma) {
+  check_not_nan("gp_dot_prod_cov", "sigma", sigma);
+  check_nonnegative("gp_dot_prod_cov", "sigma", sigma);
+  check_finite("gp_dot_prod_cov", "sigma", sigma);
+}
+
+/**
+ * Returns the lower triangle of the dot product covariance matrix of the
+ * columns of a matrix, computed with one symmetric rank update.
+ *
+ * @param x_mat matrix with the input vectors as columns
+ * @param sigma_val value of the constant function
+ * @return matrix whose lower triangle holds the covariances
+ */
+inline Eigen::MatrixXd gp_dot_prod_cov_lower(const Eigen::MatrixXd &x_mat,
+                                             double sigma_val) {
+  Eigen::MatrixXd cov_val = Eigen::MatrixXd::Constant(
+      x_mat.cols(), x_mat.cols(), square(sigma_val));
+  cov_val.selfadjointView<Eigen::Lower>().rankUpdate(x_mat.transpose());
+  return cov_val;
+}
+
+/**
+ * Returns the dot product covariance matrix of the columns of a matrix.
+ *
+ * The Gram matrix of the columns is computed with one symmetric rank
+ * update and the matrix of vars shares one vari between the symmetric
+ * elements, none of which is chained. A single reverse pass callback
+ * propagates the adjoints of the matrix to sigma.
+ *
+ * @param x_mat matrix with the input vectors as columns
+ * @param sigma constant function
+ * @return dot product covariance matrix
+ */
+inline Eigen::Matrix<var, Eigen::Dynamic, Eigen::Dynamic> gp_dot_prod_cov(
+    const Eigen::MatrixXd &x_mat, const var &sigma) {
+  const Eigen::Index x_size = x_mat.cols();
+  Eigen::Matrix<var, Eigen::Dynamic, Eigen::Dynamic> cov(x_size, x_size);
+  if (x_size == 0) {
+    return cov;
+  }
+
+  const double sigma_val = sigma.val();
+  const Eigen::MatrixXd cov_val = gp_dot_prod_cov_lower(x_mat, sigma_val);
+  arena_t<Eigen::Matrix<var, Eigen::Dynamic, 1>> cov_lower(
+      x_size * (x_size + 1) / 2);
+  Eigen::Index pos = 0;
+  for (Eigen::Index j = 0; j < x_size; ++j) {
+    for (Eigen::Index i = j; i < x_size; ++i) {
+      cov_lower.coeffRef(pos) = cov_val.coeff(i, j);
+      cov.coeffRef(i, j) = cov_lower.coeff(pos);
+      cov.coeffRef(j, i) = cov_lower.coeff(pos);
+      ++pos;
+    }
+  }
+
+  reverse_pass_callback([sigma, sigma_val, cov_lower]() mutable {
+    sigma.adj() += 2 * sigma_val * cov_lower.adj().sum();
+  });
+  return cov;
+}
+
+/**
+ * Returns the dot product covariance matrix of the columns of a matrix
+ * as a `var_value` of a matrix.
+ *
+ * The whole matrix is held by a single vari. Every element has the same
+ * derivative with respect to sigma, so the reverse pass callback only
+ * sums the adjoints of the matrix.
+ *
+ * @tparam T_ret `var_value` of a matrix
+ * @param x_mat matrix with the input vectors as columns
+ * @param sigma constant function
+ * @return dot product covariance matrix
+ */
+template <typename T_ret, require_var_matrix_t<T_ret>* = nullptr>
+inline T_ret gp_dot_prod_cov(const Eigen::MatrixXd &x_mat, const var &sigma) {
+  const double sigma_val = sigma.val();
+  Eigen::MatrixXd cov_val = gp_dot_prod_cov_lower(x_mat, sigma_val);
+  cov_val.triangularView<Eigen::StrictlyUpper>() = cov_val.transpose();
+  T_ret cov = cov_val;
+
+  reverse_pass_callback([sigma, sigma_val, cov]() mutable {
+    sigma.adj() += 2 * sigma_val * cov.adj().sum();
+  });
+  return cov;
+}
+
+}  // namespace internal
+
+/**
+ * Returns a dot product covariance matrix of vars with one reverse pass
+ * callback for the adjoint of sigma.
+ *
+ * \f$k(x,x') = \sigma^2 + x \cdot x'\f$
+ *
+ * @param x std::vector of vectors of the same size
+ * @param sigma constant function
+ * @return dot product covariance matrix that is positive semi-definite
+ * @throw std::domain_error if sigma < 0, nan, inf or
+ *   x is nan or infinite
+ * @throw std::invalid_argument if the vectors of x have different sizes
+ */
+inline Eigen::Matrix<var, Eigen::Dynamic, Eigen::Dynamic> gp_dot_prod_cov(
+    const std::vector<Eigen::VectorXd> &x, const var &sigma) {
+  internal::gp_dot_prod_cov_check_sigma(sigma);
+  return internal::gp_dot_prod_cov(internal::gp_dot_prod_cov_inputs(x),
+                                   sigma);
+}
+
+/**
+ * Returns a dot product covariance matrix of vars with one reverse pass
+ * callback for the adjoint of sigma.
+ *
+ * \f$k(x,x') = \sigma^2 + x \cdot x'\f$
+ *
+ * @param x std::vector of doubles
+ * @param sigma constant function
+ * @return dot product covariance matrix that is positive semi-definite
+ * @throw std::domain_error if sigma < 0, nan, inf or
+ *   x is nan or infinite
+ */
+inline Eigen::Matrix<var, Eigen::Dynamic, Eigen::Dynamic> gp_dot_prod_cov(
+    const std::vector<double> &x, const var &sigma) {
+  internal::gp_dot_prod_cov_check_sigma(sigma);
+  return internal::gp_dot_prod_cov(internal::gp_dot_prod_cov_inputs(x),
+                                   sigma);
+}
+
+/**
+ * Returns a dot product covariance matrix held by a single vari, with one
+ * reverse pass callback for the adjoint of sigma.
+ *
+ * \f$k(x,x') = \sigma^2 + x \cdot x'\f$
+ *
+ * @tparam T_ret `var_value` of a matrix
+ * @tparam T_x double or Eigen::VectorXd
+ * @param x std::vector of doubles or of vectors of the same size
+ * @param sigma constant function
+ * @return dot product covariance matrix that is positive semi-definite
+ * @throw std::domain_error if sigma < 0, nan, inf or
+ *   x is nan or infinite
+ * @throw std::invalid_argument if the vectors of x have different sizes
+ */
+template <typename T_ret, typename T_x,
+          require_var_matrix_t<T_ret>* = nullptr>
+inline T_ret gp_dot_prod_cov(const std::vector<T_x> &x, const var &sigma) {
+  internal::gp_dot_prod_cov_check_sigma(sigma);
+  return internal::gp_dot_prod_cov<T_ret>(
+      internal::gp_dot_prod_cov_inputs(x), sigma);
+}
+
+}  // namespace math
+}  // namespace stan
+#endif
@@ -3,287 +3,144 @@
 
 #include <stan/math/rev/meta.hpp>
 #include <stan/math/rev/core.hpp>
-#include <stan/math/rev/fun/value_of.hpp>
-#include <stan/math/prim/err.hpp>
+#include <stan/math/rev/fun/gp_isotropic_cov.hpp>
 #include <stan/math/prim/fun/Eigen.hpp>
-#include <stan/math/prim/fun/exp.hpp>
-#include <stan/math/prim/fun/squared_distance.hpp>
-#include <cmath>
-#include <type_traits>
+#include <array>
 #include <vector>
 
 namespace stan {
 namespace math {
+namespace internal {
 
 /**
- * This is a subclass of the vari class for precomputed
- * gradients of gp_exp_quad_cov.
+ * Correlations of the squared exponential kernel and their derivatives
+ * with respect to the length scale, computed for all the distances at
+ * once.
  *
- * The class stores the double values for the distance
- * matrix, pointers to the varis for the covariance
- * matrix, along with a pointer to the vari for sigma,
- * and the vari for length_scale.
- *
- * @tparam T_x type of std::vector of elements
- * @tparam T_sigma type of sigma
- * @tparam T_l type of length scale
+ * The derivative with respect to the length scale is
+ * \f$ \frac{\partial k}{\partial l} = \frac{d^2}{l^3}
+ * exp(-\frac{d^2}{2l^2}) \f$.
  */
-template <typename T_x, typename T_sigma, typename T_l>
-class gp_exp_quad_cov_vari : public vari {
- public:
-  const size_t size_;
-  const size_t size_ltri_;
-  const double l_d_;
-  const double sigma_d_;
-  const double sigma_sq_d_;
-  double *dist_;
-  vari *l_vari_;
-  vari *sigma_vari_;
-  vari **cov_lower_;
-  vari **cov_diag_;
-
+struct gp_exp_quad_cov_kernel {
   /**
-   * Constructor for gp_exp_quad_cov.
-   *
-   * All memory allocated in
-   * ChainableStack's stack_alloc arena.
-   *
-   * It is critical for the efficiency of this object
-   * that the constructor create new varis that aren't
-   * popped onto the var_stack_, but rather are
-   * popped onto the var_nochain_stack_. This is
-   * controlled to the second argument to
-   * vari's constructor.
-   *
-   * @param x std::vector input that can be used in square distance
-   *    Assumes each element of x is the same size
-   * @param sigma standard deviation
-   * @param length_scale length scale
+   * Check that the magnitude and the length scale are positive. As in the
+   * double version of <code>gp_exp_quad_cov</code>, they may be infinite.
    */
-  gp_exp_quad_cov_vari(const std::vector<T_x> &x, const T_sigma &sigma,
-                       const T_l &length_scale)
-      : vari(0.0),
-        size_(x.size()),
-        size_ltri_(size_ * (size_ - 1) / 2),
-        l_d_(value_of(length_scale)),
-        sigma_d_(value_of(sigma)),
-        sigma_sq_d_(sigma_d_ * sigma_d_),
-        dist_(ChainableStack::instance_->memalloc_.alloc_array<double>(
-            size_ltri_)),
-        l_vari_(length_scale.vi_),
-        sigma_vari_(sigma.vi_),
-        cov_lower_(ChainableStack::instance_->memalloc_.alloc_array<vari *>(
-            size_ltri_)),
-        cov_diag_(
-            ChainableStack::instance_->memalloc_.alloc_array<vari *>(size_)) {
-    double inv_half_sq_l_d = 0.5 / (l_d_ * l_d_);
-    size_t pos = 0;
-    for (size_t j = 0; j < size_ - 1; ++j) {
-      for (size_t i = j + 1; i < size_; ++i) {
-        double dist_sq = squared_distance(x[i], x[j]);
-        dist_[pos] = dist_sq;
-        cov_lower_[pos] = new vari(
-            sigma_sq_d_ * std::exp(-dist_sq * inv_half_sq_l_d), false);
-        ++pos;
-      }
-    }
-    for (size_t i = 0; i < size_; ++i) {
-      cov_diag_[i] = new vari(sigma_sq_d_, false);
-    }
+  template <typename T_s, typename T_l>
+  inline void check_parameters(const char *function, const T_s &sigma,
+                               const T_l &length_scale) const {
+    check_positive(function, "magnitude", sigma);
+    check_positive(function, "length scale", length_scale);
   }
 
-  virtual void chain() {
-    double adjl = 0;
-    double adjsigma = 0;
-
-    for (size_t i = 0; i < size_ltri_; ++i) {
-      vari *el_low = cov_lower_[i];
-      double prod_add = el_low->adj_ * el_low->val_;
-      adjl += prod_add * dist_[i];
-      adjsigma += prod_add;
-    }
-    for (size_t i = 0; i < size_; ++i) {
-      vari *el = cov_diag_[i];
-      adjsigma += el->adj_ * el->val_;
-    }
-    l_vari_->adj_ += adjl / (l_d_ * l_d_ * l_d_);
-    sigma_vari_->adj_ += adjsigma * 2 / sigma_d_;
+  inline void operator()(const arena_t<Eigen::VectorXd> &dist,
+                         double length_scale, arena_t<Eigen::VectorXd> &corr,
+                         std::array<arena_t<Eigen::VectorXd>, 1> &dcorr) const {
+    const Eigen::ArrayXd scaled_sq = (dist.array() / length_scale).square();
+    const Eigen::ArrayXd exp_scaled = (-0.5 * scaled_sq).exp();
+    corr = exp_scaled.matrix();
+    dcorr[0] = (scaled_sq * exp_scaled / length_scale).matrix();
   }
 };
 
+}  // namespace internal
+
 /**
- * This is a subclass of the vari class for precomputed
- * gradients of gp_exp_quad_cov.
+ * Returns a squared exponential covariance matrix of vars with one
+ * reverse pass callback for the adjoints of the parameters.
+ *
+ * \f[ k(x, x') = \sigma^2 exp(-\frac{d(x, x')^2}{2l^2}) \f]
  *
- * The class stores the double values for the distance
- * matrix, pointers to the varis for the covariance
- * matrix, along with a pointer to the vari for sigma,
- * and the vari for length_scale.
+ * where \f$ d(x, x') \f$ is the Euclidean distance.
  *
- * @tparam T_x type of std::vector of elements
- * @tparam T_l type of length scale
+ * @tparam T_x type of the elements of x
+ * @param x std::vector of scalars or vectors of doubles
+ * @param sigma marginal standard deviation or magnitude
+ * @param length_scale length scale
+ * @return covariance matrix
+ * @throw std::domain error if sigma <= 0, l <= 0, or x is nan
  */
-template <typename T_x, typename T_l>
-class gp_exp_quad_cov_vari<T_x, double, T_l> : public vari {
- public:
-  const size_t size_;
-  const size_t size_ltri_;
-  const double l_d_;
-  const double sigma_d_;
-  const double sigma_sq_d_;
-  double *dist_;
-  vari *l_vari_;
-  vari **cov_lower_;
-  vari **cov_diag_;
-
-  /**
-   * Constructor for gp_exp_quad_cov.
-   *
-   * All memory allocated in
-   * ChainableStack's stack_alloc arena.
-   *
-   * It is critical for the efficiency of this object
-   * that the constructor create new varis that aren't
-   * popped onto the var_stack_, but rather are
-   * popped onto the var_nochain_stack_. This is
-   * controlled to the second argument to
-   * vari's constructor.
-   *
-   * @param x std::vector input that can be used in square distance
-   *    Assumes each element of x is the same size
-   * @param sigma standard deviation
-   * @param length_scale length scale
-   */
-  gp_exp_quad_cov_vari(const std::vector<T_x> &x, double sigma,
-                       const T_l &length_scale)
-      : vari(0.0),
-        size_(x.size()),
-        size_ltri_(size_ * (size_ - 1) / 2),
-        l_d_(value_of(length_scale)),
-        sigma_d_(value_of(sigma)),
-        sigma_sq_d_(sigma_d_ * sigma_d_),
-        dist_(ChainableStack::instance_->memalloc_.alloc_array<double>(
-            size_ltri_)),
-        l_vari_(length_scale.vi_),
-        cov_lower_(ChainableStack::instance_->memalloc_.alloc_array<vari *>(
-            size_ltri_)),
-        cov_diag_(
-            ChainableStack::instance_->memalloc_.alloc_array<vari *>(size_)) {
-    double inv_half_sq_l_d = 0.5 / (l_d_ * l_d_);
-    size_t pos = 0;
-    for (size_t j = 0; j < size_ - 1; ++j) {
-      for (size_t i = j + 1; i < size_; ++i) {
-        double dist_sq = squared_distance(x[i], x[j]);
-        dist_[pos] = dist_sq;
-        cov_lower_[pos] = new vari(
-            sigma_sq_d_ * std::exp(-dist_sq * inv_half_sq_l_d), false);
-        ++pos;
-      }
-    }
-    for (size_t i = 0; i < size_; ++i) {
-      cov_diag_[i] = new vari(sigma_sq_d_, false);
-    }
-  }
-
-  virtual void chain() {
-    double adjl = 0;
-
-    for (size_t i = 0; i < size_ltri_; ++i) {
-      vari *el_low = cov_lower_[i];
-      adjl += el_low->adj_ * el_low->val_ * dist_[i];
-    }
-    l_vari_->adj_ += adjl / (l_d_ * l_d_ * l_d_);
-  }
-};
+template <typename T_x, require_arithmetic_t<scalar_type_t<T_x>>* = nullptr>
+inline Eigen::Matrix<var, Eigen::Dynamic, Eigen::Dynamic> gp_exp_quad_cov(
+    const std::vector<T_x> &x, const var &sigma, const var &length_scale) {
+  return internal::gp_isotropic_cov("gp_exp_quad_cov", x, sigma,
+                                    internal::gp_exp_quad_cov_kernel(),
+                                    length_scale);
+}
 
 /**
- * Returns a squared exponential kernel.
+ * Returns a squared exponential covariance matrix of vars with one
+ * reverse pass callback for the adjoints of the parameters.
  *
- * @tparam T_x type of elements in the vector
- * @param x std::vector input that can be used in square distance
- *    Assumes each element of x is the same size
- * @param sigma standard deviation
+ * \f[ k(x, x') = \sigma^2 exp(-\frac{d(x, x')^2}{2l^2}) \f]
+ *
+ * where \f$ d(x, x') \f$ is the Euclidean distance.
+ *
+ * @tparam T_x type of the elements of x
+ * @param x std::vector of scalars or vectors of doubles
+ * @param sigma marginal standard deviation or magnitude
  * @param length_scale length scale
- * @return squared distance
- * @throw std::domain_error if sigma <= 0, l <= 0, or
- *   x is nan or infinite
+ * @return covariance matrix
+ * @throw std::domain error if sigma <= 0, l <= 0, or x is nan
  */
-template <typename T_x,
-          typename = require_arithmetic_t<typename scalar_type<T_x>::type>>
-inline Eigen::Matrix<var, -1, -1> gp_exp_quad_cov(const std::vector<T_x> &x,
-                                                  const var &sigma,
-                                                  const var &length_scale) {
-  check_positive("gp_exp_quad_cov", "sigma", sigma);
-  check_positive("gp_exp_quad_cov", "length_scale", length_scale);
-  size_t x_size = x.size();
-  for (size_t i = 0; i < x_size; ++i) {
-    check_not_nan("gp_exp_quad_cov", "x", x[i]);
-  }
-
-  Eigen::Matrix<var, -1, -1> cov(x_size, x_size);
-  if (x_size == 0) {
-    return cov;
-  }
-
-  gp_exp_quad_cov_vari<T_x, var, var> *baseVari
-      = new gp_exp_quad_cov_vari<T_x, var, var>(x, sigma, length_scale);
-
-  size_t pos = 0;
-  for (size_t j = 0; j < x_size - 1; ++j) {
-    for (size_t i = (j + 1); i < x_size; ++i) {
-      cov.coeffRef(i, j).vi_ = baseVari->cov_lower_[pos];
-      cov.coeffRef(j, i).vi_ = cov.coeffRef(i, j).vi_;
-      ++pos;
-    }
-    cov.coeffRef(j, j).vi_ = baseVari->cov_diag_[j];
-  }
-  cov.coeffRef(x_size - 1, x_size - 1).vi_ = baseVari->cov_diag_[x_size - 1];
-  return cov;
+template <typename T_x, require_arithmetic_t<scalar_type_t<T_x>>* = nullptr>
+inline Eigen::Matrix<var, Eigen::Dynamic, Eigen::Dynamic> gp_exp_quad_cov(
+    const std::vector<T_x> &x, double sigma, const var &length_scale) {
+  return internal::gp_isotropic_cov("gp_exp_quad_cov", x, sigma,
+                                    internal::gp_exp_quad_cov_kernel(),
+                                    length_scale);
 }
 
 /**
- * Returns a squared exponential kernel.
+ * Returns a squared exponential covariance matrix of vars with one
+ * reverse pass callback for the adjoints of the parameters.
+ *
+ * \f[ k(x, x') = \sigma^2 exp(-\frac{d(x, x')^2}{2l^2}) \f]
  *
- * @tparam T_x type of elements in the vector
- * @param x std::vector input that can be used in square distance
- *    Assumes each element of x is the same size
- * @param sigma standard deviation
+ * where \f$ d(x, x') \f$ is the Euclidean distance.
+ *
+ * @tparam T_x type of the elements of x
+ * @param x std::vector of scalars or vectors of doubles
+ * @param sigma marginal standard deviation or magnitude
  * @param length_scale length scale
- * @return squared distance
- * @throw std::domain_error if sigma <= 0, l <= 0, or
- *   x is nan or infinite
+ * @return covariance matrix
+ * @throw std::domain error if sigma <= 0, l <= 0, or x is nan
  */
-template <typename T_x,
-          typename = require_arithmetic_t<typename scalar_type<T_x>::type>>
-inline Eigen::Matrix<var, -1, -1> gp_exp_quad_cov(const std::vector<T_x> &x,
-                                                  double sigma,
-                                                  const var &length_scale) {
-  check_positive("gp_exp_quad_cov", "marginal variance", sigma);
-  check_positive("gp_exp_quad_cov", "length-scale", length_scale);
-  size_t x_size = x.size();
-  for (size_t i = 0; i < x_size; ++i) {
-    check_not_nan("gp_exp_quad_cov", "x", x[i]);
-  }
-
-  Eigen::Matrix<var, -1, -1> cov(x_size, x_size);
-  if (x_size == 0) {
-    return cov;
-  }
-
-  gp_exp_quad_cov_vari<T_x, double, var> *baseVari
-      = new gp_exp_quad_cov_vari<T_x, double, var>(x, sigma, length_scale);
+template <typename T_x, require_arithmetic_t<scalar_type_t<T_x>>* = nullptr>
+inline Eigen::Matrix<var, Eigen::Dynamic, Eigen::Dynamic> gp_exp_quad_cov(
+    const std::vector<T_x> &x, const var &sigma, double length_scale) {
+  return internal::gp_isotropic_cov("gp_exp_quad_cov", x, sigma,
+                                    internal::gp_exp_quad_cov_kernel(),
+                                    length_scale);
+}
 
-  size_t pos = 0;
-  for (size_t j = 0; j < x_size - 1; ++j) {
-    for (size_t i = (j + 1); i < x_size; ++i) {
-      cov.coeffRef(i, j).vi_ = baseVari->cov_lower_[pos];
-      cov.coeffRef(j, i).vi_ = cov.coeffRef(i, j).vi_;
-      ++pos;
-    }
-    cov.coeffRef(j, j).vi_ = baseVari->cov_diag_[j];
-  }
-  cov.coeffRef(x_size - 1, x_size - 1).vi_ = baseVari->cov_diag_[x_size - 1];
-  return cov;
+/**
+ * Returns a squared exponential covariance matrix held by a single vari,
+ * with one reverse pass callback for the adjoints of the parameters.
+ *
+ * \f[ k(x, x') = \sigma^2 exp(-\frac{d(x, x')^2}{2l^2}) \f]
+ *
+ * where \f$ d(x, x') \f$ is the Euclidean distance.
+ *
+ * @tparam T_ret `var_value` of a matrix
+ * @tparam T_x type of the elements of x
+ * @tparam T_s type of sigma, var or arithmetic
+ * @tparam T_l type of the length scale, var or arithmetic
+ * @param x std::vector of scalars or vectors of doubles
+ * @param sigma marginal standard deviation or magnitude
+ * @param length_scale length scale
+ * @return covariance matrix
+ * @throw std::domain error if sigma <= 0, l <= 0, or x is nan
+ */
+template <typename T_ret, typename T_x, typename T_s, typename T_l,
+          require_var_matrix_t<T_ret>* = nullptr,
+          require_arithmetic_t<scalar_type_t<T_x>>* = nullptr,
+          require_all_var_or_arithmetic_t<T_s, T_l>* = nullptr>
+inline T_ret gp_exp_quad_cov(const std::vector<T_x> &x, const T_s &sigma,
+                             const T_l &length_scale) {
+  return internal::gp_isotropic_cov<T_ret>(
+      "gp_exp_quad_cov", x, sigma, internal::gp_exp_quad_cov_kernel(),
+      length_scale);
 }
 
 }  // namespace math
@@ -0,0 +1,295 @@
+#ifndef STAN_MATH_REV_FUN_GP_ISOTROPIC_COV_HPP
+#define STAN_MATH_REV_FUN_GP_ISOTROPIC_COV_HPP
+
+#include <stan/math/rev/meta.hpp>
+#include <stan/math/rev/core.hpp>
+#include <stan/math/rev/fun/value_of.hpp>
+#include <stan/math/prim/err.hpp>
+#include <stan/math/prim/fun/Eigen.hpp>
+#include <stan/math/prim/fun/size.hpp>
+#include <stan/math/prim/fun/square.hpp>
+#include <stan/math/prim/fun/value_of.hpp>
+#include <stan/math/prim/functor/for_each.hpp>
+#include <array>
+#include <tuple>
+#include <vector>
+
+namespace stan {
+namespace math {
+namespace internal {
+
+/**
+ * Return the distances between all pairs of distinct scalars of x,
+ * packed column by column from the strictly lower triangle of the
+ * distance matrix.
+ *
+ * @tparam T_x type of the scalars
+ * @param x std::vector of scalars
+ * @return distances of the strictly lower triangle
+ */
+template <typename T_x, require_arithmetic_t<T_x>* = nullptr>
+inline arena_t<Eigen::VectorXd> gp_lower_distances(const std::vector<T_x>& x) {
+  const size_t x_size = x.size();
+  const Eigen::VectorXd x_vec
+      = Eigen::Map<const Eigen::Matrix<T_x, Eigen::Dynamic, 1>>(x.data(),
+                                                                x_size)
+            .template cast<double>();
+  arena_t<Eigen::VectorXd> dist(x_size * (x_size - 1) / 2);
+  size_t pos = 0;
+  for (size_t j = 0; j + 1 < x_size; ++j) {
+    const size_t n = x_size - j - 1;
+    dist.segment(pos, n) = (x_vec.tail(n).array() - x_vec(j)).abs().matrix();
+    pos += n;
+  }
+  return dist;
+}
+
+/**
+ * Return the Euclidean distances between all pairs of distinct vectors of
+ * x, packed column by column from the strictly lower triangle of the
+ * distance matrix. The vectors are stored as the columns of one matrix so
+ * that the distances from each vector to all the following ones are
+ * computed together.
+ *
+ * @tparam T_x type of the vectors
+ * @param x std::vector of vectors of the same size
+ * @return distances of the strictly lower triangle
+ */
+template <typename T_x,
+          require_eigen_vector_vt<std::is_arithmetic, T_x>* = nullptr>
+inline arena_t<Eigen::VectorXd> gp_lower_distances(const std::vector<T_x>& x) {
+  const size_t x_size = x.size();
+  Eigen::MatrixXd x_mat(x[0].size(), x_size);
+  for (size_t j = 0; j < x_size; ++j) {
+    x_mat.col(j) = x[j].template cast<double>();
+  }
+  arena_t<Eigen::VectorXd> dist(x_size * (x_size - 1) / 2);
+  size_t pos = 0;
+  for (size_t j = 0; j + 1 < x_size; ++j) {
+    const size_t n = x_size - j - 1;
+    dist.segment(pos, n)
+        = (x_mat.rightCols(n).colwise() - x_mat.col(j)).colwise().norm();
+    pos += n;
+  }
+  return dist;
+}
+
+/**
+ * Check the arguments of a stationary, isotropic kernel and compute its
+ * correlations and their derivatives with respect to the kernel
+ * parameters for the strictly lower triangle of the covariance matrix.
+ *
+ * @tparam T_x type of the elements of x
+ * @tparam T_s type of sigma
+ * @tparam F type of the kernel
+ * @tparam T_k types of the kernel parameters
+ * @param function name of the calling function for the error messages
+ * @param x std::vector of input elements of the same size
+ * @param sigma marginal standard deviation
+ * @param kernel functor which checks sigma and the kernel parameters and,
+ * given the packed distances and the values of the kernel parameters,
+ * sets the correlations and their derivatives with respect to each kernel
+ * parameter
+ * @param[out] corr_lower packed correlations, not set if x is empty
+ * @param[out] dcorr_lower packed derivatives of the correlations with
+ * respect to each kernel parameter, not set if x is empty
+ * @param params kernel parameters, e.g. the length scale
+ * @throw std::domain_error if sigma or a kernel parameter is not
+ * positive, or x is nan
+ * @throw std::invalid_argument if the elements of x have different sizes
+ */
+template <typename T_x, typename T_s, typename F, typename... T_k>
+inline void gp_isotropic_corr(
+    const char* function, const std::vector<T_x>& x, const T_s& sigma,
+    const F& kernel, arena_t<Eigen::VectorXd>& corr_lower,
+    std::array<arena_t<Eigen::VectorXd>, sizeof...(T_k)>& dcorr_lower,
+    const T_k&... params) {
+  kernel.check_parameters(function, sigma, params...);
+  const size_t x_size = x.size();
+  if (x_size == 0) {
+    return;
+  }
+  const size_t x_obs_size = stan::math::size(x[0]);
+  for (size_t i = 0; i < x_size; ++i) {
+    check_size_match(function, "x row", x_obs_size, "x's other row",
+                     stan::math::size(x[i]));
+  }
+  for (size_t i = 0; i < x_size; ++i) {
+    check_not_nan(function, "x", x[i]);
+  }
+  kernel(gp_lower_distances(x), value_of(params)..., corr_lower,
+         dcorr_lower);
+}
+
+/**
+ * Return the covariance matrix of a stationary, isotropic kernel
+ * \f$ \sigma^2 k(|x - x^\prime|, \theta) \f$ with
+ * \f$ k(0, \theta) = 1 \f$ for kernel parameters \f$ \theta \f$.
+ *
+ * The covariances are computed on values and the matrix of vars shares
+ * one vari between the symmetric elements, none of which is chained.
+ * A single reverse pass callback reduces the adjoints of the matrix
+ * against the stored correlations and their derivatives with respect to
+ * the kernel parameters.
+ *
+ * This still puts \f$ N(N+1)/2 \f$ varis on the stack for \f$ N \f$
+ * inputs. It is what the public GP kernels built on this function, as
+ * well as <code>gp_dot_prod_cov()</code>, return unless the caller asks
+ * for a <code>var_value</code> of a matrix with an explicit template
+ * argument, e.g.
+ * <code>gp_exp_quad_cov<var_value<Eigen::MatrixXd>>(x, sigma, l)</code>,
+ * which puts a single vari on the stack. None of the arguments is a
+ * <code>var_value</code>, so that return type is never deduced.
+ *
+ * @tparam T_x type of the elements of x
+ * @tparam T_s type of sigma
+ * @tparam F type of the kernel
+ * @tparam T_k types of the kernel parameters
+ * @param function name of the calling function for the error messages
+ * @param x std::vector of input elements of the same size
+ * @param sigma marginal standard deviation
+ * @param kernel kernel functor, see <code>gp_isotropic_corr()</code>
+ * @param params kernel parameters, e.g. the length scale
+ * @return covariance matrix
+ * @throw std::domain_error if sigma or a kernel parameter is not
+ * positive, or x is nan
+ * @throw std::invalid_argument if the elements of x have different sizes
+ */
+template <typename T_x, typename T_s, typename F, typename... T_k>
+inline Eigen::Matrix<var, Eigen::Dynamic, Eigen::Dynamic> gp_isotropic_cov(
+    const char* function, const std::vector<T_x>& x, const T_s& sigma,
+    const F& kernel, const T_k&... params) {
+  arena_t<Eigen::VectorXd> corr_lower;
+  std::array<arena_t<Eigen::VectorXd>, sizeof...(T_k)> dcorr_lower;
+  gp_isotropic_corr(function, x, sigma, kernel, corr_lower, dcorr_lower,
+                    params...);
+  const size_t x_size = x.size();
+  Eigen::Matrix<var, Eigen::Dynamic, Eigen::Dynamic> cov(x_size, x_size);
+  if (x_size == 0) {
+    return cov;
+  }
+
+  const double sigma_val = value_of(sigma);
+  const double sigma_sq = square(sigma_val);
+  arena_t<Eigen::Matrix<var, Eigen::Dynamic, 1>> cov_lower
+      = (sigma_sq * corr_lower).eval();
+  arena_t<Eigen::Matrix<var, Eigen::Dynamic, 1>> cov_diag
+      = Eigen::VectorXd::Constant(x_size, sigma_sq);
+  size_t pos = 0;
+  for (size_t j = 0; j < x_size; ++j) {
+    cov.coeffRef(j, j) = cov_diag.coeff(j);
+    for (size_t i = j + 1; i < x_size; ++i) {
+      cov.coeffRef(i, j) = cov_lower.coeff(pos);
+      cov.coeffRef(j, i) = cov_lower.coeff(pos);
+      ++pos;
+    }
+  }
+
+  reverse_pass_callback([sigma, param_tuple = std::make_tuple(params...),
+                         sigma_val, sigma_sq, cov_lower, cov_diag,
+                         corr_lower, dcorr_lower]() mutable {
+    if (!is_constant<T_s>::value) {
+      forward_as<var>(sigma).adj()
+          += 2 * sigma_val
+             * (cov_lower.adj().dot(corr_lower) + cov_diag.adj().sum());
+    }
+    math::for_each(
+        [&](auto& param, size_t k) {
+          if (!is_constant<std::decay_t<decltype(param)>>::value) {
+            forward_as<var>(param).adj()
+                += sigma_sq * cov_lower.adj().dot(dcorr_lower[k]);
+          }
+        },
+        param_tuple);
+  });
+  return cov;
+}
+
+/**
+ * Return the covariance matrix of a stationary, isotropic kernel
+ * \f$ \sigma^2 k(|x - x^\prime|, \theta) \f$ with
+ * \f$ k(0, \theta) = 1 \f$ for kernel parameters \f$ \theta \f$
+ * as a `var_value` of a matrix.
+ *
+ * The whole matrix is held by a single vari and the reverse pass callback
+ * adds the adjoints of each symmetric pair of elements before reducing
+ * them against the stored correlations and their derivatives.
+ *
+ * @tparam T_ret `var_value` of a matrix
+ * @tparam T_x type of the elements of x
+ * @tparam T_s type of sigma
+ * @tparam F type of the kernel
+ * @tparam T_k types of the kernel parameters
+ * @param function name of the calling function for the error messages
+ * @param x std::vector of input elements of the same size
+ * @param sigma marginal standard deviation
+ * @param kernel kernel functor, see <code>gp_isotropic_corr()</code>
+ * @param params kernel parameters, e.g. the length scale
+ * @return covariance matrix
+ * @throw std::domain_error if sigma or a kernel parameter is not
+ * positive, or x is nan
+ * @throw std::invalid_argument if the elements of x have different sizes
+ */
+template <typename T_ret, typename T_x, typename T_s, typename F,
+          typename... T_k, require_var_matrix_t<T_ret>* = nullptr>
+inline T_ret gp_isotropic_cov(const char* function, const std::vector<T_x>& x,
+                              const T_s& sigma, const F& kernel,
+                              const T_k&... params) {
+  constexpr size_t num_params = sizeof...(T_k);
+  arena_t<Eigen::VectorXd> corr_lower;
+  std::array<arena_t<Eigen::VectorXd>, num_params> dcorr_lower;
+  gp_isotropic_corr(function, x, sigma, kernel, corr_lower, dcorr_lower,
+                    params...);
+  const Eigen::Index x_size = x.size();
+  if (x_size == 0) {
+    return T_ret(Eigen::MatrixXd(0, 0));
+  }
+
+  const double sigma_val = value_of(sigma);
+  const double sigma_sq = square(sigma_val);
+  Eigen::MatrixXd cov_val(x_size, x_size);
+  Eigen::Index pos = 0;
+  for (Eigen::Index j = 0; j < x_size; ++j) {
+    cov_val.coeffRef(j, j) = sigma_sq;
+    for (Eigen::Index i = j + 1; i < x_size; ++i) {
+      cov_val.coeffRef(i, j) = sigma_sq * corr_lower.coeff(pos);
+      cov_val.coeffRef(j, i) = cov_val.coeff(i, j);
+      ++pos;
+    }
+  }
+  T_ret cov = cov_val;
+
+  reverse_pass_callback([sigma, param_tuple = std::make_tuple(params...),
+                         sigma_val, sigma_sq, cov, corr_lower,
+                         dcorr_lower]() mutable {
+    double adj_corr = cov.adj().diagonal().sum();
+    std::array<double, num_params> adj_dcorr{};
+    Eigen::Index pos = 0;
+    for (Eigen::Index j = 0; j < cov.cols(); ++j) {
+      for (Eigen::Index i = j + 1; i < cov.rows(); ++i) {
+        const double adj = cov.adj().coeff(i, j) + cov.adj().coeff(j, i);
+        adj_corr += adj * corr_lower.coeff(pos);
+        for (size_t k = 0; k < num_params; ++k) {
+          adj_dcorr[k] += adj * dcorr_lower[k].coeff(pos);
+        }
+        ++pos;
+      }
+    }
+    if (!is_constant<T_s>::value) {
+      forward_as<var>(sigma).adj() += 2 * sigma_val * adj_corr;
+    }
+    math::for_each(
+        [&](auto& param, size_t k) {
+          if (!is_constant<std::decay_t<decltype(param)>>::value) {
+            forward_as<var>(param).adj() += sigma_sq * adj_dcorr[k];
+          }
+        },
+        param_tuple);
+  });
+  return cov;
+}
+
+}  // namespace internal
+}  // namespace math
+}  // namespace stan
+#endif
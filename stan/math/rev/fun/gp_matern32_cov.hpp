@@ -0,0 +1,156 @@
+#ifndef STAN_MATH_REV_FUN_GP_MATERN32_COV_HPP
+#define STAN_MATH_REV_FUN_GP_MATERN32_COV_HPP
+
+#include <stan/math/rev/meta.hpp>
+#include <stan/math/rev/core.hpp>
+#include <stan/math/rev/fun/gp_isotropic_cov.hpp>
+#include <stan/math/prim/fun/Eigen.hpp>
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace stan {
+namespace math {
+namespace internal {
+
+/**
+ * Correlations of the Matern 3/2 kernel and their derivatives with
+ * respect to the length scale, computed for all the distances at once.
+ *
+ * The derivative with respect to the length scale is
+ * \f$ \frac{\partial k}{\partial l} = \frac{\sigma^2}{l}
+ * \left(\frac{\sqrt{3}d}{l}\right)^2 exp(-\frac{\sqrt{3}d}{l}) \f$.
+ */
+struct gp_matern32_cov_kernel {
+  /**
+   * Check that the magnitude and the length scale are positive and
+   * finite, as in the double version.
+   */
+  template <typename T_s, typename T_l>
+  inline void check_parameters(const char *function, const T_s &sigma,
+                               const T_l &length_scale) const {
+    check_positive_finite(function, "magnitude", sigma);
+    check_positive_finite(function, "length scale", length_scale);
+  }
+
+  inline void operator()(const arena_t<Eigen::VectorXd> &dist,
+                         double length_scale, arena_t<Eigen::VectorXd> &corr,
+                         std::array<arena_t<Eigen::VectorXd>, 1> &dcorr) const {
+    const Eigen::ArrayXd scaled = std::sqrt(3.0) / length_scale * dist.array();
+    const Eigen::ArrayXd exp_scaled = (-scaled).exp();
+    corr = ((1.0 + scaled) * exp_scaled).matrix();
+    dcorr[0] = (scaled.square() * exp_scaled / length_scale).matrix();
+  }
+};
+
+}  // namespace internal
+
+/**
+ * Returns a Matern 3/2 covariance matrix of vars with one reverse pass
+ * callback for the adjoints of the parameters.
+ *
+ * \f[ k(x, x') = \sigma^2(1 +
+ *  \frac{\sqrt{3}d(x, x')}{l})exp(-\frac{\sqrt{3}d(x, x')}{l})
+ * \f]
+ *
+ * where \f$ d(x, x') \f$ is the Euclidean distance.
+ *
+ * @tparam T_x type of the elements of x
+ * @param x std::vector of scalars or vectors of doubles
+ * @param sigma marginal standard deviation or magnitude
+ * @param length_scale length scale
+ * @return covariance matrix
+ * @throw std::domain error if sigma <= 0, l <= 0, or x is nan
+ */
+template <typename T_x, require_arithmetic_t<scalar_type_t<T_x>>* = nullptr>
+inline Eigen::Matrix<var, Eigen::Dynamic, Eigen::Dynamic> gp_matern32_cov(
+    const std::vector<T_x> &x, const var &sigma, const var &length_scale) {
+  return internal::gp_isotropic_cov("gp_matern32_cov", x, sigma,
+                                    internal::gp_matern32_cov_kernel(),
+                                    length_scale);
+}
+
+/**
+ * Returns a Matern 3/2 covariance matrix of vars with one reverse pass
+ * callback for the adjoints of the parameters.
+ *
+ * \f[ k(x, x') = \sigma^2(1 +
+ *  \frac{\sqrt{3}d(x, x')}{l})exp(-\frac{\sqrt{3}d(x, x')}{l})
+ * \f]
+ *
+ * where \f$ d(x, x') \f$ is the Euclidean distance.
+ *
+ * @tparam T_x type of the elements of x
+ * @param x std::vector of scalars or vectors of doubles
+ * @param sigma marginal standard deviation or magnitude
+ * @param length_scale length scale
+ * @return covariance matrix
+ * @throw std::domain error if sigma <= 0, l <= 0, or x is nan
+ */
+template <typename T_x, require_arithmetic_t<scalar_type_t<T_x>>* = nullptr>
+inline Eigen::Matrix<var, Eigen::Dynamic, Eigen::Dynamic> gp_matern32_cov(
+    const std::vector<T_x> &x, double sigma, const var &length_scale) {
+  return internal::gp_isotropic_cov("gp_matern32_cov", x, sigma,
+                                    internal::gp_matern32_cov_kernel(),
+                                    length_scale);
+}
+
+/**
+ * Returns a Matern 3/2 covariance matrix of vars with one reverse pass
+ * callback for the adjoints of the parameters.
+ *
+ * \f[ k(x, x') = \sigma^2(1 +
+ *  \frac{\sqrt{3}d(x, x')}{l})exp(-\frac{\sqrt{3}d(x, x')}{l})
+ * \f]
+ *
+ * where \f$ d(x, x') \f$ is the Euclidean distance.
+ *
+ * @tparam T_x type of the elements of x
+ * @param x std::vector of scalars or vectors of doubles
+ * @param sigma marginal standard deviation or magnitude
+ * @param length_scale length scale
+ * @return covariance matrix
+ * @throw std::domain error if sigma <= 0, l <= 0, or x is nan
+ */
+template <typename T_x, require_arithmetic_t<scalar_type_t<T_x>>* = nullptr>
+inline Eigen::Matrix<var, Eigen::Dynamic, Eigen::Dynamic> gp_matern32_cov(
+    const std::vector<T_x> &x, const var &sigma, double length_scale) {
+  return internal::gp_isotropic_cov("gp_matern32_cov", x, sigma,
+                                    internal::gp_matern32_cov_kernel(),
+                                    length_scale);
+}
+
+/**
+ * Returns a Matern 3/2 covariance matrix held by a single vari, with one
+ * reverse pass callback for the adjoints of the parameters.
+ *
+ * \f[ k(x, x') = \sigma^2(1 +
+ *  \frac{\sqrt{3}d(x, x')}{l})exp(-\frac{\sqrt{3}d(x, x')}{l})
+ * \f]
+ *
+ * where \f$ d(x, x') \f$ is the Euclidean distance.
+ *
+ * @tparam T_ret `var_value` of a matrix
+ * @tparam T_x type of the elements of x
+ * @tparam T_s type of sigma, var or arithmetic
+ * @tparam T_l type of the length scale, var or arithmetic
+ * @param x std::vector of scalars or vectors of doubles
+ * @param sigma marginal standard deviation or magnitude
+ * @param length_scale length scale
+ * @return covariance matrix
+ * @throw std::domain error if sigma <= 0, l <= 0, or x is nan
+ */
+template <typename T_ret, typename T_x, typename T_s, typename T_l,
+          require_var_matrix_t<T_ret>* = nullptr,
+          require_arithmetic_t<scalar_type_t<T_x>>* = nullptr,
+          require_all_var_or_arithmetic_t<T_s, T_l>* = nullptr>
+inline T_ret gp_matern32_cov(const std::vector<T_x> &x, const T_s &sigma,
+                             const T_l &length_scale) {
+  return internal::gp_isotropic_cov<T_ret>(
+      "gp_matern32_cov", x, sigma, internal::gp_matern32_cov_kernel(),
+      length_scale);
+}
+
+}  // namespace math
+}  // namespace stan
+#endif
@@ -52,7 +52,13 @@ class log_vari final : public op_v_vari {
  * @param a Variable whose log is taken.
  * @return Natural log of variable.
  */
-inline var log(const var& a) { return var(new internal::log_vari(a.vi_)); }
+inline var log(const var& a) {
+#ifdef STAN_MATH_SOA_TAPE
+  return {internal::soa_record(internal::soa_op::log, a.vi_)};
+#else
+  return var(new internal::log_vari(a.vi_));
+#endif
+}
 
 /**
  * Return the natural logarithm (base e) of the specified complex argument.
@@ -7,8 +7,6 @@
 #include <stan/math/rev/functor/algebra_system.hpp>
 #include <stan/math/rev/functor/kinsol_data.hpp>
 #include <stan/math/prim/err.hpp>
-#include <stan/math/prim/fun/mdivide_left.hpp>
-#include <stan/math/prim/fun/to_array_1d.hpp>
 #include <stan/math/prim/fun/to_vector.hpp>
 #include <stan/math/prim/fun/value_of.hpp>
 #include <kinsol/kinsol.h>
@@ -129,8 +127,8 @@ struct KinsolFixedPointEnv {
 };
 
 /**
- * Calculate Jacobian Jxy(Jacobian of unknown x w.r.t. the * param y)
- * given the solution. Specifically, for
+ * Calculate the adjoints of the param y given the solution of the
+ * fixed point problem. Specifically, for
  *
  *  x - f(x, y) = 0
  *
@@ -138,16 +136,19 @@ struct KinsolFixedPointEnv {
  *
  * Jxy - Jfx * Jxy = Jfy
  *
- * therefore Jxy can be solved from system
+ * therefore adj(y) = Jfy^T * lambda with
  *
- * (I - Jfx) * Jxy = Jfy
+ * (I - Jfx)^T * lambda = adj(x),
  *
- * Jfx and Jfy are obtained through one AD evaluation of f
- * w.r.t combined vector [x, y].
+ * see <code>internal::algebra_solver_adjoint</code>. Jfx is obtained
+ * through AD of f w.r.t. x, with one reverse pass per color of the rows
+ * of its traced sparsity pattern (see
+ * <code>internal::traced_jacobian()</code>), and factorized before the
+ * reverse pass.
  */
 struct FixedPointADJac {
   /**
-   * Calculate Jacobian Jxy.
+   * Return the solution as vars whose adjoints are propagated to y.
    *
    * @tparam F RHS functor type
    * @param x fixed point solution
@@ -158,37 +159,24 @@ struct FixedPointADJac {
   inline Eigen::Matrix<stan::math::var, -1, 1> operator()(
       const Eigen::VectorXd& x, const Eigen::Matrix<stan::math::var, -1, 1>& y,
       KinsolFixedPointEnv<F>& env) {
-    using stan::math::precomputed_gradients;
-    using stan::math::to_array_1d;
     using stan::math::var;
+    using Fx = system_functor<F, double, double, true>;
+    using Fy = system_functor<F, double, double, false>;
 
-    auto g = [&env](const Eigen::Matrix<var, -1, 1>& par_) {
-      Eigen::Matrix<var, -1, 1> x_(par_.head(env.N_));
-      Eigen::Matrix<var, -1, 1> y_(par_.tail(env.M_));
-      return env.f_(x_, y_, env.x_r_, env.x_i_, env.msgs_);
-    };
+    Eigen::VectorXd fx;
+    Eigen::MatrixXd Jf_x;
+    internal::traced_jacobian(
+        Fx(env.f_, x, env.y_, env.x_r_, env.x_i_, env.msgs_), x, fx, Jf_x);
+    auto* adjoint = new internal::algebra_solver_adjoint<Fy>(
+        Fy(env.f_, x, env.y_, env.x_r_, env.x_i_, env.msgs_),
+        Eigen::MatrixXd::Identity(env.N_, env.N_) - Jf_x);
+    stan::arena_t<Eigen::Matrix<var, -1, 1>> y_arena = y;
+    stan::arena_t<Eigen::Matrix<var, -1, 1>> x_sol
+        = x.template cast<var>();
 
-    Eigen::VectorXd theta(x.size() + y.size());
-    for (int i = 0; i < env.N_; ++i) {
-      theta(i) = x(i);
-    }
-    for (int i = 0; i < env.M_; ++i) {
-      theta(i + env.N_) = env.y_(i);
-    }
-    Eigen::Matrix<double, -1, 1> fx;
-    Eigen::Matrix<double, -1, -1> J_theta;
-    stan::math::jacobian(g, theta, fx, J_theta);
-    Eigen::MatrixXd A(J_theta.block(0, 0, env.N_, env.N_));
-    Eigen::MatrixXd b(J_theta.block(0, env.N_, env.N_, env.M_));
-    A = Eigen::MatrixXd::Identity(env.N_, env.N_) - A;
-    Eigen::MatrixXd Jxy = A.colPivHouseholderQr().solve(b);
-    std::vector<double> gradients(env.M_);
-    Eigen::Matrix<var, -1, 1> x_sol(env.N_);
-    std::vector<stan::math::var> yv(to_array_1d(y));
-    for (int i = 0; i < env.N_; ++i) {
-      gradients = to_array_1d(Eigen::VectorXd(Jxy.row(i)));
-      x_sol[i] = precomputed_gradients(x(i), yv, gradients);
-    }
+    stan::math::reverse_pass_callback([x_sol, y_arena, adjoint]() mutable {
+      y_arena.adj() += (*adjoint)(x_sol.adj());
+    });
     return x_sol;
   }
 };
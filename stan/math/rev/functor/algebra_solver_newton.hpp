@@ -6,7 +6,6 @@
 #include <stan/math/rev/functor/algebra_solver_powell.hpp>
 #include <stan/math/rev/functor/kinsol_solve.hpp>
 #include <stan/math/prim/err.hpp>
-#include <stan/math/prim/fun/mdivide_left.hpp>
 #include <stan/math/prim/fun/value_of.hpp>
 #include <unsupported/Eigen/NonLinearOptimization>
 #include <iostream>
@@ -16,6 +15,37 @@
 namespace stan {
 namespace math {
 
+namespace internal {
+
+/**
+ * Check the arguments of the Newton solver and solve the algebraic
+ * system with KINSOL, see <code>algebra_solver_newton()</code>.
+ *
+ * @param[out] J_solution If not null, the Jacobian of the system w.r.t.
+ *            the unknowns at the solution, see <code>kinsol_solve()</code>
+ */
+template <typename F, typename T>
+Eigen::VectorXd algebra_solver_newton_solve(
+    const F& f, const T& x_eval, const Eigen::VectorXd& y,
+    const std::vector<double>& dat, const std::vector<int>& dat_int,
+    std::ostream* msgs, double scaling_step_size, double function_tolerance,
+    long int max_num_steps,  // NOLINT(runtime/int)
+    Eigen::MatrixXd* J_solution = nullptr) {
+  algebra_solver_check(x_eval, y, dat, dat_int, function_tolerance,
+                       max_num_steps);
+  check_nonnegative("algebra_solver", "scaling_step_size", scaling_step_size);
+
+  check_matching_sizes("algebra_solver", "the algebraic system's output",
+                       value_of(f(x_eval, y, dat, dat_int, msgs)),
+                       "the vector of unknowns, x,", x_eval);
+
+  return kinsol_solve(f, value_of(x_eval), y, dat, dat_int, 0,
+                      scaling_step_size, function_tolerance, max_num_steps, 1,
+                      kinsol_J_f(), 10, KIN_LINESEARCH, J_solution);
+}
+
+}  // namespace internal
+
 /**
  * Return the solution to the specified system of algebraic
  * equations given an initial guess, and parameters and data,
@@ -61,17 +91,9 @@ Eigen::VectorXd algebra_solver_newton(
     std::ostream* msgs = nullptr, double scaling_step_size = 1e-3,
     double function_tolerance = 1e-6,
     long int max_num_steps = 200) {  // NOLINT(runtime/int)
-  const auto& x_eval = x.eval();
-  algebra_solver_check(x_eval, y, dat, dat_int, function_tolerance,
-                       max_num_steps);
-  check_nonnegative("algebra_solver", "scaling_step_size", scaling_step_size);
-
-  check_matching_sizes("algebra_solver", "the algebraic system's output",
-                       value_of(f(x_eval, y, dat, dat_int, msgs)),
-                       "the vector of unknowns, x,", x);
-
-  return kinsol_solve(f, value_of(x_eval), y, dat, dat_int, 0,
-                      scaling_step_size, function_tolerance, max_num_steps);
+  return internal::algebra_solver_newton_solve(
+      f, x.eval(), y, dat, dat_int, msgs, scaling_step_size,
+      function_tolerance, max_num_steps);
 }
 
 /**
@@ -129,18 +151,16 @@ Eigen::Matrix<scalar_type_t<T2>, Eigen::Dynamic, 1> algebra_solver_newton(
 
   const auto& x_eval = x.eval();
   const auto& y_eval = y.eval();
-  Eigen::VectorXd theta_dbl = algebra_solver_newton(
+  Eigen::MatrixXd J_x;
+  Eigen::VectorXd theta_dbl = internal::algebra_solver_newton_solve(
       f, x_eval, value_of(y_eval), dat, dat_int, msgs, scaling_step_size,
-      function_tolerance, max_num_steps);
+      function_tolerance, max_num_steps, &J_x);
 
   typedef system_functor<F, double, double, false> Fy;
-  typedef system_functor<F, double, double, true> Fs;
-  typedef hybrj_functor_solver<Fs, F, double, double> Fx;
-  Fx fx(Fs(), f, value_of(x_eval), value_of(y_eval), dat, dat_int, msgs);
 
-  // Construct vari
-  auto* vi0 = new algebra_solver_vari<Fy, F, scalar_type_t<T2>, Fx>(
-      Fy(), f, value_of(x_eval), y_eval, dat, dat_int, theta_dbl, fx, msgs);
+  // Construct vari with the Jacobian w.r.t. the unknowns from KINSOL
+  auto* vi0 = new algebra_solver_vari<Fy, F, scalar_type_t<T2>>(
+      Fy(), f, value_of(x_eval), y_eval, dat, dat_int, theta_dbl, J_x, msgs);
   Eigen::Matrix<var, Eigen::Dynamic, 1> theta(x.size());
   theta(0) = var(vi0->theta_[0]);
   for (int i = 1; i < x.size(); ++i)
@@ -5,7 +5,7 @@
 #include <stan/math/rev/core.hpp>
 #include <stan/math/rev/functor/algebra_system.hpp>
 #include <stan/math/prim/err.hpp>
-#include <stan/math/prim/fun/mdivide_left.hpp>
+#include <stan/math/prim/fun/Eigen.hpp>
 #include <stan/math/prim/fun/value_of.hpp>
 #include <unsupported/Eigen/NonLinearOptimization>
 #include <iostream>
@@ -16,12 +16,14 @@ namespace stan {
 namespace math {
 
 /**
- * The vari class for the algebraic solver. We compute the  Jacobian of
- * the solutions with respect to the parameters using the implicit
- * function theorem. The call to Jacobian() occurs outside the call to
- * chain() -- this prevents malloc issues.
+ * The vari class for the algebraic solver. We compute the adjoints of
+ * the parameters using the implicit function theorem, with one linear
+ * solve and one nested reverse pass per call to chain() (see
+ * <code>internal::algebra_solver_adjoint</code>). The Jacobian w.r.t.
+ * the unknowns at the solution is passed in by the solver, which may
+ * already have it, and factorized outside the call to chain().
  */
-template <typename Fs, typename F, typename T, typename Fx>
+template <typename Fs, typename F, typename T>
 struct algebra_solver_vari : public vari {
   /** vector of parameters */
   vari** y_;
@@ -31,25 +33,23 @@ struct algebra_solver_vari : public vari {
   int x_size_;
   /** vector of solution */
   vari** theta_;
-  /** Jacobian of the solution w.r.t parameters */
-  double* Jx_y_;
+  /** implicit function theorem sensitivities */
+  internal::algebra_solver_adjoint<Fs>* adjoint_;
 
   algebra_solver_vari(const Fs& fs, const F& f, const Eigen::VectorXd& x,
                       const Eigen::Matrix<T, Eigen::Dynamic, 1>& y,
                       const std::vector<double>& dat,
                       const std::vector<int>& dat_int,
-                      const Eigen::VectorXd& theta_dbl, Fx& fx,
-                      std::ostream* msgs)
+                      const Eigen::VectorXd& theta_dbl,
+                      const Eigen::MatrixXd& J_x, std::ostream* msgs)
       : vari(theta_dbl(0)),
         y_(ChainableStack::instance_->memalloc_.alloc_array<vari*>(y.size())),
         y_size_(y.size()),
         x_size_(x.size()),
         theta_(
             ChainableStack::instance_->memalloc_.alloc_array<vari*>(x_size_)),
-        Jx_y_(ChainableStack::instance_->memalloc_.alloc_array<double>(
-            x_size_ * y_size_)) {
-    using Eigen::Map;
-    using Eigen::MatrixXd;
+        adjoint_(new internal::algebra_solver_adjoint<Fs>(
+            Fs(f, theta_dbl, value_of(y), dat, dat_int, msgs), J_x)) {
     for (int i = 0; i < y.size(); ++i) {
       y_[i] = y(i).vi_;
     }
@@ -58,21 +58,16 @@ struct algebra_solver_vari : public vari {
     for (int i = 1; i < x.size(); ++i) {
       theta_[i] = new vari(theta_dbl(i), false);
     }
-
-    // Compute the Jacobian and store in array, using the
-    // implicit function theorem, i.e. Jx_y = Jf_y / Jf_x
-    using f_y = hybrj_functor_solver<Fs, F, double, double>;
-    Map<MatrixXd>(&Jx_y_[0], x_size_, y_size_)
-        = -mdivide_left(fx.get_jacobian(theta_dbl),
-                        f_y(fs, f, theta_dbl, value_of(y), dat, dat_int, msgs)
-                            .get_jacobian(value_of(y)));
   }
 
   void chain() {
-    for (int j = 0; j < y_size_; j++) {
-      for (int i = 0; i < x_size_; i++) {
-        y_[j]->adj_ += theta_[i]->adj_ * Jx_y_[j * x_size_ + i];
-      }
+    Eigen::VectorXd theta_adj(x_size_);
+    for (int i = 0; i < x_size_; ++i) {
+      theta_adj(i) = theta_[i]->adj_;
+    }
+    Eigen::VectorXd y_adj = (*adjoint_)(theta_adj);
+    for (int j = 0; j < y_size_; ++j) {
+      y_[j]->adj_ -= y_adj(j);
     }
   }
 };
@@ -248,9 +243,10 @@ Eigen::Matrix<value_type_t<T2>, Eigen::Dynamic, 1> algebra_solver_powell(
   Fx fx(Fs(), f, x_val, y_val, dat, dat_int, msgs);
 
   // Construct vari
-  algebra_solver_vari<Fy, F, value_type_t<T2>, Fx>* vi0
-      = new algebra_solver_vari<Fy, F, value_type_t<T2>, Fx>(
-          Fy(), f, x_val, y_eval, dat, dat_int, theta_dbl, fx, msgs);
+  algebra_solver_vari<Fy, F, value_type_t<T2>>* vi0
+      = new algebra_solver_vari<Fy, F, value_type_t<T2>>(
+          Fy(), f, x_val, y_eval, dat, dat_int, theta_dbl,
+          fx.get_jacobian(theta_dbl), msgs);
   Eigen::Matrix<var, Eigen::Dynamic, 1> theta(x.size());
   theta(0) = var(vi0->theta_[0]);
   for (int i = 1; i < x.size(); ++i) {
@@ -2,7 +2,9 @@
 #define STAN_MATH_REV_FUNCTOR_ALGEBRA_SYSTEM_HPP
 
 #include <stan/math/rev/meta.hpp>
-#include <stan/math/rev/functor/jacobian.hpp>
+#include <stan/math/rev/core.hpp>
+#include <stan/math/rev/fun/dot_product.hpp>
+#include <stan/math/rev/functor/sparse_jacobian.hpp>
 #include <stan/math/prim/err.hpp>
 #include <stan/math/prim/fun/Eigen.hpp>
 #include <iostream>
@@ -115,13 +117,14 @@ struct hybrj_functor_solver : nlo_functor<double> {
 
   /**
    * Computes the value the algebraic function, f, when pluging in the
-   * independent variables, and the Jacobian w.r.t unknowns. Required
-   * by Eigen.
+   * independent variables, and the Jacobian w.r.t unknowns, with one
+   * reverse pass per color of the rows of its traced sparsity pattern
+   * (see <code>internal::traced_jacobian()</code>). Required by Eigen.
    * @param [in] iv independent variables
    * @param [in, out] fvec value of algebraic function when plugging in iv.
    */
   int operator()(const Eigen::VectorXd& iv, Eigen::VectorXd& fvec) {
-    jacobian(fs_, iv, fvec, J_);
+    internal::traced_jacobian(fs_, iv, fvec, J_);
     return 0;
   }
 
@@ -144,7 +147,7 @@ struct hybrj_functor_solver : nlo_functor<double> {
    */
   Eigen::MatrixXd get_jacobian(const Eigen::VectorXd& iv) {
     Eigen::VectorXd fvec;
-    jacobian(fs_, iv, fvec, J_);
+    internal::traced_jacobian(fs_, iv, fvec, J_);
     return J_;
   }
 
@@ -157,6 +160,62 @@ struct hybrj_functor_solver : nlo_functor<double> {
   Eigen::VectorXd get_value(const Eigen::VectorXd& iv) const { return fs_(iv); }
 };
 
+namespace internal {
+
+/**
+ * Sensitivities of the solution x of an algebraic system w.r.t. the
+ * auxiliary parameters y by the implicit function theorem. For a root
+ * of f(x, y) = 0 the adjoints of the parameters are
+ *
+ *   adj(y) = -Jf_y^T lambda,  where  Jf_x^T lambda = adj(x),
+ *
+ * so every reverse pass needs one solve with the factorized Jacobian
+ * w.r.t. the unknowns and one nested reverse pass of lambda^T f w.r.t.
+ * the parameters, instead of the full Jacobian w.r.t. the parameters.
+ *
+ * The object lives on the autodiff stack (see
+ * <code>chainable_alloc</code>) and is freed when the stack memory is
+ * recovered.
+ *
+ * @tparam Fy system functor taking the parameters as independent
+ * variable, i.e. a <code>system_functor</code> with
+ * <code>x_is_iv = false</code>
+ */
+template <typename Fy>
+class algebra_solver_adjoint : public chainable_alloc {
+  /** algebraic system at the solution as a function of the parameters */
+  Fy fy_;
+  /** LU factorization of the Jacobian w.r.t. the unknowns */
+  Eigen::PartialPivLU<Eigen::MatrixXd> J_x_lu_;
+
+ public:
+  /**
+   * @param fy algebraic system at the solution as a function of the
+   * parameters
+   * @param J_x Jacobian w.r.t. the unknowns at the solution
+   */
+  algebra_solver_adjoint(const Fy& fy, const Eigen::MatrixXd& J_x)
+      : fy_(fy), J_x_lu_(J_x) {}
+
+  /**
+   * Return Jf_y^T lambda with J_x^T lambda = x_adj, where Jf_y is the
+   * Jacobian of the system functor w.r.t. the parameters.
+   *
+   * @param x_adj adjoints of the solution
+   */
+  inline Eigen::VectorXd operator()(const Eigen::VectorXd& x_adj) const {
+    Eigen::VectorXd lambda = J_x_lu_.transpose().solve(x_adj);
+
+    nested_rev_autodiff nested;
+    Eigen::Matrix<var, Eigen::Dynamic, 1> y_var = fy_.y_.template cast<var>();
+    var lambda_f = dot_product(lambda, fy_(y_var));
+    lambda_f.grad();
+    return y_var.adj();
+  }
+};
+
+}  // namespace internal
+
 template <typename T1, typename T2>
 void algebra_solver_check(const Eigen::Matrix<T1, Eigen::Dynamic, 1>& x,
                           const Eigen::Matrix<T2, Eigen::Dynamic, 1> y,
@@ -14,6 +14,22 @@
 namespace stan {
 namespace math {
 
+/**
+ * Calculate the right hand side of a coupled ode system with forward
+ * mode autodiff. Forward mode autodiff is not available here, so this
+ * returns false and the right hand side is calculated with reverse mode
+ * autodiff. The overload for <code>coupled_ode_system_impl</code> in
+ * <code>stan/math/mix/functor/coupled_ode_system.hpp</code> is found
+ * instead if forward mode autodiff is included.
+ *
+ * @return false
+ */
+template <typename T>
+inline bool coupled_ode_forward_rhs(T& system, const std::vector<double>& z,
+                                    std::vector<double>& dz_dt, double t) {
+  return false;
+}
+
 /**
  * The <code>coupled_ode_system_impl</code> template specialization when
  * the state or parameters are autodiff types.
@@ -72,8 +88,8 @@ struct coupled_ode_system_impl<false, F, T_y0, Args...> {
   const size_t num_y0_vars_;
   const size_t num_args_vars;
   const size_t N_;
-  Eigen::VectorXd args_adjoints_;
-  Eigen::VectorXd y_adjoints_;
+  Eigen::MatrixXd args_adjoints_;
+  Eigen::MatrixXd y_adjoints_;
   std::ostream* msgs_;
 
   /**
@@ -95,14 +111,25 @@ struct coupled_ode_system_impl<false, F, T_y0, Args...> {
         num_y0_vars_(count_vars(y0_)),
         num_args_vars(count_vars(args...)),
         N_(y0.size()),
-        args_adjoints_(num_args_vars),
-        y_adjoints_(N_),
+        args_adjoints_(num_args_vars, N_),
+        y_adjoints_(N_, N_),
         msgs_(msgs) {}
 
   /**
    * Calculates the right hand side of the coupled ode system (the regular
    * ode system with forward sensitivities).
    *
+   * If forward mode autodiff is included and there are fewer
+   * sensitivities than states, the right hand side of every sensitivity
+   * is calculated as a directional derivative with one forward pass (see
+   * <code>coupled_ode_forward_rhs()</code>).
+   *
+   * Otherwise the Jacobians of the ode right hand side with respect to
+   * the states and the parameters are computed with one recording of the
+   * right hand side and one reverse sweep per state. The sensitivity
+   * right hand side J_y * S + [0, J_args] is then formed with one matrix
+   * product.
+   *
    * @param[in] z state of the coupled ode system; this must be size
    *   <code>size()</code>
    * @param[out] dz_dt a vector of size <code>size()</code> with the
@@ -115,6 +142,10 @@ struct coupled_ode_system_impl<false, F, T_y0, Args...> {
                   double t) {
     using std::vector;
 
+    if (coupled_ode_forward_rhs(*this, z, dz_dt, t)) {
+      return;
+    }
+
     dz_dt.resize(size());
 
     // Run nested autodiff in this scope
@@ -135,14 +166,14 @@ struct coupled_ode_system_impl<false, F, T_y0, Args...> {
       dz_dt[i] = f_y_t_vars.coeffRef(i).val();
       f_y_t_vars.coeffRef(i).grad();
 
-      y_adjoints_ = y_vars.adj();
+      y_adjoints_.col(i) = y_vars.adj();
 
       // memset was faster than Eigen setZero
-      memset(args_adjoints_.data(), 0, sizeof(double) * num_args_vars);
+      memset(args_adjoints_.col(i).data(), 0, sizeof(double) * num_args_vars);
 
       apply(
           [&](auto&&... args) {
-            accumulate_adjoints(args_adjoints_.data(), args...);
+            accumulate_adjoints(args_adjoints_.col(i).data(), args...);
           },
           local_args_tuple_);
 
@@ -154,30 +185,15 @@ struct coupled_ode_system_impl<false, F, T_y0, Args...> {
       if (i + 1 < N_) {
         nested.set_zero_all_adjoints();
       }
-
-      // Compute the right hand side for the sensitivities with respect to the
-      // initial conditions
-      for (size_t j = 0; j < num_y0_vars_; ++j) {
-        double temp_deriv = 0.0;
-        for (size_t k = 0; k < N_; ++k) {
-          temp_deriv += z[N_ + N_ * j + k] * y_adjoints_.coeffRef(k);
-        }
-
-        dz_dt[N_ + N_ * j + i] = temp_deriv;
-      }
-
-      // Compute the right hand size for the sensitivities with respect to the
-      // parameters
-      for (size_t j = 0; j < num_args_vars; ++j) {
-        double temp_deriv = args_adjoints_.coeffRef(j);
-        for (size_t k = 0; k < N_; ++k) {
-          temp_deriv += z[N_ + N_ * num_y0_vars_ + N_ * j + k]
-                        * y_adjoints_.coeffRef(k);
-        }
-
-        dz_dt[N_ + N_ * num_y0_vars_ + N_ * j + i] = temp_deriv;
-      }
     }
+
+    // The sensitivities are stored column major as an N x (num_y0_vars_ +
+    // num_args_vars) matrix S, with right hand side J_y * S + [0, J_args]
+    const size_t num_sens = num_y0_vars_ + num_args_vars;
+    Eigen::Map<const Eigen::MatrixXd> S(z.data() + N_, N_, num_sens);
+    Eigen::Map<Eigen::MatrixXd> dS_dt(dz_dt.data() + N_, N_, num_sens);
+    dS_dt.noalias() = y_adjoints_.transpose() * S;
+    dS_dt.rightCols(num_args_vars) += args_adjoints_.transpose();
   }
 
   /**
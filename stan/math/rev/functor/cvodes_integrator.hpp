@@ -4,18 +4,121 @@
 #include <stan/math/rev/meta.hpp>
 #include <stan/math/rev/functor/cvodes_utils.hpp>
 #include <stan/math/rev/functor/coupled_ode_system.hpp>
+#include <stan/math/rev/functor/ode_linear_solver.hpp>
 #include <stan/math/rev/functor/ode_store_sensitivities.hpp>
+#include <stan/math/rev/functor/sundials_workspace_cache.hpp>
 #include <stan/math/prim/err.hpp>
 #include <stan/math/prim/fun/value_of.hpp>
 #include <cvodes/cvodes.h>
 #include <nvector/nvector_serial.h>
+#include <sunlinsol/sunlinsol_band.h>
 #include <sunlinsol/sunlinsol_dense.h>
+#include <sunlinsol/sunlinsol_spgmr.h>
+#include <sunmatrix/sunmatrix_band.h>
 #include <algorithm>
+#include <memory>
 #include <ostream>
+#include <stdexcept>
 #include <vector>
 
 namespace stan {
 namespace math {
+namespace internal {
+
+/**
+ * Size of the problem and linear solver of a CVODES workspace.
+ */
+struct cvodes_workspace_key {
+  size_t N;
+  size_t num_sens;
+  ode_linear_solver::solver_type solver_type;
+  int upper_bandwidth;
+  int lower_bandwidth;
+  int max_krylov_dim;
+
+  inline bool operator==(const cvodes_workspace_key& other) const {
+    return N == other.N && num_sens == other.num_sens
+           && solver_type == other.solver_type
+           && upper_bandwidth == other.upper_bandwidth
+           && lower_bandwidth == other.lower_bandwidth
+           && max_krylov_dim == other.max_krylov_dim;
+  }
+};
+
+/**
+ * CVODES memory, state and sensitivity vectors, jacobian matrix and
+ * linear solver of an ODE solve, which can be reused by later solves
+ * of the same size (see <code>sundials_workspace_cache</code>).
+ *
+ * The state vectors do not own their data; it is set to the coupled
+ * state of the integrator before every solve. The CVODES memory is
+ * initialized by the first solve and reinitialized by later ones.
+ *
+ * CVODES copies its user data pointer into the sensitivity, jacobian
+ * and preconditioner modules when they are initialized, so the user
+ * data of the CVODES memory is always the workspace itself, which
+ * points to the integrator of the current solve.
+ *
+ * For the band and iterative linear solvers the workspace also keeps
+ * the sparsity pattern of the jacobian and its coloring. They are set
+ * up by the first solve and reused by later ones.
+ */
+struct cvodes_workspace {
+  void* cvodes_mem_;
+  N_Vector nv_state_;
+  N_Vector* nv_state_sens_ = nullptr;
+  const size_t num_sens_;
+  SUNMatrix A_ = nullptr;
+  SUNLinearSolver LS_ = nullptr;
+  bool initialized_ = false;
+  void* integrator_ = nullptr;
+  Eigen::SparseMatrix<double> jacobian_sparsity_;
+  std::vector<int> jacobian_colors_;
+  int num_jacobian_colors_ = 0;
+
+  /**
+   * Allocate a workspace.
+   *
+   * @param lmm ID of ODE solver (1: ADAMS, 2: BDF)
+   * @param key Size of the problem and linear solver
+   * @throw <code>std::runtime_error</code> if CVODES fails to allocate
+   *   its memory
+   */
+  cvodes_workspace(int lmm, const cvodes_workspace_key& key)
+      : cvodes_mem_(CVodeCreate(lmm)), num_sens_(key.num_sens) {
+    if (cvodes_mem_ == nullptr) {
+      throw std::runtime_error("CVodeCreate failed to allocate memory");
+    }
+    nv_state_ = N_VNewEmpty_Serial(key.N);
+    if (num_sens_ > 0) {
+      nv_state_sens_ = N_VCloneVectorArrayEmpty_Serial(num_sens_, nv_state_);
+    }
+    if (key.solver_type == ode_linear_solver::dense) {
+      A_ = SUNDenseMatrix(key.N, key.N);
+      LS_ = SUNDenseLinearSolver(nv_state_, A_);
+    } else if (key.solver_type == ode_linear_solver::band) {
+      A_ = SUNBandMatrix(key.N, key.upper_bandwidth, key.lower_bandwidth);
+      LS_ = SUNLinSol_Band(nv_state_, A_);
+    } else {
+      LS_ = SUNLinSol_SPGMR(nv_state_, PREC_LEFT, key.max_krylov_dim);
+    }
+  }
+
+  cvodes_workspace(const cvodes_workspace&) = delete;
+  cvodes_workspace& operator=(const cvodes_workspace&) = delete;
+
+  ~cvodes_workspace() {
+    CVodeFree(&cvodes_mem_);
+    SUNLinSolFree(LS_);
+    SUNMatDestroy(A_);
+    if (num_sens_ > 0) {
+      N_VDestroyVectorArray_Serial(nv_state_sens_, num_sens_);
+    }
+    N_VDestroy_Serial(nv_state_);
+  }
+};
+
+}  // namespace internal
 
 /**
  * Integrator interface for CVODES' ODE solvers (Adams & BDF
@@ -47,6 +150,7 @@ class cvodes_integrator {
   double relative_tolerance_;
   double absolute_tolerance_;
   long int max_num_steps_;  // NOLINT(runtime/int)
+  const ode_linear_solver linear_solver_;
 
   const size_t num_y0_vars_;
   const size_t num_args_vars_;
@@ -54,17 +158,29 @@ class cvodes_integrator {
   coupled_ode_system<F, T_y0_t0, T_Args...> coupled_ode_;
 
   std::vector<double> coupled_state_;
-  N_Vector nv_state_;
-  N_Vector* nv_state_sens_;
-  SUNMatrix A_;
-  SUNLinearSolver LS_;
+
+  // sparse jacobian for the band and iterative linear solvers
+  Eigen::SparseMatrix<double> jacobian_;
+  std::vector<int> jacobian_colors_;
+  int num_jacobian_colors_ = 0;
+  Eigen::SparseLU<Eigen::SparseMatrix<double>> newton_lu_;
+  bool newton_lu_analyzed_ = false;
+
+  /**
+   * Returns the integrator of the current solve from the user data of
+   * the CVODES memory, which is its workspace.
+   */
+  static inline cvodes_integrator* get_integrator(void* user_data) {
+    return static_cast<cvodes_integrator*>(
+        static_cast<internal::cvodes_workspace*>(user_data)->integrator_);
+  }
 
   /**
    * Implements the function of type CVRhsFn which is the user-defined
    * ODE RHS passed to CVODES.
    */
   static int cv_rhs(realtype t, N_Vector y, N_Vector ydot, void* user_data) {
-    cvodes_integrator* integrator = static_cast<cvodes_integrator*>(user_data);
+    cvodes_integrator* integrator = get_integrator(user_data);
     integrator->rhs(t, NV_DATA_S(y), NV_DATA_S(ydot));
     return 0;
   }
@@ -76,7 +192,7 @@ class cvodes_integrator {
   static int cv_rhs_sens(int Ns, realtype t, N_Vector y, N_Vector ydot,
                          N_Vector* yS, N_Vector* ySdot, void* user_data,
                          N_Vector tmp1, N_Vector tmp2) {
-    cvodes_integrator* integrator = static_cast<cvodes_integrator*>(user_data);
+    cvodes_integrator* integrator = get_integrator(user_data);
     integrator->rhs_sens(t, NV_DATA_S(y), yS, ySdot);
     return 0;
   }
@@ -90,11 +206,38 @@ class cvodes_integrator {
   static int cv_jacobian_states(realtype t, N_Vector y, N_Vector fy,
                                 SUNMatrix J, void* user_data, N_Vector tmp1,
                                 N_Vector tmp2, N_Vector tmp3) {
-    cvodes_integrator* integrator = static_cast<cvodes_integrator*>(user_data);
+    cvodes_integrator* integrator = get_integrator(user_data);
     integrator->jacobian_states(t, NV_DATA_S(y), J);
     return 0;
   }
 
+  /**
+   * Implements the function of type CVLsPrecSetupFn which factorizes the
+   * sparse preconditioner I - gamma * J of the iterative linear solver,
+   * calculating J anew unless CVODES allows to reuse it.
+   */
+  static int cv_prec_setup(realtype t, N_Vector y, N_Vector fy,
+                           booleantype jok, booleantype* jcurPtr,
+                           realtype gamma, void* user_data) {
+    cvodes_integrator* integrator = get_integrator(user_data);
+    *jcurPtr = jok ? SUNFALSE : SUNTRUE;
+    return integrator->prec_setup(t, NV_DATA_S(y), !jok, gamma);
+  }
+
+  /**
+   * Implements the function of type CVLsPrecSolveFn which applies the
+   * inverse of the sparse preconditioner.
+   */
+  static int cv_prec_solve(realtype t, N_Vector y, N_Vector fy, N_Vector r,
+                           N_Vector z, realtype gamma, realtype delta, int lr,
+                           void* user_data) {
+    cvodes_integrator* integrator = get_integrator(user_data);
+    Eigen::Map<Eigen::VectorXd>(NV_DATA_S(z), integrator->N_)
+        = integrator->newton_lu_.solve(
+            Eigen::Map<const Eigen::VectorXd>(NV_DATA_S(r), integrator->N_));
+    return 0;
+  }
+
   /**
    * Calculates the ODE RHS, dy_dt, using the user-supplied functor at
    * the given time t and state y.
@@ -112,20 +255,40 @@ class cvodes_integrator {
     std::copy(dy_dt_vec.data(), dy_dt_vec.data() + dy_dt_vec.size(), dy_dt);
   }
 
+  /**
+   * Return the ODE RHS at time t as a function of the states only.
+   */
+  inline auto rhs_states(double t) const {
+    return [this, t](const Eigen::Matrix<var, Eigen::Dynamic, 1>& y) {
+      return apply([&](auto&&... args) { return f_(t, y, msgs_, args...); },
+                   value_of_args_tuple_);
+    };
+  }
+
   /**
    * Calculates the jacobian of the ODE RHS wrt to its states y at the
    * given time-point t and state y.
    */
-  inline void jacobian_states(double t, const double y[], SUNMatrix J) const {
+  inline void jacobian_states(double t, const double y[], SUNMatrix J) {
+    if (linear_solver_.type == ode_linear_solver::band) {
+      internal::sparse_jacobian(rhs_states(t),
+                                Eigen::Map<const Eigen::VectorXd>(y, N_),
+                                jacobian_colors_, num_jacobian_colors_,
+                                jacobian_);
+      SUNMatZero(J);
+      for (int j = 0; j < jacobian_.outerSize(); ++j) {
+        for (Eigen::SparseMatrix<double>::InnerIterator it(jacobian_, j); it;
+             ++it) {
+          SM_ELEMENT_B(J, it.row(), it.col()) = it.value();
+        }
+      }
+      return;
+    }
+
     Eigen::VectorXd fy;
     Eigen::MatrixXd Jfy;
 
-    auto f_wrapped = [&](const Eigen::Matrix<var, Eigen::Dynamic, 1>& y) {
-      return apply([&](auto&&... args) { return f_(t, y, msgs_, args...); },
-                   value_of_args_tuple_);
-    };
-
-    jacobian(f_wrapped, Eigen::Map<const Eigen::VectorXd>(y, N_), fy, Jfy);
+    jacobian(rhs_states(t), Eigen::Map<const Eigen::VectorXd>(y, N_), fy, Jfy);
 
     for (size_t j = 0; j < Jfy.cols(); ++j) {
       for (size_t i = 0; i < Jfy.rows(); ++i) {
@@ -134,6 +297,144 @@ class cvodes_integrator {
     }
   }
 
+  /**
+   * Factorizes the sparse preconditioner I - gamma * J, where J is the
+   * sparse jacobian of the ODE RHS at time t and state y, if \p update
+   * is true, or the last jacobian otherwise. Returns a positive value,
+   * a recoverable failure for CVODES, if the matrix is singular.
+   */
+  inline int prec_setup(double t, const double y[], bool update,
+                        double gamma) {
+    if (update) {
+      internal::sparse_jacobian(rhs_states(t),
+                                Eigen::Map<const Eigen::VectorXd>(y, N_),
+                                jacobian_colors_, num_jacobian_colors_,
+                                jacobian_);
+    }
+    Eigen::SparseMatrix<double> newton_matrix = -gamma * jacobian_;
+    newton_matrix.diagonal().array() += 1.0;
+    if (!newton_lu_analyzed_) {
+      newton_lu_.analyzePattern(newton_matrix);
+      newton_lu_analyzed_ = true;
+    }
+    newton_lu_.factorize(newton_matrix);
+    return newton_lu_.info() == Eigen::Success ? 0 : 1;
+  }
+
+  /**
+   * Returns the key of the CVODES workspace of this solve.
+   */
+  inline internal::cvodes_workspace_key workspace_key() const {
+    return {N_,
+            num_y0_vars_ + num_args_vars_,
+            linear_solver_.type,
+            linear_solver_.upper_bandwidth,
+            linear_solver_.lower_bandwidth,
+            linear_solver_.max_krylov_dim};
+  }
+
+  /**
+   * Sets up the sparse jacobian of the band and iterative linear solvers
+   * from the sparsity pattern of the workspace. The pattern is built by
+   * the first solve with the workspace: from the bandwidths for the band
+   * solver and by tracing the ODE right hand side at the initial state
+   * for the iterative solver.
+   *
+   * The iterative solver only uses the jacobian in its preconditioner,
+   * so a pattern which does not fit a later solve slows down GMRES but
+   * does not change the solution.
+   */
+  inline void init_jacobian(internal::cvodes_workspace& workspace) {
+    if (linear_solver_.type == ode_linear_solver::dense) {
+      return;
+    }
+    if (workspace.jacobian_sparsity_.rows() == 0) {
+      if (linear_solver_.type == ode_linear_solver::band) {
+        workspace.jacobian_sparsity_
+            = internal::band_sparsity(N_, linear_solver_.upper_bandwidth,
+                                      linear_solver_.lower_bandwidth);
+      } else {
+        workspace.jacobian_sparsity_ = internal::jacobian_sparsity(
+            rhs_states(value_of(t0_)), value_of(y0_));
+      }
+      workspace.jacobian_colors_ = internal::sparsity_row_coloring(
+          workspace.jacobian_sparsity_, workspace.num_jacobian_colors_);
+    }
+    jacobian_ = workspace.jacobian_sparsity_;
+    jacobian_colors_ = workspace.jacobian_colors_;
+    num_jacobian_colors_ = workspace.num_jacobian_colors_;
+  }
+
+  /**
+   * Returns the cache of CVODES workspaces of this integrator type on
+   * the calling thread.
+   */
+  static inline auto& workspace_cache() {
+    return internal::sundials_workspace_cache<
+        internal::cvodes_workspace_key,
+        internal::cvodes_workspace>::template instance<cvodes_integrator>();
+  }
+
+  /**
+   * Initializes the CVODES memory of a new workspace at the initial
+   * state: attaches the linear solver of the Newton iterations with its
+   * jacobian or preconditioner and the forward sensitivity system.
+   * Reinitializes the CVODES memory of a reused workspace instead.
+   */
+  inline void init_workspace(internal::cvodes_workspace& workspace) {
+    void* cvodes_mem = workspace.cvodes_mem_;
+    const size_t num_sens = num_y0_vars_ + num_args_vars_;
+    if (workspace.initialized_) {
+      check_flag_sundials(
+          CVodeReInit(cvodes_mem, value_of(t0_), workspace.nv_state_),
+          "CVodeReInit");
+      if (num_sens > 0) {
+        check_flag_sundials(CVodeSensReInit(cvodes_mem, CV_STAGGERED,
+                                            workspace.nv_state_sens_),
+                            "CVodeSensReInit");
+      }
+      return;
+    }
+
+    check_flag_sundials(CVodeInit(cvodes_mem, &cvodes_integrator::cv_rhs,
+                                  value_of(t0_), workspace.nv_state_),
+                        "CVodeInit");
+
+    check_flag_sundials(
+        CVodeSetUserData(cvodes_mem, reinterpret_cast<void*>(&workspace)),
+        "CVodeSetUserData");
+
+    check_flag_sundials(
+        CVodeSetLinearSolver(cvodes_mem, workspace.LS_, workspace.A_),
+        "CVodeSetLinearSolver");
+    if (workspace.A_ != nullptr) {
+      check_flag_sundials(
+          CVodeSetJacFn(cvodes_mem, &cvodes_integrator::cv_jacobian_states),
+          "CVodeSetJacFn");
+    } else {
+      check_flag_sundials(
+          CVodeSetPreconditioner(cvodes_mem, &cvodes_integrator::cv_prec_setup,
+                                 &cvodes_integrator::cv_prec_solve),
+          "CVodeSetPreconditioner");
+    }
+
+    // initialize forward sensitivity system of CVODES as needed
+    if (num_sens > 0) {
+      check_flag_sundials(
+          CVodeSensInit(cvodes_mem, static_cast<int>(num_sens), CV_STAGGERED,
+                        &cvodes_integrator::cv_rhs_sens,
+                        workspace.nv_state_sens_),
+          "CVodeSensInit");
+
+      check_flag_sundials(CVodeSetSensErrCon(cvodes_mem, SUNTRUE),
+                          "CVodeSetSensErrCon");
+
+      check_flag_sundials(CVodeSensEEtolerances(cvodes_mem),
+                          "CVodeSensEEtolerances");
+    }
+    workspace.initialized_ = true;
+  }
+
   /**
    * Calculates the RHS of the sensitivity ODE system which
    * corresponds to the coupled ode system from which the first N
@@ -171,6 +472,7 @@ class cvodes_integrator {
    * @param absolute_tolerance Absolute tolerance passed to CVODES
    * @param max_num_steps Upper limit on the number of integration steps to
    *   take between each output (error if exceeded)
+   * @param linear_solver Linear solver of the Newton iterations
    * @param[in, out] msgs the print stream for warning messages
    * @param args Extra arguments passed unmodified through to ODE right hand
    * side function
@@ -178,8 +480,9 @@ class cvodes_integrator {
    * @return a vector of states, each state being a vector of the
    *   same size as the state variable, corresponding to a time in ts.
    * @throw <code>std::domain_error</code> if y0, t0, ts, theta, x are not
-   *   finite, all elements of ts are not greater than t0, or ts is not
-   *   sorted in strictly increasing order.
+   *   finite, all elements of ts are not greater than t0, ts is not
+   *   sorted in strictly increasing order, or the band linear solver has
+   *   a negative bandwidth.
    * @throw <code>std::invalid_argument</code> if arguments are the wrong
    *   size or tolerances or max_num_steps are out of range.
    */
@@ -188,6 +491,7 @@ class cvodes_integrator {
                     const T_t0& t0, const std::vector<T_ts>& ts,
                     double relative_tolerance, double absolute_tolerance,
                     long int max_num_steps,  // NOLINT(runtime/int)
+                    const ode_linear_solver& linear_solver,
                     std::ostream* msgs, const T_Args&... args)
       : function_name_(function_name),
         f_(f),
@@ -201,6 +505,7 @@ class cvodes_integrator {
         relative_tolerance_(relative_tolerance),
         absolute_tolerance_(absolute_tolerance),
         max_num_steps_(max_num_steps),
+        linear_solver_(linear_solver),
         num_y0_vars_(count_vars(y0_)),
         num_args_vars_(count_vars(args...)),
         coupled_ode_(f, y0_, msgs, args...),
@@ -228,29 +533,14 @@ class cvodes_integrator {
     check_positive_finite(function_name, "absolute_tolerance",
                           absolute_tolerance_);
     check_positive(function_name, "max_num_steps", max_num_steps_);
-
-    nv_state_ = N_VMake_Serial(N_, &coupled_state_[0]);
-    nv_state_sens_ = nullptr;
-    A_ = SUNDenseMatrix(N_, N_);
-    LS_ = SUNDenseLinearSolver(nv_state_, A_);
-
-    if (num_y0_vars_ + num_args_vars_ > 0) {
-      nv_state_sens_ = N_VCloneVectorArrayEmpty_Serial(
-          num_y0_vars_ + num_args_vars_, nv_state_);
-      for (std::size_t i = 0; i < num_y0_vars_ + num_args_vars_; i++) {
-        NV_DATA_S(nv_state_sens_[i]) = &coupled_state_[N_] + i * N_;
-      }
-    }
-  }
-
-  ~cvodes_integrator() {
-    SUNLinSolFree(LS_);
-    SUNMatDestroy(A_);
-    N_VDestroy_Serial(nv_state_);
-    if (num_y0_vars_ + num_args_vars_ > 0) {
-      N_VDestroyVectorArray_Serial(nv_state_sens_,
-                                   num_y0_vars_ + num_args_vars_);
+    if (linear_solver_.type == ode_linear_solver::band) {
+      check_nonnegative(function_name, "upper_bandwidth",
+                        linear_solver_.upper_bandwidth);
+      check_nonnegative(function_name, "lower_bandwidth",
+                        linear_solver_.lower_bandwidth);
     }
+    check_nonnegative(function_name, "max_krylov_dim",
+                      linear_solver_.max_krylov_dim);
   }
 
   /**
@@ -264,83 +554,63 @@ class cvodes_integrator {
   std::vector<Eigen::Matrix<T_Return, Eigen::Dynamic, 1>> operator()() {
     std::vector<Eigen::Matrix<T_Return, Eigen::Dynamic, 1>> y;
 
-    void* cvodes_mem = CVodeCreate(Lmm);
-    if (cvodes_mem == nullptr) {
-      throw std::runtime_error("CVodeCreate failed to allocate memory");
+    // A workspace is only put back into the cache after a successful
+    // solve and is freed otherwise
+    const internal::cvodes_workspace_key key = workspace_key();
+    std::unique_ptr<internal::cvodes_workspace> workspace
+        = workspace_cache().acquire(key);
+    if (!workspace) {
+      workspace = std::make_unique<internal::cvodes_workspace>(Lmm, key);
     }
+    void* cvodes_mem = workspace->cvodes_mem_;
+    N_Vector nv_state = workspace->nv_state_;
+    N_Vector* nv_state_sens = workspace->nv_state_sens_;
 
-    try {
-      check_flag_sundials(CVodeInit(cvodes_mem, &cvodes_integrator::cv_rhs,
-                                    value_of(t0_), nv_state_),
-                          "CVodeInit");
+    NV_DATA_S(nv_state) = coupled_state_.data();
+    for (std::size_t i = 0; i < num_y0_vars_ + num_args_vars_; i++) {
+      NV_DATA_S(nv_state_sens[i]) = coupled_state_.data() + N_ + i * N_;
+    }
 
-      // Assign pointer to this as user data
-      check_flag_sundials(
-          CVodeSetUserData(cvodes_mem, reinterpret_cast<void*>(this)),
-          "CVodeSetUserData");
+    workspace->integrator_ = this;
+    init_workspace(*workspace);
+    init_jacobian(*workspace);
 
-      cvodes_set_options(cvodes_mem, relative_tolerance_, absolute_tolerance_,
-                         max_num_steps_);
+    cvodes_set_options(cvodes_mem, relative_tolerance_, absolute_tolerance_,
+                       max_num_steps_);
 
-      check_flag_sundials(CVodeSetLinearSolver(cvodes_mem, LS_, A_),
-                          "CVodeSetLinearSolver");
-      check_flag_sundials(
-          CVodeSetJacFn(cvodes_mem, &cvodes_integrator::cv_jacobian_states),
-          "CVodeSetJacFn");
+    double t_init = value_of(t0_);
+    for (size_t n = 0; n < ts_.size(); ++n) {
+      double t_final = value_of(ts_[n]);
 
-      // initialize forward sensitivity system of CVODES as needed
-      if (num_y0_vars_ + num_args_vars_ > 0) {
-        check_flag_sundials(
-            CVodeSensInit(
-                cvodes_mem, static_cast<int>(num_y0_vars_ + num_args_vars_),
-                CV_STAGGERED, &cvodes_integrator::cv_rhs_sens, nv_state_sens_),
-            "CVodeSensInit");
+      if (t_final != t_init) {
+        int error_code
+            = CVode(cvodes_mem, t_final, nv_state, &t_init, CV_NORMAL);
 
-        check_flag_sundials(CVodeSetSensErrCon(cvodes_mem, SUNTRUE),
-                            "CVodeSetSensErrCon");
-
-        check_flag_sundials(CVodeSensEEtolerances(cvodes_mem),
-                            "CVodeSensEEtolerances");
-      }
+        if (error_code == CV_TOO_MUCH_WORK) {
+          throw_domain_error(function_name_, "", t_final,
+                             "Failed to integrate to next output time (",
+                             ") in less than max_num_steps steps");
+        } else {
+          check_flag_sundials(error_code, "CVode");
+        }
 
-      double t_init = value_of(t0_);
-      for (size_t n = 0; n < ts_.size(); ++n) {
-        double t_final = value_of(ts_[n]);
-
-        if (t_final != t_init) {
-          int error_code
-              = CVode(cvodes_mem, t_final, nv_state_, &t_init, CV_NORMAL);
-
-          if (error_code == CV_TOO_MUCH_WORK) {
-            throw_domain_error(function_name_, "", t_final,
-                               "Failed to integrate to next output time (",
-                               ") in less than max_num_steps steps");
-          } else {
-            check_flag_sundials(error_code, "CVode");
-          }
-
-          if (num_y0_vars_ + num_args_vars_ > 0) {
-            check_flag_sundials(
-                CVodeGetSens(cvodes_mem, &t_init, nv_state_sens_),
-                "CVodeGetSens");
-          }
+        if (num_y0_vars_ + num_args_vars_ > 0) {
+          check_flag_sundials(CVodeGetSens(cvodes_mem, &t_init, nv_state_sens),
+                              "CVodeGetSens");
         }
+      }
 
-        y.emplace_back(apply(
-            [&](auto&&... args) {
-              return ode_store_sensitivities(f_, coupled_state_, y0_, t0_,
-                                             ts_[n], msgs_, args...);
-            },
-            args_tuple_));
+      y.emplace_back(apply(
+          [&](auto&&... args) {
+            return ode_store_sensitivities(f_, coupled_state_, y0_, t0_,
+                                           ts_[n], msgs_, args...);
+          },
+          args_tuple_));
 
-        t_init = t_final;
-      }
-    } catch (const std::exception& e) {
-      CVodeFree(&cvodes_mem);
-      throw;
+      t_init = t_final;
     }
 
-    CVodeFree(&cvodes_mem);
+    workspace_cache().release(key, std::move(workspace));
 
     return y;
   }
@@ -0,0 +1,571 @@
+#ifndef STAN_MATH_REV_FUNCTOR_CVODES_INTEGRATOR_ADJOINT_HPP
+#define STAN_MATH_REV_FUNCTOR_CVODES_INTEGRATOR_ADJOINT_HPP
+
+#include <stan/math/rev/meta.hpp>
+#include <stan/math/rev/core.hpp>
+#include <stan/math/rev/functor/cvodes_utils.hpp>
+#include <stan/math/rev/functor/jacobian.hpp>
+#include <stan/math/prim/err.hpp>
+#include <stan/math/prim/fun/Eigen.hpp>
+#include <stan/math/prim/fun/value_of.hpp>
+#include <cvodes/cvodes.h>
+#include <nvector/nvector_serial.h>
+#include <sunlinsol/sunlinsol_dense.h>
+#include <sunlinsol/sunlinsol_spgmr.h>
+#include <algorithm>
+#include <ostream>
+#include <tuple>
+#include <vector>
+
+namespace stan {
+namespace math {
+
+/**
+ * Integrator interface for CVODES' ODE solvers (Adams & BDF methods)
+ * which calculates the gradients with the adjoint method.
+ *
+ * The forward solve integrates only the N states of the ODE and stores
+ * checkpoints of the solution. The outputs are returned as vars and a
+ * callback is put on the tape; when it is reached in the reverse pass,
+ * the adjoint ODE
+ *
+ *   lambda' = -J_y(t, y)^T lambda,
+ *
+ * is integrated backwards from the last output time to t0, adding the
+ * adjoints of the outputs to lambda at their times. The adjoints of the
+ * parameters are the quadrature of lambda^T J_p(t, y) along the way.
+ * Every right hand side of the backward problem is a single nested
+ * reverse pass through the ODE right hand side, so the cost of the
+ * gradient does not grow with the number of parameters as it does for
+ * the forward sensitivities of <code>cvodes_integrator</code>. The
+ * linear systems of the backward problem are solved with GMRES, whose
+ * products with -J_y^T are vector-jacobian products of one nested
+ * reverse pass each, so J_y is never formed in the reverse pass.
+ *
+ * Objects are created with <code>new</code> and are owned by the
+ * autodiff stack (see <code>chainable_alloc</code>), which keeps the
+ * CVODES memory and the checkpoints alive until the memory is recovered.
+ * The reverse pass can be run any number of times.
+ *
+ * @tparam Lmm ID of ODE solver (1: ADAMS, 2: BDF)
+ * @tparam F Type of ODE right hand side
+ * @tparam T_y0 Type of initial state
+ * @tparam T_t0 Type of scalar of initial time point
+ * @tparam T_ts Type of time-points where ODE solution is returned
+ * @tparam T_Args Types of pass-through parameters
+ */
+template <int Lmm, typename F, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args>
+class cvodes_integrator_adjoint : public chainable_alloc {
+  // number of steps between checkpoints of the forward solution
+  static constexpr long int num_steps_between_checkpoints_  // NOLINT
+      = 150;
+
+  const char* function_name_;
+  const F f_;
+  const size_t N_;
+  std::ostream* msgs_;
+  double relative_tolerance_;
+  double absolute_tolerance_;
+  long int max_num_steps_;  // NOLINT(runtime/int)
+
+  const Eigen::VectorXd y0_;
+  const double t0_;
+  std::vector<double> ts_;
+  std::tuple<plain_type_t<T_Args>...> args_tuple_;
+  std::tuple<plain_type_t<decltype(value_of(std::declval<const T_Args&>()))>...>
+      value_of_args_tuple_;
+
+  const size_t num_y0_vars_;
+  const size_t num_args_vars_;
+  vari** y0_varis_;
+  vari* t0_vari_ = nullptr;
+  vari** ts_varis_;
+  vari** args_varis_;
+  vari** y_varis_;  // outputs, N_ per output time
+
+  std::vector<Eigen::VectorXd> y_;  // states at the output times
+  void* cvodes_mem_ = nullptr;
+  N_Vector nv_state_ = nullptr;
+  SUNMatrix A_ = nullptr;
+  SUNLinearSolver LS_ = nullptr;
+
+  int index_backward_ = -1;
+  N_Vector nv_state_backward_ = nullptr;
+  N_Vector nv_quad_ = nullptr;
+  SUNLinearSolver LS_backward_ = nullptr;
+
+  // last right hand side of the backward problem and its quadrature
+  double adjoint_t_ = 0;
+  Eigen::VectorXd adjoint_y_;
+  Eigen::VectorXd adjoint_lambda_;
+  Eigen::VectorXd adjoint_lambda_dot_;
+  Eigen::VectorXd adjoint_quad_dot_;
+
+  /**
+   * Implements the function of type CVRhsFn which is the user-defined
+   * ODE RHS passed to CVODES.
+   */
+  static int cv_rhs(realtype t, N_Vector y, N_Vector ydot, void* user_data) {
+    auto* integrator = static_cast<cvodes_integrator_adjoint*>(user_data);
+    integrator->rhs(t, NV_DATA_S(y), NV_DATA_S(ydot));
+    return 0;
+  }
+
+  /**
+   * Implements the function of type CVDlsJacFn which is the
+   * user-defined callback for CVODES to calculate the jacobian of the
+   * ode_rhs wrt to the states y.
+   */
+  static int cv_jacobian_states(realtype t, N_Vector y, N_Vector fy,
+                                SUNMatrix J, void* user_data, N_Vector tmp1,
+                                N_Vector tmp2, N_Vector tmp3) {
+    auto* integrator = static_cast<cvodes_integrator_adjoint*>(user_data);
+    integrator->jacobian_states(t, NV_DATA_S(y), J);
+    return 0;
+  }
+
+  /**
+   * Implements the function of type CVRhsFnB which is the RHS of the
+   * adjoint ODE.
+   */
+  static int cv_rhs_adj(realtype t, N_Vector y, N_Vector yB, N_Vector yBdot,
+                        void* user_data) {
+    auto* integrator = static_cast<cvodes_integrator_adjoint*>(user_data);
+    integrator->rhs_adj(t, NV_DATA_S(y), NV_DATA_S(yB));
+    std::copy(integrator->adjoint_lambda_dot_.data(),
+              integrator->adjoint_lambda_dot_.data() + integrator->N_,
+              NV_DATA_S(yBdot));
+    return 0;
+  }
+
+  /**
+   * Implements the function of type CVQuadRhsFnB which is the RHS of
+   * the quadrature of the parameter adjoints.
+   */
+  static int cv_quad_rhs_adj(realtype t, N_Vector y, N_Vector yB,
+                             N_Vector qBdot, void* user_data) {
+    auto* integrator = static_cast<cvodes_integrator_adjoint*>(user_data);
+    integrator->rhs_adj(t, NV_DATA_S(y), NV_DATA_S(yB));
+    std::copy(integrator->adjoint_quad_dot_.data(),
+              integrator->adjoint_quad_dot_.data() + integrator->num_args_vars_,
+              NV_DATA_S(qBdot));
+    return 0;
+  }
+
+  /**
+   * Implements the function of type CVLsJacTimesVecFnB which is the
+   * product of the jacobian of the adjoint ODE RHS wrt to the adjoint
+   * states, -J_y^T, with the vector vB.
+   */
+  static int cv_jacobian_times_adj(N_Vector vB, N_Vector JvB, realtype t,
+                                   N_Vector y, N_Vector yB, N_Vector fyB,
+                                   void* user_data, N_Vector tmpB) {
+    auto* integrator = static_cast<cvodes_integrator_adjoint*>(user_data);
+    integrator->jacobian_times_adj(t, NV_DATA_S(y), NV_DATA_S(vB),
+                                   NV_DATA_S(JvB));
+    return 0;
+  }
+
+  /**
+   * Calculates the ODE RHS, dy_dt, using the user-supplied functor at
+   * the given time t and state y.
+   */
+  inline Eigen::VectorXd rhs(double t, const Eigen::VectorXd& y) const {
+    Eigen::VectorXd dy_dt
+        = apply([&](auto&&... args) { return f_(t, y, msgs_, args...); },
+                value_of_args_tuple_);
+    check_size_match(function_name_, "dy_dt", dy_dt.size(), "states", N_);
+    return dy_dt;
+  }
+
+  inline void rhs(double t, const double y[], double dy_dt[]) const {
+    Eigen::VectorXd dy_dt_vec
+        = rhs(t, Eigen::Map<const Eigen::VectorXd>(y, N_));
+    std::copy(dy_dt_vec.data(), dy_dt_vec.data() + N_, dy_dt);
+  }
+
+  /**
+   * Calculates the jacobian of the ODE RHS wrt to its states y at the
+   * given time-point t and state y.
+   */
+  inline void jacobian_states(double t, const double y[], SUNMatrix J) const {
+    Eigen::VectorXd fy;
+    Eigen::MatrixXd Jfy;
+
+    auto f_wrapped = [&](const Eigen::Matrix<var, Eigen::Dynamic, 1>& y) {
+      return apply([&](auto&&... args) { return f_(t, y, msgs_, args...); },
+                   value_of_args_tuple_);
+    };
+
+    jacobian(f_wrapped, Eigen::Map<const Eigen::VectorXd>(y, N_), fy, Jfy);
+
+    for (size_t j = 0; j < Jfy.cols(); ++j) {
+      for (size_t i = 0; i < Jfy.rows(); ++i) {
+        SM_ELEMENT_D(J, i, j) = Jfy(i, j);
+      }
+    }
+  }
+
+  /**
+   * Calculates -J_y^T v, the product of the jacobian of the adjoint ODE
+   * RHS with the vector v, as the vector-jacobian product -v^T J_y with
+   * one nested reverse pass at the given time t and state y.
+   */
+  inline void jacobian_times_adj(double t, const double y[], const double v[],
+                                 double Jv[]) const {
+    nested_rev_autodiff nested;
+    Eigen::Matrix<var, Eigen::Dynamic, 1> y_var(
+        Eigen::Map<const Eigen::VectorXd>(y, N_));
+    Eigen::Matrix<var, Eigen::Dynamic, 1> dy_dt
+        = apply([&](auto&&... args) { return f_(t, y_var, msgs_, args...); },
+                value_of_args_tuple_);
+    check_size_match(function_name_, "dy_dt", dy_dt.size(), "states", N_);
+    for (size_t i = 0; i < N_; ++i) {
+      dy_dt.coeffRef(i).adj() = -v[i];
+    }
+    grad();
+    for (size_t i = 0; i < N_; ++i) {
+      Jv[i] = y_var.coeff(i).adj();
+    }
+  }
+
+  /**
+   * Calculates the RHS of the adjoint ODE, -J_y^T lambda, and of the
+   * quadrature, -J_p^T lambda, with one nested reverse pass at the
+   * given time t, state y and adjoint state lambda. CVODES evaluates
+   * both at the same arguments, so the result of the last call is
+   * reused.
+   */
+  inline void rhs_adj(double t, const double y[], const double lambda[]) {
+    Eigen::Map<const Eigen::VectorXd> y_vec(y, N_);
+    Eigen::Map<const Eigen::VectorXd> lambda_vec(lambda, N_);
+    if (static_cast<size_t>(adjoint_lambda_dot_.size()) == N_
+        && t == adjoint_t_
+        && y_vec == adjoint_y_ && lambda_vec == adjoint_lambda_) {
+      return;
+    }
+
+    nested_rev_autodiff nested;
+    Eigen::Matrix<var, Eigen::Dynamic, 1> y_var(y_vec);
+    adjoint_quad_dot_ = Eigen::VectorXd::Zero(num_args_vars_);
+    apply(
+        [&](auto&&... args) {
+          [&](auto&&... local_args) {
+            Eigen::Matrix<var, Eigen::Dynamic, 1> dy_dt
+                = f_(t, y_var, msgs_, local_args...);
+            check_size_match(function_name_, "dy_dt", dy_dt.size(), "states",
+                             N_);
+            for (size_t i = 0; i < N_; ++i) {
+              dy_dt.coeffRef(i).adj() = -lambda[i];
+            }
+            grad();
+            accumulate_adjoints(adjoint_quad_dot_.data(), local_args...);
+          }(deep_copy_vars(args)...);
+        },
+        args_tuple_);
+
+    adjoint_lambda_dot_ = y_var.adj();
+    adjoint_t_ = t;
+    adjoint_y_ = y_vec;
+    adjoint_lambda_ = lambda_vec;
+  }
+
+  /**
+   * Throw a domain error if the integration failed because it took more
+   * than max_num_steps steps, otherwise check the CVODES flag.
+   */
+  inline void check_integration(int error_code, double t_final,
+                                const char* func_name) const {
+    if (error_code == CV_TOO_MUCH_WORK) {
+      throw_domain_error(function_name_, "", t_final,
+                         "Failed to integrate to next output time (",
+                         ") in less than max_num_steps steps");
+    }
+    check_flag_sundials(error_code, func_name);
+  }
+
+  /**
+   * Create the backward problem on the first reverse pass and restart
+   * it at time \p t_final otherwise.
+   */
+  inline void init_backward(double t_final) {
+    if (index_backward_ >= 0) {
+      check_flag_sundials(CVodeReInitB(cvodes_mem_, index_backward_, t_final,
+                                       nv_state_backward_),
+                          "CVodeReInitB");
+      if (num_args_vars_ > 0) {
+        check_flag_sundials(
+            CVodeQuadReInitB(cvodes_mem_, index_backward_, nv_quad_),
+            "CVodeQuadReInitB");
+      }
+      return;
+    }
+
+    check_flag_sundials(CVodeCreateB(cvodes_mem_, Lmm, &index_backward_),
+                        "CVodeCreateB");
+    check_flag_sundials(
+        CVodeInitB(cvodes_mem_, index_backward_,
+                   &cvodes_integrator_adjoint::cv_rhs_adj, t_final,
+                   nv_state_backward_),
+        "CVodeInitB");
+    check_flag_sundials(
+        CVodeSetUserDataB(cvodes_mem_, index_backward_,
+                          reinterpret_cast<void*>(this)),
+        "CVodeSetUserDataB");
+    check_flag_sundials(
+        CVodeSStolerancesB(cvodes_mem_, index_backward_, relative_tolerance_,
+                           absolute_tolerance_),
+        "CVodeSStolerancesB");
+    check_flag_sundials(
+        CVodeSetMaxNumStepsB(cvodes_mem_, index_backward_, max_num_steps_),
+        "CVodeSetMaxNumStepsB");
+    check_flag_sundials(CVodeSetLinearSolverB(cvodes_mem_, index_backward_,
+                                              LS_backward_, nullptr),
+                        "CVodeSetLinearSolverB");
+    check_flag_sundials(
+        CVodeSetJacTimesB(cvodes_mem_, index_backward_, nullptr,
+                          &cvodes_integrator_adjoint::cv_jacobian_times_adj),
+        "CVodeSetJacTimesB");
+
+    if (num_args_vars_ > 0) {
+      check_flag_sundials(
+          CVodeQuadInitB(cvodes_mem_, index_backward_,
+                         &cvodes_integrator_adjoint::cv_quad_rhs_adj,
+                         nv_quad_),
+          "CVodeQuadInitB");
+      check_flag_sundials(
+          CVodeQuadSStolerancesB(cvodes_mem_, index_backward_,
+                                 relative_tolerance_, absolute_tolerance_),
+          "CVodeQuadSStolerancesB");
+      check_flag_sundials(
+          CVodeSetQuadErrConB(cvodes_mem_, index_backward_, SUNTRUE),
+          "CVodeSetQuadErrConB");
+    }
+  }
+
+  /**
+   * Integrate the adjoint ODE backwards from the last output time to
+   * t0 and add the resulting adjoints to the operands.
+   */
+  inline void reverse() {
+    Eigen::Map<Eigen::VectorXd> lambda(NV_DATA_S(nv_state_backward_), N_);
+    Eigen::Map<Eigen::VectorXd> quad(NV_DATA_S(nv_quad_), num_args_vars_);
+    lambda.setZero();
+    quad.setZero();
+    Eigen::VectorXd y_adj(N_);
+
+    for (size_t n = ts_.size(); n-- > 0;) {
+      for (size_t i = 0; i < N_; ++i) {
+        y_adj.coeffRef(i) = y_varis_[n * N_ + i]->adj_;
+      }
+      lambda += y_adj;
+      if (is_var<T_ts>::value) {
+        ts_varis_[n]->adj_ += y_adj.dot(rhs(ts_[n], y_[n]));
+      }
+
+      const double t_final = ts_[n];
+      const double t_init = n > 0 ? ts_[n - 1] : t0_;
+      if (t_final != t_init) {
+        init_backward(t_final);
+        check_integration(CVodeB(cvodes_mem_, t_init, CV_NORMAL), t_init,
+                          "CVodeB");
+        double t_ret;
+        check_flag_sundials(CVodeGetB(cvodes_mem_, index_backward_, &t_ret,
+                                      nv_state_backward_),
+                            "CVodeGetB");
+        if (num_args_vars_ > 0) {
+          check_flag_sundials(
+              CVodeGetQuadB(cvodes_mem_, index_backward_, &t_ret, nv_quad_),
+              "CVodeGetQuadB");
+        }
+      }
+    }
+
+    for (size_t i = 0; i < num_y0_vars_; ++i) {
+      y0_varis_[i]->adj_ += lambda.coeff(i);
+    }
+    if (is_var<T_t0>::value) {
+      t0_vari_->adj_ -= lambda.dot(rhs(t0_, y0_));
+    }
+    for (size_t j = 0; j < num_args_vars_; ++j) {
+      args_varis_[j]->adj_ += quad.coeff(j);
+    }
+  }
+
+ public:
+  /**
+   * Construct cvodes_integrator_adjoint object. Nothing is checked
+   * or allocated here, since the object is already owned by the
+   * autodiff stack; see operator().
+   *
+   * @param function_name Calling function name (for printing debugging
+   * messages)
+   * @param f Right hand side of the ODE
+   * @param y0 Initial state
+   * @param t0 Initial time
+   * @param ts Times at which to solve the ODE at. All values must be sorted
+   *   and greater than t0.
+   * @param relative_tolerance Relative tolerance passed to CVODES
+   * @param absolute_tolerance Absolute tolerance passed to CVODES
+   * @param max_num_steps Upper limit on the number of integration steps to
+   *   take between each output (error if exceeded)
+   * @param[in, out] msgs the print stream for warning messages
+   * @param args Extra arguments passed unmodified through to ODE right hand
+   * side function
+   */
+  template <require_eigen_col_vector_t<T_y0>* = nullptr>
+  cvodes_integrator_adjoint(const char* function_name, const F& f,
+                                 const T_y0& y0, const T_t0& t0,
+                                 const std::vector<T_ts>& ts,
+                                 double relative_tolerance,
+                                 double absolute_tolerance,
+                                 long int max_num_steps,  // NOLINT
+                                 std::ostream* msgs, const T_Args&... args)
+      : function_name_(function_name),
+        f_(f),
+        N_(y0.size()),
+        msgs_(msgs),
+        relative_tolerance_(relative_tolerance),
+        absolute_tolerance_(absolute_tolerance),
+        max_num_steps_(max_num_steps),
+        y0_(value_of(y0).template cast<double>()),
+        t0_(value_of(t0)),
+        ts_(ts.size()),
+        args_tuple_(args...),
+        value_of_args_tuple_(value_of(args)...),
+        num_y0_vars_(count_vars(y0)),
+        num_args_vars_(count_vars(args...)),
+        y0_varis_(ChainableStack::instance_->memalloc_.alloc_array<vari*>(
+            num_y0_vars_)),
+        ts_varis_(ChainableStack::instance_->memalloc_.alloc_array<vari*>(
+            count_vars(ts))),
+        args_varis_(ChainableStack::instance_->memalloc_.alloc_array<vari*>(
+            num_args_vars_)),
+        y_varis_(ChainableStack::instance_->memalloc_.alloc_array<vari*>(
+            N_ * ts.size())) {
+    for (size_t n = 0; n < ts.size(); ++n) {
+      ts_[n] = value_of(ts[n]);
+    }
+    save_varis(y0_varis_, y0);
+    save_varis(ts_varis_, ts);
+    save_varis(args_varis_, args...);
+    if (is_var<T_t0>::value) {
+      save_varis(&t0_vari_, t0);
+    }
+  }
+
+  ~cvodes_integrator_adjoint() {
+    CVodeFree(&cvodes_mem_);
+    SUNLinSolFree(LS_backward_);
+    SUNLinSolFree(LS_);
+    SUNMatDestroy(A_);
+    if (nv_quad_ != nullptr) {
+      N_VDestroy_Serial(nv_quad_);
+    }
+    if (nv_state_backward_ != nullptr) {
+      N_VDestroy_Serial(nv_state_backward_);
+    }
+    if (nv_state_ != nullptr) {
+      N_VDestroy_Serial(nv_state_);
+    }
+  }
+
+  /**
+   * Solve the ODE initial value problem y' = f(t, y), y(t0) = y0 at a set of
+   * times, { t1, t2, t3, ... } and put the adjoint solve on the tape.
+   *
+   * @return std::vector of Eigen::Matrix of the states of the ODE, one for each
+   *   solution time (excluding the initial state)
+   * @throw <code>std::domain_error</code> if y0, t0, ts, theta, x are not
+   *   finite, all elements of ts are not greater than t0, ts is not
+   *   sorted, or the integration takes more than max_num_steps steps.
+   * @throw <code>std::invalid_argument</code> if arguments are the wrong
+   *   size or tolerances or max_num_steps are out of range.
+   */
+  std::vector<Eigen::Matrix<var, Eigen::Dynamic, 1>> operator()() {
+    check_finite(function_name_, "initial state", y0_);
+    check_finite(function_name_, "initial time", t0_);
+    check_finite(function_name_, "times", ts_);
+    apply(
+        [&](auto&&... args) {
+          std::vector<int> unused_temp{
+              0,
+              (check_finite(function_name_, "ode parameters and data", args),
+               0)...};
+        },
+        value_of_args_tuple_);
+    check_nonzero_size(function_name_, "times", ts_);
+    check_nonzero_size(function_name_, "initial state", y0_);
+    check_sorted(function_name_, "times", ts_);
+    check_less(function_name_, "initial time", t0_, ts_[0]);
+    check_positive_finite(function_name_, "relative_tolerance",
+                          relative_tolerance_);
+    check_positive_finite(function_name_, "absolute_tolerance",
+                          absolute_tolerance_);
+    check_positive(function_name_, "max_num_steps", max_num_steps_);
+
+    nv_state_ = N_VNew_Serial(N_);
+    std::copy(y0_.data(), y0_.data() + N_, NV_DATA_S(nv_state_));
+    A_ = SUNDenseMatrix(N_, N_);
+    LS_ = SUNDenseLinearSolver(nv_state_, A_);
+    nv_state_backward_ = N_VNew_Serial(N_);
+    nv_quad_ = N_VNew_Serial(num_args_vars_);
+    // a Krylov subspace as large as the system needs no restarts
+    LS_backward_ = SUNLinSol_SPGMR(nv_state_backward_, PREC_NONE, N_);
+
+    cvodes_mem_ = CVodeCreate(Lmm);
+    if (cvodes_mem_ == nullptr) {
+      throw std::runtime_error("CVodeCreate failed to allocate memory");
+    }
+
+    check_flag_sundials(
+        CVodeInit(cvodes_mem_, &cvodes_integrator_adjoint::cv_rhs, t0_,
+                  nv_state_),
+        "CVodeInit");
+    check_flag_sundials(
+        CVodeSetUserData(cvodes_mem_, reinterpret_cast<void*>(this)),
+        "CVodeSetUserData");
+    cvodes_set_options(cvodes_mem_, relative_tolerance_, absolute_tolerance_,
+                       max_num_steps_);
+    check_flag_sundials(CVodeSetLinearSolver(cvodes_mem_, LS_, A_),
+                        "CVodeSetLinearSolver");
+    check_flag_sundials(
+        CVodeSetJacFn(cvodes_mem_,
+                      &cvodes_integrator_adjoint::cv_jacobian_states),
+        "CVodeSetJacFn");
+    check_flag_sundials(
+        CVodeAdjInit(cvodes_mem_, num_steps_between_checkpoints_, CV_HERMITE),
+        "CVodeAdjInit");
+
+    std::vector<Eigen::Matrix<var, Eigen::Dynamic, 1>> y;
+    y.reserve(ts_.size());
+    y_.reserve(ts_.size());
+    double t_init = t0_;
+    for (size_t n = 0; n < ts_.size(); ++n) {
+      const double t_final = ts_[n];
+      if (t_final != t_init) {
+        int num_checkpoints;
+        check_integration(CVodeF(cvodes_mem_, t_final, nv_state_, &t_init,
+                                 CV_NORMAL, &num_checkpoints),
+                          t_final, "CVodeF");
+      }
+      y_.emplace_back(Eigen::Map<Eigen::VectorXd>(NV_DATA_S(nv_state_), N_));
+
+      Eigen::Matrix<var, Eigen::Dynamic, 1> y_n(N_);
+      for (size_t i = 0; i < N_; ++i) {
+        y_varis_[n * N_ + i] = new vari(y_.back().coeff(i), false);
+        y_n.coeffRef(i) = var(y_varis_[n * N_ + i]);
+      }
+      y.emplace_back(std::move(y_n));
+      t_init = t_final;
+    }
+
+    reverse_pass_callback([this]() { this->reverse(); });
+    return y;
+  }
+};  // cvodes integrator adjoint
+
+}  // namespace math
+}  // namespace stan
+#endif
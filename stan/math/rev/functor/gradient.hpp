@@ -4,6 +4,9 @@
 #include <stan/math/rev/meta.hpp>
 #include <stan/math/rev/core.hpp>
 #include <stan/math/prim/fun/Eigen.hpp>
+#include <stan/math/prim/err.hpp>
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
 #include <stdexcept>
 
 namespace stan {
@@ -51,6 +54,65 @@ void gradient(const F& f, const Eigen::Matrix<double, Eigen::Dynamic, 1>& x,
   grad_fx = x_var.adj();
 }
 
+/**
+ * Calculate the values and the gradients of the specified function
+ * at each of the specified arguments.
+ *
+ * <p>The functor must meet the requirements of <code>gradient()</code>.
+ * The arguments are the columns of <code>x</code> and may be processed
+ * concurrently, so the functor must be safe to call from several
+ * threads at once.
+ *
+ * <p>With <code>STAN_THREADS</code> the columns are split into chunks of
+ * at least <code>grainsize</code> columns which are processed with the
+ * TBB. Each thread records on its own autodiff stack (see
+ * <code>ad_tape_observer</code>) and evaluates the gradients of its
+ * columns one after the other in nested autodiff, so the memory of its
+ * arena is reused from one column to the next. Without
+ * <code>STAN_THREADS</code> the columns are processed sequentially on
+ * the autodiff stack of the caller.
+ *
+ * @tparam F Type of function
+ * @param[in] f Function
+ * @param[in] x Arguments to function, one per column
+ * @param[out] fx Function applied to each argument
+ * @param[out] grad_fx Gradient of function at each argument, one per
+ * column
+ * @param[in] grainsize Minimal number of columns processed in one task
+ * @throw std::domain_error if grainsize is not positive
+ */
+template <typename F>
+void gradient_batch(
+    const F& f, const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& x,
+    Eigen::Matrix<double, Eigen::Dynamic, 1>& fx,
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& grad_fx,
+    int grainsize = 1) {
+  check_positive("gradient_batch", "grainsize", grainsize);
+  fx.resize(x.cols());
+  grad_fx.resize(x.rows(), x.cols());
+
+  auto execute_chunk = [&](size_t start, size_t end) {
+    for (size_t j = start; j < end; ++j) {
+      nested_rev_autodiff nested;
+
+      Eigen::Matrix<var, Eigen::Dynamic, 1> x_var(x.col(j));
+      var fx_var = f(x_var);
+      fx.coeffRef(j) = fx_var.val();
+      grad(fx_var.vi_);
+      grad_fx.col(j) = x_var.adj();
+    }
+  };
+
+#ifdef STAN_THREADS
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, x.cols(), grainsize),
+                    [&](const tbb::blocked_range<size_t>& r) {
+                      execute_chunk(r.begin(), r.end());
+                    });
+#else
+  execute_chunk(0, x.cols());
+#endif
+}
+
 }  // namespace math
 }  // namespace stan
 #endif
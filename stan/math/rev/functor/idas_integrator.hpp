@@ -3,10 +3,14 @@
 
 #include <stan/math/rev/meta.hpp>
 #include <stan/math/rev/functor/idas_forward_system.hpp>
+#include <stan/math/rev/functor/ode_linear_solver.hpp>
 #include <stan/math/prim/err.hpp>
 #include <idas/idas.h>
+#include <sunmatrix/sunmatrix_band.h>
 #include <sunmatrix/sunmatrix_dense.h>
+#include <sunlinsol/sunlinsol_band.h>
 #include <sunlinsol/sunlinsol_dense.h>
+#include <sunlinsol/sunlinsol_spgmr.h>
 #include <nvector/nvector_serial.h>
 #include <ostream>
 #include <vector>
@@ -24,6 +28,7 @@ class idas_integrator {
   const double rtol_;
   const double atol_;
   const int64_t max_num_steps_;
+  const ode_linear_solver linear_solver_;
   /**
    * Forward decl
    */
@@ -77,10 +82,17 @@ class idas_integrator {
    * @param[in] rtol relative tolerance
    * @param[in] atol absolute tolerance
    * @param[in] max_num_steps max nb. of times steps
+   * @param[in] linear_solver linear solver of the Newton iterations. The
+   * bandwidths of a band solver must be given, since the jacobian of the
+   * residual is not available to detect them.
    */
   idas_integrator(const double rtol, const double atol,
-                  const int64_t max_num_steps = IDAS_MAX_STEPS)
-      : rtol_(rtol), atol_(atol), max_num_steps_(max_num_steps) {
+                  const int64_t max_num_steps = IDAS_MAX_STEPS,
+                  const ode_linear_solver& linear_solver = ode_linear_solver())
+      : rtol_(rtol),
+        atol_(atol),
+        max_num_steps_(max_num_steps),
+        linear_solver_(linear_solver) {
     if (rtol_ <= 0) {
       invalid_argument("idas_integrator", "relative tolerance,", rtol_, "",
                        ", must be greater than 0");
@@ -97,6 +109,23 @@ class idas_integrator {
       invalid_argument("idas_integrator", "max_num_steps,", max_num_steps_, "",
                        ", must be greater than 0");
     }
+    if (linear_solver_.type == ode_linear_solver::band) {
+      if (linear_solver_.upper_bandwidth < 0) {
+        invalid_argument("idas_integrator", "upper bandwidth,",
+                         linear_solver_.upper_bandwidth, "",
+                         ", must be nonnegative");
+      }
+      if (linear_solver_.lower_bandwidth < 0) {
+        invalid_argument("idas_integrator", "lower bandwidth,",
+                         linear_solver_.lower_bandwidth, "",
+                         ", must be nonnegative");
+      }
+    }
+    if (linear_solver_.max_krylov_dim < 0) {
+      invalid_argument("idas_integrator", "max_krylov_dim,",
+                       linear_solver_.max_krylov_dim, "",
+                       ", must be nonnegative");
+    }
   }
 
   /**
@@ -137,8 +166,18 @@ class idas_integrator {
     typename Dae::return_type res_yy(
         ts.size(), std::vector<typename Dae::scalar_type>(n, 0));
 
-    auto A = SUNDenseMatrix(n, n);
-    auto LS = SUNDenseLinearSolver(yy, A);
+    SUNMatrix A = nullptr;
+    SUNLinearSolver LS = nullptr;
+    if (linear_solver_.type == ode_linear_solver::dense) {
+      A = SUNDenseMatrix(n, n);
+      LS = SUNDenseLinearSolver(yy, A);
+    } else if (linear_solver_.type == ode_linear_solver::band) {
+      A = SUNBandMatrix(n, linear_solver_.upper_bandwidth,
+                        linear_solver_.lower_bandwidth);
+      LS = SUNLinSol_Band(yy, A);
+    } else {
+      LS = SUNLinSol_SPGMR(yy, PREC_NONE, linear_solver_.max_krylov_dim);
+    }
 
     try {
       CHECK_IDAS_CALL(IDASetUserData(mem, dae.to_user_data()));
@@ -10,10 +10,14 @@
 #include <stan/math/prim/fun/constants.hpp>
 #include <stan/math/prim/functor/integrate_1d.hpp>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <functional>
 #include <ostream>
 #include <string>
 #include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace stan {
@@ -59,6 +63,90 @@ inline double gradient_of_f(const F &f, const double &x, const double &xc,
   return gradient;
 }
 
+namespace internal {
+
+/**
+ * Gradients of f(x, xc, param, std::ostream&) with respect to all the
+ * parameters, memoized at the quadrature nodes.
+ *
+ * The integrals of the gradients w.r.t. the different parameters are
+ * computed with the same quadrature rule and therefore mostly evaluate
+ * the integrand at the same nodes. Memoizing the gradients lets all of
+ * them share a single nested reverse pass per node instead of running
+ * one per node and parameter.
+ *
+ * Gradients that evaluate to NaN are set to zero if the function itself
+ * evaluates to zero. If the function is not zero and the gradient
+ * evaluates to NaN, a std::domain_error is thrown when that gradient is
+ * requested.
+ *
+ * @tparam F type of f
+ */
+template <typename F>
+class integrand_gradients {
+  const F& f_;
+  const std::vector<double>& theta_vals_;
+  const std::vector<double>& x_r_;
+  const std::vector<int>& x_i_;
+  std::ostream* msgs_;
+
+  struct node_hash {
+    inline std::size_t operator()(
+        const std::pair<std::uint64_t, std::uint64_t>& node) const {
+      return std::hash<std::uint64_t>()(node.first)
+             ^ (std::hash<std::uint64_t>()(node.second) << 1);
+    }
+  };
+
+  // function value followed by the gradients, keyed by the bit patterns
+  // of x and xc (xc may be NaN)
+  std::unordered_map<std::pair<std::uint64_t, std::uint64_t>,
+                     std::vector<double>, node_hash>
+      nodes_;
+
+ public:
+  integrand_gradients(const F& f, const std::vector<double>& theta_vals,
+                      const std::vector<double>& x_r,
+                      const std::vector<int>& x_i, std::ostream* msgs)
+      : f_(f), theta_vals_(theta_vals), x_r_(x_r), x_i_(x_i), msgs_(msgs) {}
+
+  /**
+   * Return the gradient of f at (x, xc) with respect to the nth
+   * parameter.
+   */
+  inline double operator()(double x, double xc, size_t n) {
+    std::pair<std::uint64_t, std::uint64_t> node;
+    std::memcpy(&node.first, &x, sizeof(double));
+    std::memcpy(&node.second, &xc, sizeof(double));
+    auto it = nodes_.find(node);
+    if (it == nodes_.end()) {
+      nested_rev_autodiff nested;
+      std::vector<var> theta_var(theta_vals_.begin(), theta_vals_.end());
+      var fx = f_(x, xc, theta_var, x_r_, x_i_, msgs_);
+      fx.grad();
+      std::vector<double> values(theta_var.size() + 1);
+      values[0] = fx.val();
+      for (size_t i = 0; i < theta_var.size(); ++i) {
+        values[i + 1] = theta_var[i].adj();
+      }
+      it = nodes_.emplace(node, std::move(values)).first;
+    }
+
+    double gradient = it->second[n + 1];
+    if (is_nan(gradient)) {
+      if (it->second[0] == 0) {
+        gradient = 0;
+      } else {
+        throw_domain_error("gradient_of_f", "The gradient of f", n,
+                           "is nan for parameter ", "");
+      }
+    }
+    return gradient;
+  }
+};
+
+}  // namespace internal
+
 /**
  * Compute the integral of the single variable function f from a to b to within
  * a specified relative tolerance. a and b can be finite or infinite.
@@ -141,12 +229,12 @@ inline return_type_t<T_a, T_b, T_theta> integrate_1d(
 
     if (N_theta_vars > 0) {
       std::vector<double> theta_vals = value_of(theta);
+      internal::integrand_gradients<F> gradients(f, theta_vals, x_r, x_i,
+                                                 msgs);
 
       for (size_t n = 0; n < N_theta_vars; ++n) {
         dintegral_dtheta[n] = integrate(
-            std::bind<double>(gradient_of_f<F>, f, std::placeholders::_1,
-                              std::placeholders::_2, theta_vals, x_r, x_i, n,
-                              msgs),
+            [&](double x, double xc) { return gradients(x, xc, n); },
             value_of(a), value_of(b), relative_tolerance);
         theta_concat[n] = theta[n];
       }
@@ -13,7 +13,9 @@ namespace math {
 /**
  * Return the solutions for a semi-explicit DAE system with residual
  * specified by functor F,
- * given the specified consistent initial state yy0 and yp0.
+ * given the specified consistent initial state yy0 and yp0, using the
+ * given linear solver in the Newton iterations, e.g. a band solver for
+ * large systems with banded jacobians.
  *
  * @tparam DAE type of DAE system
  * @tparam Tpar scalar type of parameter theta
@@ -29,6 +31,7 @@ namespace math {
  * @param[in] x_i int data
  * @param[in] rtol relative tolerance passed to IDAS, required <10^-3
  * @param[in] atol absolute tolerance passed to IDAS, problem-dependent
+ * @param[in] linear_solver linear solver of the Newton iterations
  * @param[in] max_num_steps maximal number of admissable steps
  * between time-points
  * @param[in] msgs message
@@ -41,13 +44,14 @@ std::vector<std::vector<Tpar> > integrate_dae(
     double t0, const std::vector<double>& ts, const std::vector<Tpar>& theta,
     const std::vector<double>& x_r, const std::vector<int>& x_i,
     const double rtol, const double atol,
+    const ode_linear_solver& linear_solver,
     const int64_t max_num_steps = idas_integrator::IDAS_MAX_STEPS,
     std::ostream* msgs = nullptr) {
   /* it doesn't matter here what values \c eq_id has, as we
      don't allow yy0 or yp0 to be parameters */
   const std::vector<int> dummy_eq_id(yy0.size(), 0);
 
-  stan::math::idas_integrator solver(rtol, atol, max_num_steps);
+  stan::math::idas_integrator solver(rtol, atol, max_num_steps, linear_solver);
   stan::math::idas_forward_system<F, double, double, Tpar> dae{
       f, dummy_eq_id, yy0, yp0, theta, x_r, x_i, msgs};
 
@@ -56,6 +60,43 @@ std::vector<std::vector<Tpar> > integrate_dae(
   return solver.integrate(dae, t0, ts);
 }
 
+/**
+ * Return the solutions for a semi-explicit DAE system with residual
+ * specified by functor F,
+ * given the specified consistent initial state yy0 and yp0.
+ *
+ * @tparam DAE type of DAE system
+ * @tparam Tpar scalar type of parameter theta
+ *
+ * @param[in] f functor for the base ordinary differential equation
+ * @param[in] yy0 initial state
+ * @param[in] yp0 initial derivative state
+ * @param[in] t0 initial time
+ * @param[in] ts times of the desired solutions, in strictly
+ * increasing order, all greater than the initial time
+ * @param[in] theta parameters
+ * @param[in] x_r real data
+ * @param[in] x_i int data
+ * @param[in] rtol relative tolerance passed to IDAS, required <10^-3
+ * @param[in] atol absolute tolerance passed to IDAS, problem-dependent
+ * @param[in] max_num_steps maximal number of admissable steps
+ * between time-points
+ * @param[in] msgs message
+ * @return a vector of states, each state being a vector of the
+ * same size as the state variable, corresponding to a time in ts.
+ */
+template <typename F, typename Tpar>
+std::vector<std::vector<Tpar> > integrate_dae(
+    const F& f, const std::vector<double>& yy0, const std::vector<double>& yp0,
+    double t0, const std::vector<double>& ts, const std::vector<Tpar>& theta,
+    const std::vector<double>& x_r, const std::vector<int>& x_i,
+    const double rtol, const double atol,
+    const int64_t max_num_steps = idas_integrator::IDAS_MAX_STEPS,
+    std::ostream* msgs = nullptr) {
+  return integrate_dae(f, yy0, yp0, t0, ts, theta, x_r, x_i, rtol, atol,
+                       ode_linear_solver(), max_num_steps, msgs);
+}
+
 }  // namespace math
 }  // namespace stan
 
@@ -2,20 +2,73 @@
 #define STAN_MATH_REV_FUNCTOR_KINSOL_DATA_HPP
 
 #include <stan/math/rev/functor/algebra_system.hpp>
-#include <stan/math/rev/functor/jacobian.hpp>
+#include <stan/math/rev/functor/sparse_jacobian.hpp>
+#include <stan/math/rev/functor/sundials_workspace_cache.hpp>
+#include <stan/math/prim/err.hpp>
 #include <stan/math/prim/fun/to_array_1d.hpp>
 #include <stan/math/prim/fun/to_vector.hpp>
 #include <kinsol/kinsol.h>
 #include <sunmatrix/sunmatrix_dense.h>
 #include <sunlinsol/sunlinsol_dense.h>
 #include <nvector/nvector_serial.h>
+#include <memory>
+#include <stdexcept>
 #include <vector>
 
 namespace stan {
 namespace math {
+namespace internal {
 
 /**
- * Default Jacobian builder using reverse-mode autodiff.
+ * KINSOL memory, vectors, dense jacobian matrix and linear solver of an
+ * algebraic system, which can be reused by later solves of the same size
+ * (see <code>sundials_workspace_cache</code>). The KINSOL memory is
+ * initialized by the first solve.
+ */
+struct kinsol_workspace {
+  N_Vector nv_x_;
+  N_Vector nv_scaling_;
+  SUNMatrix J_;
+  SUNLinearSolver LS_;
+  void* kinsol_memory_;
+  bool initialized_ = false;
+
+  /**
+   * Allocate a workspace.
+   *
+   * @param N Size of the algebraic system
+   * @throw <code>std::runtime_error</code> if KINSOL fails to allocate
+   *   its memory
+   */
+  explicit kinsol_workspace(size_t N)
+      : nv_x_(N_VNew_Serial(N)),
+        nv_scaling_(N_VNew_Serial(N)),
+        J_(SUNDenseMatrix(N, N)),
+        LS_(SUNLinSol_Dense(nv_x_, J_)),
+        kinsol_memory_(KINCreate()) {
+    if (kinsol_memory_ == nullptr) {
+      throw std::runtime_error("KINCreate failed to allocate memory");
+    }
+  }
+
+  kinsol_workspace(const kinsol_workspace&) = delete;
+  kinsol_workspace& operator=(const kinsol_workspace&) = delete;
+
+  ~kinsol_workspace() {
+    N_VDestroy_Serial(nv_x_);
+    N_VDestroy_Serial(nv_scaling_);
+    SUNLinSolFree(LS_);
+    SUNMatDestroy(J_);
+    KINFree(&kinsol_memory_);
+  }
+};
+
+}  // namespace internal
+
+/**
+ * Default Jacobian builder using reverse-mode autodiff, with one reverse
+ * pass per color of the rows of the sparsity pattern traced at every
+ * argument (see <code>internal::traced_jacobian()</code>).
  */
 struct kinsol_J_f {
   template <typename F>
@@ -29,7 +82,7 @@ struct kinsol_J_f {
     system_functor<F, double, double, 1> system(f, x, y, dat, dat_int, msgs);
     Eigen::VectorXd fx;
     Eigen::MatrixXd Jac;
-    jacobian(system, to_vector(x_vec), fx, Jac);
+    internal::traced_jacobian(system, to_vector(x_vec), fx, Jac);
 
     for (int j = 0; j < Jac.cols(); j++)
       for (int i = 0; i < Jac.rows(); i++)
@@ -60,13 +113,31 @@ class kinsol_system_data {
 
   typedef kinsol_system_data<F1, F2> system_data;
 
+  static inline auto& workspace_cache() {
+    return internal::sundials_workspace_cache<
+        size_t, internal::kinsol_workspace>::template instance<system_data>();
+  }
+
+  std::unique_ptr<internal::kinsol_workspace> workspace_;
+
  public:
   N_Vector nv_x_;
+  N_Vector nv_scaling_;
   SUNMatrix J_;
   SUNLinearSolver LS_;
   void* kinsol_memory_;
+  /** If true, the last jacobian and its argument are copied below */
+  bool record_jacobian_ = false;
+  /** argument of the last jacobian, empty if none was recorded */
+  Eigen::VectorXd jacobian_x_;
+  /** last jacobian, before KINSOL factors it in place */
+  Eigen::MatrixXd jacobian_;
 
-  /* Constructor */
+  /**
+   * Constructor. Takes a workspace of the size of the system from the
+   * cache of the calling thread, or allocates and initializes a new one
+   * with the system function and dense linear solver.
+   */
   kinsol_system_data(const F1& f, const F2& J_f, const Eigen::VectorXd& x,
                      const Eigen::VectorXd& y, const std::vector<double>& dat,
                      const std::vector<int>& dat_int, std::ostream* msgs)
@@ -78,16 +149,32 @@ class kinsol_system_data {
         dat_(dat),
         dat_int_(dat_int),
         msgs_(msgs),
-        nv_x_(N_VMake_Serial(N_, &to_array_1d(x_)[0])),
-        J_(SUNDenseMatrix(N_, N_)),
-        LS_(SUNLinSol_Dense(nv_x_, J_)),
-        kinsol_memory_(KINCreate()) {}
+        workspace_(workspace_cache().acquire(N_)) {
+    if (!workspace_) {
+      workspace_ = std::make_unique<internal::kinsol_workspace>(N_);
+    }
+    nv_x_ = workspace_->nv_x_;
+    nv_scaling_ = workspace_->nv_scaling_;
+    J_ = workspace_->J_;
+    LS_ = workspace_->LS_;
+    kinsol_memory_ = workspace_->kinsol_memory_;
+    if (!workspace_->initialized_) {
+      check_flag_sundials(
+          KINInit(kinsol_memory_, &system_data::kinsol_f_system, nv_x_),
+          "KINInit");
+      check_flag_sundials(KINSetLinearSolver(kinsol_memory_, LS_, J_),
+                          "KINSetLinearSolver");
+      workspace_->initialized_ = true;
+    }
+  }
 
+  /**
+   * Destructor. KINSOL reinitializes its memory at the start of every
+   * solve, so the workspace goes back into the cache even if the solve
+   * failed.
+   */
   ~kinsol_system_data() {
-    N_VDestroy_Serial(nv_x_);
-    SUNLinSolFree(LS_);
-    SUNMatDestroy(J_);
-    KINFree(&kinsol_memory_);
+    workspace_cache().release(N_, std::move(workspace_));
   }
 
   /* Implements the user-defined function passed to KINSOL. */
@@ -120,12 +207,19 @@ class kinsol_system_data {
    */
   static int kinsol_jacobian(N_Vector x, N_Vector f, SUNMatrix J,
                              void* user_data, N_Vector tmp1, N_Vector tmp2) {
-    const system_data* explicit_system
-        = static_cast<const system_data*>(user_data);
-    return explicit_system->J_f_(explicit_system->f_, explicit_system->x_,
-                                 explicit_system->y_, explicit_system->dat_,
-                                 explicit_system->dat_int_,
-                                 explicit_system->msgs_, NV_DATA_S(x), J);
+    system_data* explicit_system = static_cast<system_data*>(user_data);
+    int flag = explicit_system->J_f_(
+        explicit_system->f_, explicit_system->x_, explicit_system->y_,
+        explicit_system->dat_, explicit_system->dat_int_,
+        explicit_system->msgs_, NV_DATA_S(x), J);
+    if (flag == 0 && explicit_system->record_jacobian_) {
+      const size_t N = explicit_system->N_;
+      explicit_system->jacobian_x_
+          = Eigen::Map<Eigen::VectorXd>(NV_DATA_S(x), N);
+      explicit_system->jacobian_
+          = Eigen::Map<Eigen::MatrixXd>(SM_DATA_D(J), N, N);
+    }
+    return flag;
   }
 };
 
@@ -10,6 +10,7 @@
 #include <sunmatrix/sunmatrix_dense.h>
 #include <sunlinsol/sunlinsol_dense.h>
 #include <nvector/nvector_serial.h>
+#include <utility>
 #include <vector>
 
 namespace stan {
@@ -47,6 +48,11 @@ namespace math {
  *            If equal to 1, the algorithm computes exact Newton steps.
  * @param[in] global_line_search does the solver use a global line search?
  *            If equal to KIN_NONE, no, if KIN_LINESEARCH, yes.
+ * @param[out] J_solution If not null, the Jacobian at the solution. The
+ *            last Jacobian of the Newton iterations is reused if it was
+ *            evaluated at the solution, which only happens if the last
+ *            step did not change the iterate; otherwise the Jacobian is
+ *            evaluated once more with <code>J_f</code>.
  * @return x_solution Vector of solutions to the system of equations.
  * @throw <code>std::invalid_argument</code> if Kinsol returns a negative
  *        flag when setting up the solver.
@@ -63,76 +69,76 @@ Eigen::VectorXd kinsol_solve(
     double function_tolerance = 1e-6,
     long int max_num_steps = 200,  // NOLINT(runtime/int)
     bool custom_jacobian = 1, const F2& J_f = kinsol_J_f(),
-    int steps_eval_jacobian = 10, int global_line_search = KIN_LINESEARCH) {
+    int steps_eval_jacobian = 10, int global_line_search = KIN_LINESEARCH,
+    Eigen::MatrixXd* J_solution = nullptr) {
   int N = x.size();
   typedef kinsol_system_data<F1, F2> system_data;
   system_data kinsol_data(f, J_f, x, y, dat, dat_int, msgs);
 
-  check_flag_sundials(KINInit(kinsol_data.kinsol_memory_,
-                              &system_data::kinsol_f_system, kinsol_data.nv_x_),
-                      "KINInit");
-
-  N_Vector scaling = N_VNew_Serial(N);
-  N_Vector nv_x = N_VNew_Serial(N);
+  N_Vector scaling = kinsol_data.nv_scaling_;
+  N_Vector nv_x = kinsol_data.nv_x_;
   Eigen::VectorXd x_solution(N);
 
-  try {
-    N_VConst_Serial(1.0, scaling);  // no scaling
-
-    check_flag_sundials(
-        KINSetNumMaxIters(kinsol_data.kinsol_memory_, max_num_steps),
-        "KINSetNumMaxIters");
-    check_flag_sundials(
-        KINSetFuncNormTol(kinsol_data.kinsol_memory_, function_tolerance),
-        "KINSetFuncNormTol");
-    check_flag_sundials(
-        KINSetScaledStepTol(kinsol_data.kinsol_memory_, scaling_step_tol),
-        "KINSetScaledStepTol");
-    check_flag_sundials(
-        KINSetMaxSetupCalls(kinsol_data.kinsol_memory_, steps_eval_jacobian),
-        "KINSetMaxSetupCalls");
-
-    // CHECK
-    // The default value is 1000 * ||u_0||_D where ||u_0|| is the initial guess.
-    // So we run into issues if ||u_0|| = 0.
-    // If the norm is non-zero, use kinsol's default (accessed with 0),
-    // else use the dimension of x -- CHECK - find optimal length.
-    double max_newton_step = (x.norm() == 0) ? x.size() : 0;
-    check_flag_sundials(
-        KINSetMaxNewtonStep(kinsol_data.kinsol_memory_, max_newton_step),
-        "KINSetMaxNewtonStep");
-    check_flag_sundials(KINSetUserData(kinsol_data.kinsol_memory_,
-                                       static_cast<void*>(&kinsol_data)),
-                        "KINSetUserData");
-
-    // construct Linear solver
-    check_flag_sundials(KINSetLinearSolver(kinsol_data.kinsol_memory_,
-                                           kinsol_data.LS_, kinsol_data.J_),
-                        "KINSetLinearSolver");
-
-    if (custom_jacobian)
-      check_flag_sundials(KINSetJacFn(kinsol_data.kinsol_memory_,
-                                      &system_data::kinsol_jacobian),
-                          "KINSetJacFn");
-
-    for (int i = 0; i < N; i++)
-      NV_Ith_S(nv_x, i) = x(i);
-
-    check_flag_kinsol(KINSol(kinsol_data.kinsol_memory_, nv_x,
-                             global_line_search, scaling, scaling),
-                      max_num_steps);
-
-    for (int i = 0; i < N; i++)
-      x_solution(i) = NV_Ith_S(nv_x, i);
-  } catch (const std::exception& e) {
-    N_VDestroy(nv_x);
-    N_VDestroy(scaling);
-    throw;
+  N_VConst_Serial(1.0, scaling);  // no scaling
+
+  check_flag_sundials(
+      KINSetNumMaxIters(kinsol_data.kinsol_memory_, max_num_steps),
+      "KINSetNumMaxIters");
+  check_flag_sundials(
+      KINSetFuncNormTol(kinsol_data.kinsol_memory_, function_tolerance),
+      "KINSetFuncNormTol");
+  check_flag_sundials(
+      KINSetScaledStepTol(kinsol_data.kinsol_memory_, scaling_step_tol),
+      "KINSetScaledStepTol");
+  check_flag_sundials(
+      KINSetMaxSetupCalls(kinsol_data.kinsol_memory_, steps_eval_jacobian),
+      "KINSetMaxSetupCalls");
+
+  // CHECK
+  // The default value is 1000 * ||u_0||_D where ||u_0|| is the initial guess.
+  // So we run into issues if ||u_0|| = 0.
+  // If the norm is non-zero, use kinsol's default (accessed with 0),
+  // else use the dimension of x -- CHECK - find optimal length.
+  double max_newton_step = (x.norm() == 0) ? x.size() : 0;
+  check_flag_sundials(
+      KINSetMaxNewtonStep(kinsol_data.kinsol_memory_, max_newton_step),
+      "KINSetMaxNewtonStep");
+  check_flag_sundials(KINSetUserData(kinsol_data.kinsol_memory_,
+                                     static_cast<void*>(&kinsol_data)),
+                      "KINSetUserData");
+
+  // a reused workspace may have been used with another jacobian setting,
+  // and a null jacobian function selects the difference quotient
+  check_flag_sundials(
+      KINSetJacFn(kinsol_data.kinsol_memory_,
+                  custom_jacobian ? &system_data::kinsol_jacobian : nullptr),
+      "KINSetJacFn");
+
+  for (int i = 0; i < N; i++)
+    NV_Ith_S(nv_x, i) = x(i);
+
+  kinsol_data.record_jacobian_ = custom_jacobian && J_solution != nullptr;
+
+  check_flag_kinsol(KINSol(kinsol_data.kinsol_memory_, nv_x,
+                           global_line_search, scaling, scaling),
+                    max_num_steps);
+
+  for (int i = 0; i < N; i++)
+    x_solution(i) = NV_Ith_S(nv_x, i);
+
+  if (J_solution != nullptr) {
+    if (kinsol_data.jacobian_x_.size() == N
+        && kinsol_data.jacobian_x_ == x_solution) {
+      *J_solution = std::move(kinsol_data.jacobian_);
+    } else {
+      check_flag_sundials(J_f(f, x, y, dat, dat_int, msgs, x_solution.data(),
+                              kinsol_data.J_),
+                          "J_f");
+      *J_solution = Eigen::Map<Eigen::MatrixXd>(SM_DATA_D(kinsol_data.J_), N,
+                                                N);
+    }
   }
 
-  N_VDestroy(nv_x);
-  N_VDestroy(scaling);
-
   return x_solution;
 }
 
@@ -0,0 +1,348 @@
+#ifndef STAN_MATH_REV_FUNCTOR_ODE_ADJOINT_HPP
+#define STAN_MATH_REV_FUNCTOR_ODE_ADJOINT_HPP
+
+#include <stan/math/rev/meta.hpp>
+#include <stan/math/rev/functor/cvodes_integrator.hpp>
+#include <stan/math/rev/functor/cvodes_integrator_adjoint.hpp>
+#include <stan/math/prim/fun/Eigen.hpp>
+#include <ostream>
+#include <vector>
+
+namespace stan {
+namespace math {
+
+namespace internal {
+
+/**
+ * Smallest number of forward sensitivities, the vars of the initial
+ * state and of the arguments, for which <code>ode_bdf_tol</code> computes
+ * the gradients with the adjoint method. The forward sensitivities add N
+ * states per sensitivity to the ODE and N reverse passes to each of its
+ * right hand sides, while the adjoint method adds a backward solve of N
+ * states and one quadrature per sensitivity.
+ */
+constexpr size_t ode_adjoint_min_sensitivities = 32;
+
+/**
+ * Return true if the ODE with the given initial state and arguments is
+ * solved with the adjoint method by <code>ode_bdf_tol</code>.
+ *
+ * @tparam T_y0 Type of initial state
+ * @tparam T_Args Types of pass-through parameters
+ * @param y0 Initial state
+ * @param args Extra arguments passed through to the ODE right hand side
+ */
+template <typename T_y0, typename... T_Args>
+inline bool ode_use_adjoint(const T_y0& y0, const T_Args&... args) {
+  return count_vars(y0, args...) >= ode_adjoint_min_sensitivities;
+}
+
+/**
+ * Solve the ODE with the adjoint integrator if the solution contains vars.
+ */
+template <int Lmm, typename F, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args,
+          require_var_t<return_type_t<T_y0, T_t0, T_ts, T_Args...>>* = nullptr>
+std::vector<Eigen::Matrix<var, Eigen::Dynamic, 1>> ode_adjoint_solve(
+    const char* function_name, const F& f, const T_y0& y0, const T_t0& t0,
+    const std::vector<T_ts>& ts, double relative_tolerance,
+    double absolute_tolerance,
+    long int max_num_steps,  // NOLINT(runtime/int)
+    std::ostream* msgs, const T_Args&... args) {
+  auto* integrator
+      = new cvodes_integrator_adjoint<Lmm, F, T_y0, T_t0, T_ts, T_Args...>(
+          function_name, f, y0, t0, ts, relative_tolerance, absolute_tolerance,
+          max_num_steps, msgs, args...);
+  return (*integrator)();
+}
+
+/**
+ * Solve the ODE without sensitivities if the solution contains no vars.
+ */
+template <int Lmm, typename F, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args,
+          require_not_var_t<
+              return_type_t<T_y0, T_t0, T_ts, T_Args...>>* = nullptr>
+std::vector<Eigen::VectorXd> ode_adjoint_solve(
+    const char* function_name, const F& f, const T_y0& y0, const T_t0& t0,
+    const std::vector<T_ts>& ts, double relative_tolerance,
+    double absolute_tolerance,
+    long int max_num_steps,  // NOLINT(runtime/int)
+    std::ostream* msgs, const T_Args&... args) {
+  cvodes_integrator<Lmm, F, T_y0, T_t0, T_ts, T_Args...> integrator(
+      function_name, f, y0, t0, ts, relative_tolerance, absolute_tolerance,
+      max_num_steps, ode_linear_solver(), msgs, args...);
+  return integrator();
+}
+
+}  // namespace internal
+
+/**
+ * Solve the ODE initial value problem y' = f(t, y), y(t0) = y0 at a set of
+ * times, { t1, t2, t3, ... } using the CVODES solver \p Lmm, calculating
+ * gradients with the adjoint method (see
+ * <code>cvodes_integrator_adjoint</code>). Without any vars the ODE
+ * is solved like <code>ode_bdf_tol_impl</code> does, without any
+ * sensitivities.
+ *
+ * @tparam Lmm ID of ODE solver (CV_ADAMS or CV_BDF)
+ * @tparam F Type of ODE right hand side
+ * @tparam T_y0 Type of initial state
+ * @tparam T_t0 Type of initial time
+ * @tparam T_ts Type of output times
+ * @tparam T_Args Types of pass-through parameters
+ *
+ * @param function_name Calling function name (for printing debugging messages)
+ * @param f Right hand side of the ODE
+ * @param y0 Initial state
+ * @param t0 Initial time
+ * @param ts Times at which to solve the ODE at. All values must be sorted and
+ *   not less than t0.
+ * @param relative_tolerance Relative tolerance passed to CVODES
+ * @param absolute_tolerance Absolute tolerance passed to CVODES
+ * @param max_num_steps Upper limit on the number of integration steps to
+ *   take between each output (error if exceeded)
+ * @param[in, out] msgs the print stream for warning messages
+ * @param args Extra arguments passed unmodified through to ODE right hand side
+ * @return Solution to ODE at times \p ts
+ */
+template <int Lmm, typename F, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args, require_eigen_col_vector_t<T_y0>* = nullptr>
+std::vector<Eigen::Matrix<stan::return_type_t<T_y0, T_t0, T_ts, T_Args...>,
+                          Eigen::Dynamic, 1>>
+ode_adjoint_tol_impl(const char* function_name, const F& f, const T_y0& y0,
+                     const T_t0& t0, const std::vector<T_ts>& ts,
+                     double relative_tolerance, double absolute_tolerance,
+                     long int max_num_steps,  // NOLINT(runtime/int)
+                     std::ostream* msgs, const T_Args&... args) {
+  const auto& args_ref_tuple = std::make_tuple(to_ref(args)...);
+  return apply(
+      [&](const auto&... args_refs) {
+        return internal::ode_adjoint_solve<Lmm>(
+            function_name, f, y0, t0, ts, relative_tolerance,
+            absolute_tolerance, max_num_steps, msgs, args_refs...);
+      },
+      args_ref_tuple);
+}
+
+/**
+ * Solve the ODE initial value problem y' = f(t, y), y(t0) = y0 at a set of
+ * times, { t1, t2, t3, ... } using the stiff backward differentiation formula
+ * (BDF) solver from CVODES and adjoint sensitivities.
+ *
+ * \p f must define an operator() with the signature as:
+ *   template<typename T_t, typename T_y, typename... T_Args>
+ *   Eigen::Matrix<stan::return_type_t<T_t, T_y, T_Args...>, Eigen::Dynamic, 1>
+ *     operator()(const T_t& t, const Eigen::Matrix<T_y, Eigen::Dynamic, 1>& y,
+ *     std::ostream* msgs, const T_Args&... args);
+ *
+ * t is the time, y is the vector-valued state, msgs is a stream for error
+ * messages, and args are optional arguments passed to the ODE solve function
+ * (which are passed through to \p f without modification).
+ *
+ * Takes the same arguments as <code>ode_bdf_tol</code> and returns the same
+ * solution. The gradients are calculated by integrating the adjoint ODE
+ * backwards in the reverse pass instead of integrating N * (number of
+ * parameters) sensitivities along with the states, which is cheaper for
+ * systems with many parameters. <code>ode_bdf_tol</code> switches to the
+ * adjoint method on its own from
+ * <code>internal::ode_adjoint_min_sensitivities</code> sensitivities on;
+ * this function uses it regardless of the size, e.g. for ODEs with fewer
+ * but expensive parameters.
+ *
+ * @tparam F Type of ODE right hand side
+ * @tparam T_y0 Type of initial state
+ * @tparam T_t0 Type of initial time
+ * @tparam T_ts Type of output times
+ * @tparam T_Args Types of pass-through parameters
+ *
+ * @param f Right hand side of the ODE
+ * @param y0 Initial state
+ * @param t0 Initial time
+ * @param ts Times at which to solve the ODE at. All values must be sorted and
+ *   not less than t0.
+ * @param relative_tolerance Relative tolerance passed to CVODES
+ * @param absolute_tolerance Absolute tolerance passed to CVODES
+ * @param max_num_steps Upper limit on the number of integration steps to
+ *   take between each output (error if exceeded)
+ * @param[in, out] msgs the print stream for warning messages
+ * @param args Extra arguments passed unmodified through to ODE right hand side
+ * @return Solution to ODE at times \p ts
+ */
+template <typename F, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args, require_eigen_col_vector_t<T_y0>* = nullptr>
+std::vector<Eigen::Matrix<stan::return_type_t<T_y0, T_t0, T_ts, T_Args...>,
+                          Eigen::Dynamic, 1>>
+ode_bdf_adjoint_tol(const F& f, const T_y0& y0, const T_t0& t0,
+                    const std::vector<T_ts>& ts, double relative_tolerance,
+                    double absolute_tolerance,
+                    long int max_num_steps,  // NOLINT(runtime/int)
+                    std::ostream* msgs, const T_Args&... args) {
+  return ode_adjoint_tol_impl<CV_BDF>("ode_bdf_adjoint_tol", f, y0, t0, ts,
+                                     relative_tolerance, absolute_tolerance,
+                                     max_num_steps, msgs, args...);
+}
+
+/**
+ * Solve the ODE initial value problem y' = f(t, y), y(t0) = y0 at a set of
+ * times, { t1, t2, t3, ... } using the stiff backward differentiation formula
+ * (BDF) solver from CVODES and adjoint sensitivities with defaults for
+ * relative_tolerance, absolute_tolerance, and max_num_steps.
+ *
+ * \p f must define an operator() with the signature as:
+ *   template<typename T_t, typename T_y, typename... T_Args>
+ *   Eigen::Matrix<stan::return_type_t<T_t, T_y, T_Args...>, Eigen::Dynamic, 1>
+ *     operator()(const T_t& t, const Eigen::Matrix<T_y, Eigen::Dynamic, 1>& y,
+ *     std::ostream* msgs, const T_Args&... args);
+ *
+ * t is the time, y is the vector-valued state, msgs is a stream for error
+ * messages, and args are optional arguments passed to the ODE solve function
+ * (which are passed through to \p f without modification).
+ *
+ * Takes the same arguments as <code>ode_bdf</code> and returns the same
+ * solution, always calculating the gradients with the adjoint method (see
+ * <code>ode_bdf_adjoint_tol</code>).
+ *
+ * @tparam F Type of ODE right hand side
+ * @tparam T_y0 Type of initial state
+ * @tparam T_t0 Type of initial time
+ * @tparam T_ts Type of output times
+ * @tparam T_Args Types of pass-through parameters
+ *
+ * @param f Right hand side of the ODE
+ * @param y0 Initial state
+ * @param t0 Initial time
+ * @param ts Times at which to solve the ODE at. All values must be sorted and
+ *   not less than t0.
+ * @param[in, out] msgs the print stream for warning messages
+ * @param args Extra arguments passed unmodified through to ODE right hand side
+ * @return Solution to ODE at times \p ts
+ */
+template <typename F, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args, require_eigen_col_vector_t<T_y0>* = nullptr>
+std::vector<Eigen::Matrix<stan::return_type_t<T_y0, T_t0, T_ts, T_Args...>,
+                          Eigen::Dynamic, 1>>
+ode_bdf_adjoint(const F& f, const T_y0& y0, const T_t0& t0,
+                const std::vector<T_ts>& ts, std::ostream* msgs,
+                const T_Args&... args) {
+  double relative_tolerance = 1e-10;
+  double absolute_tolerance = 1e-10;
+  long int max_num_steps = 1e8;  // NOLINT(runtime/int)
+
+  return ode_adjoint_tol_impl<CV_BDF>("ode_bdf_adjoint", f, y0, t0, ts,
+                                     relative_tolerance, absolute_tolerance,
+                                     max_num_steps, msgs, args...);
+}
+
+/**
+ * Solve the ODE initial value problem y' = f(t, y), y(t0) = y0 at a set of
+ * times, { t1, t2, t3, ... } using the non-stiff Adams-Moulton solver from
+ * CVODES and adjoint sensitivities.
+ *
+ * \p f must define an operator() with the signature as:
+ *   template<typename T_t, typename T_y, typename... T_Args>
+ *   Eigen::Matrix<stan::return_type_t<T_t, T_y, T_Args...>, Eigen::Dynamic, 1>
+ *     operator()(const T_t& t, const Eigen::Matrix<T_y, Eigen::Dynamic, 1>& y,
+ *     std::ostream* msgs, const T_Args&... args);
+ *
+ * t is the time, y is the vector-valued state, msgs is a stream for error
+ * messages, and args are optional arguments passed to the ODE solve function
+ * (which are passed through to \p f without modification).
+ *
+ * Takes the same arguments as <code>ode_adams_tol</code> and returns the same
+ * solution. The gradients are calculated by integrating the adjoint ODE
+ * backwards in the reverse pass instead of integrating N * (number of
+ * parameters) sensitivities along with the states, which is cheaper for
+ * systems with many parameters. <code>ode_adams_tol</code> always uses the
+ * forward sensitivities, so this is the only way to get adjoint gradients
+ * from the Adams-Moulton solver.
+ *
+ * @tparam F Type of ODE right hand side
+ * @tparam T_y0 Type of initial state
+ * @tparam T_t0 Type of initial time
+ * @tparam T_ts Type of output times
+ * @tparam T_Args Types of pass-through parameters
+ *
+ * @param f Right hand side of the ODE
+ * @param y0 Initial state
+ * @param t0 Initial time
+ * @param ts Times at which to solve the ODE at. All values must be sorted and
+ *   not less than t0.
+ * @param relative_tolerance Relative tolerance passed to CVODES
+ * @param absolute_tolerance Absolute tolerance passed to CVODES
+ * @param max_num_steps Upper limit on the number of integration steps to
+ *   take between each output (error if exceeded)
+ * @param[in, out] msgs the print stream for warning messages
+ * @param args Extra arguments passed unmodified through to ODE right hand side
+ * @return Solution to ODE at times \p ts
+ */
+template <typename F, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args, require_eigen_col_vector_t<T_y0>* = nullptr>
+std::vector<Eigen::Matrix<stan::return_type_t<T_y0, T_t0, T_ts, T_Args...>,
+                          Eigen::Dynamic, 1>>
+ode_adams_adjoint_tol(const F& f, const T_y0& y0, const T_t0& t0,
+                      const std::vector<T_ts>& ts, double relative_tolerance,
+                      double absolute_tolerance,
+                      long int max_num_steps,  // NOLINT(runtime/int)
+                      std::ostream* msgs, const T_Args&... args) {
+  return ode_adjoint_tol_impl<CV_ADAMS>("ode_adams_adjoint_tol", f, y0, t0, ts,
+                                       relative_tolerance, absolute_tolerance,
+                                       max_num_steps, msgs, args...);
+}
+
+/**
+ * Solve the ODE initial value problem y' = f(t, y), y(t0) = y0 at a set of
+ * times, { t1, t2, t3, ... } using the non-stiff Adams-Moulton solver from
+ * CVODES and adjoint sensitivities with defaults for relative_tolerance,
+ * absolute_tolerance, and max_num_steps.
+ *
+ * \p f must define an operator() with the signature as:
+ *   template<typename T_t, typename T_y, typename... T_Args>
+ *   Eigen::Matrix<stan::return_type_t<T_t, T_y, T_Args...>, Eigen::Dynamic, 1>
+ *     operator()(const T_t& t, const Eigen::Matrix<T_y, Eigen::Dynamic, 1>& y,
+ *     std::ostream* msgs, const T_Args&... args);
+ *
+ * t is the time, y is the vector-valued state, msgs is a stream for error
+ * messages, and args are optional arguments passed to the ODE solve function
+ * (which are passed through to \p f without modification).
+ *
+ * Takes the same arguments as <code>ode_adams</code> and returns the same
+ * solution. The gradients are calculated by integrating the adjoint ODE
+ * backwards in the reverse pass instead of integrating N * (number of
+ * parameters) sensitivities along with the states, which is cheaper for
+ * systems with many parameters.
+ *
+ * @tparam F Type of ODE right hand side
+ * @tparam T_y0 Type of initial state
+ * @tparam T_t0 Type of initial time
+ * @tparam T_ts Type of output times
+ * @tparam T_Args Types of pass-through parameters
+ *
+ * @param f Right hand side of the ODE
+ * @param y0 Initial state
+ * @param t0 Initial time
+ * @param ts Times at which to solve the ODE at. All values must be sorted and
+ *   not less than t0.
+ * @param[in, out] msgs the print stream for warning messages
+ * @param args Extra arguments passed unmodified through to ODE right hand side
+ * @return Solution to ODE at times \p ts
+ */
+template <typename F, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args, require_eigen_col_vector_t<T_y0>* = nullptr>
+std::vector<Eigen::Matrix<stan::return_type_t<T_y0, T_t0, T_ts, T_Args...>,
+                          Eigen::Dynamic, 1>>
+ode_adams_adjoint(const F& f, const T_y0& y0, const T_t0& t0,
+                  const std::vector<T_ts>& ts, std::ostream* msgs,
+                  const T_Args&... args) {
+  double relative_tolerance = 1e-10;
+  double absolute_tolerance = 1e-10;
+  long int max_num_steps = 1e8;  // NOLINT(runtime/int)
+
+  return ode_adjoint_tol_impl<CV_ADAMS>("ode_adams_adjoint", f, y0, t0, ts,
+                                       relative_tolerance, absolute_tolerance,
+                                       max_num_steps, msgs, args...);
+}
+
+}  // namespace math
+}  // namespace stan
+#endif
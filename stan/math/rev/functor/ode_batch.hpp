@@ -0,0 +1,440 @@
+#ifndef STAN_MATH_REV_FUNCTOR_ODE_BATCH_HPP
+#define STAN_MATH_REV_FUNCTOR_ODE_BATCH_HPP
+
+#include <stan/math/rev/meta.hpp>
+#include <stan/math/rev/core.hpp>
+#include <stan/math/rev/functor/ode_adams.hpp>
+#include <stan/math/rev/functor/ode_bdf.hpp>
+#include <stan/math/prim/err.hpp>
+#include <stan/math/prim/functor/ode_rk45.hpp>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <algorithm>
+#include <ostream>
+#include <tuple>
+#include <vector>
+
+namespace stan {
+namespace math {
+namespace internal {
+
+/**
+ * Call a function for every subject of a batch, in parallel with TBB if
+ * STAN_THREADS is defined and sequentially otherwise.
+ *
+ * @tparam G Type of function
+ * @param num_subjects Number of subjects
+ * @param g Function called with the index of every subject
+ */
+template <typename G>
+inline void ode_batch_for_each(size_t num_subjects, const G& g) {
+#ifdef STAN_THREADS
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, num_subjects),
+                    [&](const tbb::blocked_range<size_t>& r) {
+                      for (size_t s = r.begin(); s < r.end(); ++s) {
+                        g(s);
+                      }
+                    });
+#else
+  for (size_t s = 0; s < num_subjects; ++s) {
+    g(s);
+  }
+#endif
+}
+
+/**
+ * Solve independent ODE initial value problems of many subjects with
+ * values only.
+ *
+ * @tparam Solver Type of per subject solver
+ * @tparam T_y0 Type of initial states
+ * @tparam T_t0 Type of initial times
+ * @tparam T_ts Type of output times
+ * @tparam T_Args Types of pass-through parameters
+ * @param solver Function solving the ODE of one subject, called with
+ *   the initial state, initial time, output times, print stream and
+ *   arguments of the subject
+ * @param y0s Initial state of every subject
+ * @param t0s Initial time of every subject
+ * @param tss Output times of every subject
+ * @param[in, out] msgs the print stream for warning messages
+ * @param args Extra arguments of every subject
+ * @return Solution of the ODE of every subject at its output times
+ */
+template <typename Solver, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args,
+          require_all_st_arithmetic<T_y0, T_t0, T_ts, T_Args...>* = nullptr>
+inline std::vector<std::vector<Eigen::VectorXd>> ode_batch_solve(
+    const Solver& solver, const std::vector<T_y0>& y0s,
+    const std::vector<T_t0>& t0s, const std::vector<std::vector<T_ts>>& tss,
+    std::ostream* msgs, const std::vector<T_Args>&... args) {
+  std::vector<std::vector<Eigen::VectorXd>> ys(y0s.size());
+  ode_batch_for_each(y0s.size(), [&](size_t s) {
+    ys[s] = solver(y0s[s], t0s[s], tss[s], msgs, args[s]...);
+  });
+  return ys;
+}
+
+/**
+ * Solve independent ODE initial value problems of many subjects with
+ * sensitivities.
+ *
+ * Every subject is solved on the autodiff stack of the thread it runs
+ * on, in a nested autodiff scope with its own copies of the operands.
+ * The values of the solution and its jacobian with respect to the
+ * operands, read off the forward sensitivities of the solver, are stored
+ * in the arena of the calling thread. All outputs
+ * are then linked to the operands by a single reverse pass callback.
+ *
+ * @tparam Solver Type of per subject solver
+ * @tparam T_y0 Type of initial states
+ * @tparam T_t0 Type of initial times
+ * @tparam T_ts Type of output times
+ * @tparam T_Args Types of pass-through parameters
+ * @param solver Function solving the ODE of one subject, called with
+ *   the initial state, initial time, output times, print stream and
+ *   arguments of the subject
+ * @param y0s Initial state of every subject
+ * @param t0s Initial time of every subject
+ * @param tss Output times of every subject
+ * @param[in, out] msgs the print stream for warning messages
+ * @param args Extra arguments of every subject
+ * @return Solution of the ODE of every subject at its output times
+ */
+template <typename Solver, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args,
+          require_any_st_var<T_y0, T_t0, T_ts, T_Args...>* = nullptr>
+inline std::vector<std::vector<Eigen::Matrix<var, Eigen::Dynamic, 1>>>
+ode_batch_solve(const Solver& solver, const std::vector<T_y0>& y0s,
+                const std::vector<T_t0>& t0s,
+                const std::vector<std::vector<T_ts>>& tss, std::ostream* msgs,
+                const std::vector<T_Args>&... args) {
+  const size_t num_subjects = y0s.size();
+  auto& memalloc = ChainableStack::instance_->memalloc_;
+  size_t* num_outputs = memalloc.alloc_array<size_t>(num_subjects);
+  size_t* num_operands = memalloc.alloc_array<size_t>(num_subjects);
+  vari*** operands = memalloc.alloc_array<vari**>(num_subjects);
+  double** values = memalloc.alloc_array<double*>(num_subjects);
+  double** jacobians = memalloc.alloc_array<double*>(num_subjects);
+  for (size_t s = 0; s < num_subjects; ++s) {
+    num_outputs[s] = y0s[s].size() * tss[s].size();
+    num_operands[s] = count_vars(y0s[s], t0s[s], tss[s], args[s]...);
+    operands[s] = memalloc.alloc_array<vari*>(num_operands[s]);
+    save_varis(operands[s], y0s[s], t0s[s], tss[s], args[s]...);
+    values[s] = memalloc.alloc_array<double>(num_outputs[s]);
+    jacobians[s]
+        = memalloc.alloc_array<double>(num_outputs[s] * num_operands[s]);
+    std::fill(jacobians[s], jacobians[s] + num_outputs[s] * num_operands[s],
+              0.0);
+  }
+
+  ode_batch_for_each(num_subjects, [&](size_t s) {
+    nested_rev_autodiff nested;
+    auto& stack = *ChainableStack::instance_;
+    const auto& y0_local = deep_copy_vars(y0s[s]);
+    const auto& t0_local = deep_copy_vars(t0s[s]);
+    const auto& ts_local = deep_copy_vars(tss[s]);
+    auto args_local = std::make_tuple(deep_copy_vars(args[s])...);
+    std::vector<vari*> local_operands(num_operands[s]);
+    apply(
+        [&](auto&&... args_s) {
+          save_varis(local_operands.data(), y0_local, t0_local, ts_local,
+                     args_s...);
+        },
+        args_local);
+    const size_t stack_start = stack.var_stack_.size();
+    std::vector<Eigen::Matrix<var, Eigen::Dynamic, 1>> ys = apply(
+        [&](auto&&... args_s) {
+          return solver(y0_local, t0_local, ts_local, msgs, args_s...);
+        },
+        args_local);
+
+    // The solvers return one vari per output holding its forward
+    // sensitivities with respect to the operands, and nothing else goes
+    // on the tape. Chaining an output on its own then writes its row of
+    // the jacobian to the adjoints of the operands.
+    const bool direct
+        = stack.var_stack_.size() == stack_start + num_outputs[s];
+    size_t o = 0;
+    for (auto& y : ys) {
+      for (int i = 0; i < y.size(); ++i, ++o) {
+        values[s][o] = y.coeff(i).val();
+        double* jacobian = jacobians[s] + o * num_operands[s];
+        if (direct) {
+          vari* output = y.coeff(i).vi_;
+          output->adj_ = 1.0;
+          output->chain();
+          output->adj_ = 0.0;
+          for (size_t k = 0; k < num_operands[s]; ++k) {
+            jacobian[k] = local_operands[k]->adj_;
+            local_operands[k]->adj_ = 0.0;
+          }
+          continue;
+        }
+        // otherwise one nested reverse pass per output, through the varis
+        // of this subject only
+        if (o > 0) {
+          nested.set_zero_all_adjoints();
+        }
+        y.coeffRef(i).grad();
+        apply(
+            [&](auto&&... args_s) {
+              accumulate_adjoints(jacobian, y0_local, t0_local, ts_local,
+                                  args_s...);
+            },
+            args_local);
+      }
+    }
+  });
+
+  std::vector<std::vector<Eigen::Matrix<var, Eigen::Dynamic, 1>>> ys(
+      num_subjects);
+  vari*** outputs = memalloc.alloc_array<vari**>(num_subjects);
+  for (size_t s = 0; s < num_subjects; ++s) {
+    outputs[s] = memalloc.alloc_array<vari*>(num_outputs[s]);
+    ys[s].resize(tss[s].size());
+    size_t o = 0;
+    for (auto& y : ys[s]) {
+      y.resize(y0s[s].size());
+      for (int i = 0; i < y.size(); ++i, ++o) {
+        outputs[s][o] = new vari(values[s][o], false);
+        y.coeffRef(i) = outputs[s][o];
+      }
+    }
+  }
+
+  reverse_pass_callback([num_subjects, num_outputs, num_operands, operands,
+                         jacobians, outputs]() {
+    for (size_t s = 0; s < num_subjects; ++s) {
+      for (size_t o = 0; o < num_outputs[s]; ++o) {
+        const double adj = outputs[s][o]->adj_;
+        if (adj == 0) {
+          continue;
+        }
+        const double* jacobian = jacobians[s] + o * num_operands[s];
+        for (size_t k = 0; k < num_operands[s]; ++k) {
+          operands[s][k]->adj_ += adj * jacobian[k];
+        }
+      }
+    }
+  });
+
+  return ys;
+}
+
+/**
+ * Check the arguments of a batch of ODE initial value problems and
+ * solve them.
+ *
+ * @tparam Solver Type of per subject solver
+ * @tparam T_y0 Type of initial states
+ * @tparam T_t0 Type of initial times
+ * @tparam T_ts Type of output times
+ * @tparam T_Args Types of pass-through parameters
+ * @param function_name Calling function name (for printing debugging
+ *   messages)
+ * @param solver Function solving the ODE of one subject
+ * @param y0s Initial state of every subject
+ * @param t0s Initial time of every subject
+ * @param tss Output times of every subject
+ * @param[in, out] msgs the print stream for warning messages
+ * @param args Extra arguments of every subject
+ * @return Solution of the ODE of every subject at its output times
+ */
+template <typename Solver, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args>
+inline auto ode_batch_impl(const char* function_name, const Solver& solver,
+                           const std::vector<T_y0>& y0s,
+                           const std::vector<T_t0>& t0s,
+                           const std::vector<std::vector<T_ts>>& tss,
+                           std::ostream* msgs,
+                           const std::vector<T_Args>&... args) {
+  check_size_match(function_name, "number of initial times", t0s.size(),
+                   "number of initial states", y0s.size());
+  check_size_match(function_name, "number of output time vectors", tss.size(),
+                   "number of initial states", y0s.size());
+  static_cast<void>(std::initializer_list<int>{
+      (check_size_match(function_name, "number of subjects of an argument",
+                        args.size(), "number of initial states", y0s.size()),
+       0)...});
+  return ode_batch_solve(solver, y0s, t0s, tss, msgs, args...);
+}
+
+}  // namespace internal
+
+/**
+ * Solve the ODE initial value problems y_s' = f(t, y_s, args_s),
+ * y_s(t0_s) = y0_s of many independent subjects s at the times ts_s
+ * using the stiff backward differentiation formula BDF solver from
+ * CVODES.
+ *
+ * This gives the same result as calling <code>ode_bdf_tol</code> for
+ * every subject, but the subjects are solved in parallel if
+ * STAN_THREADS is defined. The sensitivities of all subjects are
+ * linked to the autodiff stack of the calling thread in a single reverse
+ * pass callback.
+ *
+ * \p f must define an operator() as required by <code>ode_bdf</code>.
+ *
+ * @tparam F Type of ODE right hand side
+ * @tparam T_y0 Type of initial states
+ * @tparam T_t0 Type of initial times
+ * @tparam T_ts Type of output times
+ * @tparam T_Args Types of pass-through parameters
+ *
+ * @param f Right hand side of the ODE
+ * @param y0s Initial state of every subject
+ * @param t0s Initial time of every subject
+ * @param tss Times at which to solve the ODE of every subject. All values
+ *   must be sorted and greater than the initial time of the subject.
+ * @param relative_tolerance Relative tolerance passed to CVODES
+ * @param absolute_tolerance Absolute tolerance passed to CVODES
+ * @param max_num_steps Upper limit on the number of integration steps to
+ *   take between each output (error if exceeded)
+ * @param[in, out] msgs the print stream for warning messages
+ * @param args Extra arguments of every subject, passed unmodified through
+ *   to the ODE right hand side. Every argument is a vector with one element
+ *   per subject.
+ * @return Solution to the ODE of every subject at its times
+ */
+template <typename F, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args, require_eigen_col_vector_t<T_y0>* = nullptr>
+std::vector<std::vector<Eigen::Matrix<
+    return_type_t<T_y0, T_t0, T_ts, T_Args...>, Eigen::Dynamic, 1>>>
+ode_bdf_batch_tol(const F& f, const std::vector<T_y0>& y0s,
+                  const std::vector<T_t0>& t0s,
+                  const std::vector<std::vector<T_ts>>& tss,
+                  double relative_tolerance, double absolute_tolerance,
+                  long int max_num_steps,  // NOLINT(runtime/int)
+                  std::ostream* msgs, const std::vector<T_Args>&... args) {
+  return internal::ode_batch_impl(
+      "ode_bdf_batch_tol",
+      [&](const auto& y0, const auto& t0, const auto& ts, std::ostream* msgs,
+          const auto&... args_s) {
+        // the forward sensitivities, not the adjoint method, give the
+        // whole jacobian of every subject in one solve
+        return ode_bdf_tol_impl("ode_bdf_batch_tol", f, y0, t0, ts,
+                                relative_tolerance, absolute_tolerance,
+                                max_num_steps, ode_linear_solver(), msgs,
+                                args_s...);
+      },
+      y0s, t0s, tss, msgs, args...);
+}
+
+/**
+ * Solve the ODE initial value problems of many independent subjects with
+ * the stiff BDF solver from CVODES and the default tolerances of
+ * <code>ode_bdf</code> (relative tolerance 1e-10, absolute tolerance
+ * 1e-10, at most 1e8 steps between outputs).
+ *
+ * @see ode_bdf_batch_tol
+ */
+template <typename F, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args, require_eigen_col_vector_t<T_y0>* = nullptr>
+std::vector<std::vector<Eigen::Matrix<
+    return_type_t<T_y0, T_t0, T_ts, T_Args...>, Eigen::Dynamic, 1>>>
+ode_bdf_batch(const F& f, const std::vector<T_y0>& y0s,
+              const std::vector<T_t0>& t0s,
+              const std::vector<std::vector<T_ts>>& tss, std::ostream* msgs,
+              const std::vector<T_Args>&... args) {
+  return ode_bdf_batch_tol(f, y0s, t0s, tss, 1e-10, 1e-10, 1e8, msgs,
+                           args...);
+}
+
+/**
+ * Solve the ODE initial value problems of many independent subjects with
+ * the non-stiff Adams-Moulton solver from CVODES. This gives the same
+ * result as calling <code>ode_adams_tol</code> for every subject.
+ *
+ * @see ode_bdf_batch_tol
+ */
+template <typename F, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args, require_eigen_col_vector_t<T_y0>* = nullptr>
+std::vector<std::vector<Eigen::Matrix<
+    return_type_t<T_y0, T_t0, T_ts, T_Args...>, Eigen::Dynamic, 1>>>
+ode_adams_batch_tol(const F& f, const std::vector<T_y0>& y0s,
+                    const std::vector<T_t0>& t0s,
+                    const std::vector<std::vector<T_ts>>& tss,
+                    double relative_tolerance, double absolute_tolerance,
+                    long int max_num_steps,  // NOLINT(runtime/int)
+                    std::ostream* msgs, const std::vector<T_Args>&... args) {
+  return internal::ode_batch_impl(
+      "ode_adams_batch_tol",
+      [&](const auto& y0, const auto& t0, const auto& ts, std::ostream* msgs,
+          const auto&... args_s) {
+        return ode_adams_tol_impl("ode_adams_batch_tol", f, y0, t0, ts,
+                                  relative_tolerance, absolute_tolerance,
+                                  max_num_steps, msgs, args_s...);
+      },
+      y0s, t0s, tss, msgs, args...);
+}
+
+/**
+ * Solve the ODE initial value problems of many independent subjects with
+ * the non-stiff Adams-Moulton solver from CVODES and the default
+ * tolerances of <code>ode_adams</code>.
+ *
+ * @see ode_adams_batch_tol
+ */
+template <typename F, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args, require_eigen_col_vector_t<T_y0>* = nullptr>
+std::vector<std::vector<Eigen::Matrix<
+    return_type_t<T_y0, T_t0, T_ts, T_Args...>, Eigen::Dynamic, 1>>>
+ode_adams_batch(const F& f, const std::vector<T_y0>& y0s,
+                const std::vector<T_t0>& t0s,
+                const std::vector<std::vector<T_ts>>& tss, std::ostream* msgs,
+                const std::vector<T_Args>&... args) {
+  return ode_adams_batch_tol(f, y0s, t0s, tss, 1e-10, 1e-10, 1e8, msgs,
+                             args...);
+}
+
+/**
+ * Solve the ODE initial value problems of many independent subjects with
+ * the non-stiff Runge-Kutta 45 solver in Boost. This gives the same
+ * result as calling <code>ode_rk45_tol</code> for every subject.
+ *
+ * @see ode_bdf_batch_tol
+ */
+template <typename F, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args, require_eigen_col_vector_t<T_y0>* = nullptr>
+std::vector<std::vector<Eigen::Matrix<
+    return_type_t<T_y0, T_t0, T_ts, T_Args...>, Eigen::Dynamic, 1>>>
+ode_rk45_batch_tol(const F& f, const std::vector<T_y0>& y0s,
+                   const std::vector<T_t0>& t0s,
+                   const std::vector<std::vector<T_ts>>& tss,
+                   double relative_tolerance, double absolute_tolerance,
+                   long int max_num_steps,  // NOLINT(runtime/int)
+                   std::ostream* msgs, const std::vector<T_Args>&... args) {
+  return internal::ode_batch_impl(
+      "ode_rk45_batch_tol",
+      [&](const auto& y0, const auto& t0, const auto& ts, std::ostream* msgs,
+          const auto&... args_s) {
+        return ode_rk45_tol_impl("ode_rk45_batch_tol", f, y0, t0, ts,
+                                 relative_tolerance, absolute_tolerance,
+                                 max_num_steps, msgs, args_s...);
+      },
+      y0s, t0s, tss, msgs, args...);
+}
+
+/**
+ * Solve the ODE initial value problems of many independent subjects with
+ * the non-stiff Runge-Kutta 45 solver in Boost and the default tolerances
+ * of <code>ode_rk45</code> (relative tolerance 1e-6, absolute tolerance
+ * 1e-6, at most 1e6 steps between outputs).
+ *
+ * @see ode_rk45_batch_tol
+ */
+template <typename F, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args, require_eigen_col_vector_t<T_y0>* = nullptr>
+std::vector<std::vector<Eigen::Matrix<
+    return_type_t<T_y0, T_t0, T_ts, T_Args...>, Eigen::Dynamic, 1>>>
+ode_rk45_batch(const F& f, const std::vector<T_y0>& y0s,
+               const std::vector<T_t0>& t0s,
+               const std::vector<std::vector<T_ts>>& tss, std::ostream* msgs,
+               const std::vector<T_Args>&... args) {
+  return ode_rk45_batch_tol(f, y0s, t0s, tss, 1e-6, 1e-6, 1e6, msgs, args...);
+}
+
+}  // namespace math
+}  // namespace stan
+#endif
@@ -3,6 +3,8 @@
 
 #include <stan/math/rev/meta.hpp>
 #include <stan/math/rev/functor/cvodes_integrator.hpp>
+#include <stan/math/rev/functor/ode_adjoint.hpp>
+#include <stan/math/rev/functor/ode_linear_solver.hpp>
 #include <stan/math/prim/fun/Eigen.hpp>
 #include <ostream>
 #include <vector>
@@ -41,6 +43,7 @@ namespace math {
  * @param absolute_tolerance Absolute tolerance passed to CVODES
  * @param max_num_steps Upper limit on the number of integration steps to
  *   take between each output (error if exceeded)
+ * @param linear_solver Linear solver of the Newton iterations
  * @param[in, out] msgs the print stream for warning messages
  * @param args Extra arguments passed unmodified through to ODE right hand side
  * @return Solution to ODE at times \p ts
@@ -53,19 +56,79 @@ ode_bdf_tol_impl(const char* function_name, const F& f, const T_y0& y0,
                  const T_t0& t0, const std::vector<T_ts>& ts,
                  double relative_tolerance, double absolute_tolerance,
                  long int max_num_steps,  // NOLINT(runtime/int)
-                 std::ostream* msgs, const T_Args&... args) {
+                 const ode_linear_solver& linear_solver, std::ostream* msgs,
+                 const T_Args&... args) {
   const auto& args_ref_tuple = std::make_tuple(to_ref(args)...);
   return apply(
       [&](const auto&... args_refs) {
         cvodes_integrator<CV_BDF, F, T_y0, T_t0, T_ts, ref_type_t<T_Args>...>
         integrator(function_name, f, y0, t0, ts, relative_tolerance,
-                   absolute_tolerance, max_num_steps, msgs, args_refs...);
+                   absolute_tolerance, max_num_steps, linear_solver, msgs,
+                   args_refs...);
 
         return integrator();
       },
       args_ref_tuple);
 }
 
+/**
+ * Solve the ODE initial value problem y' = f(t, y), y(t0) = y0 at a set of
+ * times, { t1, t2, t3, ... } using the stiff backward differentiation formula
+ * BDF solver from CVODES with the dense linear solver. With at least
+ * <code>internal::ode_adjoint_min_sensitivities</code> vars in the initial
+ * state and the arguments the gradients are calculated with the adjoint
+ * method (see <code>ode_bdf_adjoint_tol</code>), otherwise with forward
+ * sensitivities.
+ *
+ * \p f must define an operator() with the signature as:
+ *   template<typename T_t, typename T_y, typename... T_Args>
+ *   Eigen::Matrix<stan::return_type_t<T_t, T_y, T_Args...>, Eigen::Dynamic, 1>
+ *     operator()(const T_t& t, const Eigen::Matrix<T_y, Eigen::Dynamic, 1>& y,
+ *     std::ostream* msgs, const T_Args&... args);
+ *
+ * t is the time, y is the vector-valued state, msgs is a stream for error
+ * messages, and args are optional arguments passed to the ODE solve function
+ * (which are passed through to \p f without modification).
+ *
+ * @tparam F Type of ODE right hand side
+ * @tparam T_y0 Type of initial state
+ * @tparam T_t0 Type of initial time
+ * @tparam T_ts Type of output times
+ * @tparam T_Args Types of pass-through parameters
+ *
+ * @param function_name Calling function name (for printing debugging messages)
+ * @param f Right hand side of the ODE
+ * @param y0 Initial state
+ * @param t0 Initial time
+ * @param ts Times at which to solve the ODE at. All values must be sorted and
+ *   not less than t0.
+ * @param relative_tolerance Relative tolerance passed to CVODES
+ * @param absolute_tolerance Absolute tolerance passed to CVODES
+ * @param max_num_steps Upper limit on the number of integration steps to
+ *   take between each output (error if exceeded)
+ * @param[in, out] msgs the print stream for warning messages
+ * @param args Extra arguments passed unmodified through to ODE right hand side
+ * @return Solution to ODE at times \p ts
+ */
+template <typename F, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args, require_eigen_col_vector_t<T_y0>* = nullptr>
+std::vector<Eigen::Matrix<stan::return_type_t<T_y0, T_t0, T_ts, T_Args...>,
+                          Eigen::Dynamic, 1>>
+ode_bdf_tol_impl(const char* function_name, const F& f, const T_y0& y0,
+                 const T_t0& t0, const std::vector<T_ts>& ts,
+                 double relative_tolerance, double absolute_tolerance,
+                 long int max_num_steps,  // NOLINT(runtime/int)
+                 std::ostream* msgs, const T_Args&... args) {
+  if (internal::ode_use_adjoint(y0, args...)) {
+    return ode_adjoint_tol_impl<CV_BDF>(function_name, f, y0, t0, ts,
+                                        relative_tolerance, absolute_tolerance,
+                                        max_num_steps, msgs, args...);
+  }
+  return ode_bdf_tol_impl(function_name, f, y0, t0, ts, relative_tolerance,
+                          absolute_tolerance, max_num_steps,
+                          ode_linear_solver(), msgs, args...);
+}
+
 /**
  * Solve the ODE initial value problem y' = f(t, y), y(t0) = y0 at a set of
  * times, { t1, t2, t3, ... } using the stiff backward differentiation formula
@@ -112,6 +175,58 @@ ode_bdf_tol(const F& f, const T_y0& y0, const T_t0& t0,
                           absolute_tolerance, max_num_steps, msgs, args...);
 }
 
+/**
+ * Solve the ODE initial value problem y' = f(t, y), y(t0) = y0 at a set of
+ * times, { t1, t2, t3, ... } using the stiff backward differentiation formula
+ * BDF solver from CVODES and the given linear solver for the Newton
+ * iterations.
+ *
+ * \p f must define an operator() with the signature as:
+ *   template<typename T_t, typename T_y, typename... T_Args>
+ *   Eigen::Matrix<stan::return_type_t<T_t, T_y, T_Args...>, Eigen::Dynamic, 1>
+ *     operator()(const T_t& t, const Eigen::Matrix<T_y, Eigen::Dynamic, 1>& y,
+ *     std::ostream* msgs, const T_Args&... args);
+ *
+ * t is the time, y is the vector-valued state, msgs is a stream for error
+ * messages, and args are optional arguments passed to the ODE solve function
+ * (which are passed through to \p f without modification).
+ *
+ * @tparam F Type of ODE right hand side
+ * @tparam T_0 Type of initial time
+ * @tparam T_ts Type of output times
+ * @tparam T_Args Types of pass-through parameters
+ *
+ * @param f Right hand side of the ODE
+ * @param y0 Initial state
+ * @param t0 Initial time
+ * @param ts Times at which to solve the ODE at. All values must be sorted and
+ *   not less than t0.
+ * @param relative_tolerance Relative tolerance passed to CVODES
+ * @param absolute_tolerance Absolute tolerance passed to CVODES
+ * @param max_num_steps Upper limit on the number of integration steps to
+ *   take between each output (error if exceeded)
+ * @param linear_solver Linear solver of the Newton iterations, e.g. a band
+ *   or an iterative solver for large ODEs with sparse jacobians (see
+ *   <code>ode_linear_solver</code>)
+ * @param[in, out] msgs the print stream for warning messages
+ * @param args Extra arguments passed unmodified through to ODE right hand side
+ * @return Solution to ODE at times \p ts
+ */
+template <typename F, typename T_y0, typename T_t0, typename T_ts,
+          typename... T_Args, require_eigen_col_vector_t<T_y0>* = nullptr>
+std::vector<Eigen::Matrix<stan::return_type_t<T_y0, T_t0, T_ts, T_Args...>,
+                          Eigen::Dynamic, 1>>
+ode_bdf_tol(const F& f, const T_y0& y0, const T_t0& t0,
+            const std::vector<T_ts>& ts, double relative_tolerance,
+            double absolute_tolerance,
+            long int max_num_steps,  // NOLINT(runtime/int)
+            const ode_linear_solver& linear_solver, std::ostream* msgs,
+            const T_Args&... args) {
+  return ode_bdf_tol_impl("ode_bdf_tol", f, y0, t0, ts, relative_tolerance,
+                          absolute_tolerance, max_num_steps, linear_solver,
+                          msgs, args...);
+}
+
 /**
  * Solve the ODE initial value problem y' = f(t, y), y(t0) = y0 at a set of
  * times, { t1, t2, t3, ... } using the stiff backward differentiation formula
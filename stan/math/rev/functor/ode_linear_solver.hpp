@@ -0,0 +1,91 @@
+#ifndef STAN_MATH_REV_FUNCTOR_ODE_LINEAR_SOLVER_HPP
+#define STAN_MATH_REV_FUNCTOR_ODE_LINEAR_SOLVER_HPP
+
+#include <stan/math/rev/meta.hpp>
+#include <stan/math/rev/core.hpp>
+#include <stan/math/rev/functor/sparse_jacobian.hpp>
+#include <stan/math/prim/fun/Eigen.hpp>
+#include <algorithm>
+#include <vector>
+
+namespace stan {
+namespace math {
+
+/**
+ * Linear solver used in the Newton iterations of the stiff ODE and DAE
+ * integrators (<code>ode_bdf_tol</code> and <code>integrate_dae</code>).
+ *
+ * - <code>dense</code>: dense LU factorization of the N x N Newton
+ *   matrix, O(N^3) per factorization. This is the default.
+ * - <code>band</code>: banded LU factorization with the given upper and
+ *   lower bandwidths, O(N * upper_bandwidth * lower_bandwidth). Both
+ *   bandwidths must be given and nonnegative.
+ * - <code>iterative</code>: GMRES with at most
+ *   <code>max_krylov_dim</code> Krylov vectors (0 for the SUNDIALS
+ *   default). For ODEs the Newton matrix is preconditioned with a sparse
+ *   LU factorization of I - gamma * J, where the sparsity of the
+ *   jacobian J is detected from the ODE right hand side once per cached
+ *   CVODES workspace and reused by later solves. For DAEs GMRES is not
+ *   preconditioned.
+ *
+ * With band or sparse jacobians the ODE integrators calculate the
+ * jacobian with one reverse pass per group of rows that share no
+ * columns instead of one reverse pass per state.
+ */
+struct ode_linear_solver {
+  enum solver_type { dense, band, iterative };
+  solver_type type = dense;
+  int upper_bandwidth = -1;
+  int lower_bandwidth = -1;
+  int max_krylov_dim = 0;
+};
+
+namespace internal {
+
+/**
+ * Return the sparsity pattern of the jacobian of a function, with ones
+ * at the structural non-zeros and on the diagonal, as needed for the
+ * Newton matrix I - gamma * J. See
+ * <code>stan::math::jacobian_sparsity()</code>.
+ *
+ * @tparam F Type of function
+ * @param f Function from vectors to vectors of the same size
+ * @param x Argument of the function
+ * @return Square sparse matrix with the sparsity of the jacobian
+ */
+template <typename F>
+inline Eigen::SparseMatrix<double> jacobian_sparsity(
+    const F& f, const Eigen::VectorXd& x) {
+  Eigen::SparseMatrix<double> pattern = stan::math::jacobian_sparsity(f, x);
+  for (int i = 0; i < pattern.rows(); ++i) {
+    pattern.coeffRef(i, i) = 1;
+  }
+  pattern.makeCompressed();
+  return pattern;
+}
+
+/**
+ * Return the sparsity pattern of an n x n band matrix.
+ *
+ * @param n Size of the matrix
+ * @param upper_bandwidth Number of non-zero diagonals above the diagonal
+ * @param lower_bandwidth Number of non-zero diagonals below the diagonal
+ */
+inline Eigen::SparseMatrix<double> band_sparsity(int n, int upper_bandwidth,
+                                                 int lower_bandwidth) {
+  std::vector<Eigen::Triplet<double>> non_zeros;
+  for (int j = 0; j < n; ++j) {
+    for (int i = std::max(0, j - upper_bandwidth);
+         i <= std::min(n - 1, j + lower_bandwidth); ++i) {
+      non_zeros.emplace_back(i, j, 1.0);
+    }
+  }
+  Eigen::SparseMatrix<double> pattern(n, n);
+  pattern.setFromTriplets(non_zeros.begin(), non_zeros.end());
+  return pattern;
+}
+
+}  // namespace internal
+}  // namespace math
+}  // namespace stan
+#endif
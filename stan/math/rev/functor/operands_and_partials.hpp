@@ -301,10 +301,11 @@ class ops_partials_edge<double, std::vector<Eigen::Matrix<var, R, C>>> {
     }
   }
   int size() {
-    if (unlikely(this->operands_.size() == 0)) {
-      return 0;
+    int size = 0;
+    for (size_t i = 0; i < this->operands_.size(); ++i) {
+      size += this->operands_[i].size();
     }
-    return this->operands_.size() * this->operands_[0].size();
+    return size;
   }
   std::tuple<> container_operands() { return std::tuple<>(); }
   std::tuple<> container_partials() { return std::tuple<>(); }
@@ -0,0 +1,188 @@
+#ifndef STAN_MATH_REV_FUNCTOR_PARALLEL_REVERSE_SUM_HPP
+#define STAN_MATH_REV_FUNCTOR_PARALLEL_REVERSE_SUM_HPP
+
+#include <stan/math/prim/meta.hpp>
+#include <stan/math/prim/err.hpp>
+#include <stan/math/rev/core.hpp>
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+
+#include <algorithm>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+namespace stan {
+namespace math {
+namespace internal {
+
+/**
+ * Vari holding the sum of independent segments of the tape.
+ *
+ * Each segment is a range of varis which was moved from
+ * <code>var_stack_</code> to <code>var_nochain_stack_</code> after it was
+ * recorded, so their adjoints are still reset by
+ * <code>set_zero_all_adjoints()</code>. The varis of a segment
+ * only depend on each other and on segment-local copies of the shared
+ * arguments, so the reverse passes of different segments touch disjoint
+ * adjoints and are run concurrently with the TBB. Afterwards the
+ * adjoints of the local copies are added to the shared arguments in
+ * segment order.
+ */
+class parallel_reverse_sum_vari final : public vari {
+ public:
+  size_t num_segments_;
+  size_t num_shared_;
+  vari_base** segment_varis_;  // varis of all segments, in tape order
+  size_t* segment_starts_;     // num_segments_ + 1 offsets into the above
+  vari** segment_sums_;        // value of each segment
+  vari** shared_;              // shared arguments
+  vari** local_shared_;        // num_segments_ copies of the shared arguments
+
+  parallel_reverse_sum_vari(double val, size_t num_segments, size_t num_shared,
+                            vari_base** segment_varis, size_t* segment_starts,
+                            vari** segment_sums, vari** shared,
+                            vari** local_shared)
+      : vari(val),
+        num_segments_(num_segments),
+        num_shared_(num_shared),
+        segment_varis_(segment_varis),
+        segment_starts_(segment_starts),
+        segment_sums_(segment_sums),
+        shared_(shared),
+        local_shared_(local_shared) {}
+
+  inline void chain_segment(size_t s) {
+    segment_sums_[s]->adj_ += adj_;
+    for (size_t k = segment_starts_[s + 1]; k-- > segment_starts_[s];) {
+      segment_varis_[k]->chain();
+    }
+  }
+
+  inline void chain() final {
+#ifdef STAN_THREADS
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_segments_),
+                      [&](const tbb::blocked_range<size_t>& r) {
+                        for (size_t s = r.begin(); s < r.end(); ++s) {
+                          chain_segment(s);
+                        }
+                      });
+#else
+    for (size_t s = 0; s < num_segments_; ++s) {
+      chain_segment(s);
+    }
+#endif
+    for (size_t s = 0; s < num_segments_; ++s) {
+      vari** local = local_shared_ + s * num_shared_;
+      for (size_t j = 0; j < num_shared_; ++j) {
+        shared_[j]->adj_ += local[j]->adj_;
+      }
+    }
+  }
+};
+
+}  // namespace internal
+
+/**
+ * Return the sum of <code>f(i, msgs, args...)</code> for
+ * <code>i = 0, ..., num_terms - 1</code>, where the terms are
+ * independent given the shared arguments, and run the reverse pass over
+ * the terms in parallel.
+ *
+ * The forward pass is evaluated sequentially on the autodiff stack of
+ * the calling thread. The terms are grouped into segments of
+ * <code>grainsize</code> consecutive terms. Every segment works on its
+ * own deep copy of the shared arguments and the varis it creates are
+ * taken off <code>var_stack_</code> and handed to a single vari
+ * representing the sum. When that vari is reached in the reverse pass,
+ * the segments are propagated concurrently with the TBB and the adjoints
+ * of the copies are then accumulated into the shared arguments. The tape
+ * stays intact, so repeated reverse passes (e.g. in
+ * <code>jacobian()</code>) work as usual.
+ *
+ * Unlike <code>reduce_sum</code>, the model code is not run on other
+ * threads and no nested gradients are taken in the forward pass, which
+ * stays sequential. Only the reverse pass is parallel.
+ *
+ * The independent terms have to be given as an indexed functor: varis do
+ * not expose their operands, so independent parts of an already recorded
+ * <code>var_stack_</code> cannot be discovered after the fact, and the
+ * terms are instead recorded into separate segments as they are
+ * evaluated.
+ *
+ * All vars used by <code>f</code> must be passed through
+ * <code>args</code>; <code>f</code> must not capture vars by reference.
+ * Concurrent reverse passes require <code>STAN_THREADS</code>; without
+ * it the segments are propagated one after the other.
+ *
+ * @tparam F type of functor with signature
+ * <code>T f(size_t i, std::ostream* msgs, Args&&... args)</code>, where
+ * <code>T</code> is <code>var</code> or arithmetic
+ * @tparam Args types of shared arguments
+ * @param f functor returning the i-th term
+ * @param num_terms number of terms
+ * @param grainsize number of terms per segment
+ * @param[in, out] msgs the print stream for warning messages
+ * @param args shared arguments used in every term
+ * @return sum of all terms
+ * @throw std::domain_error if grainsize is not positive
+ */
+template <typename F, typename... Args>
+inline var parallel_reverse_sum(const F& f, size_t num_terms, int grainsize,
+                                std::ostream* msgs, Args&&... args) {
+  check_positive("parallel_reverse_sum", "grainsize", grainsize);
+  if (num_terms == 0) {
+    return var(0.0);
+  }
+  auto& stack = *ChainableStack::instance_;
+  const size_t num_segments = (num_terms + grainsize - 1) / grainsize;
+  const size_t num_shared = count_vars(args...);
+
+  vari** shared = stack.memalloc_.alloc_array<vari*>(num_shared);
+  save_varis(shared, args...);
+  vari** local_shared
+      = stack.memalloc_.alloc_array<vari*>(num_segments * num_shared);
+  vari** segment_sums = stack.memalloc_.alloc_array<vari*>(num_segments);
+  size_t* segment_starts
+      = stack.memalloc_.alloc_array<size_t>(num_segments + 1);
+  std::vector<vari_base*> segment_varis;
+
+  double sum = 0.0;
+  segment_starts[0] = 0;
+  for (size_t s = 0; s < num_segments; ++s) {
+    const size_t stack_start = stack.var_stack_.size();
+    var segment_sum = [&](auto&&... local_args) {
+      save_varis(local_shared + s * num_shared, local_args...);
+      const size_t end = std::min(num_terms, (s + 1) * grainsize);
+      var local_sum = 0.0;
+      for (size_t i = s * grainsize; i < end; ++i) {
+        local_sum += f(i, msgs, local_args...);
+      }
+      return local_sum;
+    }(deep_copy_vars(args)...);
+    segment_varis.insert(segment_varis.end(),
+                         stack.var_stack_.begin() + stack_start,
+                         stack.var_stack_.end());
+    stack.var_nochain_stack_.insert(stack.var_nochain_stack_.end(),
+                                    stack.var_stack_.begin() + stack_start,
+                                    stack.var_stack_.end());
+    stack.var_stack_.resize(stack_start);
+    stack.soa_segment_ = nullptr;
+    segment_sums[s] = segment_sum.vi_;
+    segment_starts[s + 1] = segment_varis.size();
+    sum += segment_sum.val();
+  }
+
+  vari_base** arena_segment_varis
+      = stack.memalloc_.alloc_array<vari_base*>(segment_varis.size());
+  std::copy(segment_varis.begin(), segment_varis.end(), arena_segment_varis);
+
+  return var(new internal::parallel_reverse_sum_vari(
+      sum, num_segments, num_shared, arena_segment_varis, segment_starts,
+      segment_sums, shared, local_shared));
+}
+
+}  // namespace math
+}  // namespace stan
+
+#endif
@@ -8,6 +8,7 @@
 #include <tbb/parallel_reduce.h>
 #include <tbb/blocked_range.h>
 
+#include <algorithm>
 #include <tuple>
 #include <memory>
 #include <utility>
@@ -34,10 +35,14 @@ struct reduce_sum_impl<ReduceFunction, require_var_t<ReturnType>, ReturnType,
     using args_tuple_t
         = std::tuple<decltype(deep_copy_vars(std::declval<Args>()))...>;
     std::unique_ptr<args_tuple_t> args_tuple_holder_;
+    bool in_use_{false};  // a reducer is working with the copies
 
     scoped_args_tuple() : stack_(), args_tuple_holder_(nullptr) {}
   };
 
+  // copies of the shared arguments, one per thread of the task arena
+  using thread_args_t = std::vector<std::unique_ptr<scoped_args_tuple>>;
+
   /**
    * This struct is used by the TBB to accumulate partial
    *  sums over consecutive ranges of the input. To distribute the workload,
@@ -54,19 +59,22 @@ struct reduce_sum_impl<ReduceFunction, require_var_t<ReturnType>, ReturnType,
     Vec vmapped_;
     std::stringstream msgs_;
     std::tuple<Args...> args_tuple_;
-    scoped_args_tuple local_args_tuple_scope_;
+    thread_args_t& thread_args_tuple_scopes_;
+    std::unique_ptr<scoped_args_tuple> local_args_tuple_scope_;
     double sum_{0.0};
     Eigen::VectorXd args_adjoints_{0};
 
     template <typename VecT, typename... ArgsT>
     recursive_reducer(size_t num_vars_per_term, size_t num_vars_shared_terms,
-                      double* sliced_partials, VecT&& vmapped, ArgsT&&... args)
+                      double* sliced_partials,
+                      thread_args_t& thread_args_tuple_scopes, VecT&& vmapped,
+                      ArgsT&&... args)
         : num_vars_per_term_(num_vars_per_term),
           num_vars_shared_terms_(num_vars_shared_terms),
           sliced_partials_(sliced_partials),
           vmapped_(std::forward<VecT>(vmapped)),
-          local_args_tuple_scope_(),
-          args_tuple_(std::forward<ArgsT>(args)...) {}
+          args_tuple_(std::forward<ArgsT>(args)...),
+          thread_args_tuple_scopes_(thread_args_tuple_scopes) {}
 
     /*
      * This is the copy operator as required for tbb::parallel_reduce
@@ -79,8 +87,32 @@ struct reduce_sum_impl<ReduceFunction, require_var_t<ReturnType>, ReturnType,
           num_vars_shared_terms_(other.num_vars_shared_terms_),
           sliced_partials_(other.sliced_partials_),
           vmapped_(other.vmapped_),
-          local_args_tuple_scope_(),
-          args_tuple_(other.args_tuple_) {}
+          args_tuple_(other.args_tuple_),
+          thread_args_tuple_scopes_(other.thread_args_tuple_scopes_) {}
+
+    /**
+     * Return the copies of the shared arguments to work with: those of
+     *  the calling thread unless another reducer on this thread is still
+     *  using them, in which case this reducer makes its own.
+     */
+    inline scoped_args_tuple& args_tuple_scope() {
+      const int thread_index = tbb::this_task_arena::current_thread_index();
+      if (thread_index >= 0
+          && static_cast<size_t>(thread_index)
+                 < thread_args_tuple_scopes_.size()) {
+        auto& scope = thread_args_tuple_scopes_[thread_index];
+        if (!scope) {
+          scope = std::make_unique<scoped_args_tuple>();
+        }
+        if (!scope->in_use_) {
+          return *scope;
+        }
+      }
+      if (!local_args_tuple_scope_) {
+        local_args_tuple_scope_ = std::make_unique<scoped_args_tuple>();
+      }
+      return *local_args_tuple_scope_;
+    }
 
     /**
      * Compute, using nested autodiff, the value and Jacobian of
@@ -106,16 +138,19 @@ struct reduce_sum_impl<ReduceFunction, require_var_t<ReturnType>, ReturnType,
 
       // Obtain reference to a local copy of all shared arguments that do
       // not point
-      //   back to main autodiff stack
+      //   back to main autodiff stack. The copy is shared by all
+      //   reducers running on the same thread, so the shared arguments
+      //   are copied once per thread rather than once per split.
+      scoped_args_tuple& args_tuple_scope = this->args_tuple_scope();
 
-      if (!local_args_tuple_scope_.args_tuple_holder_) {
-        // shared arguments need to be copied to reducer-specific
+      if (!args_tuple_scope.args_tuple_holder_) {
+        // shared arguments need to be copied to thread-specific
         // scope. In this case no need for zeroing adjoints, since the
         // fresh copy has all adjoints set to zero.
-        local_args_tuple_scope_.stack_.execute([&]() {
+        args_tuple_scope.stack_.execute([&]() {
           apply(
               [&](auto&&... args) {
-                local_args_tuple_scope_.args_tuple_holder_ = std::make_unique<
+                args_tuple_scope.args_tuple_holder_ = std::make_unique<
                     typename scoped_args_tuple::args_tuple_t>(
                     deep_copy_vars(args)...);
               },
@@ -123,10 +158,11 @@ struct reduce_sum_impl<ReduceFunction, require_var_t<ReturnType>, ReturnType,
         });
       } else {
         // set adjoints of shared arguments to zero
-        local_args_tuple_scope_.stack_.execute([] { set_zero_all_adjoints(); });
+        args_tuple_scope.stack_.execute([] { set_zero_all_adjoints(); });
       }
 
-      auto& args_tuple_local = *(local_args_tuple_scope_.args_tuple_holder_);
+      auto& args_tuple_local = *(args_tuple_scope.args_tuple_holder_);
+      args_tuple_scope.in_use_ = true;
 
       // Initialize nested autodiff stack
       const nested_rev_autodiff begin_nest;
@@ -163,6 +199,7 @@ struct reduce_sum_impl<ReduceFunction, require_var_t<ReturnType>, ReturnType,
             accumulate_adjoints(args_adjoints_.data(), args...);
           },
           args_tuple_local);
+      args_tuple_scope.in_use_ = false;
     }
 
     /**
@@ -245,7 +282,10 @@ struct reduce_sum_impl<ReduceFunction, require_var_t<ReturnType>, ReturnType,
       partials[i] = 0.0;
     }
 
+    thread_args_t thread_args_tuple_scopes(
+        std::max(tbb::this_task_arena::max_concurrency(), 1));
     recursive_reducer worker(num_vars_per_term, num_vars_shared_terms, partials,
+                             thread_args_tuple_scopes,
                              std::forward<Vec>(vmapped),
                              std::forward<Args>(args)...);
 
@@ -0,0 +1,492 @@
+#ifndef STAN_MATH_REV_FUNCTOR_SPARSE_JACOBIAN_HPP
+#define STAN_MATH_REV_FUNCTOR_SPARSE_JACOBIAN_HPP
+
+#include <stan/math/rev/meta.hpp>
+#include <stan/math/rev/core.hpp>
+#include <stan/math/rev/functor/jacobian.hpp>
+#include <stan/math/prim/err.hpp>
+#include <stan/math/prim/fun/constants.hpp>
+#include <stan/math/prim/fun/Eigen.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+namespace stan {
+namespace math {
+namespace internal {
+
+/**
+ * Greedily color the rows of a sparsity pattern such that no two rows
+ * of the same color have a non-zero in the same column.
+ *
+ * The rows of one color can be seeded together in a single reverse
+ * pass, since every column adjoint gets a contribution from at most
+ * one of them.
+ *
+ * @param[in] pattern Sparse matrix
+ * @param[out] num_colors Number of colors used
+ * @return Color of every row
+ */
+inline std::vector<int> sparsity_row_coloring(
+    const Eigen::SparseMatrix<double>& pattern, int& num_colors) {
+  const Eigen::SparseMatrix<double, Eigen::RowMajor> rows = pattern;
+  std::vector<int> colors(pattern.rows(), -1);
+  std::vector<int> forbidden(pattern.rows(), -1);
+  num_colors = 0;
+  for (int i = 0; i < rows.outerSize(); ++i) {
+    for (Eigen::SparseMatrix<double, Eigen::RowMajor>::InnerIterator row(rows,
+                                                                         i);
+         row; ++row) {
+      for (Eigen::SparseMatrix<double>::InnerIterator col(pattern, row.col());
+           col; ++col) {
+        if (colors[col.row()] >= 0) {
+          forbidden[colors[col.row()]] = i;
+        }
+      }
+    }
+    int color = 0;
+    while (forbidden[color] == i) {
+      ++color;
+    }
+    colors[i] = color;
+    num_colors = std::max(num_colors, color + 1);
+  }
+  return colors;
+}
+
+/**
+ * Calculate the values of a sparse jacobian from the recorded function
+ * with one reverse pass per color of the rows (see
+ * <code>sparsity_row_coloring()</code>).
+ *
+ * @param[in] nested Nested autodiff scope holding the recorded function
+ * @param[in] x_var Argument of the function
+ * @param[in, out] fx_var Function applied to the argument
+ * @param[in] colors Color of every row of the jacobian
+ * @param[in] num_colors Number of colors
+ * @param[in, out] J Jacobian with the sparsity pattern of the jacobian of
+ * the function; its values are overwritten
+ */
+inline void sparse_jacobian_passes(
+    nested_rev_autodiff& nested,
+    const Eigen::Matrix<var, Eigen::Dynamic, 1>& x_var,
+    Eigen::Matrix<var, Eigen::Dynamic, 1>& fx_var,
+    const std::vector<int>& colors, int num_colors,
+    Eigen::SparseMatrix<double>& J) {
+  for (int c = 0; c < num_colors; ++c) {
+    nested.set_zero_all_adjoints();
+    for (int i = 0; i < fx_var.size(); ++i) {
+      if (colors[i] == c) {
+        fx_var.coeffRef(i).adj() = 1;
+      }
+    }
+    grad();
+    for (int j = 0; j < J.outerSize(); ++j) {
+      for (Eigen::SparseMatrix<double>::InnerIterator it(J, j); it; ++it) {
+        if (colors[it.row()] == c) {
+          it.valueRef() = x_var.coeff(j).adj();
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Calculate the values of a sparse jacobian with one reverse pass per
+ * color of the rows (see <code>sparsity_row_coloring()</code>).
+ *
+ * @tparam F Type of function
+ * @param[in] f Function from vectors to vectors
+ * @param[in] x Argument of the function
+ * @param[in] colors Color of every row of the jacobian
+ * @param[in] num_colors Number of colors
+ * @param[in, out] J Jacobian with the sparsity pattern of the jacobian of
+ * <code>f</code>; its values are overwritten
+ * @return Function applied to the argument
+ */
+template <typename F>
+inline Eigen::VectorXd sparse_jacobian(const F& f, const Eigen::VectorXd& x,
+                                       const std::vector<int>& colors,
+                                       int num_colors,
+                                       Eigen::SparseMatrix<double>& J) {
+  nested_rev_autodiff nested;
+  Eigen::Matrix<var, Eigen::Dynamic, 1> x_var(x);
+  Eigen::Matrix<var, Eigen::Dynamic, 1> fx_var = f(x_var);
+  check_size_match("sparse_jacobian", "f(x)", fx_var.size(), "jacobian rows",
+                   J.rows());
+  sparse_jacobian_passes(nested, x_var, fx_var, colors, num_colors, J);
+  return fx_var.val();
+}
+
+/**
+ * Dependencies between the scalar varis of a nested tape, see
+ * <code>trace_tape()</code>.
+ */
+struct tape_graph {
+  std::unordered_map<const void*, int> nodes_;  // node of every vari
+  std::vector<std::vector<int>> operands_;      // operands of every node
+  std::vector<int> order_;  // nodes with operands, in the order of the tape
+
+  /**
+   * Return the node of a vari, or -1 if it is not on the nested tape.
+   */
+  inline int node(const vari* vi) const {
+    auto it = nodes_.find(vi);
+    return it == nodes_.end() ? -1 : it->second;
+  }
+};
+
+/**
+ * Trace the dependencies between the scalar varis recorded since the
+ * start of the innermost nested autodiff with one pass over the tape.
+ *
+ * Every scalar vari is a node, with the inputs first. The operands of a
+ * vari are found by setting its adjoint to NaN and calling its
+ * <code>chain()</code> once: NaN is not removed by multiplication with a
+ * zero partial derivative, so every vari it depends on gets a NaN
+ * adjoint, also if the derivative happens to vanish. Only the candidates
+ * named by <code>vari::trace_operands()</code> are checked and reset,
+ * so a vari which updates any other adjoint leaves a NaN behind, which
+ * is detected at the end. Entries of the SoA tape store their operands
+ * and are read directly.
+ *
+ * The trace fails if the tape holds varis which are not scalars, which
+ * do not name their operands or which update other adjoints than those
+ * they name, e.g. the reverse pass callbacks of the matrix functions.
+ * Adjoints are left dirty in any case.
+ *
+ * @param[in] inputs Varis of the inputs, which get the first nodes
+ * @param[out] graph Dependencies of the varis
+ * @return <code>true</code> if the dependencies of all varis were found
+ */
+inline bool trace_tape(const std::vector<vari*>& inputs, tape_graph& graph) {
+  auto& stack = *ChainableStack::instance_;
+  const size_t var_start = stack.nested_var_stack_sizes_.empty()
+                               ? 0
+                               : stack.nested_var_stack_sizes_.back();
+  const size_t nochain_start
+      = stack.nested_var_nochain_stack_sizes_.empty()
+            ? 0
+            : stack.nested_var_nochain_stack_sizes_.back();
+  std::vector<vari*> varis;
+  std::unordered_map<const double*, int> by_adjoint;
+  graph.nodes_.clear();
+  auto add_node = [&](vari* vi) {
+    if (graph.nodes_.emplace(vi, varis.size()).second) {
+      by_adjoint.emplace(&vi->adj_, varis.size());
+      varis.push_back(vi);
+    }
+  };
+  for (vari* vi : inputs) {
+    add_node(vi);
+  }
+  for (size_t i = nochain_start; i < stack.var_nochain_stack_.size(); ++i) {
+    if (auto* vi = dynamic_cast<vari*>(stack.var_nochain_stack_[i])) {
+      add_node(vi);
+    }
+  }
+  for (size_t i = var_start; i < stack.var_stack_.size(); ++i) {
+    if (auto* vi = dynamic_cast<vari*>(stack.var_stack_[i])) {
+      add_node(vi);
+    }
+  }
+  for (vari* vi : varis) {
+    vi->adj_ = 0;
+  }
+  graph.operands_.assign(varis.size(), std::vector<int>());
+  graph.order_.clear();
+
+  std::vector<const void*> candidates;
+  for (size_t i = var_start; i < stack.var_stack_.size(); ++i) {
+    vari_base* v = stack.var_stack_[i];
+    if (auto* seg = dynamic_cast<soa_segment_vari*>(v)) {
+      for (size_t k = 0; k < seg->size_; ++k) {
+        auto res = by_adjoint.find(seg->res_adj_[k]);
+        if (res == by_adjoint.end()) {
+          return false;
+        }
+        for (const double* adj : {seg->a_adj_[k], seg->b_adj_[k]}) {
+          auto op = by_adjoint.find(adj);
+          if (op != by_adjoint.end()) {
+            graph.operands_[res->second].push_back(op->second);
+          }
+        }
+        graph.order_.push_back(res->second);
+      }
+      continue;
+    }
+    auto* vi = dynamic_cast<vari*>(v);
+    if (vi == nullptr) {
+      return false;
+    }
+    if (typeid(*vi) == typeid(vari)) {
+      continue;
+    }
+    candidates.clear();
+    if (!vi->trace_operands(candidates)) {
+      return false;
+    }
+    const int node = graph.nodes_[vi];
+    vi->adj_ = NOT_A_NUMBER;
+    vi->chain();
+    vi->adj_ = 0;
+    for (const void* candidate : candidates) {
+      auto op = graph.nodes_.find(candidate);
+      if (op != graph.nodes_.end() && op->second != node
+          && std::isnan(varis[op->second]->adj_)) {
+        graph.operands_[node].push_back(op->second);
+        varis[op->second]->adj_ = 0;
+      }
+    }
+    graph.order_.push_back(node);
+  }
+  for (vari* vi : varis) {
+    if (std::isnan(vi->adj_)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Return the inputs every output depends on, by propagating index sets
+ * over the graph in the order of the tape. The sets of intermediate
+ * nodes are released after their last use.
+ *
+ * @param graph Dependencies from <code>trace_tape()</code>
+ * @param num_inputs Number of inputs, which are the first nodes
+ * @param outputs Nodes of the outputs, -1 for outputs which are not on
+ * the nested tape
+ * @return Sorted indexes of the inputs every output depends on
+ */
+inline std::vector<std::vector<int>> tape_dependencies(
+    const tape_graph& graph, int num_inputs, const std::vector<int>& outputs) {
+  const size_t num_nodes = graph.operands_.size();
+  std::vector<int> uses(num_nodes, 0);
+  for (int node : graph.order_) {
+    for (int op : graph.operands_[node]) {
+      ++uses[op];
+    }
+  }
+  for (int node : outputs) {
+    if (node >= 0) {
+      ++uses[node];
+    }
+  }
+  std::vector<std::vector<int>> deps(num_nodes);
+  for (int j = 0; j < num_inputs; ++j) {
+    deps[j].push_back(j);
+  }
+  std::vector<int> merged;
+  for (int node : graph.order_) {
+    for (int op : graph.operands_[node]) {
+      merged.clear();
+      std::set_union(deps[node].begin(), deps[node].end(), deps[op].begin(),
+                     deps[op].end(), std::back_inserter(merged));
+      deps[node].swap(merged);
+      if (--uses[op] == 0) {
+        std::vector<int>().swap(deps[op]);
+      }
+    }
+  }
+  std::vector<std::vector<int>> output_deps;
+  output_deps.reserve(outputs.size());
+  for (int node : outputs) {
+    output_deps.push_back(node >= 0 ? deps[node] : std::vector<int>());
+  }
+  return output_deps;
+}
+
+/**
+ * Find the sparsity pattern of the Jacobian of a recorded function with
+ * one pass over its tape (see <code>trace_tape()</code>).
+ *
+ * @param[in] x_var Argument of the function
+ * @param[in] fx_var Function applied to the argument
+ * @param[out] pattern Sparse matrix with ones at the structural
+ * non-zeros of the Jacobian; only assigned if the tape could be traced
+ * @return true if the tape could be traced
+ */
+inline bool trace_jacobian_sparsity(
+    const Eigen::Matrix<var, Eigen::Dynamic, 1>& x_var,
+    const Eigen::Matrix<var, Eigen::Dynamic, 1>& fx_var,
+    Eigen::SparseMatrix<double>& pattern) {
+  std::vector<vari*> inputs(x_var.size());
+  for (int j = 0; j < x_var.size(); ++j) {
+    inputs[j] = x_var.coeff(j).vi_;
+  }
+  tape_graph graph;
+  if (!trace_tape(inputs, graph)) {
+    return false;
+  }
+  std::vector<int> outputs(fx_var.size());
+  for (int i = 0; i < fx_var.size(); ++i) {
+    outputs[i] = graph.node(fx_var.coeff(i).vi_);
+  }
+  std::vector<std::vector<int>> deps
+      = tape_dependencies(graph, x_var.size(), outputs);
+  std::vector<Eigen::Triplet<double>> non_zeros;
+  for (int i = 0; i < fx_var.size(); ++i) {
+    for (int j : deps[i]) {
+      non_zeros.emplace_back(i, j, 1.0);
+    }
+  }
+  pattern.resize(fx_var.size(), x_var.size());
+  pattern.setFromTriplets(non_zeros.begin(), non_zeros.end());
+  return true;
+}
+
+/**
+ * Calculate the value and the dense Jacobian of the specified function
+ * from a single recording of the function.
+ *
+ * The sparsity pattern of the Jacobian is traced from the tape at
+ * <code>x</code> (see <code>trace_jacobian_sparsity()</code>). If the
+ * tape could be traced and the rows of the pattern need fewer colors than
+ * there are rows, the Jacobian is calculated with one reverse pass per
+ * color (see <code>sparse_jacobian_passes()</code>); otherwise, as by
+ * <code>jacobian()</code>, with one reverse pass per row. Since the
+ * pattern is traced at the argument itself, value dependent branches of
+ * the function cannot make it miss a non-zero.
+ *
+ * @tparam F Type of function
+ * @param[in] f Function from vectors to vectors
+ * @param[in] x Argument of the function
+ * @param[out] fx Function applied to the argument
+ * @param[out] J Jacobian of the function at the argument
+ */
+template <typename F>
+inline void traced_jacobian(const F& f, const Eigen::VectorXd& x,
+                            Eigen::VectorXd& fx, Eigen::MatrixXd& J) {
+  nested_rev_autodiff nested;
+  Eigen::Matrix<var, Eigen::Dynamic, 1> x_var(x);
+  Eigen::Matrix<var, Eigen::Dynamic, 1> fx_var = f(x_var);
+  fx = fx_var.val();
+  J.resize(fx_var.size(), x.size());
+
+  Eigen::SparseMatrix<double> pattern;
+  int num_colors = fx_var.size();
+  std::vector<int> colors;
+  if (trace_jacobian_sparsity(x_var, fx_var, pattern)) {
+    colors = sparsity_row_coloring(pattern, num_colors);
+  }
+  if (num_colors < fx_var.size()) {
+    sparse_jacobian_passes(nested, x_var, fx_var, colors, num_colors,
+                           pattern);
+    J = pattern;
+    return;
+  }
+  for (int i = 0; i < fx_var.size(); ++i) {
+    nested.set_zero_all_adjoints();
+    grad(fx_var(i).vi_);
+    J.row(i) = x_var.adj().transpose();
+  }
+}
+
+}  // namespace internal
+
+/**
+ * Return the sparsity pattern of the Jacobian of the specified function,
+ * with ones at the structural non-zeros.
+ *
+ * The function is recorded once at <code>x</code> and the pattern is
+ * found with one pass over the tape, which propagates the sets of
+ * inputs every vari depends on (see <code>internal::trace_tape()</code>).
+ * Entries whose derivative happens to vanish at <code>x</code> are
+ * found too. This costs about as much as one gradient plus the merging
+ * of the index sets, whose size is bounded by the number of non-zeros
+ * in a row.
+ *
+ * If the tape holds varis whose operands cannot be traced, such as the
+ * reverse pass callbacks of most matrix functions, the pattern is found
+ * instead by one reverse pass per output with its adjoint set to NaN,
+ * which costs as much as a dense Jacobian.
+ *
+ * Dependencies which are not on the tape because of a value dependent
+ * branch in the function (e.g. a conditional or <code>fmax</code>) are
+ * not found, so the pattern is only valid for arguments which take the
+ * same branches. The pattern is meant to be computed once and reused by
+ * <code>sparse_jacobian()</code> for many arguments.
+ *
+ * @tparam F Type of function
+ * @param f Function from vectors to vectors
+ * @param x Argument of the function
+ * @return Sparse matrix with the sparsity of the Jacobian
+ */
+template <typename F>
+inline Eigen::SparseMatrix<double> jacobian_sparsity(
+    const F& f, const Eigen::VectorXd& x) {
+  nested_rev_autodiff nested;
+  Eigen::Matrix<var, Eigen::Dynamic, 1> x_var(x);
+  Eigen::Matrix<var, Eigen::Dynamic, 1> fx_var = f(x_var);
+
+  Eigen::SparseMatrix<double> pattern;
+  if (internal::trace_jacobian_sparsity(x_var, fx_var, pattern)) {
+    return pattern;
+  }
+  std::vector<Eigen::Triplet<double>> non_zeros;
+  for (int i = 0; i < fx_var.size(); ++i) {
+    nested.set_zero_all_adjoints();
+    fx_var.coeffRef(i).adj() = NOT_A_NUMBER;
+    grad();
+    for (int j = 0; j < x_var.size(); ++j) {
+      if (x_var.coeff(j).adj() != 0) {
+        non_zeros.emplace_back(i, j, 1.0);
+      }
+    }
+  }
+  pattern.resize(fx_var.size(), x.size());
+  pattern.setFromTriplets(non_zeros.begin(), non_zeros.end());
+  return pattern;
+}
+
+/**
+ * Calculate the value and the sparse Jacobian of the specified function
+ * at the specified argument.
+ *
+ * The rows of the Jacobian are colored such that rows of the same color
+ * have no non-zero in a common column, and the rows of each color are
+ * calculated together with one reverse pass. The number of passes is the
+ * number of colors, which is the number of rows for a dense Jacobian and
+ * the bandwidth plus one for a banded Jacobian, independently of its
+ * size.
+ *
+ * <p>The functor must implement
+ *
+ * <code>
+ * Eigen::Matrix\<var, Eigen::Dynamic, 1\>
+ * operator()(const Eigen::Matrix\<var, Eigen::Dynamic, 1\>&)
+ * </code>
+ *
+ * @tparam F Type of function
+ * @param[in] f Function
+ * @param[in] x Argument to function
+ * @param[out] fx Function applied to argument
+ * @param[in, out] J Jacobian with the sparsity pattern of the Jacobian of
+ * <code>f</code>, for example from <code>jacobian_sparsity()</code>; its
+ * values are overwritten. If it is empty and <code>x</code> is not, the
+ * pattern is detected with <code>jacobian_sparsity()</code> first.
+ * @throw std::invalid_argument if the number of columns of J does not
+ * match the size of x or the number of rows of J does not match the size
+ * of f(x)
+ */
+template <typename F>
+inline void sparse_jacobian(const F& f, const Eigen::VectorXd& x,
+                            Eigen::VectorXd& fx,
+                            Eigen::SparseMatrix<double>& J) {
+  if (J.size() == 0 && x.size() > 0) {
+    J = jacobian_sparsity(f, x);
+  }
+  check_size_match("sparse_jacobian", "columns of J", J.cols(), "size of x",
+                   x.size());
+  int num_colors = 0;
+  std::vector<int> colors = internal::sparsity_row_coloring(J, num_colors);
+  fx = internal::sparse_jacobian(f, x, colors, num_colors, J);
+}
+
+}  // namespace math
+}  // namespace stan
+#endif
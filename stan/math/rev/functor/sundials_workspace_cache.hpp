@@ -0,0 +1,95 @@
+#ifndef STAN_MATH_REV_FUNCTOR_SUNDIALS_WORKSPACE_CACHE_HPP
+#define STAN_MATH_REV_FUNCTOR_SUNDIALS_WORKSPACE_CACHE_HPP
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace stan {
+namespace math {
+namespace internal {
+
+/**
+ * Bounded cache of SUNDIALS solver workspaces (solver memory, vectors,
+ * matrices and linear solvers), so that solvers called many times with
+ * problems of the same size are reinitialized instead of rebuilt.
+ *
+ * A workspace is taken out of the cache while it is used and put back
+ * afterwards, so nested solves never share a workspace. At most
+ * <code>max_size</code> workspaces are kept; when the cache is full the
+ * least recently used workspace is freed.
+ *
+ * The callbacks of SUNDIALS are registered once when the solver memory
+ * is created, so every solver type must use its own cache, see
+ * <code>instance()</code>.
+ *
+ * @tparam Key Type of the key of a workspace, which must be equality
+ * comparable
+ * @tparam Workspace Type of the workspace
+ */
+template <typename Key, typename Workspace>
+class sundials_workspace_cache {
+  // workspaces which are not in use, the most recently used last
+  std::vector<std::pair<Key, std::unique_ptr<Workspace>>> free_;
+
+ public:
+  static constexpr std::size_t max_size = 8;
+
+  /**
+   * Take a workspace out of the cache.
+   *
+   * @param key Key of the workspace
+   * @return Workspace with the given key, or a null pointer if the cache
+   * has none
+   */
+  inline std::unique_ptr<Workspace> acquire(const Key& key) {
+    for (auto it = free_.rbegin(); it != free_.rend(); ++it) {
+      if (it->first == key) {
+        std::unique_ptr<Workspace> workspace = std::move(it->second);
+        free_.erase(std::next(it).base());
+        return workspace;
+      }
+    }
+    return nullptr;
+  }
+
+  /**
+   * Put a workspace back into the cache, freeing the least recently used
+   * workspace if the cache is full.
+   *
+   * @param key Key of the workspace
+   * @param workspace Workspace
+   */
+  inline void release(const Key& key, std::unique_ptr<Workspace> workspace) {
+    if (free_.size() == max_size) {
+      free_.erase(free_.begin());
+    }
+    free_.emplace_back(key, std::move(workspace));
+  }
+
+  /**
+   * Return the number of workspaces in the cache.
+   */
+  inline std::size_t size() const { return free_.size(); }
+
+  /**
+   * Return the cache of workspaces of the calling thread for the solver
+   * type <code>Solver</code>.
+   *
+   * @tparam Solver Type owning the SUNDIALS callbacks
+   */
+  template <typename Solver>
+  static inline sundials_workspace_cache& instance() {
+    static thread_local sundials_workspace_cache cache;
+    return cache;
+  }
+};
+
+template <typename Key, typename Workspace>
+constexpr std::size_t sundials_workspace_cache<Key, Workspace>::max_size;
+
+}  // namespace internal
+}  // namespace math
+}  // namespace stan
+#endif
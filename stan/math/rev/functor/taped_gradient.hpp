@@ -0,0 +1,139 @@
+#ifndef STAN_MATH_REV_FUNCTOR_TAPED_GRADIENT_HPP
+#define STAN_MATH_REV_FUNCTOR_TAPED_GRADIENT_HPP
+
+#include <stan/math/rev/meta.hpp>
+#include <stan/math/rev/core.hpp>
+#include <stan/math/prim/fun/Eigen.hpp>
+#include <cstddef>
+
+namespace stan {
+namespace math {
+
+/**
+ * Functor calculating the value and the gradient of a function, which
+ * records the tape of the function once and replays it for new
+ * arguments.
+ *
+ * <p>The first call runs the function on vars like
+ * <code>gradient()</code> while the SoA operations (see
+ * <code>soa_tape.hpp</code>) are recorded into a program over plain
+ * arrays. Later calls evaluate that program forward for the new argument
+ * and run its reverse pass without calling the functor and without
+ * creating any varis. Every comparison of vars taken while recording is
+ * a guard; if one of them has a different outcome at the new argument,
+ * the control flow may differ, so the function is recorded again at the
+ * new argument.
+ *
+ * <p>Replay requires <code>STAN_MATH_SOA_TAPE</code>. A recording is
+ * only used if every vari the function put on the tape was an SoA
+ * operation (the arithmetic operators, unary minus, <code>exp()</code>
+ * and <code>log()</code>), no nested autodiff was started, the result
+ * was computed by a recorded operation rather than being an input or a
+ * constant, and no value was NaN. The branches of <code>fabs()</code>,
+ * <code>fmax()</code> and <code>fmin()</code> are comparisons of vars
+ * and so are guarded like the comparisons in the function itself. Otherwise,
+ * e.g. if the function calls any other special function, every call
+ * falls back to <code>gradient()</code>. The function must not make
+ * decisions on values other than through comparisons of vars and must
+ * not turn values of its argument into constants (e.g. through
+ * <code>value_of()</code>); neither can be detected.
+ *
+ * @tparam F Type of function
+ */
+template <typename F>
+class taped_gradient {
+  F f_;
+  internal::soa_tape_recorder tape_;
+  size_t out_ = 0;  // slot of the result in tape_
+  bool replayable_ = false;
+  size_t num_recordings_ = 0;
+
+  inline void record(const Eigen::Matrix<double, Eigen::Dynamic, 1>& x,
+                     double& fx,
+                     Eigen::Matrix<double, Eigen::Dynamic, 1>& grad_fx) {
+    nested_rev_autodiff nested;
+    auto& stack = *ChainableStack::instance_;
+
+    Eigen::Matrix<var, Eigen::Dynamic, 1> x_var(x);
+    tape_.clear();
+    for (int i = 0; i < x_var.size(); ++i) {
+      tape_.add_input(x_var.coeff(i).vi_);
+    }
+    const size_t stack_start = stack.var_stack_.size();
+    internal::soa_tape_recorder* outer = stack.soa_recorder_;
+    stack.soa_recorder_ = &tape_;
+    var fx_var;
+    try {
+      fx_var = f_(x_var);
+    } catch (...) {
+      stack.soa_recorder_ = outer;
+      throw;
+    }
+    stack.soa_recorder_ = outer;
+    ++num_recordings_;
+
+    replayable_ = !tape_.nested_;
+    for (size_t i = stack_start; replayable_ && i < stack.var_stack_.size();
+         ++i) {
+      replayable_ = dynamic_cast<internal::soa_segment_vari*>(
+                        stack.var_stack_[i])
+                    != nullptr;
+    }
+    // a result which is an input or a constant may have been picked by a
+    // decision on values which left nothing on the tape
+    out_ = tape_.find(fx_var.vi_);
+    replayable_ = replayable_ && out_ < tape_.values_.size()
+                  && tape_.is_result(out_) && !tape_.has_nan();
+    tape_.slots_.clear();
+
+    fx = fx_var.val();
+    grad_fx.resize(x.size());
+    grad(fx_var.vi_);
+    grad_fx = x_var.adj();
+  }
+
+ public:
+  /**
+   * @param[in] f Function
+   */
+  explicit taped_gradient(const F& f) : f_(f) {}
+
+  /**
+   * Calculate the value and the gradient of the function at the
+   * specified argument.
+   *
+   * @param[in] x Argument to function
+   * @param[out] fx Function applied to argument
+   * @param[out] grad_fx Gradient of function at argument
+   */
+  inline void operator()(const Eigen::Matrix<double, Eigen::Dynamic, 1>& x,
+                         double& fx,
+                         Eigen::Matrix<double, Eigen::Dynamic, 1>& grad_fx) {
+    if (replayable_ && static_cast<size_t>(x.size()) == tape_.num_inputs_
+        && tape_.forward(x)) {
+      tape_.reverse(out_);
+      fx = tape_.values_[out_];
+      grad_fx.resize(x.size());
+      for (int i = 0; i < x.size(); ++i) {
+        grad_fx.coeffRef(i) = tape_.adjs_[i + 1];
+      }
+      return;
+    }
+    record(x, fx, grad_fx);
+  }
+
+  /**
+   * Return <code>true</code> if the next call can replay the last
+   * recording.
+   */
+  inline bool replayable() const { return replayable_; }
+
+  /**
+   * Return the number of times the function was run on vars.
+   */
+  inline size_t num_recordings() const { return num_recordings_; }
+};
+
+}  // namespace math
+}  // namespace stan
+#endif
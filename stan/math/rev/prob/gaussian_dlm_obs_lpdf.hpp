@@ -0,0 +1,487 @@
+#ifndef STAN_MATH_REV_PROB_GAUSSIAN_DLM_OBS_LPDF_HPP
+#define STAN_MATH_REV_PROB_GAUSSIAN_DLM_OBS_LPDF_HPP
+
+#include <stan/math/rev/meta.hpp>
+#include <stan/math/rev/core.hpp>
+#include <stan/math/rev/fun/value_of.hpp>
+#include <stan/math/prim/meta.hpp>
+#include <stan/math/prim/err.hpp>
+#include <stan/math/prim/fun/Eigen.hpp>
+#include <stan/math/prim/fun/constants.hpp>
+#include <stan/math/prim/fun/size_zero.hpp>
+#include <stan/math/prim/fun/to_ref.hpp>
+#include <stan/math/prim/fun/value_of.hpp>
+#include <stan/math/prim/prob/gaussian_dlm_obs_lpdf.hpp>
+
+namespace stan {
+namespace math {
+namespace internal {
+
+/**
+ * One time step of the Kalman filter of a Gaussian dynamic linear model,
+ * calculated from the filtered mean and covariance of the previous step.
+ *
+ * The backward pass recomputes the steps from the filtered moments stored
+ * by the forward pass, so only O(n^2) numbers are kept per time step.
+ */
+class gaussian_dlm_obs_step {
+ public:
+  Eigen::VectorXd a_;                  // predicted state mean
+  Eigen::MatrixXd R_;                  // predicted state covariance
+  Eigen::MatrixXd RF_;                 // R F
+  Eigen::LLT<Eigen::MatrixXd> Q_llt_;  // predicted observation covariance
+  Eigen::VectorXd e_;                  // prediction error
+  Eigen::VectorXd Q_inv_e_;            // Q^-1 e
+
+  /**
+   * Predict the state and the observation of a time step.
+   *
+   * @param function Name of the calling function
+   * @param y Observation of the time step
+   * @param F Design matrix
+   * @param G Transition matrix
+   * @param V Observation covariance matrix
+   * @param W State covariance matrix
+   * @param m Filtered state mean of the previous step
+   * @param C Filtered state covariance of the previous step
+   * @throw std::domain_error if the predicted observation covariance is
+   * not positive definite
+   */
+  template <typename T_y>
+  gaussian_dlm_obs_step(const char* function, const T_y& y,
+                        const Eigen::MatrixXd& F, const Eigen::MatrixXd& G,
+                        const Eigen::MatrixXd& V, const Eigen::MatrixXd& W,
+                        const Eigen::VectorXd& m, const Eigen::MatrixXd& C)
+      : a_(G * m), R_(G * C * G.transpose() + W) {
+    R_ = 0.5 * (R_ + R_.transpose()).eval();
+    RF_ = R_ * F;
+    Eigen::MatrixXd Q = F.transpose() * RF_ + V;
+    Q_llt_.compute(0.5 * (Q + Q.transpose()));
+    if (Q_llt_.info() != Eigen::Success) {
+      throw_domain_error(function, "Q", "", "is not positive definite");
+    }
+    e_ = y - F.transpose() * a_;
+    Q_inv_e_ = Q_llt_.solve(e_);
+  }
+
+  /**
+   * Return the log density of the observation of the time step without
+   * the constant term.
+   */
+  inline double log_density() const {
+    return -0.5
+           * (2 * Q_llt_.matrixLLT().diagonal().array().log().sum()
+              + e_.dot(Q_inv_e_));
+  }
+
+  /**
+   * Calculate the filtered state mean and covariance of the time step.
+   *
+   * @param[out] m Filtered state mean
+   * @param[out] C Filtered state covariance
+   */
+  inline void update(Eigen::VectorXd& m, Eigen::MatrixXd& C) const {
+    m = a_ + RF_ * Q_inv_e_;
+    C = R_ - RF_ * Q_llt_.solve(RF_.transpose());
+    C = 0.5 * (C + C.transpose()).eval();
+  }
+};
+
+/**
+ * Adjoints of the arguments of the log density of a Gaussian dynamic
+ * linear model.
+ */
+struct gaussian_dlm_obs_adjoints {
+  Eigen::MatrixXd y_;
+  Eigen::MatrixXd F_;
+  Eigen::MatrixXd G_;
+  Eigen::MatrixXd V_;
+  Eigen::MatrixXd W_;
+  Eigen::VectorXd m0_;
+  Eigen::MatrixXd C0_;
+};
+
+/**
+ * Calculate the adjoints of the arguments of the log density of a
+ * Gaussian dynamic linear model by running the Kalman filter backwards
+ * in time, from the filtered moments stored by the forward pass.
+ *
+ * The adjoints of the covariance matrices V, W and C0 are symmetrized.
+ *
+ * @param function Name of the calling function
+ * @param lp_adj Adjoint of the log density
+ * @param y A r x T matrix of observations
+ * @param F A n x r design matrix
+ * @param G A n x n transition matrix
+ * @param V A r x r observation covariance matrix
+ * @param W A n x n state covariance matrix
+ * @param ms A n x T matrix with the filtered state means of the steps
+ * before each observation, the first being m0
+ * @param Cs A n x (n T) matrix with the filtered state covariances of the
+ * steps before each observation, the first being C0
+ * @return Adjoints of the arguments
+ */
+template <typename T_ms, typename T_Cs>
+inline gaussian_dlm_obs_adjoints gaussian_dlm_obs_adjoint(
+    const char* function, double lp_adj, const Eigen::MatrixXd& y,
+    const Eigen::MatrixXd& F, const Eigen::MatrixXd& G,
+    const Eigen::MatrixXd& V, const Eigen::MatrixXd& W, const T_ms& ms,
+    const T_Cs& Cs) {
+  const int n = G.rows();
+  const int r = y.rows();
+  gaussian_dlm_obs_adjoints adj;
+  adj.y_ = Eigen::MatrixXd::Zero(r, y.cols());
+  adj.F_ = Eigen::MatrixXd::Zero(n, r);
+  adj.G_ = Eigen::MatrixXd::Zero(n, n);
+  adj.V_ = Eigen::MatrixXd::Zero(r, r);
+  adj.W_ = Eigen::MatrixXd::Zero(n, n);
+  // adjoints of the filtered moments of the current step
+  Eigen::VectorXd m_adj = Eigen::VectorXd::Zero(n);
+  Eigen::MatrixXd C_adj = Eigen::MatrixXd::Zero(n, n);
+
+  for (int t = y.cols() - 1; t >= 0; --t) {
+    const Eigen::VectorXd m = ms.col(t);
+    const Eigen::MatrixXd C = Cs.block(0, t * n, n, n);
+    const gaussian_dlm_obs_step step(function, y.col(t), F, G, V, W, m, C);
+    const Eigen::MatrixXd Q_inv
+        = step.Q_llt_.solve(Eigen::MatrixXd::Identity(r, r));
+    const Eigen::VectorXd& s = step.Q_inv_e_;
+
+    // lp -= 0.5 * (log det(Q) + e' Q^-1 e)
+    Eigen::MatrixXd Q_adj = -0.5 * lp_adj * (Q_inv - s * s.transpose());
+    Eigen::VectorXd e_adj = -lp_adj * s;
+
+    // m = a + R F Q^-1 e
+    Eigen::VectorXd a_adj = m_adj;
+    Eigen::MatrixXd RF_adj = m_adj * s.transpose();
+    const Eigen::VectorXd s_adj = step.RF_.transpose() * m_adj;
+
+    // C = R - R F Q^-1 F' R
+    Eigen::MatrixXd R_adj = C_adj;
+    const Eigen::MatrixXd RF_Q_inv = step.RF_ * Q_inv;
+    RF_adj -= (C_adj + C_adj.transpose()) * RF_Q_inv;
+    Q_adj += RF_Q_inv.transpose() * C_adj * RF_Q_inv;
+
+    // Q^-1 e
+    const Eigen::VectorXd Q_inv_s_adj = Q_inv * s_adj;
+    e_adj += Q_inv_s_adj;
+    Q_adj -= Q_inv_s_adj * s.transpose();
+
+    // e = y - F' a
+    adj.y_.col(t) = e_adj;
+    adj.F_ -= step.a_ * e_adj.transpose();
+    a_adj -= F * e_adj;
+
+    // Q = F' R F + V
+    adj.V_ += Q_adj;
+    adj.F_ += step.RF_ * Q_adj.transpose();
+    RF_adj += F * Q_adj;
+
+    // R F
+    R_adj += RF_adj * F.transpose();
+    adj.F_ += step.R_ * RF_adj;
+
+    // R = G C G' + W
+    adj.W_ += R_adj;
+    adj.G_ += R_adj * G * C.transpose() + R_adj.transpose() * G * C;
+    C_adj = G.transpose() * R_adj * G;
+
+    // a = G m
+    adj.G_ += a_adj * m.transpose();
+    m_adj = G.transpose() * a_adj;
+  }
+  adj.m0_ = m_adj;
+  adj.C0_ = 0.5 * (C_adj + C_adj.transpose());
+  adj.V_ = 0.5 * (adj.V_ + adj.V_.transpose()).eval();
+  adj.W_ = 0.5 * (adj.W_ + adj.W_.transpose()).eval();
+  return adj;
+}
+
+/**
+ * Return the observation covariance matrix of a Gaussian dynamic linear
+ * model given as a matrix.
+ */
+template <typename T_V, require_eigen_matrix_dynamic_t<T_V>* = nullptr>
+inline Eigen::MatrixXd gaussian_dlm_obs_V(const T_V& V) {
+  return V;
+}
+
+/**
+ * Return the observation covariance matrix of a Gaussian dynamic linear
+ * model given as the vector of its diagonal.
+ */
+template <typename T_V, require_eigen_col_vector_t<T_V>* = nullptr>
+inline Eigen::MatrixXd gaussian_dlm_obs_V(const T_V& V) {
+  return V.asDiagonal();
+}
+
+/**
+ * Return the adjoint of the observation covariance matrix of a Gaussian
+ * dynamic linear model given as a matrix.
+ */
+template <typename T_V, require_eigen_matrix_dynamic_t<T_V>* = nullptr>
+inline const Eigen::MatrixXd& gaussian_dlm_obs_V_adj(
+    const T_V& V, const Eigen::MatrixXd& V_adj) {
+  return V_adj;
+}
+
+/**
+ * Return the adjoint of the observation covariance matrix of a Gaussian
+ * dynamic linear model given as the vector of its diagonal.
+ */
+template <typename T_V, require_eigen_col_vector_t<T_V>* = nullptr>
+inline auto gaussian_dlm_obs_V_adj(const T_V& V, const Eigen::MatrixXd& V_adj) {
+  return V_adj.diagonal();
+}
+
+/**
+ * Return the log density of a Gaussian dynamic linear model, with the
+ * gradients calculated by an adjoint Kalman filter.
+ *
+ * The Kalman filter runs on the values of the arguments, so no vari is
+ * created per operation. The forward pass stores the filtered state means
+ * and covariances of the steps, and a single callback runs the filter
+ * backwards to accumulate the adjoints of all the arguments.
+ *
+ * @tparam propto Carry out calculations up to a proportion
+ */
+template <bool propto, typename T_y, typename T_F,
+          typename T_G, typename T_V, typename T_W, typename T_m0,
+          typename T_C0>
+inline var gaussian_dlm_obs_lpdf_rev(const char* function, const T_y& y,
+                                     const T_F& F, const T_G& G, const T_V& V,
+                                     const T_W& W, const T_m0& m0,
+                                     const T_C0& C0) {
+  const int r = y.rows();
+  const int n = G.rows();
+  const int T = y.cols();
+
+  arena_t<T_y> arena_y = y;
+  arena_t<T_F> arena_F = F;
+  arena_t<T_G> arena_G = G;
+  arena_t<T_V> arena_V = V;
+  arena_t<T_W> arena_W = W;
+  arena_t<T_m0> arena_m0 = m0;
+  arena_t<T_C0> arena_C0 = C0;
+
+  arena_t<Eigen::MatrixXd> y_val = value_of(arena_y);
+  arena_t<Eigen::MatrixXd> F_val = value_of(arena_F);
+  arena_t<Eigen::MatrixXd> G_val = value_of(arena_G);
+  arena_t<Eigen::MatrixXd> V_val = gaussian_dlm_obs_V(value_of(arena_V));
+  arena_t<Eigen::MatrixXd> W_val = value_of(arena_W);
+
+  // filtered moments before every observation
+  arena_t<Eigen::MatrixXd> ms(n, T);
+  arena_t<Eigen::MatrixXd> Cs(n, n * T);
+  Eigen::VectorXd m = value_of(arena_m0);
+  Eigen::MatrixXd C = value_of(arena_C0);
+  double lp_val = 0;
+  if (include_summand<propto>::value) {
+    lp_val -= HALF_LOG_TWO_PI * r * T;
+  }
+  for (int t = 0; t < T; ++t) {
+    ms.col(t) = m;
+    Cs.block(0, t * n, n, n) = C;
+    const gaussian_dlm_obs_step step(function, y_val.col(t), F_val, G_val,
+                                     V_val, W_val, m, C);
+    lp_val += step.log_density();
+    step.update(m, C);
+  }
+
+  var lp = lp_val;
+  reverse_pass_callback([function, lp, arena_y, arena_F, arena_G, arena_V,
+                         arena_W, arena_m0, arena_C0, y_val, F_val, G_val,
+                         V_val, W_val, ms, Cs]() mutable {
+    gaussian_dlm_obs_adjoints adj = gaussian_dlm_obs_adjoint(
+        function, lp.adj(), y_val, F_val, G_val, V_val, W_val, ms, Cs);
+    using T_y_var = arena_t<promote_scalar_t<var, T_y>>;
+    using T_F_var = arena_t<promote_scalar_t<var, T_F>>;
+    using T_G_var = arena_t<promote_scalar_t<var, T_G>>;
+    using T_V_var = arena_t<promote_scalar_t<var, T_V>>;
+    using T_W_var = arena_t<promote_scalar_t<var, T_W>>;
+    using T_m0_var = arena_t<promote_scalar_t<var, T_m0>>;
+    using T_C0_var = arena_t<promote_scalar_t<var, T_C0>>;
+    if (!is_constant<T_y>::value) {
+      forward_as<T_y_var>(arena_y).adj() += adj.y_;
+    }
+    if (!is_constant<T_F>::value) {
+      forward_as<T_F_var>(arena_F).adj() += adj.F_;
+    }
+    if (!is_constant<T_G>::value) {
+      forward_as<T_G_var>(arena_G).adj() += adj.G_;
+    }
+    if (!is_constant<T_V>::value) {
+      forward_as<T_V_var>(arena_V).adj()
+          += gaussian_dlm_obs_V_adj(arena_V, adj.V_);
+    }
+    if (!is_constant<T_W>::value) {
+      forward_as<T_W_var>(arena_W).adj() += adj.W_;
+    }
+    if (!is_constant<T_m0>::value) {
+      forward_as<T_m0_var>(arena_m0).adj() += adj.m0_;
+    }
+    if (!is_constant<T_C0>::value) {
+      forward_as<T_C0_var>(arena_C0).adj() += adj.C0_;
+    }
+  });
+  return lp;
+}
+
+}  // namespace internal
+
+/** \ingroup multivar_dists
+ * The log of a Gaussian dynamic linear model (GDLM) with var arguments,
+ * see the overload in prim for the definition.
+ *
+ * The Kalman filter runs on the values of the arguments and the gradients
+ * are calculated by an adjoint Kalman filter running backwards in time in
+ * a single callback, so the size of the autodiff tape does not grow with
+ * the number of time steps.
+ *
+ * @tparam T_y type of scalar
+ * @tparam T_F type of design matrix
+ * @tparam T_G type of transition matrix
+ * @tparam T_V type of observation covariance matrix
+ * @tparam T_W type of state covariance matrix
+ * @tparam T_m0 type of initial state mean vector
+ * @tparam T_C0 type of initial state covariance matrix
+ *
+ * @param y A r x T matrix of observations. Rows are variables,
+ * columns are observations.
+ * @param F A n x r matrix. The design matrix.
+ * @param G A n x n matrix. The transition matrix.
+ * @param V A r x r matrix. The observation covariance matrix.
+ * @param W A n x n matrix. The state covariance matrix.
+ * @param m0 A n x 1 matrix. The mean vector of the distribution
+ * of the initial state.
+ * @param C0 A n x n matrix. The covariance matrix of the
+ * distribution of the initial state.
+ * @return The log of the joint density of the GDLM.
+ * @throw std::domain_error if a matrix in the Kalman filter is
+ * not positive semi-definite.
+ */
+template <bool propto, typename T_y, typename T_F, typename T_G, typename T_V,
+          typename T_W, typename T_m0, typename T_C0,
+          require_all_eigen_matrix_dynamic_t<T_y, T_F, T_G, T_V, T_W,
+                                             T_C0>* = nullptr,
+          require_eigen_col_vector_t<T_m0>* = nullptr,
+          require_any_st_var<T_y, T_F, T_G, T_V, T_W, T_m0, T_C0>* = nullptr>
+inline var gaussian_dlm_obs_lpdf(const T_y& y, const T_F& F, const T_G& G,
+                                 const T_V& V, const T_W& W, const T_m0& m0,
+                                 const T_C0& C0) {
+  static const char* function = "gaussian_dlm_obs_lpdf";
+  check_size_match(function, "columns of F", F.cols(), "rows of y", y.rows());
+  check_size_match(function, "rows of F", F.rows(), "rows of G", G.rows());
+  check_size_match(function, "rows of V", V.rows(), "rows of y", y.rows());
+  check_size_match(function, "rows of W", W.rows(), "rows of G", G.rows());
+  check_size_match(function, "size of m0", m0.size(), "rows of G", G.rows());
+  check_size_match(function, "rows of C0", C0.rows(), "rows of G", G.rows());
+  check_square(function, "G", G);
+
+  const auto& y_ref = to_ref(y);
+  const auto& F_ref = to_ref(F);
+  const auto& G_ref = to_ref(G);
+  const auto& V_ref = to_ref(V);
+  const auto& W_ref = to_ref(W);
+  const auto& m0_ref = to_ref(m0);
+  const auto& C0_ref = to_ref(C0);
+
+  check_finite(function, "y", y_ref);
+  check_finite(function, "F", F_ref);
+  check_finite(function, "G", G_ref);
+  check_finite(function, "V", V_ref);
+  check_pos_semidefinite(function, "V", V_ref);
+  check_finite(function, "W", W_ref);
+  check_pos_semidefinite(function, "W", W_ref);
+  check_finite(function, "m0", m0_ref);
+  check_pos_semidefinite(function, "C0", C0_ref);
+  check_finite(function, "C0", C0_ref);
+
+  if (size_zero(y)) {
+    return 0;
+  }
+
+  return internal::gaussian_dlm_obs_lpdf_rev<propto>(
+      function, y_ref, F_ref, G_ref, V_ref, W_ref, m0_ref, C0_ref);
+}
+
+/** \ingroup multivar_dists
+ * The log of a Gaussian dynamic linear model (GDLM) with uncorrelated
+ * observation disturbances and var arguments, see the overload in prim
+ * for the definition.
+ *
+ * The observations are filtered jointly with the diagonal observation
+ * covariance matrix, which gives the same density as the sequential
+ * filter, and the gradients are calculated by an adjoint Kalman filter
+ * running backwards in time in a single callback.
+ *
+ * @param y A r x T matrix of observations. Rows are variables,
+ * columns are observations.
+ * @param F A n x r matrix. The design matrix.
+ * @param G A n x n matrix. The transition matrix.
+ * @param V A size r vector. The diagonal of the observation
+ * covariance matrix.
+ * @param W A n x n matrix. The state covariance matrix.
+ * @param m0 A n x 1 matrix. The mean vector of the distribution
+ * of the initial state.
+ * @param C0 A n x n matrix. The covariance matrix of the
+ * distribution of the initial state.
+ * @return The log of the joint density of the GDLM.
+ * @throw std::domain_error if a matrix in the Kalman filter is
+ * not semi-positive definite.
+ * @tparam T_y Type of scalar.
+ * @tparam T_F Type of design matrix.
+ * @tparam T_G Type of transition matrix.
+ * @tparam T_V Type of observation variances
+ * @tparam T_W Type of state covariance matrix.
+ * @tparam T_m0 Type of initial state mean vector.
+ * @tparam T_C0 Type of initial state covariance matrix.
+ */
+template <
+    bool propto, typename T_y, typename T_F, typename T_G, typename T_V,
+    typename T_W, typename T_m0, typename T_C0,
+    require_all_eigen_matrix_dynamic_t<T_y, T_F, T_G, T_W, T_C0>* = nullptr,
+    require_all_eigen_col_vector_t<T_V, T_m0>* = nullptr,
+    require_any_st_var<T_y, T_F, T_G, T_V, T_W, T_m0, T_C0>* = nullptr>
+inline var gaussian_dlm_obs_lpdf(const T_y& y, const T_F& F, const T_G& G,
+                                 const T_V& V, const T_W& W, const T_m0& m0,
+                                 const T_C0& C0) {
+  static const char* function = "gaussian_dlm_obs_lpdf";
+  check_size_match(function, "columns of F", F.cols(), "rows of y", y.rows());
+  check_size_match(function, "rows of F", F.rows(), "rows of G", G.rows());
+  check_size_match(function, "rows of G", G.rows(), "columns of G", G.cols());
+  check_size_match(function, "size of V", V.size(), "rows of y", y.rows());
+  check_size_match(function, "rows of W", W.rows(), "rows of G", G.rows());
+  check_size_match(function, "size of m0", m0.size(), "rows of G", G.rows());
+  check_size_match(function, "rows of C0", C0.rows(), "rows of G", G.rows());
+
+  const auto& y_ref = to_ref(y);
+  const auto& F_ref = to_ref(F);
+  const auto& G_ref = to_ref(G);
+  const auto& V_ref = to_ref(V);
+  const auto& W_ref = to_ref(W);
+  const auto& m0_ref = to_ref(m0);
+  const auto& C0_ref = to_ref(C0);
+
+  check_finite(function, "y", y_ref);
+  check_finite(function, "F", F_ref);
+  check_finite(function, "G", G_ref);
+  check_nonnegative(function, "V", V_ref);
+  check_finite(function, "V", V_ref);
+  check_pos_semidefinite(function, "W", W_ref);
+  check_finite(function, "W", W_ref);
+  check_finite(function, "m0", m0_ref);
+  check_pos_semidefinite(function, "C0", C0_ref);
+  check_finite(function, "C0", C0_ref);
+
+  if (y.cols() == 0 || y.rows() == 0) {
+    return 0;
+  }
+
+  return internal::gaussian_dlm_obs_lpdf_rev<propto>(
+      function, y_ref, F_ref, G_ref, V_ref, W_ref, m0_ref, C0_ref);
+}
+
+}  // namespace math
+}  // namespace stan
+#endif
@@ -1,3 +1,9 @@
+// the arena and autodiff stack statistics are only kept if
+// STAN_MATH_ARENA_STATS is defined
+#ifndef STAN_MATH_ARENA_STATS
+#define STAN_MATH_ARENA_STATS
+#endif
+
 #include <gtest/gtest.h>
 #include <stan/math/memory/stack_alloc.hpp>
 #include <stdlib.h>
@@ -119,3 +125,163 @@ TEST(stack_alloc, in_stack_second_block) {
   EXPECT_FALSE(allocator.in_stack(x));
   EXPECT_FALSE(allocator.in_stack(y));
 }
+
+TEST(stack_alloc, blocks_are_cache_line_aligned) {
+  stan::math::stack_alloc allocator;
+  EXPECT_TRUE(stan::math::is_aligned(allocator.alloc(1), 64U));
+
+  // force allocation of new blocks, first alloc in each must be aligned
+  for (size_t n = 1; n < 8; ++n) {
+    void* x = allocator.alloc(stan::math::internal::DEFAULT_INITIAL_NBYTES * n);
+    EXPECT_TRUE(stan::math::is_aligned(x, 64U));
+  }
+  allocator.free_all();
+  EXPECT_TRUE(stan::math::is_aligned(allocator.alloc(1), 64U));
+}
+
+TEST(stack_alloc, huge_pages) {
+  stan::math::stack_alloc allocator(
+      stan::math::internal::DEFAULT_INITIAL_NBYTES, true);
+  const size_t big = 3 * stan::math::internal::HUGE_PAGE_NBYTES + 1;
+  char* x = allocator.alloc_array<char>(big);
+  EXPECT_TRUE(stan::math::is_aligned(x, 64U));
+  x[0] = 1;
+  x[big - 1] = 2;
+  EXPECT_EQ(1, x[0]);
+  EXPECT_EQ(2, x[big - 1]);
+  EXPECT_TRUE(allocator.in_stack(x + big - 1));
+  EXPECT_LE(stan::math::internal::DEFAULT_INITIAL_NBYTES + big,
+            allocator.bytes_allocated());
+
+  allocator.recover_all();
+  char* y = allocator.alloc_array<char>(big);
+  EXPECT_EQ(x, y);
+  allocator.free_all();
+  EXPECT_EQ(stan::math::internal::DEFAULT_INITIAL_NBYTES,
+            allocator.bytes_allocated());
+}
+
+TEST(stack_alloc, retention_keep_all) {
+  stan::math::stack_alloc allocator;
+  const size_t initial = stan::math::internal::DEFAULT_INITIAL_NBYTES;
+  allocator.alloc(initial * 8);
+  size_t peak = allocator.bytes_allocated();
+  allocator.recover_all();
+  allocator.alloc(initial * 8);
+  EXPECT_EQ(peak, allocator.bytes_allocated());
+}
+
+TEST(stack_alloc, retention_fixed_bytes) {
+  using stan::math::arena_retention;
+  stan::math::stack_alloc allocator;
+  const size_t initial = stan::math::internal::DEFAULT_INITIAL_NBYTES;
+  allocator.set_retention(arena_retention::fixed_bytes, 4 * initial);
+  for (int i = 0; i < 3; ++i) {
+    allocator.alloc(initial / 2);
+    allocator.alloc(initial * 8);
+    allocator.recover_all();
+    // first block is kept, rest is consolidated into one block
+    char* x = allocator.alloc_array<char>(initial / 2);
+    char* y = allocator.alloc_array<char>(3 * initial - 1);
+    EXPECT_TRUE(allocator.in_stack(x));
+    EXPECT_TRUE(allocator.in_stack(y));
+    EXPECT_EQ(4 * initial, allocator.bytes_allocated());
+    allocator.recover_all();
+  }
+
+  allocator.set_retention(arena_retention::fixed_bytes, 0);
+  allocator.alloc(initial * 8);
+  allocator.recover_all();
+  allocator.alloc(1);
+  EXPECT_EQ(initial, allocator.bytes_allocated());
+}
+
+TEST(stack_alloc, retention_moving_average) {
+  using stan::math::arena_retention;
+  stan::math::stack_alloc allocator;
+  const size_t initial = stan::math::internal::DEFAULT_INITIAL_NBYTES;
+  allocator.set_retention(arena_retention::moving_average, 0, 0.5);
+
+  // a single large cycle is kept
+  allocator.alloc(initial / 2);
+  allocator.alloc(initial * 3);
+  allocator.recover_all();
+  allocator.alloc(initial / 2);
+  allocator.alloc(initial * 3);
+  EXPECT_EQ(4 * initial, allocator.bytes_allocated());
+
+  // after many small cycles the large block is released
+  for (int i = 0; i < 20; ++i) {
+    allocator.recover_all();
+    allocator.alloc(initial / 2);
+  }
+  allocator.recover_all();
+  allocator.alloc(initial / 2);
+  allocator.alloc(initial);
+  EXPECT_GT(4 * initial, allocator.bytes_allocated());
+
+  EXPECT_THROW(allocator.set_retention(arena_retention::moving_average, 0, 0),
+               std::invalid_argument);
+}
+
+TEST(stack_alloc, retention_nested_peak) {
+  using stan::math::arena_retention;
+  stan::math::stack_alloc allocator;
+  const size_t initial = stan::math::internal::DEFAULT_INITIAL_NBYTES;
+  allocator.set_retention(arena_retention::moving_average);
+  allocator.alloc(initial / 2);
+  allocator.start_nested();
+  allocator.alloc(initial);
+  allocator.recover_nested();
+  allocator.recover_all();
+
+  // the block used only within the nested region is retained
+  allocator.alloc(initial / 2);
+  allocator.alloc(initial);
+  EXPECT_EQ(3 * initial, allocator.bytes_allocated());
+}
+
+TEST(stack_alloc, stats) {
+  stan::math::stack_alloc allocator;
+  const size_t initial = stan::math::internal::DEFAULT_INITIAL_NBYTES;
+  stan::math::stack_alloc_stats stats = allocator.stats();
+  EXPECT_EQ(0, stats.bytes_requested);
+  EXPECT_EQ(initial, stats.bytes_reserved);
+  EXPECT_EQ(1, stats.blocks_allocated);
+  EXPECT_FLOAT_EQ(0.0, stats.fragmentation());
+
+  allocator.alloc(100);
+  allocator.alloc(initial - 50);  // does not fit, 64KB - 100 bytes wasted
+  allocator.start_nested();
+  allocator.alloc(200);
+  allocator.recover_nested();
+  allocator.alloc(10);
+  stats = allocator.stats();
+  EXPECT_EQ(100 + initial - 50 + 200 + 10, stats.bytes_requested);
+  EXPECT_EQ(initial - 100, stats.wasted_bytes);
+  EXPECT_EQ(initial + 2 * initial, stats.bytes_reserved);
+  EXPECT_EQ(initial + initial - 50 + 200, stats.peak_bytes_used);
+  EXPECT_EQ(1, stats.block_switches);
+  EXPECT_EQ(2, stats.blocks_allocated);
+  EXPECT_EQ(1, stats.nested_starts);
+  EXPECT_GT(stats.fragmentation(), 0.0);
+
+  allocator.recover_all();
+  allocator.alloc(8);
+  stats = allocator.stats();
+  EXPECT_EQ(1, stats.recoveries);
+  EXPECT_EQ(100 + initial - 50 + 200 + 10 + 8, stats.bytes_requested);
+
+  allocator.reset_stats();
+  allocator.alloc(16);
+  stats = allocator.stats();
+  EXPECT_EQ(16, stats.bytes_requested);
+  EXPECT_EQ(24, stats.peak_bytes_used);
+  EXPECT_EQ(0, stats.recoveries);
+  EXPECT_EQ(0, stats.block_switches);
+
+  allocator.free_all();
+  stats = allocator.stats();
+  EXPECT_EQ(1, stats.blocks_freed);
+  EXPECT_EQ(initial, stats.bytes_reserved);
+}
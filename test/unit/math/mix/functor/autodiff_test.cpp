@@ -110,6 +110,55 @@ TEST(MixFunctor, hessianTimesVector) {
   EXPECT_FLOAT_EQ(2 * x(0) * v(0) + 6 * v(1), Hv(1));
 }
 
+TEST(MixFunctor, hessianTimesMatrix) {
+  norm_functor f;
+  Matrix<double, Dynamic, 1> x(3);
+  x << 0.5, -1.2, 2.0;
+  Matrix<double, Dynamic, Dynamic> V(3, 2);
+  V << 1, 0.5, 0, -2, 0, 3;
+
+  double fx;
+  Matrix<double, Dynamic, Dynamic> HV;
+  stan::math::hessian_times_vector(f, x, V, fx, HV);
+
+  double fx_expected;
+  Matrix<double, Dynamic, 1> grad;
+  Matrix<double, Dynamic, Dynamic> H;
+  stan::math::hessian(f, x, fx_expected, grad, H);
+
+  EXPECT_FLOAT_EQ(fx_expected, fx);
+  EXPECT_EQ(3, HV.rows());
+  EXPECT_EQ(2, HV.cols());
+  Matrix<double, Dynamic, Dynamic> HV_expected = H * V;
+  for (int i = 0; i < 3; ++i) {
+    for (int k = 0; k < 2; ++k) {
+      EXPECT_FLOAT_EQ(HV_expected(i, k), HV(i, k));
+    }
+  }
+
+  for (int k = 0; k < 2; ++k) {
+    Matrix<double, Dynamic, 1> Hv;
+    Matrix<double, Dynamic, 1> v = V.col(k);
+    stan::math::hessian_times_vector(f, x, v, fx, Hv);
+    for (int i = 0; i < 3; ++i) {
+      EXPECT_FLOAT_EQ(Hv(i), HV(i, k));
+    }
+  }
+
+  // the passes may run in parallel on request
+  Matrix<double, Dynamic, Dynamic> HV_parallel;
+  stan::math::hessian_times_vector(f, x, V, fx, HV_parallel, true);
+  for (int i = 0; i < 3; ++i) {
+    for (int k = 0; k < 2; ++k) {
+      EXPECT_FLOAT_EQ(HV(i, k), HV_parallel(i, k));
+    }
+  }
+
+  Matrix<double, Dynamic, Dynamic> V_wrong(2, 1);
+  EXPECT_THROW(stan::math::hessian_times_vector(f, x, V_wrong, fx, HV),
+               std::invalid_argument);
+}
+
 TEST(MixFunctor, jacobian) {
   using stan::math::jacobian;
 
@@ -184,6 +233,19 @@ TEST(MixFunctor, hessian) {
   EXPECT_FLOAT_EQ(2 * 5, H2(0, 1));
   EXPECT_FLOAT_EQ(2 * 5, H2(1, 0));
   EXPECT_FLOAT_EQ(2 * 3, H2(1, 1));
+
+  // the columns may be computed in parallel on request
+  double fx3;
+  Matrix<double, Dynamic, 1> grad3;
+  Matrix<double, Dynamic, Dynamic> H3;
+  stan::math::hessian(f, x, fx3, grad3, H3, true);
+  EXPECT_FLOAT_EQ(fx, fx3);
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_FLOAT_EQ(grad(i), grad3(i));
+    for (int j = 0; j < 2; ++j) {
+      EXPECT_FLOAT_EQ(H(i, j), H3(i, j));
+    }
+  }
 }
 
 TEST(MixFunctor, GradientTraceMatrixTimesHessian) {
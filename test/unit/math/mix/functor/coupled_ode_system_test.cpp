@@ -0,0 +1,132 @@
+#include <stan/math/mix.hpp>
+#include <test/unit/util.hpp>
+#include <test/unit/math/prim/functor/harmonic_oscillator.hpp>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace coupled_ode_system_test {
+// chain of states driven by parameters in a std::vector and an Eigen vector
+struct chain_ode {
+  template <typename T0, typename T1, typename T2, typename T3>
+  inline auto operator()(const T0& t,
+                         const Eigen::Matrix<T1, Eigen::Dynamic, 1>& y,
+                         std::ostream* msgs, const std::vector<T2>& a,
+                         const Eigen::Matrix<T3, Eigen::Dynamic, 1>& b,
+                         const std::vector<int>& idx) const {
+    Eigen::Matrix<stan::return_type_t<T1, T2, T3>, Eigen::Dynamic, 1> dy_dt(
+        y.size());
+    dy_dt(0) = -a[0] * y(0);
+    for (int i = 1; i < y.size(); ++i) {
+      dy_dt(i) = a[0] * y(i - 1) - b(idx[i]) * sin(y(i));
+    }
+    return dy_dt;
+  }
+};
+
+// whether the right hand side of the coupled system is calculated with
+// forward mode
+template <typename F, typename T_y0, typename... Args>
+bool is_forward(
+    stan::math::coupled_ode_system_impl<false, F, T_y0, Args...>& system,
+    const std::vector<double>& z) {
+  std::vector<double> dz_dt;
+  return stan::math::coupled_ode_forward_rhs(system, z, dz_dt, 0.0);
+}
+}  // namespace coupled_ode_system_test
+
+TEST(MixFunctor, coupled_ode_system_forward) {
+  using stan::math::var;
+  stan::math::nested_rev_autodiff nested;
+  const int N = 6;
+  const int num_sens = 3;
+  coupled_ode_system_test::chain_ode f;
+  Eigen::VectorXd y0 = Eigen::VectorXd::LinSpaced(N, 0.5, 1.5);
+  std::vector<var> a{0.7};
+  Eigen::Matrix<var, Eigen::Dynamic, 1> b(2);
+  b << 0.3, -1.2;
+  std::vector<int> idx{0, 1, 0, 1, 0, 1};
+
+  stan::math::coupled_ode_system<coupled_ode_system_test::chain_ode, double,
+                                 std::vector<var>,
+                                 Eigen::Matrix<var, Eigen::Dynamic, 1>,
+                                 std::vector<int>>
+      system(f, y0, nullptr, a, b, idx);
+  std::vector<double> z(N + N * num_sens);
+  for (size_t i = 0; i < z.size(); ++i) {
+    z[i] = std::cos(0.4 * i);
+  }
+  std::vector<double> dz_dt;
+  system(z, dz_dt, 0.0);
+  EXPECT_TRUE(coupled_ode_system_test::is_forward(system, z));
+
+  // dS/dt = J_y * S + J_args, with the Jacobian of the right hand side
+  // w.r.t. the states and the parameters
+  auto g = [&](const auto& w) {
+    using T = stan::scalar_type_t<std::decay_t<decltype(w)>>;
+    std::vector<T> a_w{w(N)};
+    Eigen::Matrix<T, Eigen::Dynamic, 1> b_w = w.tail(2);
+    Eigen::Matrix<T, Eigen::Dynamic, 1> y_w = w.head(N);
+    return f(0.0, y_w, nullptr, a_w, b_w, idx);
+  };
+  Eigen::VectorXd w(N + num_sens);
+  for (int n = 0; n < N; ++n) {
+    w(n) = z[n];
+  }
+  w.tail(num_sens) << 0.7, 0.3, -1.2;
+  Eigen::VectorXd f_w;
+  Eigen::MatrixXd J;
+  stan::math::jacobian(g, w, f_w, J);
+  Eigen::Map<const Eigen::MatrixXd> S(z.data() + N, N, num_sens);
+  Eigen::MatrixXd dS_dt = J.leftCols(N) * S + J.rightCols(num_sens);
+
+  ASSERT_EQ(N + N * num_sens, dz_dt.size());
+  EXPECT_MATRIX_FLOAT_EQ(f_w, Eigen::Map<Eigen::VectorXd>(dz_dt.data(), N));
+  EXPECT_MATRIX_FLOAT_EQ(
+      dS_dt, Eigen::Map<Eigen::MatrixXd>(dz_dt.data() + N, N, num_sens));
+}
+
+TEST(MixFunctor, coupled_ode_system_reverse) {
+  // as many sensitivities as states use the reverse mode right hand side
+  using stan::math::var;
+  stan::math::nested_rev_autodiff nested;
+  harm_osc_ode_fun_eigen harm_osc;
+  Eigen::Matrix<var, Eigen::Dynamic, 1> y0(2);
+  y0 << 1.0, 0.5;
+  std::vector<var> theta{0.15};
+  std::vector<double> x;
+  std::vector<int> x_int;
+  stan::math::coupled_ode_system<harm_osc_ode_fun_eigen, var,
+                                 std::vector<var>, std::vector<double>,
+                                 std::vector<int>>
+      system(harm_osc, y0, nullptr, theta, x, x_int);
+  std::vector<double> z{1.0, 0.5, 1.0, 0.0, 0.0, 1.0, 0.0, 0.0};
+  std::vector<double> dz_dt;
+  system(z, dz_dt, 0.0);
+  EXPECT_FALSE(coupled_ode_system_test::is_forward(system, z));
+  std::vector<double> expected{0.5, -1.075, 0, -1, 1, -0.15, 0, -0.5};
+  EXPECT_STD_VECTOR_FLOAT_EQ(expected, dz_dt);
+}
+
+TEST(MixFunctor, coupled_ode_system_forward_harmonic_oscillator) {
+  // one sensitivity for two states uses the forward mode right hand side
+  using stan::math::var;
+  stan::math::nested_rev_autodiff nested;
+  harm_osc_ode_fun_eigen harm_osc;
+  Eigen::VectorXd y0(2);
+  y0 << 1.0, 0.5;
+  std::vector<var> theta{0.15};
+  std::vector<double> x;
+  std::vector<int> x_int;
+  stan::math::coupled_ode_system<harm_osc_ode_fun_eigen, double,
+                                 std::vector<var>, std::vector<double>,
+                                 std::vector<int>>
+      system(harm_osc, y0, nullptr, theta, x, x_int);
+  std::size_t stack_size = stan::math::nested_size();
+  std::vector<double> z{1.0, 0.5, 1.0, 2.0};
+  std::vector<double> dz_dt;
+  system(z, dz_dt, 0.0);
+  EXPECT_EQ(stack_size, stan::math::nested_size());
+  EXPECT_TRUE(coupled_ode_system_test::is_forward(system, z));
+  std::vector<double> expected{0.5, -1.075, 2, -1.8};
+  EXPECT_STD_VECTOR_FLOAT_EQ(expected, dz_dt);
+}
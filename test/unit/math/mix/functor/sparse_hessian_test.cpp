@@ -0,0 +1,106 @@
+#include <stan/math/mix.hpp>
+#include <test/unit/util.hpp>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace sparse_hessian_test {
+// chain of neighbouring interactions with a tridiagonal Hessian
+struct chain {
+  template <typename T>
+  inline T operator()(const Eigen::Matrix<T, Eigen::Dynamic, 1>& x) const {
+    T y = 0;
+    for (int i = 0; i < x.size(); ++i) {
+      y += x(i) * x(i) * x(i);
+      if (i > 0) {
+        y += exp(x(i) - x(i - 1)) + x(i) * x(i - 1);
+      }
+    }
+    return y;
+  }
+};
+}  // namespace sparse_hessian_test
+
+TEST(MixFunctor, sparse_hessian) {
+  sparse_hessian_test::chain f;
+  const int n = 200;
+  Eigen::VectorXd x(n);
+  for (int i = 0; i < n; ++i) {
+    x(i) = std::cos(0.3 * i);
+  }
+  Eigen::SparseMatrix<double> H
+      = stan::math::internal::band_sparsity(n, 1, 1);
+
+  // three passes for a tridiagonal Hessian, independently of its size
+  int num_colors;
+  stan::math::internal::sparsity_row_coloring(H, num_colors);
+  EXPECT_EQ(3, num_colors);
+
+  double fx;
+  Eigen::VectorXd grad;
+  stan::math::sparse_hessian(f, x, fx, grad, H);
+  double fx_dense;
+  Eigen::VectorXd grad_dense;
+  Eigen::MatrixXd H_dense;
+  stan::math::hessian(f, x, fx_dense, grad_dense, H_dense);
+  EXPECT_FLOAT_EQ(fx_dense, fx);
+  EXPECT_MATRIX_FLOAT_EQ(grad_dense, grad);
+  EXPECT_MATRIX_FLOAT_EQ(H_dense, Eigen::MatrixXd(H));
+
+  Eigen::VectorXd x_empty(0);
+  Eigen::SparseMatrix<double> H_empty(0, 0);
+  stan::math::sparse_hessian(f, x_empty, fx, grad, H_empty);
+  EXPECT_FLOAT_EQ(0, fx);
+  EXPECT_EQ(0, grad.size());
+}
+
+TEST(MixFunctor, hessian_sparsity) {
+  sparse_hessian_test::chain f;
+  const int n = 50;
+  Eigen::VectorXd x = Eigen::VectorXd::Zero(n);
+  Eigen::MatrixXd pattern
+      = Eigen::MatrixXd(stan::math::hessian_sparsity(f, x));
+  Eigen::MatrixXd expected
+      = Eigen::MatrixXd(stan::math::internal::band_sparsity(n, 1, 1));
+  EXPECT_MATRIX_EQ(expected, pattern);
+
+  // the second derivatives of x(0) * x(1) * x(2) vanish at zero and
+  // x(3) only enters linearly
+  auto g = [](const auto& y) { return y(0) * y(1) * y(2) + 2.0 * y(3); };
+  Eigen::MatrixXd g_pattern = Eigen::MatrixXd(
+      stan::math::hessian_sparsity(g, Eigen::VectorXd::Zero(4)));
+  Eigen::MatrixXd g_expected(4, 4);
+  g_expected << 0, 1, 1, 0, 1, 0, 1, 0, 1, 1, 0, 0, 0, 0, 0, 0;
+  EXPECT_MATRIX_EQ(g_expected, g_pattern);
+  EXPECT_EQ(0, stan::math::ChainableStack::instance_->var_stack_.size());
+}
+
+TEST(MixFunctor, sparse_hessian_detected_pattern) {
+  sparse_hessian_test::chain f;
+  const int n = 30;
+  Eigen::VectorXd x = Eigen::VectorXd::LinSpaced(n, -1.0, 1.0);
+  double fx;
+  Eigen::VectorXd grad;
+  Eigen::SparseMatrix<double> H;
+  stan::math::sparse_hessian(f, x, fx, grad, H);
+  EXPECT_EQ(3 * n - 2, H.nonZeros());
+  double fx_dense;
+  Eigen::VectorXd grad_dense;
+  Eigen::MatrixXd H_dense;
+  stan::math::hessian(f, x, fx_dense, grad_dense, H_dense);
+  EXPECT_FLOAT_EQ(fx_dense, fx);
+  EXPECT_MATRIX_FLOAT_EQ(grad_dense, grad);
+  EXPECT_MATRIX_FLOAT_EQ(H_dense, Eigen::MatrixXd(H));
+}
+
+TEST(MixFunctor, sparse_hessian_errors) {
+  sparse_hessian_test::chain f;
+  double fx;
+  Eigen::VectorXd grad;
+  Eigen::SparseMatrix<double> H(3, 4);
+  EXPECT_THROW(
+      stan::math::sparse_hessian(f, Eigen::VectorXd::Ones(3), fx, grad, H),
+      std::invalid_argument);
+  EXPECT_THROW(
+      stan::math::sparse_hessian(f, Eigen::VectorXd::Ones(4), fx, grad, H),
+      std::invalid_argument);
+}
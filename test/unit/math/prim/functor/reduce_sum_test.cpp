@@ -232,3 +232,52 @@ TEST(StanMathPrim_reduce_sum, sum) {
       std::vector<std::vector<double>>(2, std::vector<double>(5, 1.0)),
       std::vector<Eigen::VectorXd>(2, Eigen::VectorXd::Ones(5)));
 }
+
+TEST(StanMathPrim_reduce_sum, adaptive_value) {
+  using stan::math::test::count_lpdf;
+  using stan::math::test::get_new_msg;
+  double lambda_d = 10.0;
+  const std::size_t elems = 10000;
+  std::vector<int> data(elems);
+
+  for (std::size_t i = 0; i != elems; ++i)
+    data[i] = i;
+
+  std::vector<int> idata;
+  std::vector<double> vlambda_d(1, lambda_d);
+
+  double poisson_lpdf_ref = stan::math::poisson_lpmf(data, lambda_d);
+  for (int n = 0; n < 10; ++n) {
+    double poisson_lpdf
+        = stan::math::reduce_sum_adaptive<count_lpdf<double>>(
+            data, get_new_msg(), vlambda_d, idata);
+    EXPECT_FLOAT_EQ(poisson_lpdf, poisson_lpdf_ref);
+  }
+
+  std::vector<int> empty;
+  EXPECT_EQ(0.0, stan::math::reduce_sum_adaptive<count_lpdf<double>>(
+                     empty, get_new_msg(), vlambda_d, idata));
+}
+
+TEST(StanMathPrim_reduce_sum, adaptive_grainsize_tuner) {
+  stan::math::internal::reduce_sum_grainsize_tuner tuner;
+  EXPECT_EQ(1, tuner.grainsize(100));
+
+  // cost falls until grainsize 8, so the tuner climbs there and then
+  // keeps probing the neighbours of 8
+  auto cost = [](int grainsize) { return std::abs(std::log2(grainsize) - 3); };
+  std::set<int> late_grainsizes;
+  for (int n = 0; n < 20; ++n) {
+    const int grainsize = tuner.grainsize(100);
+    EXPECT_GE(grainsize, 1);
+    EXPECT_LE(grainsize, 100);
+    if (n >= 10) {
+      late_grainsizes.insert(grainsize);
+    }
+    tuner.update(grainsize, cost(grainsize), 100);
+  }
+  EXPECT_EQ(std::set<int>({4, 8, 16}), late_grainsizes);
+
+  // the largest grainsize is respected
+  EXPECT_EQ(2, tuner.grainsize(2));
+}
@@ -140,3 +140,83 @@ TEST(hmm_marginal, exceptions) {
       "  all arguments must be scalars or multidimensional values of"
       " the same shape.")
 }
+
+TEST_F(hmm_test, batched_sequences) {
+  using stan::math::hmm_marginal;
+  using stan::math::var;
+
+  // sequences of 1 to 11 observations, in more than one lockstep group
+  std::vector<Eigen::MatrixXd> log_omegas;
+  for (int s = 0; s < 600; s++) {
+    int n_obs = 1 + (7 * s) % 11;
+    Eigen::MatrixXd log_omega = log_omegas_.leftCols(n_obs);
+    log_omega.row(0).array() += 0.01 * s;
+    log_omegas.push_back(log_omega);
+  }
+  double lp = 0;
+  for (const auto& log_omega : log_omegas) {
+    lp += hmm_marginal(log_omega, Gamma_, rho_);
+  }
+  EXPECT_FLOAT_EQ(lp, hmm_marginal(log_omegas, Gamma_, rho_));
+  std::vector<Eigen::MatrixXd> no_sequences;
+  EXPECT_FLOAT_EQ(0, hmm_marginal(no_sequences, Gamma_, rho_));
+
+  // the gradient is the one of the sum of the single sequences
+  std::vector<Eigen::Matrix<var, Eigen::Dynamic, Eigen::Dynamic>> log_omegas_v(
+      log_omegas.begin(), log_omegas.end());
+  Eigen::Matrix<var, Eigen::Dynamic, Eigen::Dynamic> Gamma_v = Gamma_;
+  Eigen::Matrix<var, Eigen::Dynamic, 1> rho_v = rho_;
+  std::vector<var> operands(Gamma_v.data(), Gamma_v.data() + Gamma_v.size());
+  operands.insert(operands.end(), rho_v.data(), rho_v.data() + rho_v.size());
+  for (const auto& log_omega : log_omegas_v) {
+    operands.insert(operands.end(), log_omega.data(),
+                    log_omega.data() + log_omega.size());
+  }
+  std::vector<double> grad_batch;
+  hmm_marginal(log_omegas_v, Gamma_v, rho_v).grad(operands, grad_batch);
+  stan::math::set_zero_all_adjoints();
+  var lp_single = 0;
+  for (const auto& log_omega : log_omegas_v) {
+    lp_single += hmm_marginal(log_omega, Gamma_v, rho_v);
+  }
+  std::vector<double> grad_single;
+  lp_single.grad(operands, grad_single);
+  for (size_t n = 0; n < operands.size(); n++) {
+    EXPECT_NEAR(grad_single[n], grad_batch[n],
+                1e-10 * (1 + std::fabs(grad_single[n])))
+        << "operand " << n;
+  }
+  stan::math::recover_memory();
+
+  // Differentiation tests
+  auto hmm_functor = [](const auto& log_omegas, const auto& Gamma_unconstrained,
+                        const auto& rho_unconstrained) {
+    return hmm_marginal_test_wrapper(log_omegas, Gamma_unconstrained,
+                                     rho_unconstrained);
+  };
+  std::vector<Eigen::MatrixXd> log_omegas_ad{
+      log_omegas_.leftCols(3), log_omegas_zero_, log_omegas_.rightCols(5)};
+  stan::test::expect_ad(tols_, hmm_functor, log_omegas_ad,
+                        Gamma_unconstrained_, rho_unconstrained_);
+}
+
+TEST_F(hmm_test, batched_exceptions) {
+  using stan::math::hmm_marginal;
+
+  std::vector<Eigen::MatrixXd> log_omegas{log_omegas_, log_omegas_zero_};
+  log_omegas.push_back(Eigen::MatrixXd(n_states_, 0));
+  EXPECT_THROW_MSG(hmm_marginal(log_omegas, Gamma_, rho_),
+                   std::invalid_argument,
+                   "hmm_marginal: log_omegas[i] has size 0, but must have a "
+                   "non-zero size");
+
+  log_omegas.back() = Eigen::MatrixXd::Zero(n_states_ + 1, 2);
+  EXPECT_THROW_MSG(hmm_marginal(log_omegas, Gamma_, rho_),
+                   std::invalid_argument,
+                   "hmm_marginal: Rows of log_omegas[i] (3) and rows of Gamma "
+                   "(2) must match in size");
+
+  Eigen::MatrixXd Gamma_bad = Gamma_;
+  Gamma_bad(0, 0) += 1;
+  EXPECT_THROW(hmm_marginal(log_omegas, Gamma_bad, rho_), std::domain_error);
+}
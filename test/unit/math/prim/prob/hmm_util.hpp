@@ -14,17 +14,18 @@
  * Gamma without the last element of each column. We recover
  * the last element using the fact each column sums to 1.
  * The purpose of this function is to do finite diff benchmarking,
- * without breaking the simplex constraint.
+ * without breaking the simplex constraint. The log densities are
+ * either a matrix or a std::vector of matrices, one per sequence.
  */
 template <typename T_omega, typename T_Gamma, typename T_rho>
 inline stan::return_type_t<T_omega, T_Gamma, T_rho> hmm_marginal_test_wrapper(
-    const Eigen::Matrix<T_omega, Eigen::Dynamic, Eigen::Dynamic>& log_omegas,
+    const T_omega& log_omegas,
     const Eigen::Matrix<T_Gamma, Eigen::Dynamic, Eigen::Dynamic>&
         Gamma_unconstrained,
     const std::vector<T_rho>& rho_unconstrained) {
   using stan::math::row;
   using stan::math::sum;
-  int n_states = log_omegas.rows();
+  int n_states = Gamma_unconstrained.rows();
 
   Eigen::Matrix<T_Gamma, Eigen::Dynamic, Eigen::Dynamic> Gamma(n_states,
                                                                n_states);
@@ -1,3 +1,9 @@
+// the arena and autodiff stack statistics are only kept if
+// STAN_MATH_ARENA_STATS is defined
+#ifndef STAN_MATH_ARENA_STATS
+#define STAN_MATH_ARENA_STATS
+#endif
+
 #include <stan/math/rev.hpp>
 #include <gtest/gtest.h>
 
@@ -106,6 +112,107 @@ TEST(Profiling, duplicate_active_profile) {
   using stan::math::profile;
   using stan::math::var;
   stan::math::profile_map profiles;
-  profile<var> t1("t1", profiles);
-  EXPECT_THROW(profile<var>("t1", profiles), std::runtime_error);
+  {
+    profile<var> t1("t1", profiles);
+    EXPECT_THROW(profile<var>("t1", profiles), std::runtime_error);
+  }
+  stan::math::recover_memory();
+}
+
+TEST(Profiling, handle) {
+  using stan::math::profile;
+  using stan::math::var;
+  stan::math::profile_map profiles;
+  stan::math::profile_info& handle
+      = stan::math::register_profile("h", profiles);
+  EXPECT_EQ(&handle, &stan::math::register_profile("h", profiles));
+  EXPECT_EQ("h", handle.get_name());
+  var c = 1.0;
+  for (int i = 0; i < 10; i++) {
+    profile<var> p(handle);
+    c = c * 2.0;
+  }
+  {
+    profile<var> p("h", profiles);
+    c = c * 2.0;
+  }
+  c.grad();
+  stan::math::recover_memory();
+  EXPECT_EQ(1, profiles.size());
+  EXPECT_EQ(11, handle.get_num_AD_fwd_passes());
+  EXPECT_EQ(11, handle.get_num_rev_passes());
+  EXPECT_EQ(11, handle.get_fwd_time_histogram().size());
+  EXPECT_EQ(11, handle.get_rev_time_histogram().size());
+  EXPECT_GT(handle.get_arena_bytes(), 0);
+  EXPECT_GT(handle.get_fwd_time_quantile(0.5), 0.0);
+  EXPECT_LE(handle.get_fwd_time_quantile(0.5),
+            handle.get_fwd_time_quantile(1.0));
+  EXPECT_GE(2 * handle.get_fwd_time_quantile(1.0) + 1e-9,
+            handle.get_fwd_time() / 11);
+  EXPECT_TRUE(handle.get_events().empty());
+}
+
+TEST(Profiling, nested) {
+  using stan::math::profile;
+  using stan::math::var;
+  stan::math::profile_map profiles;
+  var c = 1.0;
+  {
+    profile<var> outer("outer", profiles);
+    c = c * 2.0;
+    for (int i = 0; i < 3; i++) {
+      profile<var> inner("inner", profiles);
+      c = c * 2.0;
+    }
+  }
+  {
+    profile<var> other("other", profiles);
+    c = c * 2.0;
+  }
+  c.grad();
+  stan::math::recover_memory();
+  const auto& outer = stan::math::register_profile("outer", profiles);
+  const auto& inner = stan::math::register_profile("inner", profiles);
+  const auto& other = stan::math::register_profile("other", profiles);
+  EXPECT_EQ(nullptr, outer.get_parent());
+  EXPECT_EQ(&outer, inner.get_parent());
+  EXPECT_EQ(nullptr, other.get_parent());
+  EXPECT_EQ("outer/inner", inner.get_path());
+  EXPECT_EQ(3, inner.get_num_rev_passes());
+  EXPECT_GE(outer.get_arena_bytes(), inner.get_arena_bytes());
+  EXPECT_GE(outer.get_fwd_time(), inner.get_fwd_time());
+}
+
+TEST(Profiling, chrome_trace) {
+  using stan::math::profile;
+  using stan::math::var;
+  stan::math::profile_map profiles;
+  stan::math::set_profile_tracing(true);
+  var c = 1.0;
+  {
+    profile<var> outer("outer", profiles);
+    c = c * 2.0;
+    for (int i = 0; i < 2; i++) {
+      profile<double> inner("in\"ner", profiles);
+    }
+  }
+  c.grad();
+  stan::math::recover_memory();
+  stan::math::set_profile_tracing(false);
+  EXPECT_EQ(2, stan::math::register_profile("outer", profiles)
+                   .get_events()
+                   .size());
+  std::stringstream trace;
+  stan::math::write_chrome_trace(trace, profiles);
+  const std::string json = trace.str();
+  EXPECT_EQ(0, json.find("{\"traceEvents\":["));
+  EXPECT_NE(std::string::npos, json.find("\"name\":\"outer\""));
+  EXPECT_NE(std::string::npos, json.find("\"name\":\"in\\\"ner\""));
+  EXPECT_NE(std::string::npos, json.find("\"cat\":\"reverse\""));
+  size_t num_events = 0;
+  for (size_t pos = json.find("\"ph\":\"X\""); pos != std::string::npos;
+       pos = json.find("\"ph\":\"X\"", pos + 1)) {
+    ++num_events;
+  }
+  EXPECT_EQ(4, num_events);
 }
@@ -0,0 +1,157 @@
+// the scalar operators record on the SoA tape only if STAN_MATH_SOA_TAPE
+// is defined
+#ifndef STAN_MATH_SOA_TAPE
+#define STAN_MATH_SOA_TAPE
+#endif
+// the arena bytes are only counted if STAN_MATH_ARENA_STATS is defined
+#ifndef STAN_MATH_ARENA_STATS
+#define STAN_MATH_ARENA_STATS
+#endif
+
+#include <stan/math/rev.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+TEST(AgradRevSoaTape, arithmetic) {
+  using stan::math::var;
+  var a = 2.0;
+  var b = 3.0;
+  var f = (a * b + a / b - 4.0 * a) / (b - 1.0) + 1.0 / b - (2.0 - a) * 3.0;
+  f.grad();
+  const double da = (3.0 + 1.0 / 3.0 - 4.0) / 2.0 + 3.0;
+  const double db = (2.0 - 2.0 / 9.0) / 2.0
+                    - (6.0 + 2.0 / 3.0 - 8.0) / 4.0 - 1.0 / 9.0;
+  EXPECT_FLOAT_EQ(da, a.adj());
+  EXPECT_FLOAT_EQ(db, b.adj());
+  // the 13 operations were recorded in segments of 1, 2, 4 and 8 entries
+  EXPECT_EQ(4, stan::math::ChainableStack::instance_->var_stack_.size());
+  stan::math::recover_memory();
+}
+
+TEST(AgradRevSoaTape, interleaved) {
+  using stan::math::var;
+  var a = 0.5;
+  var f = stan::math::exp(a * a) * a + stan::math::log(a + 1.0) * a;
+  f.grad();
+  const double da = std::exp(0.25) * (2 * 0.25 + 1) + std::log(1.5)
+                    + 0.5 / 1.5;
+  EXPECT_FLOAT_EQ(da, a.adj());
+  stan::math::recover_memory();
+}
+
+TEST(AgradRevSoaTape, interleavedArenaBytes) {
+  using stan::math::var;
+  auto& memalloc = stan::math::ChainableStack::instance_->memalloc_;
+  var a = 0.5;
+  var f = 1.0;
+  const size_t start = memalloc.bytes_requested();
+  const int n = 1000;
+  for (int i = 0; i < n; ++i) {
+    // every SoA operation is followed by a plain vari
+    f = stan::math::sin(f * a);
+  }
+  const size_t bytes_per_iteration = (memalloc.bytes_requested() - start) / n;
+  // a segment of one entry, its result and the vari of sin, instead of a
+  // segment with room for 16 entries (about 750 bytes)
+  EXPECT_LE(bytes_per_iteration,
+            sizeof(stan::math::internal::soa_segment_vari)
+                + 3 * sizeof(double*) + 2 * sizeof(double)
+                + sizeof(stan::math::vari) + 64);
+  EXPECT_EQ(2 * n, stan::math::ChainableStack::instance_->var_stack_.size());
+  f.grad();
+  double f_val = 1.0;
+  double df_da = 0.0;
+  for (int i = 0; i < n; ++i) {
+    df_da = std::cos(f_val * 0.5) * (df_da * 0.5 + f_val);
+    f_val = std::sin(f_val * 0.5);
+  }
+  EXPECT_FLOAT_EQ(f_val, f.val());
+  EXPECT_FLOAT_EQ(df_da, a.adj());
+  stan::math::recover_memory();
+}
+
+TEST(AgradRevSoaTape, segmentGrowth) {
+  using stan::math::var;
+  var a = 1.0;
+  var f = 0.0;
+  for (int i = 0; i < 20000; ++i) {
+    f = f + a * 2.0;
+  }
+  f.grad();
+  EXPECT_FLOAT_EQ(40000.0, a.adj());
+  stan::math::set_zero_all_adjoints();
+  EXPECT_FLOAT_EQ(0.0, a.adj());
+  f.grad();
+  EXPECT_FLOAT_EQ(40000.0, a.adj());
+  stan::math::recover_memory();
+}
+
+TEST(AgradRevSoaTape, nested) {
+  using stan::math::var;
+  var a = 2.0;
+  var b = a * a;
+  {
+    stan::math::nested_rev_autodiff nested;
+    var c = b * 3.0;
+    c.grad();
+    EXPECT_FLOAT_EQ(3.0, b.adj());
+    EXPECT_FLOAT_EQ(0.0, a.adj());
+  }
+  b.adj() = 0;
+  var d = b + a;
+  d.grad();
+  EXPECT_FLOAT_EQ(5.0, a.adj());
+  stan::math::recover_memory();
+}
+
+TEST(AgradRevSoaTape, jacobian) {
+  using stan::math::var;
+  auto f = [](const auto& x) {
+    Eigen::Matrix<stan::scalar_type_t<decltype(x)>, -1, 1> y(2);
+    y(0) = x(0) * x(1) - x(0);
+    y(1) = x(0) / x(1) + 2.0 * x(1);
+    return y;
+  };
+  Eigen::VectorXd x(2);
+  x << 1.5, 2.5;
+  Eigen::VectorXd fx;
+  Eigen::MatrixXd J;
+  stan::math::jacobian(f, x, fx, J);
+  EXPECT_FLOAT_EQ(2.5 - 1.0, J(0, 0));
+  EXPECT_FLOAT_EQ(1.5, J(0, 1));
+  EXPECT_FLOAT_EQ(1 / 2.5, J(1, 0));
+  EXPECT_FLOAT_EQ(-1.5 / (2.5 * 2.5) + 2.0, J(1, 1));
+}
+
+TEST(AgradRevSoaTape, nan) {
+  using stan::math::var;
+  var a = std::numeric_limits<double>::quiet_NaN();
+  var b = 2.0;
+  var f = a * b;
+  f.grad();
+  EXPECT_TRUE(std::isnan(a.adj()));
+  EXPECT_TRUE(std::isnan(b.adj()));
+  stan::math::recover_memory();
+}
+
+TEST(AgradRevSoaTape, jacobianSparsity) {
+  // the operands of the SoA entries are read from the segments
+  auto f = [](const auto& x) {
+    Eigen::Matrix<stan::scalar_type_t<decltype(x)>, -1, 1> y(3);
+    y(0) = x(0) * x(1) - x(0);
+    y(1) = stan::math::exp(x(2)) / 2.0;
+    y(2) = stan::math::sin(x(1)) + x(2) * 0.0;
+    return y;
+  };
+  Eigen::MatrixXd pattern = Eigen::MatrixXd(
+      stan::math::jacobian_sparsity(f, Eigen::VectorXd::Zero(3)));
+  Eigen::MatrixXd expected(3, 3);
+  expected << 1, 1, 0, 0, 0, 1, 0, 1, 1;
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      EXPECT_EQ(expected(i, j), pattern(i, j)) << i << ", " << j;
+    }
+  }
+}
@@ -0,0 +1,73 @@
+// the arena and autodiff stack statistics are only kept if
+// STAN_MATH_ARENA_STATS is defined
+#ifndef STAN_MATH_ARENA_STATS
+#define STAN_MATH_ARENA_STATS
+#endif
+
+#include <stan/math/rev/core.hpp>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace {
+struct stats_alloc : public stan::math::chainable_alloc {
+  std::vector<double> x_{1, 2, 3};
+};
+}  // namespace
+
+TEST(AgradRevStackStats, peaks) {
+  using stan::math::var;
+  stan::math::recover_memory();
+  stan::math::reset_stack_stats();
+
+  var a = 2.0;
+  var b = 3.0;
+  var c = a * b + a;
+  new stats_alloc();
+  stan::math::autodiff_stack_stats stats = stan::math::get_stack_stats();
+  EXPECT_EQ(2, stats.var_stack_size);
+  EXPECT_EQ(2, stats.var_stack_peak);
+  EXPECT_EQ(2, stats.var_nochain_stack_size);
+  EXPECT_EQ(2, stats.var_nochain_stack_peak);
+  EXPECT_EQ(1, stats.chainable_alloc_peak);
+  EXPECT_EQ(1, stats.chainable_allocs);
+  EXPECT_LT(0, stats.memalloc.bytes_requested);
+
+  c.grad();
+  stan::math::recover_memory();
+  var d = 1.0;
+  stats = stan::math::get_stack_stats();
+  EXPECT_EQ(0, stats.var_stack_size);
+  EXPECT_EQ(2, stats.var_stack_peak);
+  EXPECT_EQ(1, stats.var_nochain_stack_size);
+  EXPECT_EQ(2, stats.var_nochain_stack_peak);
+  EXPECT_EQ(1, stats.chainable_allocs);
+  EXPECT_EQ(1, stats.memalloc.recoveries);
+
+  stan::math::reset_stack_stats();
+  stats = stan::math::get_stack_stats();
+  EXPECT_EQ(0, stats.var_stack_peak);
+  EXPECT_EQ(1, stats.var_nochain_stack_peak);
+  EXPECT_EQ(0, stats.chainable_allocs);
+  EXPECT_EQ(0, stats.memalloc.recoveries);
+  stan::math::recover_memory();
+}
+
+TEST(AgradRevStackStats, nested) {
+  using stan::math::var;
+  stan::math::recover_memory();
+  stan::math::reset_stack_stats();
+
+  var a = 2.0;
+  {
+    stan::math::nested_rev_autodiff nested;
+    var b = a * a;
+    var c = b * b;
+    new stats_alloc();
+  }
+  stan::math::autodiff_stack_stats stats = stan::math::get_stack_stats();
+  EXPECT_EQ(0, stats.var_stack_size);
+  EXPECT_EQ(2, stats.var_stack_peak);
+  EXPECT_EQ(1, stats.chainable_allocs);
+  EXPECT_EQ(1, stats.memalloc.nested_starts);
+  stan::math::recover_memory();
+}
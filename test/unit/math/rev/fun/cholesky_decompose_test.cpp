@@ -1,6 +1,7 @@
 #include <stan/math/rev.hpp>
 #include <gtest/gtest.h>
 #include <test/unit/math/rev/util.hpp>
+#include <test/unit/util.hpp>
 #include <boost/random/mersenne_twister.hpp>
 #include <vector>
 
@@ -472,3 +473,39 @@ TEST(AgradRevMatrix, cholesky_replicated_input) {
   fd_ref = (f(size, ydbl + dx) - f(size, ydbl - dx)) / (2.0 * dx);
   EXPECT_FLOAT_EQ(y.adj(), fd_ref);
 }
+
+TEST(AgradRevMatrix, cholesky_blocked_matches_unblocked_adjoint) {
+  using stan::math::var;
+  using stan::math::var_value;
+  const int N = 600;
+  // the panels of the blocked algorithm span several tiles
+  EXPECT_LT(2 * stan::math::internal::cholesky_tile_size, N - N / 8);
+  Eigen::MatrixXd X = Eigen::MatrixXd::Random(N, N);
+  Eigen::MatrixXd A_val
+      = X * X.transpose() + N * Eigen::MatrixXd::Identity(N, N);
+  Eigen::MatrixXd L_adj = Eigen::MatrixXd::Random(N, N);
+  L_adj.triangularView<Eigen::StrictlyUpper>().setZero();
+
+  // adjoint of A from the elementwise algorithm
+  stan::arena_t<Eigen::MatrixXd> L_A = A_val.llt().matrixL();
+  stan::arena_t<Eigen::Matrix<var, -1, -1>> L_ref = L_A;
+  stan::arena_t<Eigen::Matrix<var, -1, -1>> A_ref = A_val;
+  L_ref.adj() = L_adj;
+  stan::math::internal::unblocked_cholesky_lambda(L_A, L_ref, A_ref)();
+  Eigen::MatrixXd A_adj = A_ref.adj().triangularView<Eigen::Lower>();
+
+  Eigen::Matrix<var, -1, -1> A = A_val;
+  Eigen::Matrix<var, -1, -1> L = stan::math::cholesky_decompose(A);
+  L.adj() = L_adj;
+  stan::math::grad();
+  EXPECT_MATRIX_NEAR(A_adj, A.adj(), 1e-10);
+  stan::math::recover_memory();
+
+  var_value<Eigen::MatrixXd> A_vm = A_val;
+  var_value<Eigen::MatrixXd> L_vm = stan::math::cholesky_decompose(A_vm);
+  L_vm.adj() = L_adj;
+  stan::math::grad();
+  Eigen::MatrixXd A_vm_adj = A_vm.adj().triangularView<Eigen::Lower>();
+  EXPECT_MATRIX_NEAR(A_adj, A_vm_adj, 1e-10);
+  stan::math::recover_memory();
+}
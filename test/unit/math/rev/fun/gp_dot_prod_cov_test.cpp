@@ -0,0 +1,80 @@
+#include <stan/math/rev.hpp>
+#include <test/unit/math/rev/util.hpp>
+#include <test/unit/util.hpp>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace gp_dot_prod_cov_test {
+// the values match the kernel on doubles, the matrix adds a single callback
+// to the stack and the gradient of sigma is the sum of the adjoints times
+// two sigma
+template <typename T_x>
+void expect_dot_prod_cov(const std::vector<T_x>& x) {
+  using stan::math::var;
+  const double sigma = 0.8;
+  Eigen::MatrixXd cov = stan::math::gp_dot_prod_cov(x, sigma);
+
+  var sigma_v = sigma;
+  size_t stack_size = stan::math::ChainableStack::instance_->var_stack_.size();
+  Eigen::Matrix<var, Eigen::Dynamic, Eigen::Dynamic> cov_v
+      = stan::math::gp_dot_prod_cov(x, sigma_v);
+  EXPECT_EQ(stack_size + 1,
+            stan::math::ChainableStack::instance_->var_stack_.size());
+  ASSERT_EQ(cov.rows(), cov_v.rows());
+  ASSERT_EQ(cov.cols(), cov_v.cols());
+  var sum = 0;
+  double d_sigma = 0;
+  for (int j = 0; j < cov.cols(); ++j) {
+    for (int i = 0; i < cov.rows(); ++i) {
+      EXPECT_FLOAT_EQ(cov(i, j), cov_v(i, j).val());
+      double w = std::cos(1.0 + i + 2.0 * j);
+      sum += w * cov_v(i, j);
+      d_sigma += w * 2 * sigma;
+    }
+  }
+  sum.grad();
+  EXPECT_FLOAT_EQ(d_sigma, sigma_v.adj());
+  stan::math::set_zero_all_adjoints();
+
+  size_t nochain_size
+      = stan::math::ChainableStack::instance_->var_nochain_stack_.size();
+  stan::math::var_value<Eigen::MatrixXd> cov_vm
+      = stan::math::gp_dot_prod_cov<stan::math::var_value<Eigen::MatrixXd>>(
+          x, sigma_v);
+  EXPECT_EQ(nochain_size + 1,
+            stan::math::ChainableStack::instance_->var_nochain_stack_.size());
+  EXPECT_MATRIX_NEAR(cov, cov_vm.val(), 1e-12);
+  for (int j = 0; j < cov.cols(); ++j) {
+    for (int i = 0; i < cov.rows(); ++i) {
+      cov_vm.adj()(i, j) = std::cos(1.0 + i + 2.0 * j);
+    }
+  }
+  stan::math::grad();
+  EXPECT_FLOAT_EQ(d_sigma, sigma_v.adj());
+  stan::math::recover_memory();
+}
+}  // namespace gp_dot_prod_cov_test
+
+TEST(RevMath, gp_dot_prod_cov_callback) {
+  std::vector<double> x{-2.0, -1.0, -0.5, 0.3, 1.7};
+  gp_dot_prod_cov_test::expect_dot_prod_cov(x);
+
+  std::vector<Eigen::VectorXd> x_vec(4, Eigen::VectorXd(3));
+  for (size_t i = 0; i < x_vec.size(); ++i) {
+    x_vec[i] << std::sin(i), std::cos(2.0 * i), 0.1 * i;
+  }
+  gp_dot_prod_cov_test::expect_dot_prod_cov(x_vec);
+
+  std::vector<double> x_empty;
+  EXPECT_EQ(0, stan::math::gp_dot_prod_cov(x_empty, stan::math::var(1)).size());
+  EXPECT_EQ(0, stan::math::gp_dot_prod_cov<
+                   stan::math::var_value<Eigen::MatrixXd>>(
+                   x_empty, stan::math::var(1))
+                   .size());
+  EXPECT_THROW(stan::math::gp_dot_prod_cov(x, stan::math::var(-1)),
+               std::domain_error);
+  x_vec[2] = Eigen::VectorXd::Ones(2);
+  EXPECT_THROW(stan::math::gp_dot_prod_cov(x_vec, stan::math::var(1)),
+               std::invalid_argument);
+  stan::math::recover_memory();
+}
@@ -0,0 +1,190 @@
+#include <stan/math/rev.hpp>
+#include <test/unit/math/rev/util.hpp>
+#include <test/unit/util.hpp>
+#include <gtest/gtest.h>
+#include <limits>
+#include <vector>
+
+namespace gp_isotropic_cov_test {
+// weighted sum of the elements of a covariance matrix
+template <typename T>
+T weighted_sum(const Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>& cov) {
+  T sum = 0;
+  for (int j = 0; j < cov.cols(); ++j) {
+    for (int i = 0; i < cov.rows(); ++i) {
+      sum += std::cos(1.0 + i + 2.0 * j) * cov(i, j);
+    }
+  }
+  return sum;
+}
+
+// weights of weighted_sum
+inline Eigen::MatrixXd weights(int n) {
+  Eigen::MatrixXd w(n, n);
+  for (int j = 0; j < n; ++j) {
+    for (int i = 0; i < n; ++i) {
+      w(i, j) = std::cos(1.0 + i + 2.0 * j);
+    }
+  }
+  return w;
+}
+
+// the values match the kernel on doubles, the matrix adds a single callback
+// to the stack and the gradients match finite differences, for every
+// combination of var and double parameters. The var_value form g allocates
+// no vari per element and gives the same gradients.
+template <typename F, typename G, typename T_x>
+void expect_kernel(const F& f, const G& g, const std::vector<T_x>& x) {
+  using stan::math::var;
+  const double sigma = 1.3;
+  const double l = 0.7;
+  const double h = 1e-6;
+  Eigen::MatrixXd cov = f(x, sigma, l);
+  double d_sigma = (weighted_sum(f(x, sigma + h, l))
+                    - weighted_sum(f(x, sigma - h, l)))
+                   / (2 * h);
+  double d_l
+      = (weighted_sum(f(x, sigma, l + h)) - weighted_sum(f(x, sigma, l - h)))
+        / (2 * h);
+
+  var sigma_v = sigma;
+  var l_v = l;
+  size_t stack_size = stan::math::ChainableStack::instance_->var_stack_.size();
+  Eigen::Matrix<var, Eigen::Dynamic, Eigen::Dynamic> cov_v = f(x, sigma_v, l_v);
+  EXPECT_EQ(stack_size + 1,
+            stan::math::ChainableStack::instance_->var_stack_.size());
+  for (int i = 0; i < cov.size(); ++i) {
+    EXPECT_NEAR(cov(i), cov_v(i).val(), 1e-12);
+  }
+  weighted_sum(cov_v).grad();
+  EXPECT_NEAR(d_sigma, sigma_v.adj(), 1e-6);
+  EXPECT_NEAR(d_l, l_v.adj(), 1e-6);
+  stan::math::set_zero_all_adjoints();
+
+  weighted_sum(f(x, sigma, l_v)).grad();
+  EXPECT_NEAR(d_l, l_v.adj(), 1e-6);
+  stan::math::set_zero_all_adjoints();
+  weighted_sum(f(x, sigma_v, l)).grad();
+  EXPECT_NEAR(d_sigma, sigma_v.adj(), 1e-6);
+  stan::math::set_zero_all_adjoints();
+
+  size_t nochain_size
+      = stan::math::ChainableStack::instance_->var_nochain_stack_.size();
+  stan::math::var_value<Eigen::MatrixXd> cov_vm = g(x, sigma_v, l_v);
+  EXPECT_EQ(nochain_size + 1,
+            stan::math::ChainableStack::instance_->var_nochain_stack_.size());
+  ASSERT_EQ(cov.rows(), cov_vm.rows());
+  ASSERT_EQ(cov.cols(), cov_vm.cols());
+  EXPECT_MATRIX_NEAR(cov, cov_vm.val(), 1e-12);
+  cov_vm.adj() = weights(cov.rows());
+  stan::math::grad();
+  EXPECT_NEAR(d_sigma, sigma_v.adj(), 1e-6);
+  EXPECT_NEAR(d_l, l_v.adj(), 1e-6);
+  stan::math::set_zero_all_adjoints();
+
+  cov_vm = g(x, sigma, l_v);
+  cov_vm.adj() = weights(cov.rows());
+  stan::math::grad();
+  EXPECT_NEAR(d_l, l_v.adj(), 1e-6);
+  stan::math::recover_memory();
+}
+
+template <typename F, typename G>
+void expect_kernel(const F& f, const G& g) {
+  std::vector<double> x{-2.0, -1.0, -0.5, 0.3, 1.7, 1.8};
+  expect_kernel(f, g, x);
+
+  std::vector<Eigen::VectorXd> x_vec(5, Eigen::VectorXd(3));
+  for (size_t i = 0; i < x_vec.size(); ++i) {
+    x_vec[i] << std::sin(i), std::cos(2.0 * i), 0.1 * i;
+  }
+  expect_kernel(f, g, x_vec);
+
+  std::vector<double> x_empty;
+  EXPECT_EQ(0, f(x_empty, stan::math::var(1), stan::math::var(1)).size());
+  EXPECT_EQ(0, g(x_empty, stan::math::var(1), stan::math::var(1)).size());
+  std::vector<double> x_one{1.0};
+  EXPECT_FLOAT_EQ(
+      4.0, f(x_one, stan::math::var(2), stan::math::var(1))(0, 0).val());
+
+  EXPECT_THROW(f(x, stan::math::var(-1), stan::math::var(1)),
+               std::domain_error);
+  EXPECT_THROW(f(x, stan::math::var(1), stan::math::var(0)),
+               std::domain_error);
+  EXPECT_THROW(g(x, stan::math::var(1), 0.0), std::domain_error);
+  x[2] = std::numeric_limits<double>::quiet_NaN();
+  EXPECT_THROW(f(x, stan::math::var(1), stan::math::var(1)),
+               std::domain_error);
+  x_vec[2] = Eigen::VectorXd::Ones(2);
+  EXPECT_THROW(f(x_vec, stan::math::var(1), stan::math::var(1)),
+               std::invalid_argument);
+  stan::math::recover_memory();
+}
+}  // namespace gp_isotropic_cov_test
+
+TEST(RevMath, gp_matern32_cov_callback) {
+  using var_matrix = stan::math::var_value<Eigen::MatrixXd>;
+  gp_isotropic_cov_test::expect_kernel(
+      [](const auto& x, const auto& sigma, const auto& l) {
+        return stan::math::gp_matern32_cov(x, sigma, l);
+      },
+      [](const auto& x, const auto& sigma, const auto& l) {
+        return stan::math::gp_matern32_cov<var_matrix>(x, sigma, l);
+      });
+}
+
+TEST(RevMath, gp_matern52_cov_callback) {
+  using var_matrix = stan::math::var_value<Eigen::MatrixXd>;
+  gp_isotropic_cov_test::expect_kernel(
+      [](const auto& x, const auto& sigma, const auto& l) {
+        return stan::math::gp_matern52_cov(x, sigma, l);
+      },
+      [](const auto& x, const auto& sigma, const auto& l) {
+        return stan::math::gp_matern52_cov<var_matrix>(x, sigma, l);
+      });
+}
+
+TEST(RevMath, gp_exponential_cov_callback) {
+  using var_matrix = stan::math::var_value<Eigen::MatrixXd>;
+  gp_isotropic_cov_test::expect_kernel(
+      [](const auto& x, const auto& sigma, const auto& l) {
+        return stan::math::gp_exponential_cov(x, sigma, l);
+      },
+      [](const auto& x, const auto& sigma, const auto& l) {
+        return stan::math::gp_exponential_cov<var_matrix>(x, sigma, l);
+      });
+}
+
+TEST(RevMath, gp_exp_quad_cov_callback) {
+  using var_matrix = stan::math::var_value<Eigen::MatrixXd>;
+  gp_isotropic_cov_test::expect_kernel(
+      [](const auto& x, const auto& sigma, const auto& l) {
+        return stan::math::gp_exp_quad_cov(x, sigma, l);
+      },
+      [](const auto& x, const auto& sigma, const auto& l) {
+        return stan::math::gp_exp_quad_cov<var_matrix>(x, sigma, l);
+      });
+}
+
+TEST(RevMath, gp_isotropic_cov_infinite_parameters) {
+  using stan::math::var;
+  using var_matrix = stan::math::var_value<Eigen::MatrixXd>;
+  const double inf = std::numeric_limits<double>::infinity();
+  std::vector<double> x{-2.0, -1.0, 0.3};
+
+  Eigen::MatrixXd cov_prim = stan::math::gp_exp_quad_cov(x, 1.0, inf);
+  EXPECT_MATRIX_FLOAT_EQ(
+      cov_prim, stan::math::gp_exp_quad_cov(x, var(1), var(inf)).val());
+  EXPECT_MATRIX_FLOAT_EQ(
+      cov_prim,
+      stan::math::gp_exp_quad_cov<var_matrix>(x, var(1), var(inf)).val());
+
+  EXPECT_THROW(stan::math::gp_matern32_cov(x, 1.0, inf), std::domain_error);
+  EXPECT_THROW(stan::math::gp_matern32_cov(x, var(1), var(inf)),
+               std::domain_error);
+  EXPECT_THROW(stan::math::gp_exponential_cov(x, var(inf), var(1)),
+               std::domain_error);
+  EXPECT_THROW(stan::math::gp_matern52_cov<var_matrix>(x, var(1), var(inf)),
+               std::domain_error);
+  stan::math::recover_memory();
+}
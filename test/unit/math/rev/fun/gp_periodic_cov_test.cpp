@@ -2712,3 +2712,83 @@ TEST(AgradRevMatrix, gp_periodic_cov_check_varis_on_stack) {
   test::check_varis_on_stack(
       stan::math::gp_periodic_cov(x, sigma, l, to_var(p)));
 }
+
+TEST(RevMath, gp_periodic_cov_callback) {
+  using stan::math::var;
+  using var_matrix = stan::math::var_value<Eigen::MatrixXd>;
+  std::vector<Eigen::VectorXd> x(5, Eigen::VectorXd(2));
+  for (size_t i = 0; i < x.size(); ++i) {
+    x[i] << std::sin(i), 0.3 * i;
+  }
+  const double sigma = 1.3;
+  const double l = 0.7;
+  const double p = 1.9;
+  const double h = 1e-6;
+  Eigen::MatrixXd w(x.size(), x.size());
+  for (int j = 0; j < w.cols(); ++j) {
+    for (int i = 0; i < w.rows(); ++i) {
+      w(i, j) = std::cos(1.0 + i + 2.0 * j);
+    }
+  }
+  auto weighted_sum = [&](double sigma, double l, double p) {
+    return w.cwiseProduct(stan::math::gp_periodic_cov(x, sigma, l, p)).sum();
+  };
+  Eigen::MatrixXd cov = stan::math::gp_periodic_cov(x, sigma, l, p);
+  double d_sigma
+      = (weighted_sum(sigma + h, l, p) - weighted_sum(sigma - h, l, p)) / 2 / h;
+  double d_l
+      = (weighted_sum(sigma, l + h, p) - weighted_sum(sigma, l - h, p)) / 2 / h;
+  double d_p
+      = (weighted_sum(sigma, l, p + h) - weighted_sum(sigma, l, p - h)) / 2 / h;
+
+  var sigma_v = sigma;
+  var l_v = l;
+  var p_v = p;
+  size_t stack_size = stan::math::ChainableStack::instance_->var_stack_.size();
+  Eigen::Matrix<var, Eigen::Dynamic, Eigen::Dynamic> cov_v
+      = stan::math::gp_periodic_cov(x, sigma_v, l_v, p_v);
+  EXPECT_EQ(stack_size + 1,
+            stan::math::ChainableStack::instance_->var_stack_.size());
+  var sum = 0;
+  for (int j = 0; j < cov.cols(); ++j) {
+    for (int i = 0; i < cov.rows(); ++i) {
+      EXPECT_NEAR(cov(i, j), cov_v(i, j).val(), 1e-12);
+      sum += w(i, j) * cov_v(i, j);
+    }
+  }
+  sum.grad();
+  EXPECT_NEAR(d_sigma, sigma_v.adj(), 1e-6);
+  EXPECT_NEAR(d_l, l_v.adj(), 1e-6);
+  EXPECT_NEAR(d_p, p_v.adj(), 1e-6);
+  stan::math::set_zero_all_adjoints();
+
+  size_t nochain_size
+      = stan::math::ChainableStack::instance_->var_nochain_stack_.size();
+  var_matrix cov_vm
+      = stan::math::gp_periodic_cov<var_matrix>(x, sigma_v, l_v, p_v);
+  EXPECT_EQ(nochain_size + 1,
+            stan::math::ChainableStack::instance_->var_nochain_stack_.size());
+  EXPECT_MATRIX_NEAR(cov, cov_vm.val(), 1e-12);
+  cov_vm.adj() = w;
+  stan::math::grad();
+  EXPECT_NEAR(d_sigma, sigma_v.adj(), 1e-6);
+  EXPECT_NEAR(d_l, l_v.adj(), 1e-6);
+  EXPECT_NEAR(d_p, p_v.adj(), 1e-6);
+  stan::math::set_zero_all_adjoints();
+
+  cov_vm = stan::math::gp_periodic_cov<var_matrix>(x, sigma, l, p_v);
+  cov_vm.adj() = w;
+  stan::math::grad();
+  EXPECT_NEAR(d_p, p_v.adj(), 1e-6);
+
+  std::vector<double> x_empty;
+  EXPECT_EQ(0, stan::math::gp_periodic_cov<var_matrix>(x_empty, sigma_v, l_v,
+                                                        p_v)
+                   .size());
+  EXPECT_THROW(stan::math::gp_periodic_cov<var_matrix>(x, sigma_v, l_v, -1.0),
+               std::domain_error);
+  x[2] = Eigen::VectorXd::Ones(3);
+  EXPECT_THROW(stan::math::gp_periodic_cov<var_matrix>(x, sigma_v, l_v, p_v),
+               std::invalid_argument);
+  stan::math::recover_memory();
+}
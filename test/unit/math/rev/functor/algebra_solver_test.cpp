@@ -589,3 +589,89 @@ TEST_F(degenerate_eq_test, newton_guess_saddle_point_dbl) {
                                          y_scale, dat, dat_int),
                    std::runtime_error, msg);
 }
+
+// x_i = y_i + 0.5 * tanh(x_{i - 1}), whose solution can be computed
+// recursively, so the gradients of the solvers can be compared with
+// autodiff through the recursion.
+struct recursive_eq_functor {
+  template <typename T0, typename T1>
+  inline Eigen::Matrix<stan::return_type_t<T0, T1>, Eigen::Dynamic, 1>
+  operator()(const Eigen::Matrix<T0, Eigen::Dynamic, 1>& x,
+             const Eigen::Matrix<T1, Eigen::Dynamic, 1>& y,
+             const std::vector<double>& dat, const std::vector<int>& dat_int,
+             std::ostream* pstream__) const {
+    Eigen::Matrix<stan::return_type_t<T0, T1>, Eigen::Dynamic, 1> z(x.size());
+    z(0) = x(0) - y(0);
+    for (int i = 1; i < x.size(); ++i) {
+      z(i) = x(i) - y(i) - 0.5 * stan::math::tanh(x(i - 1));
+    }
+    return z;
+  }
+};
+
+TEST(MathMatrixRevMat, algebra_solver_adjoint_many_params) {
+  using stan::math::var;
+  const int N = 20;
+  std::vector<double> dat;
+  std::vector<int> dat_int;
+
+  for (int solver = 0; solver < 2; ++solver) {
+    Eigen::Matrix<var, Eigen::Dynamic, 1> y(N);
+    for (int i = 0; i < N; ++i) {
+      y(i) = 0.1 * i - 0.7;
+    }
+    Eigen::Matrix<var, Eigen::Dynamic, 1> x_ref(N);
+    x_ref(0) = y(0);
+    for (int i = 1; i < N; ++i) {
+      x_ref(i) = y(i) + 0.5 * stan::math::tanh(x_ref(i - 1));
+    }
+
+    Eigen::VectorXd x_guess = Eigen::VectorXd::Ones(N);
+    Eigen::Matrix<var, Eigen::Dynamic, 1> x
+        = solver == 0 ? stan::math::algebra_solver_newton(
+              recursive_eq_functor(), x_guess, y, dat, dat_int, 0, 1e-3,
+              1e-12)
+                      : stan::math::algebra_solver_powell(
+                          recursive_eq_functor(), x_guess, y, dat, dat_int, 0,
+                          1e-12, 1e-12);
+
+    for (int k = 0; k < N; k += 3) {
+      EXPECT_NEAR(x(k).val(), x_ref(k).val(), 1e-6);
+      stan::math::set_zero_all_adjoints();
+      x_ref(k).grad();
+      Eigen::VectorXd grad_ref = y.adj();
+      stan::math::set_zero_all_adjoints();
+      x(k).grad();
+      EXPECT_MATRIX_NEAR(y.adj(), grad_ref, 1e-6);
+    }
+    stan::math::recover_memory();
+  }
+}
+
+TEST(MathMatrixRevMat, kinsol_solve_jacobian_at_solution) {
+  const int N = 8;
+  Eigen::VectorXd y = Eigen::VectorXd::LinSpaced(N, -0.5, 0.5);
+  std::vector<double> dat;
+  std::vector<int> dat_int;
+  Eigen::MatrixXd J_solution;
+  Eigen::VectorXd x = stan::math::kinsol_solve(
+      recursive_eq_functor(), Eigen::VectorXd::Ones(N), y, dat, dat_int, 0,
+      1e-3, 1e-12, 200, 1, stan::math::kinsol_J_f(), 10, KIN_LINESEARCH,
+      &J_solution);
+
+  stan::math::system_functor<recursive_eq_functor, double, double, true> fx(
+      recursive_eq_functor(), x, y, dat, dat_int, 0);
+  Eigen::VectorXd f;
+  Eigen::MatrixXd J;
+  stan::math::jacobian(fx, x, f, J);
+  EXPECT_MATRIX_NEAR(J, J_solution, 1e-10);
+
+  // with the difference quotient for the Newton steps, the jacobian at
+  // the solution is still calculated with autodiff
+  x = stan::math::kinsol_solve(recursive_eq_functor(),
+                               Eigen::VectorXd::Ones(N), y, dat, dat_int, 0,
+                               1e-3, 1e-12, 200, 0, stan::math::kinsol_J_f(),
+                               10, KIN_LINESEARCH, &J_solution);
+  stan::math::jacobian(fx, x, f, J);
+  EXPECT_MATRIX_NEAR(J, J_solution, 1e-10);
+}
@@ -0,0 +1,117 @@
+#include <stan/math/rev.hpp>
+#include <gtest/gtest.h>
+#include <test/unit/math/prim/functor/ode_test_functors.hpp>
+#include <test/unit/util.hpp>
+#include <memory>
+#include <vector>
+
+TEST(StanMath, sundials_workspace_cache) {
+  using cache_t = stan::math::internal::sundials_workspace_cache<int, int>;
+  cache_t cache;
+  EXPECT_EQ(cache.acquire(1), nullptr);
+
+  cache.release(1, std::make_unique<int>(10));
+  cache.release(2, std::make_unique<int>(20));
+  cache.release(1, std::make_unique<int>(11));
+  EXPECT_EQ(cache.size(), 3);
+
+  // the most recently released workspace with the key comes first
+  std::unique_ptr<int> workspace = cache.acquire(1);
+  ASSERT_NE(workspace, nullptr);
+  EXPECT_EQ(*workspace, 11);
+  EXPECT_EQ(cache.size(), 2);
+
+  // the least recently released workspaces are freed first
+  for (int i = 0; i < 10; ++i) {
+    cache.release(3, std::make_unique<int>(30 + i));
+  }
+  EXPECT_EQ(cache.size(), cache_t::max_size);
+  EXPECT_EQ(cache.acquire(1), nullptr);
+  EXPECT_EQ(cache.acquire(2), nullptr);
+  EXPECT_EQ(*cache.acquire(3), 39);
+
+  // every solver type and thread has its own cache
+  EXPECT_NE(&cache_t::instance<int>(), &cache_t::instance<double>());
+  EXPECT_EQ(&cache_t::instance<int>(), &cache_t::instance<int>());
+}
+
+namespace cvodes_workspace_test {
+struct decay {
+  template <typename T0, typename T1>
+  inline Eigen::Matrix<T1, Eigen::Dynamic, 1> operator()(
+      const T0& t, const Eigen::Matrix<T1, Eigen::Dynamic, 1>& y,
+      std::ostream* msgs) const {
+    return -y;
+  }
+};
+}  // namespace cvodes_workspace_test
+
+TEST(StanMath, cvodes_workspace_reuse) {
+  using stan::math::var;
+
+  Eigen::VectorXd y0 = Eigen::VectorXd::Zero(1);
+  std::vector<double> ts = {0.45, 1.1};
+  Eigen::VectorXd y0_2 = Eigen::VectorXd::Ones(2);
+
+  std::vector<Eigen::VectorXd> first
+      = stan::math::ode_bdf(stan::test::CosArg1(), y0, 0.0, ts, nullptr, 1.5);
+
+  for (int i = 0; i < 3; ++i) {
+    // solves of other sizes and with sensitivities in between
+    EXPECT_NEAR(stan::math::ode_bdf(cvodes_workspace_test::decay(), y0_2, 0.0,
+                                    ts, nullptr)[1](1),
+                std::exp(-1.1), 1e-7);
+    var a = 1.5;
+    std::vector<Eigen::Matrix<var, Eigen::Dynamic, 1>> sens
+        = stan::math::ode_bdf(stan::test::CosArg1(), y0, 0.0, ts, nullptr, a);
+    sens[1](0).grad();
+    EXPECT_NEAR(sens[1](0).val(), 0.66457668563, 1e-5);
+    EXPECT_NEAR(a.adj(), -0.50107310888, 1e-5);
+    stan::math::recover_memory();
+
+    // a failed solve does not spoil the next solves
+    EXPECT_THROW(
+        stan::math::ode_bdf_tol(stan::test::CosArg1(), y0, 0.0,
+                                std::vector<double>{100.0}, 1e-10, 1e-10, 10,
+                                nullptr, 1.5),
+        std::domain_error);
+
+    std::vector<Eigen::VectorXd> again
+        = stan::math::ode_bdf(stan::test::CosArg1(), y0, 0.0, ts, nullptr, 1.5);
+    ASSERT_EQ(again.size(), first.size());
+    for (size_t n = 0; n < first.size(); ++n) {
+      EXPECT_MATRIX_EQ(first[n], again[n]);
+    }
+  }
+}
+
+namespace cvodes_workspace_test {
+struct quadratic {
+  template <typename T0, typename T1>
+  inline Eigen::Matrix<stan::return_type_t<T0, T1>, Eigen::Dynamic, 1>
+  operator()(const Eigen::Matrix<T0, Eigen::Dynamic, 1>& x,
+             const Eigen::Matrix<T1, Eigen::Dynamic, 1>& y,
+             const std::vector<double>& dat, const std::vector<int>& dat_int,
+             std::ostream* pstream__) const {
+    Eigen::Matrix<stan::return_type_t<T0, T1>, Eigen::Dynamic, 1> z(x.size());
+    for (int i = 0; i < x.size(); ++i) {
+      z(i) = x(i) * x(i) - y(i);
+    }
+    return z;
+  }
+};
+}  // namespace cvodes_workspace_test
+
+TEST(StanMath, kinsol_workspace_reuse) {
+  std::vector<double> dat;
+  std::vector<int> dat_int;
+  for (int i = 0; i < 3; ++i) {
+    for (int n = 1; n <= 3; ++n) {
+      Eigen::VectorXd x = Eigen::VectorXd::Ones(n);
+      Eigen::VectorXd y = Eigen::VectorXd::LinSpaced(n, 2.0, 4.0 + i);
+      Eigen::VectorXd theta = stan::math::algebra_solver_newton(
+          cvodes_workspace_test::quadratic(), x, y, dat, dat_int);
+      EXPECT_MATRIX_NEAR(theta, y.array().sqrt().matrix(), 1e-6);
+    }
+  }
+}
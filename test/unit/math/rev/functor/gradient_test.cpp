@@ -223,3 +223,35 @@ TEST(RevFunctor, RecoverMemory) {
   EXPECT_LT(stan::math::ChainableStack::instance_->memalloc_.bytes_allocated(),
             100000);
 }
+
+TEST(RevFunctor, gradient_batch) {
+  fun1 f;
+  MatrixXd x(2, 50);
+  for (int j = 0; j < x.cols(); ++j) {
+    x(0, j) = 0.1 * j;
+    x(1, j) = 2.0 - 0.05 * j;
+  }
+  for (int grainsize : {1, 7, 100}) {
+    VectorXd fx;
+    MatrixXd grad_fx;
+    stan::math::gradient_batch(f, x, fx, grad_fx, grainsize);
+    ASSERT_EQ(x.cols(), fx.size());
+    ASSERT_EQ(x.rows(), grad_fx.rows());
+    ASSERT_EQ(x.cols(), grad_fx.cols());
+    for (int j = 0; j < x.cols(); ++j) {
+      EXPECT_FLOAT_EQ(x(0, j) * x(0, j) * x(1, j) + 3 * x(1, j) * x(1, j),
+                      fx(j));
+      EXPECT_FLOAT_EQ(2 * x(0, j) * x(1, j), grad_fx(0, j));
+      EXPECT_FLOAT_EQ(x(0, j) * x(0, j) + 3 * 2 * x(1, j), grad_fx(1, j));
+    }
+  }
+  EXPECT_EQ(0, stan::math::ChainableStack::instance_->var_stack_.size());
+
+  VectorXd fx;
+  MatrixXd grad_fx;
+  EXPECT_THROW(stan::math::gradient_batch(f, x, fx, grad_fx, 0),
+               std::domain_error);
+  EXPECT_THROW(stan::math::gradient_batch(sum_and_throw, x, fx, grad_fx),
+               std::domain_error);
+  EXPECT_EQ(0, stan::math::ChainableStack::instance_->var_stack_.size());
+}
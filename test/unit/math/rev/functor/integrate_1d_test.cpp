@@ -893,3 +893,40 @@ TEST(StanMath_integrate_1d_rev, TestWeibull) {
   EXPECT_FLOAT_EQ(1, 1 + g[0]);
   EXPECT_FLOAT_EQ(1, 1 + g[1]);
 }
+
+TEST(StanMath_integrate_1d_rev, gradients_share_evaluations) {
+  using stan::math::integrate_1d;
+  using stan::math::var;
+
+  int num_evals = 0;
+  auto f = [&num_evals](auto x, auto xc, const auto &theta, auto x_r,
+                        auto x_i, std::ostream *msgs) {
+    ++num_evals;
+    auto sum = 0 * theta[0];
+    for (size_t i = 0; i < theta.size(); ++i) {
+      sum += (i + 1) * theta[i];
+    }
+    return exp(-x * x * sum);
+  };
+
+  std::vector<var> theta_1 = {1.5};
+  var I_1 = integrate_1d(f, 0.0, 2.0, theta_1, {}, {}, msgs, 1e-8);
+  int num_evals_1 = num_evals;
+
+  num_evals = 0;
+  std::vector<var> theta_4 = {1.5, 0.0, 0.0, 0.0};
+  var I_4 = integrate_1d(f, 0.0, 2.0, theta_4, {}, {}, msgs, 1e-8);
+
+  // the gradient integrands are evaluated once per node for all the
+  // parameters together
+  EXPECT_EQ(num_evals, num_evals_1);
+
+  EXPECT_FLOAT_EQ(I_4.val(), I_1.val());
+  I_1.grad();
+  double grad_1 = theta_1[0].adj();
+  stan::math::set_zero_all_adjoints();
+  I_4.grad();
+  for (size_t i = 0; i < theta_4.size(); ++i) {
+    EXPECT_FLOAT_EQ(theta_4[i].adj(), (i + 1) * grad_1);
+  }
+}
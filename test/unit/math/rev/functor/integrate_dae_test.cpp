@@ -85,6 +85,49 @@ TEST_F(StanIntegrateDAETest, idas_ivp_system_yy0) {
   EXPECT_NEAR(0.0944571, yy[1][2], 1e-6);
 }
 
+TEST_F(StanIntegrateDAETest, linear_solvers) {
+  using stan::math::integrate_dae;
+  using stan::math::ode_linear_solver;
+  using stan::math::to_var;
+  using stan::math::value_of;
+  using stan::math::var;
+
+  std::vector<var> theta_var = to_var(theta);
+  std::vector<std::vector<var>> yy_dense
+      = integrate_dae(f, yy0, yp0, t0, ts, theta_var, x_r, x_i, 1e-5, 1e-12);
+
+  ode_linear_solver band;
+  band.type = ode_linear_solver::band;
+  band.upper_bandwidth = 2;
+  band.lower_bandwidth = 1;
+  ode_linear_solver iterative;
+  iterative.type = ode_linear_solver::iterative;
+  for (const auto& solver : {band, iterative}) {
+    std::vector<std::vector<var>> yy = integrate_dae(
+        f, yy0, yp0, t0, ts, theta_var, x_r, x_i, 1e-5, 1e-12, solver, 10000);
+    for (size_t i = 0; i < ts.size(); ++i) {
+      for (size_t k = 0; k < yy0.size(); ++k) {
+        EXPECT_NEAR(value_of(yy_dense[i][k]), value_of(yy[i][k]), 1e-5);
+      }
+    }
+    std::vector<double> g_dense;
+    std::vector<double> g;
+    stan::math::set_zero_all_adjoints();
+    yy_dense[1][1].grad(theta_var, g_dense);
+    stan::math::set_zero_all_adjoints();
+    yy[1][1].grad(theta_var, g);
+    for (size_t k = 0; k < theta.size(); ++k) {
+      EXPECT_NEAR(g_dense[k], g[k], 1e-6 * (1 + std::fabs(g_dense[k])));
+    }
+  }
+
+  ode_linear_solver no_bandwidths;
+  no_bandwidths.type = ode_linear_solver::band;
+  EXPECT_THROW(integrate_dae(f, yy0, yp0, t0, ts, theta, x_r, x_i, 1e-5,
+                             1e-12, no_bandwidths),
+               std::invalid_argument);
+}
+
 TEST_F(StanIntegrateDAETest, forward_sensitivity_theta) {
   using stan::math::idas_forward_system;
   using stan::math::idas_integrator;
@@ -0,0 +1,238 @@
+#include <stan/math/rev.hpp>
+#include <gtest/gtest.h>
+#include <test/unit/math/prim/functor/ode_test_functors.hpp>
+#include <test/unit/util.hpp>
+#include <vector>
+
+namespace ode_adjoint_test {
+struct lotka_volterra {
+  template <typename T0, typename T1, typename T2, typename T3>
+  inline Eigen::Matrix<stan::return_type_t<T1, T2, T3>, Eigen::Dynamic, 1>
+  operator()(const T0& t, const Eigen::Matrix<T1, Eigen::Dynamic, 1>& y,
+             std::ostream* msgs, const Eigen::Matrix<T2, Eigen::Dynamic, 1>& a,
+             const T3& b) const {
+    Eigen::Matrix<stan::return_type_t<T1, T2, T3>, Eigen::Dynamic, 1> dy_dt(2);
+    dy_dt << a(0) * y(0) - a(1) * y(0) * y(1),
+        a(2) * y(0) * y(1) - b * y(1);
+    return dy_dt;
+  }
+};
+
+struct many_rates {
+  template <typename T0, typename T1, typename T2>
+  inline Eigen::Matrix<stan::return_type_t<T1, T2>, Eigen::Dynamic, 1>
+  operator()(const T0& t, const Eigen::Matrix<T1, Eigen::Dynamic, 1>& y,
+             std::ostream* msgs,
+             const Eigen::Matrix<T2, Eigen::Dynamic, 1>& k) const {
+    Eigen::Matrix<stan::return_type_t<T1, T2>, Eigen::Dynamic, 1> dy_dt(2);
+    dy_dt << -stan::math::mean(k) * y(0), stan::math::mean(k) * y(0) - y(1);
+    return dy_dt;
+  }
+};
+}  // namespace ode_adjoint_test
+
+TEST(StanMathOde_ode_adjoint, scalar_arg_multi_time) {
+  using stan::math::var;
+
+  Eigen::VectorXd y0 = Eigen::VectorXd::Zero(1);
+  double t0 = 0.0;
+  std::vector<double> ts = {0.45, 1.1};
+
+  var a = 1.5;
+
+  std::vector<Eigen::Matrix<var, Eigen::Dynamic, 1>> output
+      = stan::math::ode_bdf_adjoint(stan::test::CosArg1(), y0, t0, ts, nullptr,
+                                    a);
+
+  output[0](0).grad();
+
+  EXPECT_NEAR(output[0](0).val(), 0.4165982112, 1e-5);
+  EXPECT_NEAR(a.adj(), -0.04352005542, 1e-5);
+
+  stan::math::set_zero_all_adjoints();
+
+  output[1](0).grad();
+
+  EXPECT_NEAR(output[1](0).val(), 0.66457668563, 1e-5);
+  EXPECT_NEAR(a.adj(), -0.50107310888, 1e-5);
+}
+
+TEST(StanMathOde_ode_adjoint, t0_ts_repeat) {
+  using stan::math::var;
+
+  Eigen::VectorXd y0 = Eigen::VectorXd::Zero(1);
+  var t0 = 0.0;
+  std::vector<var> ts = {0.45, 0.45, 1.1};
+
+  double a = 1.5;
+
+  std::vector<Eigen::Matrix<var, Eigen::Dynamic, 1>> output
+      = stan::math::ode_adams_adjoint(stan::test::CosArg1(), y0, t0, ts,
+                                      nullptr, a);
+
+  output[1](0).grad();
+
+  EXPECT_NEAR(output[1](0).val(), 0.4165982112, 1e-5);
+  EXPECT_NEAR(t0.adj(), -1.0, 1e-5);
+  EXPECT_NEAR(ts[0].adj(), 0.0, 1e-5);
+  EXPECT_NEAR(ts[1].adj(), 0.78070695113, 1e-5);
+
+  stan::math::set_zero_all_adjoints();
+
+  output[2](0).grad();
+
+  EXPECT_NEAR(output[2](0).val(), 0.66457668563, 1e-5);
+  EXPECT_NEAR(t0.adj(), -1.0, 1e-5);
+  EXPECT_NEAR(ts[2].adj(), -0.0791208888, 1e-5);
+}
+
+TEST(StanMathOde_ode_adjoint, matches_forward_sensitivities) {
+  using stan::math::var;
+
+  for (int lmm = 0; lmm < 2; ++lmm) {
+    Eigen::Matrix<var, Eigen::Dynamic, 1> y0(2);
+    y0 << 10.0, 5.0;
+    var t0 = 0.0;
+    std::vector<var> ts = {0.5, 1.0, 2.5};
+    Eigen::Matrix<var, Eigen::Dynamic, 1> a(3);
+    a << 1.1, 0.4, 0.1;
+    var b = 0.4;
+
+    auto adjoint = lmm == 0 ? stan::math::ode_bdf_adjoint_tol(
+                       ode_adjoint_test::lotka_volterra(), y0, t0, ts, 1e-10,
+                       1e-10, 100000, nullptr, a, b)
+                            : stan::math::ode_adams_adjoint_tol(
+                                ode_adjoint_test::lotka_volterra(), y0, t0, ts,
+                                1e-10, 1e-10, 100000, nullptr, a, b);
+    auto forward = lmm == 0 ? stan::math::ode_bdf_tol(
+                       ode_adjoint_test::lotka_volterra(), y0, t0, ts, 1e-10,
+                       1e-10, 100000, nullptr, a, b)
+                            : stan::math::ode_adams_tol(
+                                ode_adjoint_test::lotka_volterra(), y0, t0, ts,
+                                1e-10, 1e-10, 100000, nullptr, a, b);
+
+    std::vector<var> operands{y0(0), y0(1), t0,   ts[0], ts[1],
+                              ts[2], a(0),  a(1), a(2),  b};
+    for (size_t n = 0; n < ts.size(); ++n) {
+      for (int i = 0; i < 2; ++i) {
+        EXPECT_NEAR(forward[n](i).val(), adjoint[n](i).val(), 1e-6);
+
+        stan::math::set_zero_all_adjoints();
+        forward[n](i).grad();
+        std::vector<double> grad_forward;
+        for (auto& x : operands) {
+          grad_forward.push_back(x.adj());
+        }
+
+        stan::math::set_zero_all_adjoints();
+        adjoint[n](i).grad();
+        for (size_t k = 0; k < operands.size(); ++k) {
+          EXPECT_NEAR(grad_forward[k], operands[k].adj(),
+                      1e-5 * (1 + std::fabs(grad_forward[k])))
+              << "lmm " << lmm << " output " << n << ", " << i << " operand "
+              << k;
+        }
+      }
+    }
+
+    // weighted sum of all outputs, so every output adjoint is non-zero
+    var sum_forward = 0;
+    var sum_adjoint = 0;
+    for (size_t n = 0; n < ts.size(); ++n) {
+      sum_forward += (n + 1.0) * (forward[n](0) - 2 * forward[n](1));
+      sum_adjoint += (n + 1.0) * (adjoint[n](0) - 2 * adjoint[n](1));
+    }
+    stan::math::set_zero_all_adjoints();
+    sum_forward.grad();
+    std::vector<double> grad_forward;
+    for (auto& x : operands) {
+      grad_forward.push_back(x.adj());
+    }
+    stan::math::set_zero_all_adjoints();
+    sum_adjoint.grad();
+    for (size_t k = 0; k < operands.size(); ++k) {
+      EXPECT_NEAR(grad_forward[k], operands[k].adj(),
+                  1e-5 * (1 + std::fabs(grad_forward[k])))
+          << "lmm " << lmm << " operand " << k;
+    }
+    stan::math::recover_memory();
+  }
+}
+
+TEST(StanMathOde_ode_adjoint, double_args) {
+  Eigen::VectorXd y0(2);
+  y0 << 10.0, 5.0;
+  std::vector<double> ts = {0.5, 1.0};
+  Eigen::VectorXd a(3);
+  a << 1.1, 0.4, 0.1;
+
+  std::vector<Eigen::VectorXd> adjoint = stan::math::ode_bdf_adjoint(
+      ode_adjoint_test::lotka_volterra(), y0, 0.0, ts, nullptr, a, 0.4);
+  std::vector<Eigen::VectorXd> forward = stan::math::ode_bdf(
+      ode_adjoint_test::lotka_volterra(), y0, 0.0, ts, nullptr, a, 0.4);
+
+  for (size_t n = 0; n < ts.size(); ++n) {
+    EXPECT_MATRIX_NEAR(forward[n], adjoint[n], 1e-8);
+  }
+}
+
+TEST(StanMathOde_ode_adjoint, errors) {
+  using stan::math::var;
+
+  Eigen::VectorXd y0 = Eigen::VectorXd::Zero(1);
+  var a = 1.5;
+
+  EXPECT_THROW(stan::math::ode_bdf_adjoint(stan::test::CosArg1(), y0, 1.0,
+                                           std::vector<double>{0.5}, nullptr,
+                                           a),
+               std::domain_error);
+  EXPECT_THROW(stan::math::ode_bdf_adjoint(stan::test::CosArg1(), y0, 0.0,
+                                           std::vector<double>{1.0, 0.5},
+                                           nullptr, a),
+               std::domain_error);
+  EXPECT_THROW(stan::math::ode_bdf_adjoint(stan::test::CosArgWrongSize(), y0,
+                                           0.0, std::vector<double>{1.0},
+                                           nullptr, a),
+               std::invalid_argument);
+  EXPECT_THROW(stan::math::ode_bdf_adjoint_tol(stan::test::CosArg1(), y0, 0.0,
+                                               std::vector<double>{100.0},
+                                               1e-10, 1e-10, 10, nullptr, a),
+               std::domain_error);
+  stan::math::recover_memory();
+}
+
+TEST(StanMathOde_ode_adjoint, bdf_tol_switches_to_adjoint) {
+  using stan::math::var;
+  auto& stack = *stan::math::ChainableStack::instance_;
+  Eigen::VectorXd y0(2);
+  y0 << 1.0, 0.0;
+  std::vector<double> ts = {0.5, 1.0};
+
+  for (int num_rates : {4, 40}) {
+    Eigen::Matrix<var, Eigen::Dynamic, 1> k(num_rates);
+    for (int j = 0; j < num_rates; ++j) {
+      k(j) = 0.5 + 0.01 * j;
+    }
+    // the adjoint method puts one callback on the stack, the forward
+    // sensitivities one vari per output
+    const size_t stack_start = stack.var_stack_.size();
+    auto y = stan::math::ode_bdf_tol(ode_adjoint_test::many_rates(), y0, 0.0,
+                                     ts, 1e-10, 1e-10, 100000, nullptr, k);
+    const size_t num_chained = stack.var_stack_.size() - stack_start;
+    const bool adjoint = num_rates
+                         >= stan::math::internal::ode_adjoint_min_sensitivities;
+    EXPECT_EQ(adjoint ? 1 : 4, num_chained) << num_rates;
+
+    auto forward = stan::math::ode_bdf_tol(
+        ode_adjoint_test::many_rates(), y0, 0.0, ts, 1e-10, 1e-10, 100000,
+        stan::math::ode_linear_solver(), nullptr, k);
+    stan::math::set_zero_all_adjoints();
+    forward[1](1).grad();
+    Eigen::VectorXd grad_forward = k.adj();
+    stan::math::set_zero_all_adjoints();
+    y[1](1).grad();
+    EXPECT_NEAR(forward[1](1).val(), y[1](1).val(), 1e-8);
+    EXPECT_MATRIX_NEAR(grad_forward, k.adj(), 1e-6);
+    stan::math::recover_memory();
+  }
+}
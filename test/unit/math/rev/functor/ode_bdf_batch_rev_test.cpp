@@ -0,0 +1,153 @@
+#include <stan/math/rev.hpp>
+#include <gtest/gtest.h>
+#include <test/unit/util.hpp>
+#include <vector>
+
+namespace ode_batch_test {
+struct lotka_volterra {
+  template <typename T0, typename T1, typename T2, typename T3>
+  inline Eigen::Matrix<stan::return_type_t<T1, T2, T3>, Eigen::Dynamic, 1>
+  operator()(const T0& t, const Eigen::Matrix<T1, Eigen::Dynamic, 1>& y,
+             std::ostream* msgs, const Eigen::Matrix<T2, Eigen::Dynamic, 1>& a,
+             const T3& b) const {
+    Eigen::Matrix<stan::return_type_t<T1, T2, T3>, Eigen::Dynamic, 1> dy_dt(2);
+    dy_dt << a(0) * y(0) - a(1) * y(0) * y(1),
+        a(2) * y(0) * y(1) - b * y(1);
+    return dy_dt;
+  }
+};
+}  // namespace ode_batch_test
+
+TEST(StanMathOde_ode_batch, matches_single_solves) {
+  using stan::math::var;
+  using vector_v = Eigen::Matrix<var, Eigen::Dynamic, 1>;
+
+  for (int solver = 0; solver < 3; ++solver) {
+    std::vector<vector_v> y0s;
+    std::vector<var> t0s;
+    std::vector<std::vector<var>> tss;
+    std::vector<vector_v> as;
+    std::vector<double> bs;
+    for (int s = 0; s < 3; ++s) {
+      vector_v y0(2);
+      y0 << 10.0 - s, 5.0 + s;
+      y0s.push_back(y0);
+      t0s.push_back(0.1 * s);
+      tss.push_back(std::vector<var>{0.5, 1.0 + 0.5 * s, 2.5});
+      vector_v a(3);
+      a << 1.1 - 0.1 * s, 0.4, 0.1 + 0.05 * s;
+      as.push_back(a);
+      bs.push_back(0.4 + 0.1 * s);
+    }
+
+    auto batch = solver == 0
+                     ? stan::math::ode_bdf_batch_tol(
+                         ode_batch_test::lotka_volterra(), y0s, t0s, tss,
+                         1e-10, 1e-10, 100000, nullptr, as, bs)
+                     : solver == 1 ? stan::math::ode_adams_batch_tol(
+                           ode_batch_test::lotka_volterra(), y0s, t0s, tss,
+                           1e-10, 1e-10, 100000, nullptr, as, bs)
+                                   : stan::math::ode_rk45_batch_tol(
+                                       ode_batch_test::lotka_volterra(), y0s,
+                                       t0s, tss, 1e-8, 1e-8, 100000, nullptr,
+                                       as, bs);
+    ASSERT_EQ(batch.size(), 3);
+
+    for (int s = 0; s < 3; ++s) {
+      auto single = solver == 0
+                        ? stan::math::ode_bdf_tol(
+                            ode_batch_test::lotka_volterra(), y0s[s], t0s[s],
+                            tss[s], 1e-10, 1e-10, 100000, nullptr, as[s], bs[s])
+                        : solver == 1 ? stan::math::ode_adams_tol(
+                              ode_batch_test::lotka_volterra(), y0s[s], t0s[s],
+                              tss[s], 1e-10, 1e-10, 100000, nullptr, as[s],
+                              bs[s])
+                                      : stan::math::ode_rk45_tol(
+                                          ode_batch_test::lotka_volterra(),
+                                          y0s[s], t0s[s], tss[s], 1e-8, 1e-8,
+                                          100000, nullptr, as[s], bs[s]);
+      ASSERT_EQ(batch[s].size(), tss[s].size());
+
+      std::vector<var> operands{y0s[s](0), y0s[s](1), t0s[s],   tss[s][0],
+                                tss[s][1], tss[s][2], as[s](0), as[s](1),
+                                as[s](2)};
+      for (size_t n = 0; n < tss[s].size(); ++n) {
+        for (int i = 0; i < 2; ++i) {
+          EXPECT_FLOAT_EQ(single[n](i).val(), batch[s][n](i).val());
+
+          stan::math::set_zero_all_adjoints();
+          single[n](i).grad();
+          std::vector<double> grad_single;
+          for (auto& x : operands) {
+            grad_single.push_back(x.adj());
+          }
+
+          stan::math::set_zero_all_adjoints();
+          batch[s][n](i).grad();
+          for (size_t k = 0; k < operands.size(); ++k) {
+            EXPECT_FLOAT_EQ(grad_single[k], operands[k].adj())
+                << "solver " << solver << " subject " << s << " output " << n
+                << ", " << i << " operand " << k;
+          }
+        }
+      }
+    }
+
+    // outputs of different subjects only depend on their own operands
+    stan::math::set_zero_all_adjoints();
+    batch[1][2](0).grad();
+    EXPECT_EQ(y0s[0](0).adj(), 0.0);
+    EXPECT_EQ(as[2](1).adj(), 0.0);
+    EXPECT_NE(as[1](1).adj(), 0.0);
+    stan::math::recover_memory();
+  }
+}
+
+TEST(StanMathOde_ode_batch, double_args) {
+  std::vector<Eigen::VectorXd> y0s(2, Eigen::VectorXd(2));
+  y0s[0] << 10.0, 5.0;
+  y0s[1] << 8.0, 6.0;
+  std::vector<double> t0s{0.0, 0.0};
+  std::vector<std::vector<double>> tss{{0.5, 1.0}, {0.25, 0.75, 1.5}};
+  std::vector<Eigen::VectorXd> as(2, Eigen::VectorXd(3));
+  as[0] << 1.1, 0.4, 0.1;
+  as[1] << 1.0, 0.3, 0.2;
+  std::vector<double> bs{0.4, 0.5};
+
+  std::vector<std::vector<Eigen::VectorXd>> batch = stan::math::ode_bdf_batch(
+      ode_batch_test::lotka_volterra(), y0s, t0s, tss, nullptr, as, bs);
+
+  for (size_t s = 0; s < 2; ++s) {
+    std::vector<Eigen::VectorXd> single
+        = stan::math::ode_bdf(ode_batch_test::lotka_volterra(), y0s[s],
+                              t0s[s], tss[s], nullptr, as[s], bs[s]);
+    ASSERT_EQ(batch[s].size(), single.size());
+    for (size_t n = 0; n < single.size(); ++n) {
+      EXPECT_MATRIX_NEAR(single[n], batch[s][n], 1e-12);
+    }
+  }
+}
+
+TEST(StanMathOde_ode_batch, errors) {
+  using stan::math::var;
+
+  std::vector<Eigen::VectorXd> y0s(2, Eigen::VectorXd::Ones(2));
+  std::vector<Eigen::VectorXd> as(2, Eigen::VectorXd::Ones(3));
+  std::vector<var> bs{0.4, 0.5};
+  std::vector<std::vector<double>> tss{{0.5}, {0.5}};
+
+  EXPECT_THROW(
+      stan::math::ode_bdf_batch(ode_batch_test::lotka_volterra(), y0s,
+                                std::vector<double>{0.0}, tss, nullptr, as, bs),
+      std::invalid_argument);
+  EXPECT_THROW(stan::math::ode_rk45_batch(
+                   ode_batch_test::lotka_volterra(), y0s,
+                   std::vector<double>{0.0, 0.0}, tss, nullptr, as,
+                   std::vector<var>{0.4}),
+               std::invalid_argument);
+  EXPECT_THROW(stan::math::ode_adams_batch(
+                   ode_batch_test::lotka_volterra(), y0s,
+                   std::vector<double>{0.0, 1.0}, tss, nullptr, as, bs),
+               std::domain_error);
+  stan::math::recover_memory();
+}
@@ -539,3 +539,115 @@ TEST(StanMathOde_ode_bdf_tol, too_much_work) {
                    std::domain_error,
                    "ode_bdf_tol:  Failed to integrate to next output time");
 }
+
+TEST(StanMathOde_ode_bdf_tol, dense_output_grid) {
+  using stan::math::var;
+
+  Eigen::VectorXd y0 = Eigen::VectorXd::Zero(1);
+  std::vector<double> ts;
+  for (int n = 1; n <= 2000; ++n) {
+    ts.push_back(0.005 * n);
+  }
+  var a = 1.5;
+
+  // many more output times than steps
+  std::vector<Eigen::Matrix<var, Eigen::Dynamic, 1>> output
+      = stan::math::ode_bdf_tol(stan::test::CosArg1(), y0, 0.0, ts, 1e-10,
+                                1e-10, 1e6, nullptr, a);
+  ASSERT_EQ(output.size(), ts.size());
+
+  for (size_t n = 0; n < ts.size(); n += 199) {
+    double t = ts[n];
+    EXPECT_NEAR(output[n][0].val(), std::sin(1.5 * t) / 1.5, 1e-7);
+
+    stan::math::set_zero_all_adjoints();
+    output[n][0].grad();
+    EXPECT_NEAR(a.adj(),
+                t * std::cos(1.5 * t) / 1.5 - std::sin(1.5 * t) / (1.5 * 1.5),
+                1e-6);
+  }
+  stan::math::recover_memory();
+}
+
+namespace ode_bdf_tol_test {
+// method of lines discretization of the reaction diffusion equation
+// u_t = d u_xx - k u^2 on a grid with Dirichlet boundaries
+struct diffusion {
+  template <typename T0, typename T1, typename T2>
+  inline Eigen::Matrix<stan::return_type_t<T1, T2>, Eigen::Dynamic, 1>
+  operator()(const T0& t, const Eigen::Matrix<T1, Eigen::Dynamic, 1>& u,
+             std::ostream* msgs, const T2& d, double k) const {
+    const int n = u.size();
+    const double h2 = 1.0 / ((n + 1.0) * (n + 1.0));
+    Eigen::Matrix<stan::return_type_t<T1, T2>, Eigen::Dynamic, 1> du_dt(n);
+    for (int i = 0; i < n; ++i) {
+      auto left = i > 0 ? u(i - 1) : 0.0;
+      auto right = i < n - 1 ? u(i + 1) : 0.0;
+      du_dt(i) = d * (left - 2 * u(i) + right) / h2 - k * u(i) * u(i);
+    }
+    return du_dt;
+  }
+};
+}  // namespace ode_bdf_tol_test
+
+TEST(StanMathOde_ode_bdf_tol, linear_solvers) {
+  using stan::math::ode_linear_solver;
+  using stan::math::var;
+
+  const int n = 30;
+  std::vector<ode_linear_solver> solvers(5);
+  solvers[1].type = ode_linear_solver::band;
+  solvers[1].upper_bandwidth = 1;
+  solvers[1].lower_bandwidth = 1;
+  solvers[2].type = ode_linear_solver::band;
+  solvers[2].upper_bandwidth = 2;
+  solvers[2].lower_bandwidth = 3;
+  solvers[3].type = ode_linear_solver::iterative;
+  // reuses the workspace and jacobian sparsity of the previous solve
+  solvers[4].type = ode_linear_solver::iterative;
+
+  std::vector<double> ts = {0.01, 0.1};
+  std::vector<std::vector<Eigen::VectorXd>> values;
+  std::vector<std::vector<double>> grads;
+  for (const auto& solver : solvers) {
+    Eigen::Matrix<var, Eigen::Dynamic, 1> u0(n);
+    for (int i = 0; i < n; ++i) {
+      u0(i) = std::sin(3.14159 * (i + 1.0) / (n + 1.0));
+    }
+    var d = 0.5;
+    std::vector<Eigen::Matrix<var, Eigen::Dynamic, 1>> u
+        = stan::math::ode_bdf_tol(ode_bdf_tol_test::diffusion(), u0, 0.0, ts,
+                                  1e-8, 1e-8, 100000, solver, nullptr, d, 2.0);
+    std::vector<Eigen::VectorXd> u_values;
+    for (const auto& u_n : u) {
+      u_values.push_back(stan::math::value_of(u_n));
+    }
+    values.push_back(u_values);
+
+    var u_mid = u[1](n / 2);
+    u_mid.grad();
+    std::vector<double> grad{d.adj()};
+    for (int i = 0; i < n; ++i) {
+      grad.push_back(u0(i).adj());
+    }
+    grads.push_back(grad);
+    stan::math::recover_memory();
+  }
+
+  for (size_t s = 1; s < solvers.size(); ++s) {
+    for (size_t m = 0; m < ts.size(); ++m) {
+      EXPECT_MATRIX_NEAR(values[0][m], values[s][m], 1e-6);
+    }
+    for (size_t k = 0; k < grads[0].size(); ++k) {
+      EXPECT_NEAR(grads[0][k], grads[s][k], 1e-5) << "solver " << s;
+    }
+  }
+
+  ode_linear_solver no_bandwidths;
+  no_bandwidths.type = ode_linear_solver::band;
+  Eigen::VectorXd u0 = Eigen::VectorXd::Ones(n);
+  EXPECT_THROW(stan::math::ode_bdf_tol(ode_bdf_tol_test::diffusion(), u0, 0.0,
+                                       ts, 1e-8, 1e-8, 100000, no_bandwidths,
+                                       nullptr, 0.5, 2.0),
+               std::domain_error);
+}
@@ -0,0 +1,66 @@
+#include <stan/math/rev.hpp>
+#include <test/unit/util.hpp>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace ode_linear_solver_test {
+struct tridiagonal {
+  template <typename T>
+  inline Eigen::Matrix<T, Eigen::Dynamic, 1> operator()(
+      const Eigen::Matrix<T, Eigen::Dynamic, 1>& x) const {
+    const int n = x.size();
+    Eigen::Matrix<T, Eigen::Dynamic, 1> y(n);
+    for (int i = 0; i < n; ++i) {
+      y(i) = x(i) * x(i);
+      if (i > 0) {
+        // zero at x = 0, but still a structural non-zero
+        y(i) += x(i) * x(i - 1);
+      }
+      if (i < n - 1) {
+        y(i) += 3 * x(i + 1);
+      }
+    }
+    return y;
+  }
+};
+}  // namespace ode_linear_solver_test
+
+TEST(RevFunctor, ode_linear_solver_sparsity) {
+  using stan::math::internal::jacobian_sparsity;
+  Eigen::VectorXd x = Eigen::VectorXd::Zero(6);
+  Eigen::SparseMatrix<double> pattern
+      = jacobian_sparsity(ode_linear_solver_test::tridiagonal(), x);
+  EXPECT_EQ(6 + 5 + 5, pattern.nonZeros());
+
+  Eigen::SparseMatrix<double> band
+      = stan::math::internal::band_sparsity(6, 1, 1);
+  EXPECT_MATRIX_EQ(Eigen::MatrixXd(band), Eigen::MatrixXd(pattern));
+}
+
+TEST(RevFunctor, ode_linear_solver_sparse_jacobian) {
+  using stan::math::internal::sparsity_row_coloring;
+  const int n = 9;
+  Eigen::VectorXd x(n);
+  for (int i = 0; i < n; ++i) {
+    x(i) = 0.3 * i - 1;
+  }
+  ode_linear_solver_test::tridiagonal f;
+  Eigen::SparseMatrix<double> J
+      = stan::math::internal::jacobian_sparsity(f, x);
+
+  int num_colors;
+  std::vector<int> colors = sparsity_row_coloring(J, num_colors);
+  EXPECT_EQ(3, num_colors);
+  for (int i = 0; i < n; ++i) {
+    for (int k = i + 1; k < std::min(n, i + 3); ++k) {
+      EXPECT_NE(colors[i], colors[k]);
+    }
+  }
+
+  stan::math::internal::sparse_jacobian(f, x, colors, num_colors, J);
+  Eigen::VectorXd fx;
+  Eigen::MatrixXd J_dense;
+  stan::math::jacobian(f, x, fx, J_dense);
+  EXPECT_MATRIX_FLOAT_EQ(J_dense, Eigen::MatrixXd(J));
+  EXPECT_EQ(0, stan::math::ChainableStack::instance_->var_stack_.size());
+}
@@ -0,0 +1,92 @@
+#include <stan/math/rev.hpp>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace {
+struct normal_term {
+  template <typename T1, typename T2>
+  auto operator()(size_t i, std::ostream* msgs, const std::vector<double>& y,
+                  const T1& mu, const T2& sigma) const {
+    return stan::math::normal_lpdf(y[i], mu, sigma);
+  }
+};
+}  // namespace
+
+TEST(StanMathRev_parallel_reverse_sum, gradient) {
+  using stan::math::var;
+  std::vector<double> y(1000);
+  for (size_t i = 0; i < y.size(); ++i) {
+    y[i] = 0.01 * i - 3.0;
+  }
+  for (int grainsize : {1, 7, 100, 5000}) {
+    var mu = 0.5;
+    var sigma = 2.0;
+    var lp = stan::math::parallel_reverse_sum(normal_term(), y.size(),
+                                              grainsize, nullptr, y, mu, sigma);
+    var lp_ref = stan::math::normal_lpdf(y, mu, sigma);
+    EXPECT_FLOAT_EQ(lp_ref.val(), lp.val());
+
+    stan::math::grad(lp.vi_);
+    const double dmu = mu.adj();
+    const double dsigma = sigma.adj();
+    stan::math::set_zero_all_adjoints();
+    stan::math::grad(lp_ref.vi_);
+    EXPECT_FLOAT_EQ(mu.adj(), dmu) << "grainsize " << grainsize;
+    EXPECT_FLOAT_EQ(sigma.adj(), dsigma) << "grainsize " << grainsize;
+
+    // reverse pass can be repeated after zeroing
+    stan::math::set_zero_all_adjoints();
+    stan::math::grad(lp.vi_);
+    EXPECT_FLOAT_EQ(dmu, mu.adj());
+    stan::math::recover_memory();
+  }
+}
+
+TEST(StanMathRev_parallel_reverse_sum, composed) {
+  using stan::math::var;
+  std::vector<double> y{1.0, 2.0, 3.0};
+  var mu = 1.5;
+  var sigma = 1.0;
+  var mu2 = mu * 2.0;
+  var lp = stan::math::parallel_reverse_sum(normal_term(), y.size(), 2,
+                                            nullptr, y, mu2, sigma);
+  var f = lp * 3.0 + mu;
+  f.grad();
+  // d/dmu2 sum normal_lpdf(y | mu2, 1) = sum(y - mu2)
+  EXPECT_FLOAT_EQ(3.0 * 2.0 * (6.0 - 3 * 3.0) + 1.0, mu.adj());
+  stan::math::recover_memory();
+}
+
+TEST(StanMathRev_parallel_reverse_sum, jacobian) {
+  using stan::math::var;
+  std::vector<double> y{1.0, 2.0, 3.0, 4.0};
+  auto f = [&](const auto& theta) {
+    Eigen::Matrix<stan::scalar_type_t<decltype(theta)>, -1, 1> res(2);
+    res(0) = stan::math::parallel_reverse_sum(normal_term(), y.size(), 1,
+                                              nullptr, y, theta(0), 1.0);
+    res(1) = theta(0) * theta(1);
+    return res;
+  };
+  Eigen::VectorXd theta(2);
+  theta << 0.5, 3.0;
+  Eigen::VectorXd fx;
+  Eigen::MatrixXd J;
+  stan::math::jacobian(f, theta, fx, J);
+  EXPECT_FLOAT_EQ(10.0 - 4 * 0.5, J(0, 0));
+  EXPECT_FLOAT_EQ(0.0, J(0, 1));
+  EXPECT_FLOAT_EQ(3.0, J(1, 0));
+  EXPECT_FLOAT_EQ(0.5, J(1, 1));
+}
+
+TEST(StanMathRev_parallel_reverse_sum, errors) {
+  using stan::math::var;
+  std::vector<double> y{1.0};
+  var mu = 0;
+  EXPECT_THROW(stan::math::parallel_reverse_sum(normal_term(), y.size(), 0,
+                                                nullptr, y, mu, 1.0),
+               std::domain_error);
+  EXPECT_FLOAT_EQ(0.0, stan::math::parallel_reverse_sum(normal_term(), 0, 1,
+                                                        nullptr, y, mu, 1.0)
+                           .val());
+  stan::math::recover_memory();
+}
@@ -0,0 +1,70 @@
+// the tests here check that the reverse pass of parallel_reverse_sum runs
+// the segments concurrently, as such they only run if STAN_THREADS is
+// defined
+
+#ifdef STAN_THREADS
+
+#include <stan/math/rev.hpp>
+#include <gtest/gtest.h>
+#include <tbb/task_arena.h>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace parallel_reverse_sum_threads_test {
+std::mutex ids_mutex;
+std::set<std::thread::id> chain_thread_ids;
+
+// vari for 2 * x which records the thread running its reverse pass
+class thread_recording_vari : public stan::math::vari {
+  stan::math::vari* x_;
+
+ public:
+  explicit thread_recording_vari(stan::math::vari* x)
+      : stan::math::vari(2.0 * x->val_), x_(x) {}
+
+  void chain() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    {
+      std::lock_guard<std::mutex> lock(ids_mutex);
+      chain_thread_ids.insert(std::this_thread::get_id());
+    }
+    x_->adj_ += 2.0 * adj_;
+  }
+};
+
+struct recorded_normal_term {
+  auto operator()(size_t i, std::ostream* msgs, const std::vector<double>& y,
+                  const stan::math::var& mu) const {
+    return stan::math::var(new thread_recording_vari(mu.vi_))
+           + stan::math::normal_lpdf(y[i], mu, 1.0);
+  }
+};
+}  // namespace parallel_reverse_sum_threads_test
+
+TEST(StanMathRev_parallel_reverse_sum, concurrent_reverse_pass) {
+  using parallel_reverse_sum_threads_test::chain_thread_ids;
+  using stan::math::var;
+  std::vector<double> y(256);
+  double sum_y = 0;
+  for (size_t i = 0; i < y.size(); ++i) {
+    y[i] = 0.01 * i - 1.0;
+    sum_y += y[i];
+  }
+  var mu = 0.5;
+  var lp = stan::math::parallel_reverse_sum(
+      parallel_reverse_sum_threads_test::recorded_normal_term(), y.size(), 4,
+      nullptr, y, mu);
+
+  chain_thread_ids.clear();
+  tbb::task_arena arena(4);
+  arena.execute([&] { lp.grad(); });
+
+  EXPECT_LT(1U, chain_thread_ids.size());
+  EXPECT_FLOAT_EQ(2.0 * y.size() + sum_y - y.size() * mu.val(), mu.adj());
+  stan::math::recover_memory();
+}
+
+#endif
@@ -0,0 +1,129 @@
+// reduce_sum uses a fixed partition only if STAN_MATH_DETERMINISTIC_REDUCE
+// is defined
+#ifndef STAN_MATH_DETERMINISTIC_REDUCE
+#define STAN_MATH_DETERMINISTIC_REDUCE
+#endif
+
+#include <stan/math.hpp>
+#include <test/unit/math/prim/functor/reduce_sum_util.hpp>
+#include <tbb/task_arena.h>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+TEST(StanMathRev_reduce_sum, deterministic_grainsize) {
+  using stan::math::internal::deterministic_grainsize;
+  EXPECT_EQ(1, deterministic_grainsize(10, 1));
+  EXPECT_EQ(7, deterministic_grainsize(10, 7));
+  EXPECT_EQ(1, deterministic_grainsize(1024, 1));
+  EXPECT_EQ(2, deterministic_grainsize(1025, 1));
+  EXPECT_EQ(10, deterministic_grainsize(10000, 1));
+  EXPECT_EQ(20, deterministic_grainsize(10000, 20));
+}
+
+namespace reduce_sum_deterministic_test {
+struct sum_terms {
+  double operator()(const std::vector<double>& sub_slice, std::size_t start,
+                    std::size_t end, std::ostream* msgs) const {
+    double sum = 0;
+    for (double x : sub_slice) {
+      sum += x;
+    }
+    return sum;
+  }
+};
+}  // namespace reduce_sum_deterministic_test
+
+// runs the fixed partition of the double specialization on several
+// threads, which does not need STAN_THREADS
+TEST(StanMathPrim_reduce_sum, deterministic_partition_across_threads) {
+  using reduce_sum_deterministic_test::sum_terms;
+  using stan::math::internal::deterministic_grainsize;
+  std::vector<double> terms(5000);
+  for (std::size_t i = 0; i != terms.size(); ++i) {
+    terms[i] = std::sin(i) * std::pow(10.0, static_cast<int>(i % 17) - 8);
+  }
+  // the sum depends on the order of the additions
+  double sum_forward = 0;
+  double sum_backward = 0;
+  for (std::size_t i = 0; i != terms.size(); ++i) {
+    sum_forward += terms[i];
+    sum_backward += terms[terms.size() - 1 - i];
+  }
+  EXPECT_NE(sum_forward, sum_backward);
+
+  for (int grainsize : {1, 3, 50}) {
+    auto run = [&](int num_threads) {
+      double sum;
+      tbb::task_arena arena(num_threads);
+      arena.execute([&] {
+        sum = stan::math::internal::reduce_sum_impl<
+            sum_terms, void, double, const std::vector<double>&>()(
+            terms, false, deterministic_grainsize(terms.size(), grainsize),
+            nullptr);
+      });
+      return sum;
+    };
+    const double sum_ref = run(1);
+    EXPECT_FLOAT_EQ(sum_forward, sum_ref);
+    for (int num_threads : {2, 3, 4, 8}) {
+      for (int rep = 0; rep < 3; ++rep) {
+        EXPECT_EQ(sum_ref, run(num_threads))
+            << "grainsize " << grainsize << ", " << num_threads << " threads";
+      }
+    }
+  }
+}
+
+// reduce_sum over vars runs in parallel only with STAN_THREADS
+#ifdef STAN_THREADS
+TEST(StanMathRev_reduce_sum, deterministic_across_threads) {
+  using stan::math::var;
+  using stan::math::test::get_new_msg;
+  using stan::math::test::grouped_count_lpdf;
+
+  const std::size_t groups = 10;
+  const std::size_t elems = 20000;
+  std::vector<int> data(elems);
+  std::vector<int> gidx(elems);
+  for (std::size_t i = 0; i != elems; ++i) {
+    data[i] = i % 37;
+    gidx[i] = i % groups;
+  }
+  std::vector<double> lambda_d(groups);
+  for (std::size_t i = 0; i != groups; ++i) {
+    lambda_d[i] = 0.3 + 1.7 * i;
+  }
+
+  auto run = [&](int num_threads, double& lp, std::vector<double>& grad) {
+    tbb::task_arena arena(num_threads);
+    arena.execute([&] {
+      std::vector<var> lambda(lambda_d.begin(), lambda_d.end());
+      var lp_v = stan::math::reduce_sum<grouped_count_lpdf<var>>(
+          data, 1, get_new_msg(), lambda, gidx);
+      lp_v.grad();
+      lp = lp_v.val();
+      grad.resize(groups);
+      for (std::size_t i = 0; i != groups; ++i) {
+        grad[i] = lambda[i].adj();
+      }
+      stan::math::recover_memory();
+    });
+  };
+
+  double lp_ref;
+  std::vector<double> grad_ref;
+  run(1, lp_ref, grad_ref);
+  for (int num_threads : {1, 2, 3, 4, 8}) {
+    for (int rep = 0; rep < 3; ++rep) {
+      double lp;
+      std::vector<double> grad;
+      run(num_threads, lp, grad);
+      EXPECT_EQ(lp_ref, lp);
+      for (std::size_t i = 0; i != groups; ++i) {
+        EXPECT_EQ(grad_ref[i], grad[i]);
+      }
+    }
+  }
+}
+#endif
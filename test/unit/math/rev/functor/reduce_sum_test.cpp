@@ -431,3 +431,34 @@ TEST(StanMathRev_reduce_sum, linked_args) {
 
   stan::math::recover_memory();
 }
+
+TEST(StanMathRev_reduce_sum, adaptive_gradient) {
+  using stan::math::var;
+  using stan::math::test::count_lpdf;
+  using stan::math::test::get_new_msg;
+
+  double lambda_d = 10.0;
+  const std::size_t elems = 10000;
+  std::vector<int> data(elems);
+
+  for (std::size_t i = 0; i != elems; ++i)
+    data[i] = i;
+
+  var lambda_ref = lambda_d;
+  var poisson_lpdf_ref = stan::math::poisson_lpmf(data, lambda_ref);
+  stan::math::grad(poisson_lpdf_ref.vi_);
+  const double lambda_ref_adj = lambda_ref.adj();
+
+  std::vector<int> idata;
+  for (int n = 0; n < 10; ++n) {
+    var lambda_v = lambda_d;
+    std::vector<var> vlambda_v(1, lambda_v);
+    var poisson_lpdf = stan::math::reduce_sum_adaptive<count_lpdf<var>>(
+        data, get_new_msg(), vlambda_v, idata);
+    EXPECT_FLOAT_EQ(poisson_lpdf.val(), poisson_lpdf_ref.val());
+    stan::math::set_zero_all_adjoints();
+    stan::math::grad(poisson_lpdf.vi_);
+    EXPECT_FLOAT_EQ(lambda_v.adj(), lambda_ref_adj);
+  }
+  stan::math::recover_memory();
+}
@@ -0,0 +1,224 @@
+#include <stan/math/rev.hpp>
+#include <test/unit/util.hpp>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace sparse_jacobian_test {
+// blocks of three outputs, each depending on its own three inputs
+struct block_diagonal {
+  template <typename T>
+  inline Eigen::Matrix<T, Eigen::Dynamic, 1> operator()(
+      const Eigen::Matrix<T, Eigen::Dynamic, 1>& x) const {
+    Eigen::Matrix<T, Eigen::Dynamic, 1> y(x.size());
+    for (int b = 0; b < x.size() / 3; ++b) {
+      const T& u = x(3 * b);
+      const T& v = x(3 * b + 1);
+      const T& w = x(3 * b + 2);
+      y(3 * b) = u * v + w;
+      y(3 * b + 1) = exp(v) * w;
+      y(3 * b + 2) = u * u - v * w;
+    }
+    return y;
+  }
+};
+
+// two outputs from five inputs
+struct rectangular {
+  template <typename T>
+  inline Eigen::Matrix<T, Eigen::Dynamic, 1> operator()(
+      const Eigen::Matrix<T, Eigen::Dynamic, 1>& x) const {
+    Eigen::Matrix<T, Eigen::Dynamic, 1> y(2);
+    y(0) = x(0) * x(1);
+    y(1) = sin(x(3)) + x(4);
+    return y;
+  }
+};
+}  // namespace sparse_jacobian_test
+
+TEST(RevFunctor, jacobian_sparsity) {
+  sparse_jacobian_test::block_diagonal f;
+  Eigen::VectorXd x = Eigen::VectorXd::Zero(12);
+  Eigen::SparseMatrix<double> pattern = stan::math::jacobian_sparsity(f, x);
+  EXPECT_EQ(12, pattern.rows());
+  EXPECT_EQ(12, pattern.cols());
+  // the entries which vanish at zero are still found, only dy(3b + 1) / du
+  // is structurally zero in a block
+  EXPECT_EQ(4 * 8, pattern.nonZeros());
+  for (int i = 0; i < 12; ++i) {
+    for (int j = 0; j < 12; ++j) {
+      bool non_zero = i / 3 == j / 3 && !(i % 3 == 1 && j % 3 == 0);
+      EXPECT_EQ(non_zero ? 1.0 : 0.0, pattern.coeff(i, j)) << i << ", " << j;
+    }
+  }
+
+  Eigen::SparseMatrix<double> rect_pattern = stan::math::jacobian_sparsity(
+      sparse_jacobian_test::rectangular(), Eigen::VectorXd::Ones(5));
+  EXPECT_EQ(2, rect_pattern.rows());
+  EXPECT_EQ(5, rect_pattern.cols());
+  EXPECT_EQ(4, rect_pattern.nonZeros());
+  EXPECT_EQ(0, stan::math::ChainableStack::instance_->var_stack_.size());
+}
+
+TEST(RevFunctor, jacobian_sparsity_vanishing_derivatives) {
+  // y(0) = x(0) * x(1) and y(1) = x(1)^2 * x(2) have derivatives which
+  // vanish at every point with x(1) = 0
+  auto f = [](const auto& x) {
+    using T = stan::scalar_type_t<std::decay_t<decltype(x)>>;
+    Eigen::Matrix<T, Eigen::Dynamic, 1> y(2);
+    y(0) = x(0) * x(1);
+    y(1) = x(1) * x(1) * x(2);
+    return y;
+  };
+  Eigen::VectorXd x(3);
+  x << 0.0, 0.0, 2.0;
+  Eigen::MatrixXd pattern
+      = Eigen::MatrixXd(stan::math::jacobian_sparsity(f, x));
+  Eigen::MatrixXd expected(2, 3);
+  expected << 1, 1, 0, 0, 1, 1;
+  EXPECT_MATRIX_EQ(expected, pattern);
+}
+
+TEST(RevFunctor, jacobian_sparsity_one_pass) {
+  using stan::math::var;
+  sparse_jacobian_test::block_diagonal f;
+  stan::math::nested_rev_autodiff nested;
+  Eigen::Matrix<var, Eigen::Dynamic, 1> x_var = Eigen::VectorXd::Ones(6);
+  Eigen::Matrix<var, Eigen::Dynamic, 1> y = f(x_var);
+  std::vector<stan::math::vari*> inputs;
+  for (int j = 0; j < 6; ++j) {
+    inputs.push_back(x_var(j).vi_);
+  }
+  stan::math::internal::tape_graph graph;
+  EXPECT_TRUE(stan::math::internal::trace_tape(inputs, graph));
+  std::vector<int> outputs;
+  for (int i = 0; i < 6; ++i) {
+    outputs.push_back(graph.node(y(i).vi_));
+  }
+  std::vector<std::vector<int>> deps
+      = stan::math::internal::tape_dependencies(graph, 6, outputs);
+  EXPECT_EQ(std::vector<int>({0, 1, 2}), deps[0]);
+  EXPECT_EQ(std::vector<int>({1, 2}), deps[1]);
+  EXPECT_EQ(std::vector<int>({3, 4, 5}), deps[5]);
+}
+
+TEST(RevFunctor, jacobian_sparsity_untraced) {
+  // dot_self records a reverse pass callback, whose operands are not
+  // known, so the pattern is found with one reverse pass per output
+  auto f = [](const auto& x) {
+    using T = stan::scalar_type_t<std::decay_t<decltype(x)>>;
+    Eigen::Matrix<T, Eigen::Dynamic, 1> y(2);
+    y(0) = stan::math::dot_self(x.head(2));
+    y(1) = x(2) * x(3);
+    return y;
+  };
+  Eigen::VectorXd x(4);
+  x << 0.0, 1.0, 2.0, 0.0;
+  Eigen::MatrixXd pattern
+      = Eigen::MatrixXd(stan::math::jacobian_sparsity(f, x));
+  Eigen::MatrixXd expected(2, 4);
+  expected << 1, 1, 0, 0, 0, 0, 1, 1;
+  EXPECT_MATRIX_EQ(expected, pattern);
+}
+
+TEST(RevFunctor, sparse_jacobian) {
+  sparse_jacobian_test::block_diagonal f;
+  const int n = 300;
+  Eigen::VectorXd x(n);
+  for (int i = 0; i < n; ++i) {
+    x(i) = std::sin(0.7 * i);
+  }
+  Eigen::SparseMatrix<double> J = stan::math::jacobian_sparsity(f, x);
+
+  // the number of reverse passes does not grow with the number of blocks
+  int num_colors;
+  stan::math::internal::sparsity_row_coloring(J, num_colors);
+  EXPECT_EQ(3, num_colors);
+
+  Eigen::VectorXd fx;
+  stan::math::sparse_jacobian(f, x, fx, J);
+  Eigen::VectorXd fx_dense;
+  Eigen::MatrixXd J_dense;
+  stan::math::jacobian(f, x, fx_dense, J_dense);
+  EXPECT_MATRIX_FLOAT_EQ(fx_dense, fx);
+  EXPECT_MATRIX_FLOAT_EQ(J_dense, Eigen::MatrixXd(J));
+
+  // the pattern is reused at other arguments
+  x.array() += 0.5;
+  stan::math::sparse_jacobian(f, x, fx, J);
+  stan::math::jacobian(f, x, fx_dense, J_dense);
+  EXPECT_MATRIX_FLOAT_EQ(fx_dense, fx);
+  EXPECT_MATRIX_FLOAT_EQ(J_dense, Eigen::MatrixXd(J));
+  EXPECT_EQ(0, stan::math::ChainableStack::instance_->var_stack_.size());
+}
+
+TEST(RevFunctor, sparse_jacobian_rectangular) {
+  sparse_jacobian_test::rectangular f;
+  Eigen::VectorXd x(5);
+  x << 0.5, -1.0, 2.0, 0.3, 4.0;
+  Eigen::SparseMatrix<double> J = stan::math::jacobian_sparsity(f, x);
+  Eigen::VectorXd fx;
+  stan::math::sparse_jacobian(f, x, fx, J);
+  Eigen::VectorXd fx_dense;
+  Eigen::MatrixXd J_dense;
+  stan::math::jacobian(f, x, fx_dense, J_dense);
+  EXPECT_MATRIX_FLOAT_EQ(fx_dense, fx);
+  EXPECT_MATRIX_FLOAT_EQ(J_dense, Eigen::MatrixXd(J));
+}
+
+TEST(RevFunctor, sparse_jacobian_detected_pattern) {
+  sparse_jacobian_test::block_diagonal f;
+  Eigen::VectorXd x = Eigen::VectorXd::LinSpaced(9, -1.0, 1.0);
+  Eigen::SparseMatrix<double> J;
+  Eigen::VectorXd fx;
+  stan::math::sparse_jacobian(f, x, fx, J);
+  EXPECT_EQ(3 * 8, J.nonZeros());
+  Eigen::VectorXd fx_dense;
+  Eigen::MatrixXd J_dense;
+  stan::math::jacobian(f, x, fx_dense, J_dense);
+  EXPECT_MATRIX_FLOAT_EQ(fx_dense, fx);
+  EXPECT_MATRIX_FLOAT_EQ(J_dense, Eigen::MatrixXd(J));
+}
+
+TEST(RevFunctor, traced_jacobian) {
+  Eigen::VectorXd fx;
+  Eigen::MatrixXd J;
+  Eigen::VectorXd fx_dense;
+  Eigen::MatrixXd J_dense;
+
+  // traced pattern with three colors
+  sparse_jacobian_test::block_diagonal f;
+  Eigen::VectorXd x = Eigen::VectorXd::LinSpaced(30, -1.0, 1.0);
+  stan::math::internal::traced_jacobian(f, x, fx, J);
+  stan::math::jacobian(f, x, fx_dense, J_dense);
+  EXPECT_MATRIX_FLOAT_EQ(fx_dense, fx);
+  EXPECT_MATRIX_FLOAT_EQ(J_dense, J);
+
+  // dot_self cannot be traced, so there is one reverse pass per row
+  auto g = [](const auto& x) {
+    using T = stan::scalar_type_t<std::decay_t<decltype(x)>>;
+    Eigen::Matrix<T, Eigen::Dynamic, 1> y(3);
+    y(0) = stan::math::dot_self(x.head(2));
+    y(1) = x(2) * x(3);
+    y(2) = x(0) - x(3);
+    return y;
+  };
+  Eigen::VectorXd u(4);
+  u << 0.5, 1.0, 2.0, -0.5;
+  stan::math::internal::traced_jacobian(g, u, fx, J);
+  stan::math::jacobian(g, u, fx_dense, J_dense);
+  EXPECT_MATRIX_FLOAT_EQ(fx_dense, fx);
+  EXPECT_MATRIX_FLOAT_EQ(J_dense, J);
+  EXPECT_EQ(0, stan::math::ChainableStack::instance_->var_stack_.size());
+}
+
+TEST(RevFunctor, sparse_jacobian_errors) {
+  sparse_jacobian_test::block_diagonal f;
+  Eigen::VectorXd fx;
+  Eigen::SparseMatrix<double> J(6, 5);
+  EXPECT_THROW(stan::math::sparse_jacobian(f, Eigen::VectorXd::Ones(6), fx, J),
+               std::invalid_argument);
+  Eigen::SparseMatrix<double> J_rows(5, 6);
+  EXPECT_THROW(
+      stan::math::sparse_jacobian(f, Eigen::VectorXd::Ones(6), fx, J_rows),
+      std::invalid_argument);
+}
@@ -0,0 +1,219 @@
+// the scalar operators record on the SoA tape only if STAN_MATH_SOA_TAPE
+// is defined
+#ifndef STAN_MATH_SOA_TAPE
+#define STAN_MATH_SOA_TAPE
+#endif
+
+#include <stan/math/rev.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+
+namespace taped_gradient_test {
+struct smooth {
+  template <typename T>
+  inline T operator()(const Eigen::Matrix<T, Eigen::Dynamic, 1>& x) const {
+    T sum = 0;
+    for (int i = 0; i < x.size(); ++i) {
+      sum += stan::math::exp(-x(i) * x(i) / 2.0)
+             + stan::math::log(1.0 + x(i) * x(i)) / x.size();
+    }
+    return sum * x(0) - 3.0 / x(1);
+  }
+};
+
+struct branching {
+  template <typename T>
+  inline T operator()(const Eigen::Matrix<T, Eigen::Dynamic, 1>& x) const {
+    if (x(0) > x(1)) {
+      return x(0) * x(0) - x(1);
+    }
+    return 2.0 * x(1) * x(0);
+  }
+};
+
+struct absolute {
+  template <typename T>
+  inline T operator()(const Eigen::Matrix<T, Eigen::Dynamic, 1>& x) const {
+    return stan::math::fabs(x(0));
+  }
+};
+
+struct scaled_absolute {
+  template <typename T>
+  inline T operator()(const Eigen::Matrix<T, Eigen::Dynamic, 1>& x) const {
+    return stan::math::fabs(x(0)) * x(1);
+  }
+};
+
+struct special {
+  template <typename T>
+  inline T operator()(const Eigen::Matrix<T, Eigen::Dynamic, 1>& x) const {
+    return stan::math::sin(x(0)) * x(1);
+  }
+};
+
+struct nested {
+  template <typename T>
+  inline T operator()(const Eigen::Matrix<T, Eigen::Dynamic, 1>& x) const {
+    { stan::math::nested_rev_autodiff nested; }
+    return x(0) * x(1);
+  }
+};
+}  // namespace taped_gradient_test
+
+TEST(RevFunctor, taped_gradient_replay) {
+  using stan::math::taped_gradient;
+  taped_gradient_test::smooth f;
+  taped_gradient<taped_gradient_test::smooth> taped(f);
+
+  for (int n = 0; n < 5; ++n) {
+    Eigen::VectorXd x(3);
+    x << 0.5 + n, -1.5 + 0.3 * n, 2.0 - n;
+    double fx;
+    Eigen::VectorXd grad_fx;
+    taped(x, fx, grad_fx);
+    double fx_expected;
+    Eigen::VectorXd grad_fx_expected;
+    stan::math::gradient(f, x, fx_expected, grad_fx_expected);
+    EXPECT_FLOAT_EQ(fx_expected, fx);
+    ASSERT_EQ(3, grad_fx.size());
+    for (int i = 0; i < 3; ++i) {
+      EXPECT_FLOAT_EQ(grad_fx_expected(i), grad_fx(i));
+    }
+    EXPECT_TRUE(taped.replayable());
+  }
+  EXPECT_EQ(1, taped.num_recordings());
+  EXPECT_EQ(0, stan::math::ChainableStack::instance_->var_stack_.size());
+}
+
+TEST(RevFunctor, taped_gradient_rerecords_on_branch_change) {
+  using stan::math::taped_gradient;
+  taped_gradient_test::branching f;
+  taped_gradient<taped_gradient_test::branching> taped(f);
+  Eigen::VectorXd x(2);
+  Eigen::VectorXd grad_fx;
+  double fx;
+
+  x << 3, 1;
+  taped(x, fx, grad_fx);
+  EXPECT_FLOAT_EQ(8, fx);
+  EXPECT_FLOAT_EQ(6, grad_fx(0));
+  EXPECT_FLOAT_EQ(-1, grad_fx(1));
+
+  x << 4, 2;
+  taped(x, fx, grad_fx);
+  EXPECT_EQ(1, taped.num_recordings());
+  EXPECT_FLOAT_EQ(14, fx);
+  EXPECT_FLOAT_EQ(8, grad_fx(0));
+  EXPECT_FLOAT_EQ(-1, grad_fx(1));
+
+  x << 1, 2;
+  taped(x, fx, grad_fx);
+  EXPECT_EQ(2, taped.num_recordings());
+  EXPECT_FLOAT_EQ(4, fx);
+  EXPECT_FLOAT_EQ(4, grad_fx(0));
+  EXPECT_FLOAT_EQ(2, grad_fx(1));
+
+  x << 0.5, 3;
+  taped(x, fx, grad_fx);
+  EXPECT_EQ(2, taped.num_recordings());
+  EXPECT_FLOAT_EQ(3, fx);
+  EXPECT_FLOAT_EQ(6, grad_fx(0));
+  EXPECT_FLOAT_EQ(1, grad_fx(1));
+}
+
+TEST(RevFunctor, taped_gradient_falls_back) {
+  using stan::math::taped_gradient;
+  taped_gradient_test::special f;
+  taped_gradient<taped_gradient_test::special> taped(f);
+  Eigen::VectorXd x(2);
+  Eigen::VectorXd grad_fx;
+  double fx;
+
+  for (int n = 0; n < 3; ++n) {
+    x << 0.3 * n, 2;
+    taped(x, fx, grad_fx);
+    EXPECT_FALSE(taped.replayable());
+    EXPECT_FLOAT_EQ(std::sin(0.3 * n) * 2, fx);
+    EXPECT_FLOAT_EQ(std::cos(0.3 * n) * 2, grad_fx(0));
+    EXPECT_FLOAT_EQ(std::sin(0.3 * n), grad_fx(1));
+  }
+  EXPECT_EQ(3, taped.num_recordings());
+}
+
+TEST(RevFunctor, taped_gradient_fabs_sign_change) {
+  using stan::math::taped_gradient;
+  Eigen::VectorXd x(1);
+  Eigen::VectorXd grad_fx;
+  double fx;
+
+  // fabs(x) at x > 0 returns x itself, which is not replayed
+  taped_gradient<taped_gradient_test::absolute> taped(
+      taped_gradient_test::absolute{});
+  x << 1;
+  taped(x, fx, grad_fx);
+  EXPECT_FALSE(taped.replayable());
+  x << -1;
+  taped(x, fx, grad_fx);
+  EXPECT_FLOAT_EQ(1, fx);
+  EXPECT_FLOAT_EQ(-1, grad_fx(0));
+  EXPECT_EQ(2, taped.num_recordings());
+
+  // the sign of the argument of fabs() is a guard
+  taped_gradient<taped_gradient_test::scaled_absolute> scaled(
+      taped_gradient_test::scaled_absolute{});
+  x.resize(2);
+  x << 1, 3;
+  scaled(x, fx, grad_fx);
+  EXPECT_TRUE(scaled.replayable());
+  x << 2, 3;
+  scaled(x, fx, grad_fx);
+  EXPECT_EQ(1, scaled.num_recordings());
+  EXPECT_FLOAT_EQ(6, fx);
+  x << -1, 3;
+  scaled(x, fx, grad_fx);
+  EXPECT_EQ(2, scaled.num_recordings());
+  EXPECT_FLOAT_EQ(3, fx);
+  EXPECT_FLOAT_EQ(-3, grad_fx(0));
+  EXPECT_FLOAT_EQ(1, grad_fx(1));
+  EXPECT_TRUE(scaled.replayable());
+  x << -2, 3;
+  scaled(x, fx, grad_fx);
+  EXPECT_EQ(2, scaled.num_recordings());
+  EXPECT_FLOAT_EQ(6, fx);
+  EXPECT_FLOAT_EQ(-3, grad_fx(0));
+  EXPECT_FLOAT_EQ(2, grad_fx(1));
+}
+
+TEST(RevFunctor, taped_gradient_nested_not_replayed) {
+  using stan::math::taped_gradient;
+  taped_gradient<taped_gradient_test::nested> taped(
+      taped_gradient_test::nested{});
+  Eigen::VectorXd x(2);
+  Eigen::VectorXd grad_fx;
+  double fx;
+  x << 0.5, 1.5;
+  taped(x, fx, grad_fx);
+  EXPECT_FALSE(taped.replayable());
+  EXPECT_FLOAT_EQ(0.75, fx);
+  EXPECT_FLOAT_EQ(1.5, grad_fx(0));
+  EXPECT_FLOAT_EQ(0.5, grad_fx(1));
+}
+
+TEST(RevFunctor, taped_gradient_nan_not_replayed) {
+  using stan::math::taped_gradient;
+  taped_gradient<taped_gradient_test::smooth> taped(
+      taped_gradient_test::smooth{});
+  Eigen::VectorXd x(3);
+  Eigen::VectorXd grad_fx;
+  double fx;
+  x << 0.5, 1.5, 2.0;
+  taped(x, fx, grad_fx);
+  EXPECT_TRUE(taped.replayable());
+  x(2) = std::numeric_limits<double>::quiet_NaN();
+  taped(x, fx, grad_fx);
+  EXPECT_EQ(2, taped.num_recordings());
+  EXPECT_FALSE(taped.replayable());
+  EXPECT_TRUE(std::isnan(fx));
+}
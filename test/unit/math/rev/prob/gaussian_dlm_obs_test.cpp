@@ -0,0 +1,160 @@
+#include <stan/math/rev.hpp>
+#include <test/unit/math/rev/util.hpp>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace gaussian_dlm_obs_test {
+template <typename T>
+using matrix_t = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>;
+template <typename T>
+using vector_t = Eigen::Matrix<T, Eigen::Dynamic, 1>;
+
+// fill a symmetric matrix from its lower triangle
+template <typename T>
+matrix_t<T> symmetric(const std::vector<T>& theta, size_t& k, int n) {
+  matrix_t<T> S(n, n);
+  for (int j = 0; j < n; ++j) {
+    for (int i = j; i < n; ++i) {
+      S(i, j) = theta[k++];
+      S(j, i) = S(i, j);
+    }
+  }
+  return S;
+}
+
+template <typename T>
+matrix_t<T> general(const std::vector<T>& theta, size_t& k, int rows,
+                    int cols) {
+  matrix_t<T> M(rows, cols);
+  for (int j = 0; j < cols; ++j) {
+    for (int i = 0; i < rows; ++i) {
+      M(i, j) = theta[k++];
+    }
+  }
+  return M;
+}
+
+// the arguments of the GDLM with 2 states and 3 variables from the prim
+// tests, as a flat vector
+std::vector<double> arguments(bool V_vector) {
+  std::vector<double> theta{
+      // F
+      0.585528817843856, -0.453497173462763, 0.709466017509524,
+      0.605887455840394, -0.109303314681054, -1.81795596770373,
+      // G
+      0.520216457554957, -0.750531994502331, 0.816899839520583,
+      -0.886357521243213};
+  // V
+  if (V_vector) {
+    theta.insert(theta.end(),
+                 {7.19105866377728, 3.27048576782842, 5.86564522448303});
+  } else {
+    theta.insert(theta.end(), {7.19105866377728, -0.311731853764732,
+                               4.87333111936296, 3.27048576782842,
+                               0.457616661474554, 5.86564522448303});
+  }
+  // W
+  theta.insert(theta.end(),
+               {2.24277594357501, -1.65863136283477, 6.69010664813895});
+  // m0
+  theta.insert(theta.end(), {-0.892071328367409, 3.74785137677115});
+  // C0
+  theta.insert(theta.end(), {82.1224673418328, 0.3, 56.0195157304406});
+  // y
+  for (int t = 0; t < 10; ++t) {
+    for (int i = 0; i < 3; ++i) {
+      theta.push_back(4 * std::sin(1.7 * t + i));
+    }
+  }
+  return theta;
+}
+
+template <typename T>
+T lpdf(const std::vector<T>& theta, bool V_vector) {
+  size_t k = 0;
+  matrix_t<T> F = general(theta, k, 2, 3);
+  matrix_t<T> G = general(theta, k, 2, 2);
+  matrix_t<T> V;
+  vector_t<T> V_vec(3);
+  if (V_vector) {
+    for (int i = 0; i < 3; ++i) {
+      V_vec(i) = theta[k++];
+    }
+  } else {
+    V = symmetric(theta, k, 3);
+  }
+  matrix_t<T> W = symmetric(theta, k, 2);
+  vector_t<T> m0(2);
+  m0 << theta[k], theta[k + 1];
+  k += 2;
+  matrix_t<T> C0 = symmetric(theta, k, 2);
+  matrix_t<T> y = general(theta, k, 3, 10);
+  return V_vector ? stan::math::gaussian_dlm_obs_lpdf(y, F, G, V_vec, W, m0, C0)
+                  : stan::math::gaussian_dlm_obs_lpdf(y, F, G, V, W, m0, C0);
+}
+
+// the gradient of the adjoint Kalman filter matches the finite differences
+// of the Kalman filter on doubles
+void expect_gradient(bool V_vector) {
+  using stan::math::var;
+  std::vector<double> theta = arguments(V_vector);
+  std::vector<var> theta_v(theta.begin(), theta.end());
+
+  size_t stack_size = stan::math::ChainableStack::instance_->var_stack_.size();
+  var lp = lpdf(theta_v, V_vector);
+  // one callback for all time steps
+  EXPECT_EQ(stack_size + 1,
+            stan::math::ChainableStack::instance_->var_stack_.size());
+  std::vector<double> grad;
+  lp.grad(theta_v, grad);
+
+  EXPECT_FLOAT_EQ(lpdf(theta, V_vector), lp.val());
+  const double h = 1e-6;
+  for (size_t n = 0; n < theta.size(); ++n) {
+    std::vector<double> theta_plus = theta;
+    std::vector<double> theta_minus = theta;
+    theta_plus[n] += h;
+    theta_minus[n] -= h;
+    double grad_fd
+        = (lpdf(theta_plus, V_vector) - lpdf(theta_minus, V_vector)) / (2 * h);
+    EXPECT_NEAR(grad_fd, grad[n], 1e-6 * (1 + std::fabs(grad[n])))
+        << "argument " << n;
+  }
+  stan::math::recover_memory();
+}
+}  // namespace gaussian_dlm_obs_test
+
+TEST(ProbDistributionsGaussianDLM, gradient_matrix_V) {
+  gaussian_dlm_obs_test::expect_gradient(false);
+}
+
+TEST(ProbDistributionsGaussianDLM, gradient_vector_V) {
+  gaussian_dlm_obs_test::expect_gradient(true);
+}
+
+TEST(ProbDistributionsGaussianDLM, mixed_var_double) {
+  using stan::math::var;
+  Eigen::MatrixXd F = Eigen::MatrixXd::Random(2, 3);
+  Eigen::MatrixXd G = Eigen::MatrixXd::Random(2, 2);
+  Eigen::MatrixXd V = Eigen::MatrixXd::Identity(3, 3);
+  Eigen::MatrixXd W = Eigen::MatrixXd::Identity(2, 2);
+  Eigen::MatrixXd y = Eigen::MatrixXd::Random(3, 5);
+  Eigen::VectorXd m0 = Eigen::VectorXd::Random(2);
+  Eigen::MatrixXd C0 = Eigen::MatrixXd::Identity(2, 2);
+
+  Eigen::Matrix<var, Eigen::Dynamic, Eigen::Dynamic> W_v = W;
+  var lp = stan::math::gaussian_dlm_obs_lpdf(y, F, G, V, W_v, m0, C0);
+  EXPECT_FLOAT_EQ(stan::math::gaussian_dlm_obs_lpdf(y, F, G, V, W, m0, C0),
+                  lp.val());
+  var lp_propto
+      = stan::math::gaussian_dlm_obs_lpdf<true>(y, F, G, V, W_v, m0, C0);
+  EXPECT_FLOAT_EQ(lp.val() + 0.5 * std::log(2 * stan::math::pi()) * 15,
+                  lp_propto.val());
+  lp.grad();
+  EXPECT_NE(W_v(0, 0).adj(), 0);
+
+  Eigen::MatrixXd V_bad = -Eigen::MatrixXd::Identity(3, 3);
+  EXPECT_THROW(stan::math::gaussian_dlm_obs_lpdf(y, F, G, V_bad, W_v, m0, C0),
+               std::domain_error);
+  stan::math::recover_memory();
+}
@@ -0,0 +1,103 @@
+#include <stan/math/rev.hpp>
+#include <test/unit/math/rev/util.hpp>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace multi_normal_array_test {
+using stan::math::var;
+using matrix_v = Eigen::Matrix<var, Eigen::Dynamic, Eigen::Dynamic>;
+using vector_v = Eigen::Matrix<var, Eigen::Dynamic, 1>;
+
+struct observations {
+  std::vector<vector_v> y;
+  std::vector<vector_v> mu;
+  matrix_v Sigma;
+  var nu;
+
+  observations(int n, int k, bool cholesky) : nu(4.5) {
+    for (int i = 0; i < n; ++i) {
+      Eigen::VectorXd y_i(k);
+      Eigen::VectorXd mu_i(k);
+      for (int j = 0; j < k; ++j) {
+        y_i(j) = std::sin(1.3 * i + j);
+        mu_i(j) = 0.2 * std::cos(0.7 * i - j);
+      }
+      y.push_back(y_i);
+      mu.push_back(mu_i);
+    }
+    Eigen::MatrixXd A = Eigen::MatrixXd::Random(k, k);
+    Eigen::MatrixXd Sigma_val
+        = A * A.transpose() + k * Eigen::MatrixXd::Identity(k, k);
+    if (cholesky) {
+      Sigma = Eigen::MatrixXd(Sigma_val.llt().matrixL());
+    } else {
+      Sigma = Sigma_val;
+    }
+  }
+
+  std::vector<var> operands() const {
+    std::vector<var> ops;
+    for (size_t i = 0; i < y.size(); ++i) {
+      ops.insert(ops.end(), y[i].data(), y[i].data() + y[i].size());
+      ops.insert(ops.end(), mu[i].data(), mu[i].data() + mu[i].size());
+    }
+    ops.insert(ops.end(), Sigma.data(), Sigma.data() + Sigma.size());
+    ops.push_back(nu);
+    return ops;
+  }
+};
+
+// the density of all the observations in one call has one vari and the
+// value and gradient of the sum of the densities of single observations
+template <typename F>
+void expect_matches_single_observations(const F& lpdf, bool cholesky) {
+  observations obs(40, 4, cholesky);
+  std::vector<var> ops = obs.operands();
+
+  size_t stack_size = stan::math::ChainableStack::instance_->var_stack_.size();
+  var lp_batch = lpdf(obs.y, obs.mu, obs.Sigma, obs.nu);
+  EXPECT_EQ(stack_size + 1,
+            stan::math::ChainableStack::instance_->var_stack_.size());
+  std::vector<double> grad_batch;
+  lp_batch.grad(ops, grad_batch);
+  stan::math::set_zero_all_adjoints();
+
+  var lp_single = 0;
+  for (size_t i = 0; i < obs.y.size(); ++i) {
+    lp_single += lpdf(obs.y[i], obs.mu[i], obs.Sigma, obs.nu);
+  }
+  std::vector<double> grad_single;
+  lp_single.grad(ops, grad_single);
+
+  EXPECT_FLOAT_EQ(lp_single.val(), lp_batch.val());
+  ASSERT_EQ(grad_single.size(), grad_batch.size());
+  for (size_t n = 0; n < grad_single.size(); ++n) {
+    EXPECT_NEAR(grad_single[n], grad_batch[n], 1e-8) << "operand " << n;
+  }
+  stan::math::recover_memory();
+}
+}  // namespace multi_normal_array_test
+
+TEST(ProbDistributionsMultiNormal, array_matches_single_observations) {
+  multi_normal_array_test::expect_matches_single_observations(
+      [](const auto& y, const auto& mu, const auto& Sigma, const auto& nu) {
+        return stan::math::multi_normal_lpdf(y, mu, Sigma);
+      },
+      false);
+}
+
+TEST(ProbDistributionsMultiNormalCholesky, array_matches_single_observations) {
+  multi_normal_array_test::expect_matches_single_observations(
+      [](const auto& y, const auto& mu, const auto& L, const auto& nu) {
+        return stan::math::multi_normal_cholesky_lpdf(y, mu, L);
+      },
+      true);
+}
+
+TEST(ProbDistributionsMultiStudentT, array_matches_single_observations) {
+  multi_normal_array_test::expect_matches_single_observations(
+      [](const auto& y, const auto& mu, const auto& Sigma, const auto& nu) {
+        return stan::math::multi_student_t_lpdf(y, nu, mu, Sigma);
+      },
+      false);
+}